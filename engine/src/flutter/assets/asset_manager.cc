@@ -13,7 +13,7 @@ AssetManager::AssetManager() = default;
 
 AssetManager::~AssetManager() = default;
 
-bool AssetManager::PushFront(std::unique_ptr<AssetResolver> resolver) {
+bool AssetManager::PushFront(std::shared_ptr<AssetResolver> resolver) {
   if (resolver == nullptr || !resolver->IsValid()) {
     return false;
   }
@@ -22,7 +22,7 @@ bool AssetManager::PushFront(std::unique_ptr<AssetResolver> resolver) {
   return true;
 }
 
-bool AssetManager::PushBack(std::unique_ptr<AssetResolver> resolver) {
+bool AssetManager::PushBack(std::shared_ptr<AssetResolver> resolver) {
   if (resolver == nullptr || !resolver->IsValid()) {
     return false;
   }
@@ -38,7 +38,7 @@ void AssetManager::UpdateResolverByType(
     return;
   }
   bool updated = false;
-  std::deque<std::unique_ptr<AssetResolver>> new_resolvers;
+  std::deque<std::shared_ptr<AssetResolver>> new_resolvers;
   for (auto& old_resolver : resolvers_) {
     if (!updated && old_resolver->GetType() == type) {
       // Push the replacement updated resolver in place of the old_resolver.
@@ -55,10 +55,14 @@ void AssetManager::UpdateResolverByType(
   resolvers_.swap(new_resolvers);
 }
 
-std::deque<std::unique_ptr<AssetResolver>> AssetManager::TakeResolvers() {
+std::deque<std::shared_ptr<AssetResolver>> AssetManager::TakeResolvers() {
   return std::move(resolvers_);
 }
 
+std::deque<std::shared_ptr<AssetResolver>> AssetManager::GetResolvers() const {
+  return resolvers_;
+}
+
 // |AssetResolver|
 std::unique_ptr<fml::Mapping> AssetManager::GetAsMapping(
     const std::string& asset_name) const {
@@ -70,6 +74,9 @@ std::unique_ptr<fml::Mapping> AssetManager::GetAsMapping(
   for (const auto& resolver : resolvers_) {
     auto mapping = resolver->GetAsMapping(asset_name);
     if (mapping != nullptr) {
+      if (prefetcher_) {
+        prefetcher_->RecordUse(asset_name);
+      }
       return mapping;
     }
   }
@@ -77,6 +84,10 @@ std::unique_ptr<fml::Mapping> AssetManager::GetAsMapping(
   return nullptr;
 }
 
+void AssetManager::SetPrefetcher(std::shared_ptr<AssetPrefetcher> prefetcher) {
+  prefetcher_ = std::move(prefetcher);
+}
+
 // |AssetResolver|
 std::vector<std::unique_ptr<fml::Mapping>> AssetManager::GetAsMappings(
     const std::string& asset_pattern,
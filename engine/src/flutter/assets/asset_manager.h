@@ -10,6 +10,7 @@
 #include <string>
 
 #include <optional>
+#include "flutter/assets/asset_prefetcher.h"
 #include "flutter/assets/asset_resolver.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
@@ -29,7 +30,7 @@ class AssetManager final : public AssetResolver {
   ///
   /// @return     Returns whether this resolver is valid and has been added to
   ///             the resolver queue.
-  bool PushFront(std::unique_ptr<AssetResolver> resolver);
+  bool PushFront(std::shared_ptr<AssetResolver> resolver);
 
   //--------------------------------------------------------------------------
   /// @brief      Adds an asset resolver to the end of the resolver queue.
@@ -38,7 +39,7 @@ class AssetManager final : public AssetResolver {
   ///
   /// @return     Returns whether this resolver is valid and has been added to
   ///             the resolver queue.
-  bool PushBack(std::unique_ptr<AssetResolver> resolver);
+  bool PushBack(std::shared_ptr<AssetResolver> resolver);
 
   //--------------------------------------------------------------------------
   /// @brief      Replaces an asset resolver of the specified `type` with
@@ -68,7 +69,20 @@ class AssetManager final : public AssetResolver {
       std::unique_ptr<AssetResolver> updated_asset_resolver,
       AssetResolver::AssetResolverType type);
 
-  std::deque<std::unique_ptr<AssetResolver>> TakeResolvers();
+  std::deque<std::shared_ptr<AssetResolver>> TakeResolvers();
+
+  //--------------------------------------------------------------------------
+  /// @brief      Returns a copy of the resolver queue. The resolvers are
+  ///             shared, so the copy can be used on another thread while the
+  ///             resolvers of this manager are updated.
+  ///
+  std::deque<std::shared_ptr<AssetResolver>> GetResolvers() const;
+
+  //--------------------------------------------------------------------------
+  /// @brief      Sets the prefetcher that every asset resolved by
+  ///             `GetAsMapping` is reported to.
+  ///
+  void SetPrefetcher(std::shared_ptr<AssetPrefetcher> prefetcher);
 
   // |AssetResolver|
   bool IsValid() const override;
@@ -95,7 +109,8 @@ class AssetManager final : public AssetResolver {
   const AssetManager* as_asset_manager() const override { return this; }
 
  private:
-  std::deque<std::unique_ptr<AssetResolver>> resolvers_;
+  std::deque<std::shared_ptr<AssetResolver>> resolvers_;
+  std::shared_ptr<AssetPrefetcher> prefetcher_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(AssetManager);
 };
@@ -0,0 +1,209 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/asset_prefetcher.h"
+
+#include <cstring>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+static constexpr const char* kManifestFileName = "flutter.assets.prefetch";
+
+static constexpr uint32_t kFileMagic = 0x4150464d;  // 'APFM'
+static constexpr uint32_t kFileVersion = 1u;
+
+// Names longer than this are not asset names and mark a corrupt file.
+static constexpr uint32_t kMaxNameSize = 4096u;
+
+// Pages are touched at this stride. Touching more often than the page size of
+// the platform is harmless.
+static constexpr size_t kPageSize = 4096u;
+
+struct FileHeader {
+  uint32_t magic = kFileMagic;
+  uint32_t version = kFileVersion;
+  uint32_t entry_count = 0u;
+  uint32_t reserved = 0u;
+};
+
+// Each entry is the size of the name as a uint32_t followed by the name.
+void AppendEntry(std::vector<uint8_t>& data, const std::string& name) {
+  uint32_t name_size = name.size();
+  const uint8_t* size_bytes = reinterpret_cast<const uint8_t*>(&name_size);
+  data.insert(data.end(), size_bytes, size_bytes + sizeof(name_size));
+  data.insert(data.end(), name.begin(), name.end());
+}
+
+// Reads one byte of every page of a mapping so that the pages are faulted in.
+void TouchPages(const fml::Mapping& mapping) {
+  const uint8_t* data = mapping.GetMapping();
+  if (data == nullptr) {
+    return;
+  }
+  volatile uint8_t sink = 0u;
+  for (size_t offset = 0u; offset < mapping.GetSize(); offset += kPageSize) {
+    sink = sink ^ data[offset];
+  }
+  (void)sink;
+}
+
+}  // namespace
+
+AssetPrefetcher::AssetPrefetcher(fml::UniqueFD cache_directory)
+    : cache_directory_(std::move(cache_directory)) {
+  LoadPersistedManifest();
+}
+
+AssetPrefetcher::~AssetPrefetcher() = default;
+
+const std::vector<std::string>& AssetPrefetcher::GetManifest() const {
+  return persisted_manifest_;
+}
+
+bool AssetPrefetcher::Prefetch(const std::string& asset_name,
+                               const fml::Mapping& mapping) {
+  {
+    std::scoped_lock lock(mutex_);
+    if (used_assets_.count(asset_name) > 0 ||
+        unused_prefetched_assets_.count(asset_name) > 0 ||
+        stats_.prefetched_bytes + mapping.GetSize() > kMaxPrefetchBytes) {
+      return false;
+    }
+    unused_prefetched_assets_[asset_name] = mapping.GetSize();
+    stats_.prefetched_assets++;
+    stats_.prefetched_bytes += mapping.GetSize();
+    stats_.wasted_bytes += mapping.GetSize();
+  }
+
+  TRACE_EVENT1("flutter", "AssetPrefetcher::Prefetch", "name",
+               asset_name.c_str());
+  TouchPages(mapping);
+  return true;
+}
+
+size_t AssetPrefetcher::PrefetchAssets(
+    const std::deque<std::shared_ptr<AssetResolver>>& resolvers) {
+  TRACE_EVENT0("flutter", "AssetPrefetcher::PrefetchAssets");
+  size_t prefetched = 0u;
+  for (const std::string& asset_name : persisted_manifest_) {
+    for (const auto& resolver : resolvers) {
+      auto mapping = resolver->GetAsMapping(asset_name);
+      if (mapping != nullptr) {
+        if (Prefetch(asset_name, *mapping)) {
+          prefetched++;
+        }
+        break;
+      }
+    }
+  }
+  return prefetched;
+}
+
+void AssetPrefetcher::RecordUse(const std::string& asset_name) {
+  std::scoped_lock lock(mutex_);
+  auto prefetched = unused_prefetched_assets_.find(asset_name);
+  bool was_prefetched = prefetched != unused_prefetched_assets_.end();
+  if (was_prefetched) {
+    stats_.hits++;
+    stats_.wasted_bytes -= prefetched->second;
+    unused_prefetched_assets_.erase(prefetched);
+  }
+
+  if (!is_recording_ || asset_name.size() > kMaxNameSize ||
+      !used_assets_.insert(asset_name).second) {
+    return;
+  }
+  if (!was_prefetched) {
+    stats_.misses++;
+  }
+  manifest_.push_back(asset_name);
+  if (manifest_.size() >= kMaxAssets) {
+    is_recording_ = false;
+  }
+}
+
+void AssetPrefetcher::StopRecording() {
+  std::scoped_lock lock(mutex_);
+  is_recording_ = false;
+}
+
+AssetPrefetcher::Stats AssetPrefetcher::GetStats() const {
+  std::scoped_lock lock(mutex_);
+  return stats_;
+}
+
+void AssetPrefetcher::LoadPersistedManifest() {
+  if (!cache_directory_.is_valid()) {
+    return;
+  }
+  std::unique_ptr<fml::FileMapping> mapping =
+      fml::FileMapping::CreateReadOnly(cache_directory_, kManifestFileName);
+  if (!mapping || mapping->GetSize() < sizeof(FileHeader)) {
+    return;
+  }
+
+  const uint8_t* data = mapping->GetMapping();
+  const size_t size = mapping->GetSize();
+  FileHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != kFileMagic || header.version != kFileVersion) {
+    FML_LOG(INFO) << "Ignoring asset prefetch manifest of a different version.";
+    return;
+  }
+
+  std::vector<std::string> manifest;
+  size_t offset = sizeof(FileHeader);
+  for (uint32_t i = 0; i < header.entry_count && i < kMaxAssets; i++) {
+    uint32_t name_size = 0u;
+    if (size - offset < sizeof(name_size)) {
+      break;
+    }
+    std::memcpy(&name_size, data + offset, sizeof(name_size));
+    offset += sizeof(name_size);
+    if (name_size == 0u || name_size > kMaxNameSize ||
+        size - offset < name_size) {
+      break;
+    }
+    manifest.emplace_back(reinterpret_cast<const char*>(data + offset),
+                          name_size);
+    offset += name_size;
+  }
+  if (manifest.size() != header.entry_count || offset != size) {
+    FML_LOG(WARNING) << "Ignoring corrupt asset prefetch manifest.";
+    return;
+  }
+  persisted_manifest_ = std::move(manifest);
+}
+
+bool AssetPrefetcher::Persist() const {
+  if (!cache_directory_.is_valid()) {
+    return false;
+  }
+
+  std::vector<uint8_t> data(sizeof(FileHeader), 0u);
+  {
+    std::scoped_lock lock(mutex_);
+    FileHeader header;
+    header.entry_count = manifest_.size();
+    std::memcpy(data.data(), &header, sizeof(header));
+    for (const std::string& name : manifest_) {
+      AppendEntry(data, name);
+    }
+  }
+
+  fml::NonOwnedMapping mapping(data.data(), data.size());
+  if (!fml::WriteAtomically(cache_directory_, kManifestFileName, mapping)) {
+    FML_LOG(ERROR) << "Could not write the asset prefetch manifest to disk.";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace flutter
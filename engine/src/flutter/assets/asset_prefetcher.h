@@ -0,0 +1,140 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_ASSET_PREFETCHER_H_
+#define FLUTTER_ASSETS_ASSET_PREFETCHER_H_
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "flutter/assets/asset_resolver.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Records the order in which the assets of an application are
+///             first used during startup into a manifest, and prefetches the
+///             assets of the manifest recorded by a previous run.
+///
+///             The |AssetManager| reports every asset it resolves to the
+///             prefetcher, which appends the assets it has not seen yet to
+///             the manifest of this run until recording is stopped. On the
+///             next launch, the assets of that manifest are resolved and
+///             read into the page cache on the IO thread ahead of their
+///             first use, so that fonts, images and shaders are not read
+///             from disk in the middle of a frame.
+///
+///             This object is thread safe.
+///
+class AssetPrefetcher {
+ public:
+  /// The maximum number of assets that are recorded in the manifest.
+  static constexpr size_t kMaxAssets = 256u;
+
+  /// The maximum number of bytes that are prefetched in one launch.
+  static constexpr size_t kMaxPrefetchBytes = 32u * 1024u * 1024u;
+
+  struct Stats {
+    /// The number of assets that were prefetched.
+    size_t prefetched_assets = 0u;
+    /// The number of bytes that were prefetched.
+    size_t prefetched_bytes = 0u;
+    /// The number of prefetched assets that were used afterwards.
+    size_t hits = 0u;
+    /// The number of assets that were first used while recording and were
+    /// not prefetched, either because they were missing from the manifest
+    /// or because they were used before the prefetch got to them.
+    size_t misses = 0u;
+    /// The number of prefetched bytes that have not been used yet.
+    size_t wasted_bytes = 0u;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a prefetcher and loads the manifest recorded by a
+  ///             previous run.
+  ///
+  /// @param[in]  cache_directory  The directory of the manifest. If invalid,
+  ///                              nothing is loaded or persisted.
+  explicit AssetPrefetcher(fml::UniqueFD cache_directory = {});
+
+  ~AssetPrefetcher();
+
+  //----------------------------------------------------------------------------
+  /// @brief      The names of the assets recorded by a previous run, in the
+  ///             order in which they were first used.
+  const std::vector<std::string>& GetManifest() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reads the pages of a resolved asset of the manifest so that
+  ///             they are in the page cache by the time the asset is used.
+  ///
+  ///             Assets that have already been used or prefetched, and assets
+  ///             past the |kMaxPrefetchBytes| budget, are not read.
+  ///
+  /// @return     Whether the asset was prefetched.
+  bool Prefetch(const std::string& asset_name, const fml::Mapping& mapping);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Resolves the assets of the manifest with the first of the
+  ///             |resolvers| that has them and prefetches them. This blocks on
+  ///             disk I/O and should be called on the IO thread.
+  ///
+  ///             The resolvers are a copy of the queue of the asset manager,
+  ///             taken with |AssetManager::GetResolvers| on the thread that
+  ///             owns the manager, so that updates to its resolvers do not
+  ///             race with the prefetch.
+  ///
+  /// @return     The number of assets that were prefetched.
+  size_t PrefetchAssets(
+      const std::deque<std::shared_ptr<AssetResolver>>& resolvers);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reports a use of an asset. Assets used for the first time
+  ///             are appended to the manifest of this run while recording.
+  void RecordUse(const std::string& asset_name);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Stops appending assets to the manifest of this run. Hits are
+  ///             still counted.
+  void StopRecording();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Writes the manifest of this run to the cache directory, to
+  ///             be prefetched by the next launch.
+  ///
+  /// @return     True if the file was written, false if the prefetcher has no
+  ///             directory or the write failed.
+  bool Persist() const;
+
+  Stats GetStats() const;
+
+ private:
+  const fml::UniqueFD cache_directory_;
+  std::vector<std::string> persisted_manifest_;
+
+  mutable std::mutex mutex_;
+  bool is_recording_ = true;
+  // The manifest of this run, in the order in which assets were first used.
+  std::vector<std::string> manifest_;
+  std::unordered_set<std::string> used_assets_;
+  // The sizes of the prefetched assets that have not been used yet.
+  std::unordered_map<std::string, size_t> unused_prefetched_assets_;
+  Stats stats_;
+
+  void LoadPersistedManifest();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AssetPrefetcher);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_ASSETS_ASSET_PREFETCHER_H_
@@ -0,0 +1,167 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/asset_prefetcher.h"
+
+#include <string>
+#include <vector>
+
+#include "flutter/assets/asset_manager.h"
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+class AssetPrefetcherTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    WriteAsset("a.ttf", std::string(100u, 'a'));
+    WriteAsset("b.png", std::string(2000u, 'b'));
+    WriteAsset("c.frag", std::string(30000u, 'c'));
+    WriteAsset("d.json", std::string(4u, 'd'));
+  }
+
+  void WriteAsset(const char* name, const std::string& contents) {
+    fml::DataMapping mapping(contents);
+    ASSERT_TRUE(fml::WriteAtomically(assets_dir_.fd(), name, mapping));
+  }
+
+  // Creates a prefetcher that loads the manifest persisted by the previous
+  // one, and an asset manager that reports to it.
+  std::shared_ptr<AssetPrefetcher> Launch() {
+    auto prefetcher = std::make_shared<AssetPrefetcher>(
+        fml::Duplicate(cache_dir_.fd().get()));
+    asset_manager_ = std::make_shared<AssetManager>();
+    asset_manager_->PushBack(std::make_unique<DirectoryAssetBundle>(
+        fml::Duplicate(assets_dir_.fd().get()), false));
+    asset_manager_->SetPrefetcher(prefetcher);
+    return prefetcher;
+  }
+
+  size_t Prefetch(const std::shared_ptr<AssetPrefetcher>& prefetcher) {
+    return prefetcher->PrefetchAssets(asset_manager_->GetResolvers());
+  }
+
+  void Use(const std::string& asset_name) {
+    asset_manager_->GetAsMapping(asset_name);
+  }
+
+  fml::ScopedTemporaryDirectory assets_dir_;
+  fml::ScopedTemporaryDirectory cache_dir_;
+  std::shared_ptr<AssetManager> asset_manager_;
+};
+
+TEST_F(AssetPrefetcherTest, RecordsTheOrderOfFirstUses) {
+  std::shared_ptr<AssetPrefetcher> prefetcher = Launch();
+  EXPECT_TRUE(prefetcher->GetManifest().empty());
+  Use("c.frag");
+  Use("a.ttf");
+  Use("c.frag");
+  Use("missing.png");
+  ASSERT_TRUE(prefetcher->Persist());
+
+  prefetcher = Launch();
+  EXPECT_EQ(prefetcher->GetManifest(),
+            (std::vector<std::string>{"c.frag", "a.ttf"}));
+}
+
+TEST_F(AssetPrefetcherTest, CountsHitsMissesAndWastedBytes) {
+  std::shared_ptr<AssetPrefetcher> prefetcher = Launch();
+  Use("a.ttf");
+  Use("b.png");
+  Use("c.frag");
+  ASSERT_TRUE(prefetcher->Persist());
+
+  prefetcher = Launch();
+  EXPECT_EQ(Prefetch(prefetcher), 3u);
+  AssetPrefetcher::Stats stats = prefetcher->GetStats();
+  EXPECT_EQ(stats.prefetched_assets, 3u);
+  EXPECT_EQ(stats.prefetched_bytes, 32100u);
+  EXPECT_EQ(stats.wasted_bytes, 32100u);
+
+  Use("b.png");
+  Use("b.png");
+  Use("d.json");
+  stats = prefetcher->GetStats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.wasted_bytes, 30100u);
+
+  // Prefetching again does not read the assets a second time.
+  EXPECT_EQ(Prefetch(prefetcher), 0u);
+  EXPECT_EQ(prefetcher->GetStats().prefetched_bytes, 32100u);
+}
+
+TEST_F(AssetPrefetcherTest, DoesNotPrefetchAssetsThatWereAlreadyUsed) {
+  std::shared_ptr<AssetPrefetcher> prefetcher = Launch();
+  Use("a.ttf");
+  Use("b.png");
+  ASSERT_TRUE(prefetcher->Persist());
+
+  prefetcher = Launch();
+  Use("a.ttf");
+  EXPECT_EQ(Prefetch(prefetcher), 1u);
+  AssetPrefetcher::Stats stats = prefetcher->GetStats();
+  EXPECT_EQ(stats.prefetched_bytes, 2000u);
+  EXPECT_EQ(stats.misses, 1u);
+}
+
+TEST_F(AssetPrefetcherTest, PrefetchesFromACopyOfTheResolvers) {
+  std::shared_ptr<AssetPrefetcher> prefetcher = Launch();
+  Use("a.ttf");
+  Use("b.png");
+  ASSERT_TRUE(prefetcher->Persist());
+
+  prefetcher = Launch();
+  auto resolvers = asset_manager_->GetResolvers();
+  // Replacing the resolvers of the manager does not affect the copy.
+  asset_manager_->TakeResolvers();
+  asset_manager_.reset();
+  EXPECT_EQ(prefetcher->PrefetchAssets(resolvers), 2u);
+  EXPECT_EQ(prefetcher->GetStats().prefetched_bytes, 2100u);
+}
+
+TEST_F(AssetPrefetcherTest, StopsRecording) {
+  std::shared_ptr<AssetPrefetcher> prefetcher = Launch();
+  Use("a.ttf");
+  prefetcher->StopRecording();
+  Use("b.png");
+  ASSERT_TRUE(prefetcher->Persist());
+
+  prefetcher = Launch();
+  EXPECT_EQ(prefetcher->GetManifest(), (std::vector<std::string>{"a.ttf"}));
+}
+
+TEST_F(AssetPrefetcherTest, IgnoresCorruptManifests) {
+  std::shared_ptr<AssetPrefetcher> prefetcher = Launch();
+  Use("a.ttf");
+  Use("b.png");
+  ASSERT_TRUE(prefetcher->Persist());
+
+  std::unique_ptr<fml::FileMapping> mapping = fml::FileMapping::CreateReadOnly(
+      cache_dir_.fd(), "flutter.assets.prefetch");
+  ASSERT_TRUE(mapping);
+  std::vector<uint8_t> data(mapping->GetMapping(),
+                            mapping->GetMapping() + mapping->GetSize() - 1u);
+  mapping.reset();
+  fml::NonOwnedMapping truncated(data.data(), data.size());
+  ASSERT_TRUE(fml::WriteAtomically(cache_dir_.fd(), "flutter.assets.prefetch",
+                                   truncated));
+
+  prefetcher = Launch();
+  EXPECT_TRUE(prefetcher->GetManifest().empty());
+}
+
+TEST(AssetPrefetcherWithoutDirectoryTest, DoesNotPersist) {
+  AssetPrefetcher prefetcher;
+  prefetcher.RecordUse("a.ttf");
+  EXPECT_TRUE(prefetcher.GetManifest().empty());
+  EXPECT_FALSE(prefetcher.Persist());
+}
+
+}  // namespace testing
+}  // namespace flutter
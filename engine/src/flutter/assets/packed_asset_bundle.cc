@@ -0,0 +1,405 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <algorithm>
+#include <cstring>
+#include <regex>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+#if defined(FML_OS_POSIX)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // defined(FML_OS_POSIX)
+
+namespace flutter {
+
+namespace {
+
+static constexpr uint32_t kFileMagic = 0x4b415046;  // 'FPAK'
+static constexpr uint32_t kFileVersion = 1u;
+
+struct FileHeader {
+  uint32_t magic = kFileMagic;
+  uint32_t version = kFileVersion;
+  uint32_t entry_count = 0u;
+  uint32_t bucket_count = 0u;
+  uint64_t names_offset = 0u;
+  uint64_t names_size = 0u;
+};
+
+static_assert(sizeof(FileHeader) == 32u);
+
+enum EntryFlags : uint16_t {
+  kStartupAsset = 1 << 0,
+};
+
+// A 64-bit FNV-1a hash. Unlike std::hash, the result is stable across
+// processes so that it can be stored in the archive.
+uint64_t HashName(std::string_view name) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (char c : name) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+uint64_t AlignTo(uint64_t size, uint64_t alignment) {
+  return (size + alignment - 1u) & ~(alignment - 1u);
+}
+
+// The offset of the first entry, which follows the header and the
+// |bucket_count| + 1 bucket offsets.
+uint64_t GetEntriesOffset(uint32_t bucket_count) {
+  return AlignTo(sizeof(FileHeader) +
+                     (static_cast<uint64_t>(bucket_count) + 1u) *
+                         sizeof(uint32_t),
+                 alignof(uint64_t));
+}
+
+struct PackedFile {
+  std::string name;
+  std::unique_ptr<fml::FileMapping> mapping;
+};
+
+bool CollectFiles(const fml::UniqueFD& directory,
+                  const std::string& prefix,
+                  std::vector<PackedFile>& files) {
+  bool success = true;
+  fml::VisitFiles(directory, [&](const fml::UniqueFD& parent,
+                                 const std::string& filename) {
+    fml::UniqueFD fd = fml::OpenFileReadOnly(parent, filename.c_str());
+    if (fml::IsDirectory(fd)) {
+      success = CollectFiles(fd, prefix + filename + "/", files);
+      return success;
+    }
+    auto mapping = std::make_unique<fml::FileMapping>(fd);
+    if (!mapping->IsValid()) {
+      FML_LOG(ERROR) << "Could not map asset " << prefix << filename;
+      success = false;
+      return false;
+    }
+    files.push_back({.name = prefix + filename, .mapping = std::move(mapping)});
+    return true;
+  });
+  return success;
+}
+
+}  // namespace
+
+struct PackedAssetBundle::Entry {
+  uint64_t name_hash = 0u;
+  uint64_t data_offset = 0u;
+  uint64_t data_size = 0u;
+  uint32_t name_offset = 0u;
+  uint16_t name_size = 0u;
+  uint16_t flags = 0u;
+};
+
+static_assert(sizeof(PackedAssetBundle::Entry) == 32u);
+
+// static
+bool PackedAssetBundle::Pack(const fml::UniqueFD& assets_directory,
+                             const fml::UniqueFD& destination_directory,
+                             const std::string& file_name,
+                             const std::vector<std::string>& startup_assets) {
+  TRACE_EVENT0("flutter", "PackedAssetBundle::Pack");
+  std::vector<PackedFile> files;
+  if (!fml::IsDirectory(assets_directory) ||
+      !CollectFiles(assets_directory, "", files)) {
+    return false;
+  }
+  const std::unordered_set<std::string> startup_set(startup_assets.begin(),
+                                                    startup_assets.end());
+
+  uint32_t bucket_count = 1u;
+  while (bucket_count < files.size()) {
+    bucket_count <<= 1u;
+  }
+  const uint32_t bucket_mask = bucket_count - 1u;
+
+  std::vector<Entry> entries(files.size());
+  std::string names;
+  for (size_t i = 0; i < files.size(); i++) {
+    const std::string& name = files[i].name;
+    if (name.size() > UINT16_MAX) {
+      FML_LOG(ERROR) << "Asset name is too long: " << name;
+      return false;
+    }
+    entries[i] = Entry{
+        .name_hash = HashName(name),
+        .data_size = files[i].mapping->GetSize(),
+        .name_offset = static_cast<uint32_t>(names.size()),
+        .name_size = static_cast<uint16_t>(name.size()),
+        .flags = static_cast<uint16_t>(
+            startup_set.count(name) > 0u ? kStartupAsset : 0u),
+    };
+    names.append(name);
+  }
+
+  // Order the entries by bucket so that each bucket is a contiguous range.
+  std::vector<size_t> order(files.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return std::make_tuple(entries[a].name_hash & bucket_mask,
+                           entries[a].name_hash, files[a].name) <
+           std::make_tuple(entries[b].name_hash & bucket_mask,
+                           entries[b].name_hash, files[b].name);
+  });
+
+  std::vector<uint32_t> buckets(bucket_count + 1u, 0u);
+  for (const Entry& entry : entries) {
+    buckets[(entry.name_hash & bucket_mask) + 1u]++;
+  }
+  for (uint32_t i = 0; i < bucket_count; i++) {
+    buckets[i + 1u] += buckets[i];
+  }
+
+  FileHeader header;
+  header.entry_count = files.size();
+  header.bucket_count = bucket_count;
+  header.names_offset =
+      GetEntriesOffset(bucket_count) + files.size() * sizeof(Entry);
+  header.names_size = names.size();
+
+  // Lay out the contents of the assets in the sorted order.
+  uint64_t offset =
+      AlignTo(header.names_offset + header.names_size, kAssetAlignment);
+  for (size_t index : order) {
+    entries[index].data_offset = offset;
+    offset = AlignTo(offset + entries[index].data_size, kAssetAlignment);
+  }
+
+  std::vector<uint8_t> data(offset, 0u);
+  std::memcpy(data.data(), &header, sizeof(header));
+  std::memcpy(data.data() + sizeof(FileHeader), buckets.data(),
+              buckets.size() * sizeof(uint32_t));
+  uint8_t* entry_data = data.data() + GetEntriesOffset(bucket_count);
+  for (size_t i = 0; i < order.size(); i++) {
+    const Entry& entry = entries[order[i]];
+    std::memcpy(entry_data + i * sizeof(Entry), &entry, sizeof(Entry));
+    if (entry.data_size > 0u) {
+      std::memcpy(data.data() + entry.data_offset,
+                  files[order[i]].mapping->GetMapping(), entry.data_size);
+    }
+  }
+  if (!names.empty()) {
+    std::memcpy(data.data() + header.names_offset, names.data(), names.size());
+  }
+
+  fml::NonOwnedMapping mapping(data.data(), data.size());
+  if (!fml::WriteAtomically(destination_directory, file_name.c_str(),
+                            mapping)) {
+    FML_LOG(ERROR) << "Could not write the packed asset bundle.";
+    return false;
+  }
+  return true;
+}
+
+PackedAssetBundle::PackedAssetBundle(const fml::UniqueFD& directory,
+                                     const std::string& file_name,
+                                     bool is_valid_after_asset_manager_change)
+    : mapping_(fml::FileMapping::CreateReadOnly(directory, file_name)) {
+  if (!mapping_ || !Parse()) {
+    mapping_.reset();
+    return;
+  }
+  is_valid_after_asset_manager_change_ = is_valid_after_asset_manager_change;
+  is_valid_ = true;
+  AdviseStartupAssets();
+}
+
+PackedAssetBundle::~PackedAssetBundle() = default;
+
+bool PackedAssetBundle::Parse() {
+  const uint64_t size = mapping_->GetSize();
+  if (size < sizeof(FileHeader)) {
+    return false;
+  }
+  const uint8_t* data = mapping_->GetMapping();
+  FileHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != kFileMagic || header.version != kFileVersion) {
+    FML_LOG(ERROR) << "Packed asset bundle has an unsupported version.";
+    return false;
+  }
+  if (header.bucket_count == 0u ||
+      (header.bucket_count & (header.bucket_count - 1u)) != 0u ||
+      GetEntriesOffset(header.bucket_count) +
+              static_cast<uint64_t>(header.entry_count) * sizeof(Entry) >
+          header.names_offset ||
+      header.names_offset > size || header.names_size > size ||
+      header.names_offset + header.names_size > size) {
+    FML_LOG(ERROR) << "Packed asset bundle has a corrupt index.";
+    return false;
+  }
+
+  // The archive is mapped at a page boundary and the tables are aligned
+  // within it, so they can be read in place.
+  buckets_ = reinterpret_cast<const uint32_t*>(data + sizeof(FileHeader));
+  bucket_count_ = header.bucket_count;
+  entry_count_ = header.entry_count;
+  entries_ = data + GetEntriesOffset(header.bucket_count);
+  names_ = reinterpret_cast<const char*>(data + header.names_offset);
+
+  if (buckets_[0] != 0u || buckets_[bucket_count_] != entry_count_) {
+    FML_LOG(ERROR) << "Packed asset bundle has a corrupt index.";
+    return false;
+  }
+  for (uint32_t bucket = 0; bucket < bucket_count_; bucket++) {
+    if (buckets_[bucket] > buckets_[bucket + 1u]) {
+      FML_LOG(ERROR) << "Packed asset bundle has a corrupt index.";
+      return false;
+    }
+    for (uint32_t i = buckets_[bucket]; i < buckets_[bucket + 1u]; i++) {
+      const Entry entry = GetEntry(i);
+      if (static_cast<uint64_t>(entry.name_offset) + entry.name_size >
+              header.names_size ||
+          entry.data_offset > size || entry.data_size > size ||
+          entry.data_offset + entry.data_size > size ||
+          entry.name_hash != HashName(GetName(entry)) ||
+          (entry.name_hash & (bucket_count_ - 1u)) != bucket) {
+        FML_LOG(ERROR) << "Packed asset bundle has a corrupt entry.";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+PackedAssetBundle::Entry PackedAssetBundle::GetEntry(uint32_t index) const {
+  Entry entry;
+  std::memcpy(&entry, entries_ + index * sizeof(Entry), sizeof(Entry));
+  return entry;
+}
+
+std::string_view PackedAssetBundle::GetName(const Entry& entry) const {
+  return std::string_view(names_ + entry.name_offset, entry.name_size);
+}
+
+std::unique_ptr<fml::Mapping> PackedAssetBundle::CreateMapping(
+    const Entry& entry) const {
+  // The mapping of each asset keeps the archive mapped.
+  return std::make_unique<fml::NonOwnedMapping>(
+      mapping_->GetMapping() + entry.data_offset, entry.data_size,
+      [archive = mapping_](const uint8_t*, size_t) {},
+      /*dontneed_safe=*/true);
+}
+
+void PackedAssetBundle::AdviseStartupAssets() const {
+#if defined(FML_OS_POSIX)
+  TRACE_EVENT0("flutter", "PackedAssetBundle::AdviseStartupAssets");
+  static const uintptr_t page_size = ::sysconf(_SC_PAGESIZE);
+  const uintptr_t base = reinterpret_cast<uintptr_t>(mapping_->GetMapping());
+  for (uint32_t i = 0; i < entry_count_; i++) {
+    const Entry entry = GetEntry(i);
+    if ((entry.flags & kStartupAsset) == 0u || entry.data_size == 0u) {
+      continue;
+    }
+    // The assets are aligned to 4096 bytes, which may be smaller than a page.
+    const uintptr_t start = (base + entry.data_offset) & ~(page_size - 1u);
+    const uintptr_t end = base + entry.data_offset + entry.data_size;
+    if (::madvise(reinterpret_cast<void*>(start), end - start,
+                  MADV_WILLNEED) != 0) {
+      FML_DLOG(WARNING) << "Could not advise the readahead of "
+                        << GetName(entry);
+    }
+  }
+#endif  // defined(FML_OS_POSIX)
+}
+
+size_t PackedAssetBundle::GetAssetCount() const {
+  return entry_count_;
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValid() const {
+  return is_valid_;
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValidAfterAssetManagerChange() const {
+  return is_valid_after_asset_manager_change_;
+}
+
+// |AssetResolver|
+AssetResolver::AssetResolverType PackedAssetBundle::GetType() const {
+  return AssetResolver::AssetResolverType::kPackedAssetBundle;
+}
+
+// |AssetResolver|
+std::unique_ptr<fml::Mapping> PackedAssetBundle::GetAsMapping(
+    const std::string& asset_name) const {
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return nullptr;
+  }
+
+  const uint64_t hash = HashName(asset_name);
+  const uint32_t bucket = hash & (bucket_count_ - 1u);
+  for (uint32_t i = buckets_[bucket]; i < buckets_[bucket + 1u]; i++) {
+    const Entry entry = GetEntry(i);
+    if (entry.name_hash == hash && GetName(entry) == asset_name) {
+      return CreateMapping(entry);
+    }
+  }
+  return nullptr;
+}
+
+// |AssetResolver|
+std::vector<std::unique_ptr<fml::Mapping>> PackedAssetBundle::GetAsMappings(
+    const std::string& asset_pattern,
+    const std::optional<std::string>& subdir) const {
+  std::vector<std::unique_ptr<fml::Mapping>> mappings;
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return mappings;
+  }
+
+  // Like |DirectoryAssetBundle|, match the pattern against the file names of
+  // the assets, either in the subdirectory only or anywhere in the bundle.
+  std::regex asset_regex(asset_pattern);
+  const std::string prefix = subdir.has_value() ? subdir.value() + "/" : "";
+  for (uint32_t i = 0; i < entry_count_; i++) {
+    const Entry entry = GetEntry(i);
+    std::string_view name = GetName(entry);
+    if (name.substr(0, prefix.size()) != prefix) {
+      continue;
+    }
+    std::string_view relative_name = name.substr(prefix.size());
+    size_t separator = relative_name.rfind('/');
+    if (subdir.has_value() && separator != std::string_view::npos) {
+      continue;
+    }
+    std::string filename(separator == std::string_view::npos
+                             ? relative_name
+                             : relative_name.substr(separator + 1u));
+    if (std::regex_match(filename, asset_regex)) {
+      mappings.push_back(CreateMapping(entry));
+    }
+  }
+  return mappings;
+}
+
+bool PackedAssetBundle::operator==(const AssetResolver& other) const {
+  auto other_bundle = other.as_packed_asset_bundle();
+  if (!other_bundle) {
+    return false;
+  }
+  return is_valid_after_asset_manager_change_ ==
+             other_bundle->is_valid_after_asset_manager_change_ &&
+         mapping_ == other_bundle->mapping_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,126 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+#define FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flutter/assets/asset_resolver.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      An asset resolver over a single archive that packs all of the
+///             assets of an application.
+///
+///             The archive starts with an index of the assets, hashed by
+///             name, followed by the contents of the assets, each aligned to
+///             4096 bytes. The whole archive is mapped once and assets are
+///             looked up in constant time and returned as views into the
+///             mapping, so resolving an asset makes no system calls.
+///
+///             Assets that were marked as needed at startup when the archive
+///             was packed are hinted to the kernel for readahead when the
+///             bundle is opened.
+///
+class PackedAssetBundle : public AssetResolver {
+ public:
+  /// The name of the archive in the assets directory, if one was packed.
+  static constexpr const char* kFileName = "assets.pack";
+
+  /// The alignment of the contents of each asset in the archive.
+  static constexpr size_t kAssetAlignment = 4096u;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Packs all of the files in a directory and its
+  ///             subdirectories into an archive.
+  ///
+  /// @param[in]  assets_directory       The directory to pack. Assets are
+  ///                                    named by their path relative to it.
+  /// @param[in]  destination_directory  The directory to write the archive
+  ///                                    to.
+  /// @param[in]  file_name              The name of the archive.
+  /// @param[in]  startup_assets         The names of the assets to read ahead
+  ///                                    when the archive is opened.
+  ///
+  /// @return     Whether the archive was written.
+  static bool Pack(const fml::UniqueFD& assets_directory,
+                   const fml::UniqueFD& destination_directory,
+                   const std::string& file_name,
+                   const std::vector<std::string>& startup_assets = {});
+
+  //----------------------------------------------------------------------------
+  /// @brief      Opens an archive. The bundle is invalid if the archive could
+  ///             not be mapped or is corrupt.
+  PackedAssetBundle(const fml::UniqueFD& directory,
+                    const std::string& file_name,
+                    bool is_valid_after_asset_manager_change);
+
+  ~PackedAssetBundle() override;
+
+  /// @brief      Returns the number of assets in the archive.
+  size_t GetAssetCount() const;
+
+ private:
+  struct Entry;
+
+  std::shared_ptr<fml::FileMapping> mapping_;
+  const uint32_t* buckets_ = nullptr;
+  uint32_t bucket_count_ = 0u;
+  uint32_t entry_count_ = 0u;
+  const uint8_t* entries_ = nullptr;
+  const char* names_ = nullptr;
+  bool is_valid_ = false;
+  bool is_valid_after_asset_manager_change_ = false;
+
+  bool Parse();
+
+  Entry GetEntry(uint32_t index) const;
+
+  std::string_view GetName(const Entry& entry) const;
+
+  std::unique_ptr<fml::Mapping> CreateMapping(const Entry& entry) const;
+
+  void AdviseStartupAssets() const;
+
+  // |AssetResolver|
+  bool IsValid() const override;
+
+  // |AssetResolver|
+  bool IsValidAfterAssetManagerChange() const override;
+
+  // |AssetResolver|
+  AssetResolver::AssetResolverType GetType() const override;
+
+  // |AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) const override;
+
+  // |AssetResolver|
+  std::vector<std::unique_ptr<fml::Mapping>> GetAsMappings(
+      const std::string& asset_pattern,
+      const std::optional<std::string>& subdir) const override;
+
+  // |AssetResolver|
+  bool operator==(const AssetResolver& other) const override;
+
+  // |AssetResolver|
+  const PackedAssetBundle* as_packed_asset_bundle() const override {
+    return this;
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PackedAssetBundle);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
@@ -0,0 +1,87 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+
+namespace flutter {
+
+namespace {
+
+// Writes |count| small assets into |directory|, spread over a few
+// subdirectories like the assets of a large application.
+std::vector<std::string> WriteAssets(const fml::UniqueFD& directory,
+                                     size_t count) {
+  static constexpr size_t kSubdirectoryCount = 16u;
+  std::vector<std::string> names;
+  std::vector<uint8_t> contents(512u, 0xaa);
+  fml::NonOwnedMapping mapping(contents.data(), contents.size());
+  for (size_t i = 0; i < count; i++) {
+    std::string subdirectory = "dir" + std::to_string(i % kSubdirectoryCount);
+    std::string file_name = "asset" + std::to_string(i) + ".png";
+    fml::UniqueFD parent = fml::CreateDirectory(
+        directory, {subdirectory}, fml::FilePermission::kReadWrite);
+    fml::WriteAtomically(parent, file_name.c_str(), mapping);
+    names.push_back(subdirectory + "/" + file_name);
+  }
+  return names;
+}
+
+// Opens a resolver and resolves every asset once, like an application that
+// loads its assets at startup.
+void ResolveAllAssets(benchmark::State& state, bool packed) {
+  fml::ScopedTemporaryDirectory assets_dir;
+  fml::ScopedTemporaryDirectory pack_dir;
+  std::vector<std::string> names = WriteAssets(assets_dir.fd(), state.range(0));
+  if (packed && !PackedAssetBundle::Pack(assets_dir.fd(), pack_dir.fd(),
+                                         PackedAssetBundle::kFileName)) {
+    state.SkipWithError("Could not pack the assets.");
+    return;
+  }
+
+  for (auto _ : state) {
+    std::unique_ptr<AssetResolver> resolver;
+    if (packed) {
+      resolver = std::make_unique<PackedAssetBundle>(
+          pack_dir.fd(), PackedAssetBundle::kFileName, false);
+    } else {
+      resolver = std::make_unique<DirectoryAssetBundle>(
+          fml::Duplicate(assets_dir.fd().get()), false);
+    }
+    size_t bytes = 0u;
+    for (const std::string& name : names) {
+      std::unique_ptr<fml::Mapping> mapping = resolver->GetAsMapping(name);
+      bytes += mapping ? mapping->GetSize() : 0u;
+    }
+    benchmark::DoNotOptimize(bytes);
+  }
+  state.SetItemsProcessed(state.iterations() * names.size());
+}
+
+}  // namespace
+
+static void BM_DirectoryAssetBundleResolveAll(benchmark::State& state) {
+  ResolveAllAssets(state, /*packed=*/false);
+}
+
+static void BM_PackedAssetBundleResolveAll(benchmark::State& state) {
+  ResolveAllAssets(state, /*packed=*/true);
+}
+
+BENCHMARK(BM_DirectoryAssetBundleResolveAll)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PackedAssetBundleResolveAll)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
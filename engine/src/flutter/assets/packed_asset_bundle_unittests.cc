@@ -0,0 +1,159 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <cstring>
+#include <string>
+
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+void WriteAsset(const fml::UniqueFD& directory,
+                const std::vector<std::string>& path,
+                const std::string& contents) {
+  fml::UniqueFD parent = fml::Duplicate(directory.get());
+  if (path.size() > 1u) {
+    parent = fml::CreateDirectory(
+        directory, std::vector<std::string>(path.begin(), path.end() - 1),
+        fml::FilePermission::kReadWrite);
+  }
+  if (contents.empty()) {
+    ASSERT_TRUE(fml::OpenFile(parent, path.back().c_str(), true,
+                              fml::FilePermission::kReadWrite)
+                    .is_valid());
+    return;
+  }
+  fml::DataMapping mapping(contents);
+  ASSERT_TRUE(fml::WriteAtomically(parent, path.back().c_str(), mapping));
+}
+
+bool IsValidArchive(const fml::UniqueFD& directory,
+                    const std::string& file_name) {
+  std::unique_ptr<AssetResolver> bundle =
+      std::make_unique<PackedAssetBundle>(directory, file_name, false);
+  return bundle->IsValid();
+}
+
+std::string ToString(const std::unique_ptr<fml::Mapping>& mapping) {
+  return std::string(reinterpret_cast<const char*>(mapping->GetMapping()),
+                     mapping->GetSize());
+}
+
+}  // namespace
+
+class PackedAssetBundleTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    WriteAsset(assets_dir_.fd(), {"AssetManifest.bin"}, "manifest");
+    WriteAsset(assets_dir_.fd(), {"fonts", "a.ttf"}, "font a");
+    WriteAsset(assets_dir_.fd(), {"fonts", "b.ttf"}, "font b");
+    WriteAsset(assets_dir_.fd(), {"fonts", "nested", "c.ttf"}, "font c");
+    WriteAsset(assets_dir_.fd(), {"empty.txt"}, "");
+  }
+
+  std::unique_ptr<AssetResolver> PackAndOpen(
+      const std::vector<std::string>& startup_assets = {}) {
+    EXPECT_TRUE(PackedAssetBundle::Pack(assets_dir_.fd(), pack_dir_.fd(),
+                                        PackedAssetBundle::kFileName,
+                                        startup_assets));
+    return std::make_unique<PackedAssetBundle>(
+        pack_dir_.fd(), PackedAssetBundle::kFileName, false);
+  }
+
+  fml::ScopedTemporaryDirectory assets_dir_;
+  fml::ScopedTemporaryDirectory pack_dir_;
+};
+
+TEST_F(PackedAssetBundleTest, ResolvesPackedAssets) {
+  std::unique_ptr<AssetResolver> bundle = PackAndOpen({"AssetManifest.bin"});
+  ASSERT_TRUE(bundle->IsValid());
+  EXPECT_EQ(bundle->GetType(),
+            AssetResolver::AssetResolverType::kPackedAssetBundle);
+  EXPECT_EQ(bundle->as_packed_asset_bundle()->GetAssetCount(), 5u);
+
+  for (const auto& [name, contents] :
+       std::vector<std::pair<std::string, std::string>>{
+           {"AssetManifest.bin", "manifest"},
+           {"fonts/a.ttf", "font a"},
+           {"fonts/b.ttf", "font b"},
+           {"fonts/nested/c.ttf", "font c"},
+           {"empty.txt", ""},
+       }) {
+    std::unique_ptr<fml::Mapping> mapping = bundle->GetAsMapping(name);
+    ASSERT_TRUE(mapping) << name;
+    EXPECT_EQ(ToString(mapping), contents);
+  }
+  EXPECT_FALSE(bundle->GetAsMapping("fonts"));
+  EXPECT_FALSE(bundle->GetAsMapping("missing.txt"));
+}
+
+TEST_F(PackedAssetBundleTest, AssetsAreAligned) {
+  std::unique_ptr<AssetResolver> bundle = PackAndOpen();
+  ASSERT_TRUE(bundle->IsValid());
+  std::unique_ptr<fml::Mapping> mapping = bundle->GetAsMapping("fonts/a.ttf");
+  ASSERT_TRUE(mapping);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(mapping->GetMapping()) %
+                PackedAssetBundle::kAssetAlignment,
+            0u);
+}
+
+TEST_F(PackedAssetBundleTest, MappingsOutliveTheBundle) {
+  std::unique_ptr<AssetResolver> bundle = PackAndOpen();
+  std::unique_ptr<fml::Mapping> mapping = bundle->GetAsMapping("fonts/b.ttf");
+  ASSERT_TRUE(mapping);
+  bundle.reset();
+  EXPECT_EQ(ToString(mapping), "font b");
+}
+
+TEST_F(PackedAssetBundleTest, GetAsMappingsMatchesTheDirectoryBundle) {
+  std::unique_ptr<AssetResolver> bundle = PackAndOpen();
+  DirectoryAssetBundle directory_bundle(fml::Duplicate(assets_dir_.fd().get()),
+                                        false);
+  const AssetResolver& directory = directory_bundle;
+
+  EXPECT_EQ(bundle->GetAsMappings(".*\\.ttf", std::nullopt).size(), 3u);
+  EXPECT_EQ(directory.GetAsMappings(".*\\.ttf", std::nullopt).size(), 3u);
+  EXPECT_EQ(bundle->GetAsMappings(".*\\.ttf", "fonts").size(), 2u);
+  EXPECT_EQ(directory.GetAsMappings(".*\\.ttf", "fonts").size(), 2u);
+  EXPECT_EQ(bundle->GetAsMappings("c\\.ttf", "fonts/nested").size(), 1u);
+  EXPECT_EQ(bundle->GetAsMappings("a\\.ttf", "missing").size(), 0u);
+}
+
+TEST_F(PackedAssetBundleTest, RejectsCorruptArchives) {
+  ASSERT_TRUE(PackedAssetBundle::Pack(assets_dir_.fd(), pack_dir_.fd(),
+                                      PackedAssetBundle::kFileName));
+  std::unique_ptr<fml::FileMapping> mapping = fml::FileMapping::CreateReadOnly(
+      pack_dir_.fd(), PackedAssetBundle::kFileName);
+  ASSERT_TRUE(mapping);
+
+  // Truncate the archive in the middle of the contents of the assets.
+  fml::NonOwnedMapping truncated(mapping->GetMapping(),
+                                 mapping->GetSize() - 4096u);
+  ASSERT_TRUE(fml::WriteAtomically(pack_dir_.fd(), "truncated.pack",
+                                   truncated));
+  EXPECT_FALSE(IsValidArchive(pack_dir_.fd(), "truncated.pack"));
+
+  // Flip a byte of the first name so it no longer matches its hash.
+  std::vector<uint8_t> data(mapping->GetMapping(),
+                            mapping->GetMapping() + mapping->GetSize());
+  uint64_t names_offset = 0u;
+  std::memcpy(&names_offset, data.data() + 16u, sizeof(names_offset));
+  data[names_offset] ^= 0xff;
+  fml::NonOwnedMapping corrupt(data.data(), data.size());
+  ASSERT_TRUE(fml::WriteAtomically(pack_dir_.fd(), "corrupt.pack", corrupt));
+  EXPECT_FALSE(IsValidArchive(pack_dir_.fd(), "corrupt.pack"));
+
+  EXPECT_FALSE(IsValidArchive(pack_dir_.fd(), "missing.pack"));
+}
+
+}  // namespace testing
+}  // namespace flutter
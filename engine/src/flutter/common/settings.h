@@ -214,6 +214,11 @@ struct Settings {
   // manager before creating the engine.
   bool prefetched_default_font_manager = false;
 
+  // Record the order in which assets are first used during startup into a
+  // manifest in the caches directory, and prefetch the assets of the manifest
+  // recorded by a previous run on the IO thread before the first frame.
+  bool enable_asset_prefetch = false;
+
   // Enable the rendering of colors outside of the sRGB gamut.
   bool enable_wide_gamut = false;
 
@@ -244,6 +249,22 @@ struct Settings {
   // Whether to use SDFs for rendering in Impeller.
   bool impeller_use_sdfs = false;
 
+  // Whether Impeller tessellates the filled paths of a frame on worker
+  // threads before rendering it.
+  bool impeller_parallel_path_tessellation = false;
+
+  // Whether Impeller caches the tessellations of curved filled paths and
+  // persists them across launches.
+  bool impeller_tessellation_cache = false;
+
+  // Whether Impeller records the draws of large Vulkan render passes into
+  // secondary command buffers on worker threads.
+  bool impeller_parallel_render_pass_encoding = false;
+
+  // Whether Impeller records the pipeline variants it creates on demand and
+  // compiles them ahead of their first use on the next launch.
+  bool impeller_pipeline_variant_warm_up = false;
+
   // Log a warning during shell initialization if Impeller is not enabled.
   bool warn_on_impeller_opt_out = false;
 
@@ -357,6 +378,10 @@ struct Settings {
   // Max bytes threshold of resource cache, or 0 for unlimited.
   size_t resource_cache_max_bytes_threshold = 0;
 
+  // The number of isolates to create ahead of time at idle time for engines
+  // spawned from this one to take, or 0 to create them on spawn.
+  size_t spawn_isolate_pool_size = 0;
+
   /// Enable embedder api on the embedder.
   ///
   /// This is currently only used by iOS.
@@ -200,6 +200,34 @@ static void BM_DisplayListBuilderWithSaveLayerAndImageFilter(
   }
 }
 
+// Simulates a sequence of frames that each record a batch of pictures
+// which are released before the next frame is recorded, and reports how
+// many storage pages had to come from the system allocator versus the
+// recycled page pool.
+static void BM_DisplayListBuilderFrameAllocations(benchmark::State& state) {
+  constexpr int kPicturesPerFrame = 50;
+  DisplayListStorage::ResetPool();
+  size_t frames = 0u;
+  while (state.KeepRunning()) {
+    std::vector<sk_sp<DisplayList>> frame;
+    frame.reserve(kPicturesPerFrame);
+    for (int i = 0; i < kPicturesPerFrame; i++) {
+      DisplayListBuilder builder;
+      InvokeAllRenderingOps(builder);
+      frame.push_back(builder.Build());
+    }
+    frames++;
+  }
+  DisplayListStorage::PoolStats stats = DisplayListStorage::GetPoolStats();
+  double frame_count = static_cast<double>(std::max<size_t>(frames, 1u));
+  state.counters["PagesAllocatedPerFrame"] =
+      stats.pages_allocated / frame_count;
+  state.counters["PagesReusedPerFrame"] = stats.pages_reused / frame_count;
+  state.counters["LargeBlocksPerFrame"] =
+      stats.large_blocks_allocated / frame_count;
+  state.counters["PagesRetained"] = stats.pages_retained;
+}
+
 class DlOpReceiverIgnore : public IgnoreAttributeDispatchHelper,
                            public IgnoreTransformDispatchHelper,
                            public IgnoreClipDispatchHelper,
@@ -429,6 +457,9 @@ BENCHMARK_CAPTURE(BM_DisplayListBuilderWithSaveLayerAndImageFilter,
                   DisplayListBuilderBenchmarkType::kBoundsAndRtree)
     ->Unit(benchmark::kMicrosecond);
 
+BENCHMARK(BM_DisplayListBuilderFrameAllocations)
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK_CAPTURE(BM_DisplayListDispatchDefault,
                   kDefaultNoRtree,
                   DisplayListDispatchBenchmarkType::kDefaultNoRtree)
@@ -6,6 +6,7 @@
 
 #include "flutter/display_list/geometry/dl_geometry_conversions.h"
 #include "flutter/display_list/geometry/dl_region.h"
+#include "flutter/display_list/geometry/dl_rtree.h"
 #include "flutter/fml/logging.h"
 #include "third_party/skia/include/core/SkRegion.h"
 
@@ -261,6 +262,63 @@ void RunIntersectsSingleRectBenchmark(benchmark::State& state, int maxSize) {
   }
 }
 
+enum RTreeSearchMode { kLinearScan, kSingleQueries, kBatchedQueries };
+
+// Simulates culling a long scrolling list against a set of viewport
+// sized query rects, comparing a brute force scan of the rects, one
+// DlRTree::search per query, and a single batched DlRTree::search.
+void RunRTreeSearchBenchmark(benchmark::State& state,
+                             RTreeSearchMode mode,
+                             int numRects,
+                             int numQueries) {
+  std::seed_seq seed{2, 1, 3};
+  std::mt19937 rng(seed);
+
+  int list_height = 50 * numRects;
+  std::uniform_int_distribution size(10, 400);
+  std::vector<flutter::DlRect> rects;
+  rects.reserve(numRects);
+  for (int i = 0; i < numRects; ++i) {
+    rects.push_back(flutter::DlRect::MakeXYWH(size(rng), i * 50,  //
+                                              size(rng), size(rng)));
+  }
+  flutter::DlRTree tree(rects.data(), numRects);
+
+  std::uniform_int_distribution scroll(0, list_height - 2000);
+  std::vector<flutter::DlRect> queries;
+  queries.reserve(numQueries);
+  for (int i = 0; i < numQueries; ++i) {
+    queries.push_back(flutter::DlRect::MakeXYWH(0, scroll(rng), 1000, 2000));
+  }
+
+  std::vector<std::vector<int>> results(numQueries);
+  while (state.KeepRunning()) {
+    for (auto& result : results) {
+      result.clear();
+    }
+    switch (mode) {
+      case kLinearScan:
+        for (int q = 0; q < numQueries; ++q) {
+          for (int i = 0; i < numRects; ++i) {
+            if (rects[i].IntersectsWithRect(queries[q])) {
+              results[q].push_back(i);
+            }
+          }
+        }
+        break;
+      case kSingleQueries:
+        for (int q = 0; q < numQueries; ++q) {
+          tree.search(queries[q], &results[q]);
+        }
+        break;
+      case kBatchedQueries:
+        tree.search(queries.data(), numQueries, results.data());
+        break;
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+}
+
 }  // namespace
 
 namespace flutter {
@@ -321,6 +379,13 @@ static void BM_SkRegion_IntersectsSingleRect(benchmark::State& state,
   RunIntersectsSingleRectBenchmark<SkRegionAdapter>(state, maxSize);
 }
 
+static void BM_DlRTree_Search(benchmark::State& state,
+                              RTreeSearchMode mode,
+                              int numRects,
+                              int numQueries) {
+  RunRTreeSearchBenchmark(state, mode, numRects, numQueries);
+}
+
 const double kSizeFactorSmall = 0.3;
 
 BENCHMARK_CAPTURE(BM_DlRegion_IntersectsSingleRect, Tiny, 30)
@@ -717,4 +782,61 @@ BENCHMARK_CAPTURE(BM_DlRegion_GetRects, Large, 1500)
 BENCHMARK_CAPTURE(BM_SkRegion_GetRects, Large, 1500)
     ->Unit(benchmark::kMicrosecond);
 
+BENCHMARK_CAPTURE(BM_DlRTree_Search,
+                  LinearScan_Small,
+                  kLinearScan,
+                  1000,
+                  8)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRTree_Search,
+                  SingleQueries_Small,
+                  kSingleQueries,
+                  1000,
+                  8)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRTree_Search,
+                  BatchedQueries_Small,
+                  kBatchedQueries,
+                  1000,
+                  8)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_DlRTree_Search,
+                  LinearScan_Large,
+                  kLinearScan,
+                  10000,
+                  8)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRTree_Search,
+                  SingleQueries_Large,
+                  kSingleQueries,
+                  10000,
+                  8)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRTree_Search,
+                  BatchedQueries_Large,
+                  kBatchedQueries,
+                  10000,
+                  8)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_DlRTree_Search,
+                  LinearScan_Large_ManyQueries,
+                  kLinearScan,
+                  10000,
+                  32)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRTree_Search,
+                  SingleQueries_Large_ManyQueries,
+                  kSingleQueries,
+                  10000,
+                  32)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DlRTree_Search,
+                  BatchedQueries_Large_ManyQueries,
+                  kBatchedQueries,
+                  10000,
+                  32)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
\ No newline at end of file
@@ -59,9 +59,7 @@ DisplayList::DisplayList(DisplayListStorage&& storage,
       root_has_backdrop_filter_(root_has_backdrop_filter),
       root_is_unbounded_(root_is_unbounded),
       max_root_blend_mode_(max_root_blend_mode),
-      rtree_(std::move(rtree)) {
-  FML_DCHECK(storage_.capacity() == storage_.size());
-}
+      rtree_(std::move(rtree)) {}
 
 DisplayList::~DisplayList() {
   DisposeOps(storage_, offsets_);
@@ -119,7 +117,7 @@ void DisplayList::RTreeResultsToIndexVector(
         return;
       }
     }
-    const uint8_t* ptr = storage_.base() + offsets_[index];
+    const uint8_t* ptr = storage_.at(offsets_[index]);
     const DLOp* op = reinterpret_cast<const DLOp*>(ptr);
     switch (GetOpCategory(op->type)) {
       case DisplayListOpCategory::kAttribute:
@@ -180,9 +178,8 @@ void DisplayList::RTreeResultsToIndexVector(
 }
 
 void DisplayList::Dispatch(DlOpReceiver& receiver) const {
-  const uint8_t* base = storage_.base();
   for (size_t offset : offsets_) {
-    DispatchOneOp(receiver, base + offset);
+    DispatchOneOp(receiver, storage_.at(offset));
   }
 }
 
@@ -200,9 +197,8 @@ void DisplayList::Dispatch(DlOpReceiver& receiver,
     Dispatch(receiver);
   } else {
     auto op_indices = GetCulledIndices(cull_rect);
-    const uint8_t* base = storage_.base();
     for (DlIndex index : op_indices) {
-      DispatchOneOp(receiver, base + offsets_[index]);
+      DispatchOneOp(receiver, storage_.at(offsets_[index]));
     }
   }
 }
@@ -229,12 +225,11 @@ void DisplayList::DispatchOneOp(DlOpReceiver& receiver,
 
 void DisplayList::DisposeOps(const DisplayListStorage& storage,
                              const std::vector<size_t>& offsets) {
-  const uint8_t* base = storage.base();
-  if (!base) {
+  if (storage.size() == 0u) {
     return;
   }
   for (size_t offset : offsets) {
-    auto op = reinterpret_cast<const DLOp*>(base + offset);
+    auto op = reinterpret_cast<const DLOp*>(storage.at(offset));
     switch (op->type) {
 #define DL_OP_DISPOSE(name)                            \
   case DisplayListOpType::k##name:                     \
@@ -355,7 +350,7 @@ DisplayListOpType DisplayList::GetOpType(DlIndex index) const {
 
   size_t offset = offsets_[index];
   FML_DCHECK(offset < storage_.size());
-  auto ptr = storage_.base() + offset;
+  auto ptr = storage_.at(offset);
   auto op = reinterpret_cast<const DLOp*>(ptr);
   return op->type;
 }
@@ -391,7 +386,7 @@ bool DisplayList::Dispatch(DlOpReceiver& receiver, DlIndex index) const {
 
   size_t offset = offsets_[index];
   FML_DCHECK(offset < storage_.size());
-  auto ptr = storage_.base() + offset;
+  auto ptr = storage_.at(offset);
 
   DispatchOneOp(receiver, ptr);
 
@@ -402,17 +397,15 @@ static bool CompareOps(const DisplayListStorage& storageA,
                        const std::vector<size_t>& offsetsA,
                        const DisplayListStorage& storageB,
                        const std::vector<size_t>& offsetsB) {
-  const uint8_t* base_a = storageA.base();
-  const uint8_t* base_b = storageB.base();
   // These conditions are checked by the caller...
   FML_DCHECK(offsetsA.size() == offsetsB.size());
-  FML_DCHECK(base_a != base_b);
+  FML_DCHECK(storageA.base() != storageB.base());
   size_t bulk_start = 0u;
   for (size_t i = 0; i < offsetsA.size(); i++) {
     size_t offset = offsetsA[i];
     FML_DCHECK(offsetsB[i] == offset);
-    auto opA = reinterpret_cast<const DLOp*>(base_a + offset);
-    auto opB = reinterpret_cast<const DLOp*>(base_b + offset);
+    auto opA = reinterpret_cast<const DLOp*>(storageA.at(offset));
+    auto opB = reinterpret_cast<const DLOp*>(storageB.at(offset));
     if (opA->type != opB->type) {
       return false;
     }
@@ -440,12 +433,10 @@ static bool CompareOps(const DisplayListStorage& storageA,
       case DisplayListCompare::kEqual:
         // Check if we have a backlog of bytes to bulk compare and then
         // reset the bulk compare pointers to the address following this op
-        if (bulk_start < offset) {
-          const uint8_t* bulk_start_a = base_a + bulk_start;
-          const uint8_t* bulk_start_b = base_b + bulk_start;
-          if (memcmp(bulk_start_a, bulk_start_b, offset - bulk_start) != 0) {
-            return false;
-          }
+        if (bulk_start < offset &&
+            !DisplayListStorage::RangeEquals(storageA, storageB, bulk_start,
+                                             offset)) {
+          return false;
         }
         bulk_start =
             i + 1 < offsetsA.size() ? offsetsA[i + 1] : storageA.size();
@@ -454,9 +445,8 @@ static bool CompareOps(const DisplayListStorage& storageA,
   }
   if (bulk_start < storageA.size()) {
     // Perform a final bulk compare if we have remaining bytes waiting
-    const uint8_t* bulk_start_a = base_a + bulk_start;
-    const uint8_t* bulk_start_b = base_b + bulk_start;
-    if (memcmp(bulk_start_a, bulk_start_b, storageA.size() - bulk_start) != 0) {
+    if (!DisplayListStorage::RangeEquals(storageA, storageB, bulk_start,
+                                         storageA.size())) {
       return false;
     }
   }
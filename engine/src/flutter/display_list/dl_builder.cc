@@ -41,11 +41,12 @@ template <typename T, typename... Args>
 void* DisplayListBuilder::Push(size_t pod, Args&&... args) {
   // Plan out where and how large a space we need
   size_t size = SkAlignPtr(sizeof(T) + pod);
-  size_t offset = storage_.size();
 
-  // Allocate the space
+  // Allocate the space, the op may start on a fresh page so its offset
+  // is only known after the allocation
   auto ptr = storage_.allocate(size);
   FML_CHECK(ptr);
+  size_t offset = storage_.size() - size;
 
   // Initialize the space via the constructor
   auto op = reinterpret_cast<T*>(ptr);
@@ -395,9 +396,8 @@ void DisplayListBuilder::SetAttributesFromPaint(
 
 void DisplayListBuilder::checkForDeferredSave() {
   if (current_info().has_deferred_save_op) {
-    size_t save_offset = storage_.size();
     Push<SaveOp>(0);
-    current_info().save_offset = save_offset;
+    current_info().save_offset = offsets_.back();
     current_info().save_depth = depth_;
     current_info().has_deferred_save_op = false;
   }
@@ -440,7 +440,6 @@ void DisplayListBuilder::saveLayer(const DlRect& bounds,
   // Snapshot these values before we do any work as we need the values
   // from before the method was called, but some of the operations below
   // might update them.
-  size_t save_offset = storage_.size();
   uint32_t save_depth = depth_;
 
   // A backdrop will affect up to the entire surface, bounded by the clip
@@ -482,7 +481,6 @@ void DisplayListBuilder::saveLayer(const DlRect& bounds,
     FML_DCHECK(current_info().is_save_layer);
     FML_DCHECK(!current_info().is_nop);
     FML_DCHECK(!current_info().has_deferred_save_op);
-    current_info().save_offset = save_offset;
     current_info().save_depth = save_depth;
 
     // If we inherit some culling bounds and we have a filter then we need
@@ -532,6 +530,7 @@ void DisplayListBuilder::saveLayer(const DlRect& bounds,
     } else {
       Push<SaveLayerOp>(0, options, record_bounds);
     }
+    current_info().save_offset = offsets_.back();
   }
 
   if (options.renders_with_attributes()) {
@@ -570,8 +569,8 @@ void DisplayListBuilder::Restore() {
   }
 
   if (!current_info().has_deferred_save_op) {
-    SaveOpBase* op = reinterpret_cast<SaveOpBase*>(storage_.base() +
-                                                   current_info().save_offset);
+    SaveOpBase* op =
+        reinterpret_cast<SaveOpBase*>(storage_.at(current_info().save_offset));
     FML_CHECK(op->type == DisplayListOpType::kSave ||
               op->type == DisplayListOpType::kSaveLayer ||
               op->type == DisplayListOpType::kSaveLayerBackdrop);
@@ -607,7 +606,7 @@ void DisplayListBuilder::RestoreLayer() {
   DlRect content_bounds = current_layer().layer_local_accumulator.GetBounds();
 
   SaveLayerOpBase* layer_op = reinterpret_cast<SaveLayerOpBase*>(
-      storage_.base() + current_info().save_offset);
+      storage_.at(current_info().save_offset));
   FML_CHECK(layer_op->type == DisplayListOpType::kSaveLayer ||
             layer_op->type == DisplayListOpType::kSaveLayerBackdrop);
 
@@ -4,8 +4,105 @@
 
 #include "flutter/display_list/dl_storage.h"
 
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
 namespace flutter {
 
+namespace {
+
+// The number of free pages the pool keeps by default, 1MB worth of pages.
+static constexpr size_t kDefaultMaxPooledPages = 256u;
+
+// A process-wide free list of kDLPageSize pages.
+//
+// DisplayLists are typically recorded on the UI thread and released on the
+// raster thread, so a per-thread cache would drain on one side and overflow
+// on the other. A single locked free list keeps the pages flowing back to
+// the builders at the cost of one uncontended lock per page.
+class PagePool {
+ public:
+  static PagePool& Instance() {
+    static PagePool* instance = new PagePool();
+    return *instance;
+  }
+
+  uint8_t* Acquire() {
+    {
+      std::scoped_lock lock(mutex_);
+      if (!free_pages_.empty()) {
+        uint8_t* page = free_pages_.back();
+        free_pages_.pop_back();
+        stats_.pages_reused++;
+        return page;
+      }
+      stats_.pages_allocated++;
+    }
+    return static_cast<uint8_t*>(std::malloc(DisplayListStorage::kDLPageSize));
+  }
+
+  void Release(uint8_t* page) {
+    {
+      std::scoped_lock lock(mutex_);
+      if (free_pages_.size() < max_pages_) {
+        free_pages_.push_back(page);
+        return;
+      }
+    }
+    std::free(page);
+  }
+
+  void CountLargeBlock() {
+    std::scoped_lock lock(mutex_);
+    stats_.large_blocks_allocated++;
+  }
+
+  DisplayListStorage::PoolStats GetStats() {
+    std::scoped_lock lock(mutex_);
+    DisplayListStorage::PoolStats stats = stats_;
+    stats.pages_retained = free_pages_.size();
+    return stats;
+  }
+
+  void SetMaxPages(size_t max_pages) {
+    std::vector<uint8_t*> trimmed;
+    {
+      std::scoped_lock lock(mutex_);
+      max_pages_ = max_pages;
+      while (free_pages_.size() > max_pages_) {
+        trimmed.push_back(free_pages_.back());
+        free_pages_.pop_back();
+      }
+    }
+    for (uint8_t* page : trimmed) {
+      std::free(page);
+    }
+  }
+
+  void Reset() {
+    std::vector<uint8_t*> pages;
+    {
+      std::scoped_lock lock(mutex_);
+      std::swap(pages, free_pages_);
+      stats_ = {};
+    }
+    for (uint8_t* page : pages) {
+      std::free(page);
+    }
+  }
+
+ private:
+  PagePool() = default;
+
+  std::mutex mutex_;
+  std::vector<uint8_t*> free_pages_;
+  size_t max_pages_ = kDefaultMaxPooledPages;
+  DisplayListStorage::PoolStats stats_;
+};
+
+}  // namespace
+
 static constexpr inline bool is_power_of_two(int value) {
   return (value & (value - 1)) == 0;
 }
@@ -30,53 +127,139 @@ size_t DisplayListStorage::NextPowerOfTwoSize(size_t x) {
   return x + 1;
 }
 
-void DisplayListStorage::realloc(size_t count) {
-  ptr_.reset(static_cast<uint8_t*>(std::realloc(ptr_.release(), count)));
-  FML_CHECK(ptr_);
-  allocated_ = count;
+// static
+DisplayListStorage::PoolStats DisplayListStorage::GetPoolStats() {
+  return PagePool::Instance().GetStats();
+}
+
+// static
+void DisplayListStorage::SetMaxPooledPages(size_t max_pages) {
+  PagePool::Instance().SetMaxPages(max_pages);
+}
+
+// static
+void DisplayListStorage::ResetPool() {
+  PagePool::Instance().Reset();
 }
 
 uint8_t* DisplayListStorage::allocate(size_t needed) {
+  FML_DCHECK(!trimmed_);
   if (used_ + needed > allocated_) {
     static_assert(is_power_of_two(kDLPageSize),
                   "This math needs updating for non-pow2.");
 
-    // NPOT, with minimum size of kDLPageSize.
-    size_t new_size = std::max(NextPowerOfTwoSize(used_ + needed), kDLPageSize);
-    size_t old_size = allocated_;
-    realloc(new_size);
-    FML_CHECK(ptr_.get());
-    FML_CHECK(allocated_ == new_size);
-    FML_CHECK(allocated_ >= old_size);
+    // Skip the remainder of the current page, it was zeroed when the
+    // page was allocated.
+    used_ = allocated_;
+
+    size_t page_count = std::max<size_t>(
+        (needed + kDLPageSize - 1) / kDLPageSize, static_cast<size_t>(1u));
+    size_t block_size = page_count * kDLPageSize;
+    uint8_t* block;
+    bool pooled = page_count == 1u;
+    if (pooled) {
+      block = PagePool::Instance().Acquire();
+    } else {
+      block = static_cast<uint8_t*>(std::malloc(block_size));
+      PagePool::Instance().CountLargeBlock();
+    }
+    FML_CHECK(block);
+    memset(block, 0, block_size);
+    blocks_.push_back({block, pooled});
+    for (size_t i = 0; i < page_count; i++) {
+      pages_.push_back(block + i * kDLPageSize);
+    }
+    allocated_ += block_size;
+    FML_CHECK(allocated_ == pages_.size() * kDLPageSize);
     FML_CHECK(used_ + needed <= allocated_);
-    memset(ptr_.get() + used_, 0, allocated_ - old_size);
   }
-  uint8_t* ret = ptr_.get() + used_;
+  uint8_t* ret = pages_[used_ / kDLPageSize] + (used_ % kDLPageSize);
   used_ += needed;
   FML_CHECK(used_ <= allocated_);
   return ret;
 }
 
-DisplayListStorage::DisplayListStorage(DisplayListStorage&& source) {
-  ptr_ = std::move(source.ptr_);
-  used_ = source.used_;
-  allocated_ = source.allocated_;
+void DisplayListStorage::trim() {
+  if (trimmed_ || blocks_.size() != 1u || !blocks_.front().pooled ||
+      used_ > kDLPageSize / 2) {
+    return;
+  }
+  uint8_t* compact = static_cast<uint8_t*>(std::malloc(used_));
+  FML_CHECK(compact);
+  memcpy(compact, blocks_.front().ptr, used_);
+  ReleaseBlocks();
+  blocks_.push_back({compact, false});
+  pages_.push_back(compact);
+  allocated_ = used_;
+  trimmed_ = true;
+}
+
+// static
+bool DisplayListStorage::RangeEquals(const DisplayListStorage& a,
+                                     const DisplayListStorage& b,
+                                     size_t start,
+                                     size_t end) {
+  FML_DCHECK(end <= a.size() && end <= b.size());
+  while (start < end) {
+    size_t page_end = std::min((start / kDLPageSize + 1) * kDLPageSize, end);
+    if (memcmp(a.at(start), b.at(start), page_end - start) != 0) {
+      return false;
+    }
+    start = page_end;
+  }
+  return true;
+}
+
+void DisplayListStorage::ReleaseBlocks() {
+  for (const Block& block : blocks_) {
+    if (block.pooled) {
+      PagePool::Instance().Release(block.ptr);
+    } else {
+      std::free(block.ptr);
+    }
+  }
+  blocks_.clear();
+  pages_.clear();
+}
+
+DisplayListStorage::DisplayListStorage(DisplayListStorage&& source)
+    : pages_(std::move(source.pages_)),
+      blocks_(std::move(source.blocks_)),
+      used_(source.used_),
+      allocated_(source.allocated_),
+      trimmed_(source.trimmed_) {
+  source.pages_.clear();
+  source.blocks_.clear();
   source.used_ = 0u;
   source.allocated_ = 0u;
+  source.trimmed_ = false;
+}
+
+DisplayListStorage::~DisplayListStorage() {
+  ReleaseBlocks();
 }
 
 void DisplayListStorage::reset() {
-  ptr_.reset();
+  ReleaseBlocks();
   used_ = 0u;
   allocated_ = 0u;
+  trimmed_ = false;
 }
 
 DisplayListStorage& DisplayListStorage::operator=(DisplayListStorage&& source) {
-  ptr_ = std::move(source.ptr_);
-  used_ = source.used_;
-  allocated_ = source.allocated_;
-  source.used_ = 0u;
-  source.allocated_ = 0u;
+  if (this != &source) {
+    ReleaseBlocks();
+    pages_ = std::move(source.pages_);
+    blocks_ = std::move(source.blocks_);
+    used_ = source.used_;
+    allocated_ = source.allocated_;
+    trimmed_ = source.trimmed_;
+    source.pages_.clear();
+    source.blocks_.clear();
+    source.used_ = 0u;
+    source.allocated_ = 0u;
+    source.trimmed_ = false;
+  }
   return *this;
 }
 
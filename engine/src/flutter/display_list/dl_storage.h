@@ -7,56 +7,127 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "flutter/fml/logging.h"
 
 namespace flutter {
 
-// Manages a buffer allocated with malloc.
+// Manages the op records of a DisplayList in a sequence of fixed size
+// pages that are recycled through a process-wide pool.
+//
+// Offsets into the storage are linear, but the memory behind them is not
+// contiguous. Each page of the offset space maps to its own block of memory
+// so that growing the storage never moves or copies the records that were
+// already written. Allocations never straddle a page boundary; a request
+// that does not fit in the remainder of the current page starts a new one,
+// and a request larger than a page receives a dedicated block that covers
+// as many pages of the offset space as it needs.
 class DisplayListStorage {
  public:
   static const constexpr size_t kDLPageSize = 4096u;
 
   DisplayListStorage() = default;
   DisplayListStorage(DisplayListStorage&&);
-
-  /// Returns a pointer to the base of the storage.
-  uint8_t* base() { return ptr_.get(); }
-  const uint8_t* base() const { return ptr_.get(); }
-
-  /// Returns the currently allocated size
+  ~DisplayListStorage();
+
+  /// Returns a pointer to the base of the first page of the storage.
+  uint8_t* base() { return pages_.empty() ? nullptr : pages_.front(); }
+  const uint8_t* base() const {
+    return pages_.empty() ? nullptr : pages_.front();
+  }
+
+  /// Returns a pointer to the memory at the indicated offset, which must
+  /// lie within the allocated size of the storage.
+  uint8_t* at(size_t offset) {
+    FML_DCHECK(offset < used_);
+    return pages_[offset / kDLPageSize] + (offset % kDLPageSize);
+  }
+  const uint8_t* at(size_t offset) const {
+    FML_DCHECK(offset < used_);
+    return pages_[offset / kDLPageSize] + (offset % kDLPageSize);
+  }
+
+  /// Returns the currently allocated size, including any padding that
+  /// was skipped at the end of a page.
   size_t size() const { return used_; }
 
   /// Returns the maximum currently allocated space
   size_t capacity() const { return allocated_; }
 
   /// Ensures the indicated number of bytes are available and returns
-  /// a pointer to that memory within the storage while also invalidating
-  /// any other outstanding pointers into the storage.
+  /// a pointer to that memory within the storage. The returned memory
+  /// is zero-initialized and, unlike the pointers returned by a growing
+  /// malloc buffer, pointers to earlier allocations remain valid.
   uint8_t* allocate(size_t needed);
 
-  /// Trims the storage to the currently allocated size and invalidates
-  /// any outstanding pointers into the storage.
-  void trim() { realloc(used_); }
+  /// Compacts a storage that fits in a fraction of a single page into an
+  /// exactly sized block so that the page can be returned to the pool for
+  /// the next builder. No further allocations may be made after a trim.
+  void trim();
 
-  /// Resets the storage and allocation of the object to an empty state
+  /// Resets the storage and allocation of the object to an empty state,
+  /// returning any pooled pages to the pool.
   void reset();
 
   DisplayListStorage& operator=(DisplayListStorage&& other);
 
+  /// @brief Compares the bytes in the range [start, end) of two storage
+  ///        objects that were filled with an identical sequence of
+  ///        allocations.
+  static bool RangeEquals(const DisplayListStorage& a,
+                          const DisplayListStorage& b,
+                          size_t start,
+                          size_t end);
+
   /// @brief Compute the next power of two from [x].
   static size_t NextPowerOfTwoSize(size_t x);
 
- private:
-  void realloc(size_t count);
+  struct PoolStats {
+    /// The number of page allocations that went to the system allocator.
+    size_t pages_allocated = 0u;
+
+    /// The number of page allocations satisfied from the pool.
+    size_t pages_reused = 0u;
+
+    /// The number of blocks larger than a page that went to the system
+    /// allocator. These are never pooled.
+    size_t large_blocks_allocated = 0u;
+
+    /// The number of free pages currently held by the pool.
+    size_t pages_retained = 0u;
+  };
+
+  /// @brief Returns a snapshot of the counters of the page pool that is
+  ///        shared by all storage objects in the process.
+  static PoolStats GetPoolStats();
+
+  /// @brief Sets the maximum number of free pages the pool keeps around
+  ///        for reuse. Pages released past that limit are freed. A value
+  ///        of 0 disables pooling.
+  static void SetMaxPooledPages(size_t max_pages);
+
+  /// @brief Frees all pages currently retained by the pool and resets the
+  ///        allocation counters. Primarily intended for tests and
+  ///        benchmarks.
+  static void ResetPool();
 
-  struct FreeDeleter {
-    void operator()(uint8_t* p) { std::free(p); }
+ private:
+  struct Block {
+    uint8_t* ptr;
+    bool pooled;
   };
-  std::unique_ptr<uint8_t, FreeDeleter> ptr_;
+
+  void ReleaseBlocks();
+
+  // The memory behind each kDLPageSize slice of the offset space.
+  std::vector<uint8_t*> pages_;
+  // The allocations that own the memory referenced by |pages_|.
+  std::vector<Block> blocks_;
 
   size_t used_ = 0u;
   size_t allocated_ = 0u;
+  bool trimmed_ = false;
 };
 
 }  // namespace flutter
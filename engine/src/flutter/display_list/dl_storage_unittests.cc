@@ -43,6 +43,122 @@ TEST(DisplayListStorage, PostMove) {
   EXPECT_EQ(moved.capacity(), DisplayListStorage::kDLPageSize);
 }
 
+TEST(DisplayListStorage, GrowthDoesNotMoveEarlierAllocations) {
+  DisplayListStorage storage;
+  uint8_t* first = storage.allocate(16u);
+  memset(first, 0xA5, 16u);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_NE(storage.allocate(200u), nullptr);
+  }
+  EXPECT_EQ(storage.at(0u), first);
+  for (int i = 0; i < 16; i++) {
+    EXPECT_EQ(first[i], 0xA5);
+  }
+}
+
+TEST(DisplayListStorage, AllocationsDoNotStraddlePages) {
+  DisplayListStorage storage;
+  storage.allocate(DisplayListStorage::kDLPageSize - 8u);
+  uint8_t* ptr = storage.allocate(16u);
+
+  // The new allocation skips the remainder of the first page.
+  EXPECT_EQ(storage.size(), DisplayListStorage::kDLPageSize + 16u);
+  EXPECT_EQ(storage.capacity(), DisplayListStorage::kDLPageSize * 2u);
+  EXPECT_EQ(storage.at(DisplayListStorage::kDLPageSize), ptr);
+  EXPECT_EQ(*storage.at(DisplayListStorage::kDLPageSize - 4u), 0u);
+}
+
+TEST(DisplayListStorage, LargeAllocationsAreContiguous) {
+  DisplayListStorage storage;
+  storage.allocate(10u);
+  size_t large = DisplayListStorage::kDLPageSize * 3u + 100u;
+  uint8_t* ptr = storage.allocate(large);
+  memset(ptr, 0x5A, large);
+
+  size_t offset = DisplayListStorage::kDLPageSize;
+  EXPECT_EQ(storage.at(offset), ptr);
+  EXPECT_EQ(storage.at(offset + large - 1u), ptr + large - 1u);
+  EXPECT_EQ(storage.capacity(), DisplayListStorage::kDLPageSize * 5u);
+}
+
+TEST(DisplayListStorage, TrimCompactsSmallStorage) {
+  DisplayListStorage storage;
+  uint8_t* ptr = storage.allocate(24u);
+  memset(ptr, 0x3C, 24u);
+  storage.trim();
+
+  EXPECT_EQ(storage.size(), 24u);
+  EXPECT_EQ(storage.capacity(), 24u);
+  for (size_t i = 0; i < 24u; i++) {
+    EXPECT_EQ(*storage.at(i), 0x3C);
+  }
+}
+
+TEST(DisplayListStorage, TrimKeepsLargeStorage) {
+  DisplayListStorage storage;
+  storage.allocate(DisplayListStorage::kDLPageSize - 8u);
+  storage.trim();
+
+  EXPECT_EQ(storage.capacity(), DisplayListStorage::kDLPageSize);
+}
+
+TEST(DisplayListStorage, PagesAreRecycled) {
+  DisplayListStorage::ResetPool();
+  {
+    DisplayListStorage storage;
+    storage.allocate(DisplayListStorage::kDLPageSize);
+    storage.allocate(DisplayListStorage::kDLPageSize);
+  }
+  DisplayListStorage::PoolStats stats = DisplayListStorage::GetPoolStats();
+  EXPECT_EQ(stats.pages_allocated, 2u);
+  EXPECT_EQ(stats.pages_reused, 0u);
+  EXPECT_EQ(stats.pages_retained, 2u);
+
+  {
+    DisplayListStorage storage;
+    storage.allocate(10u);
+    // Recycled pages are handed out zeroed.
+    EXPECT_EQ(*storage.at(9u), 0u);
+  }
+  stats = DisplayListStorage::GetPoolStats();
+  EXPECT_EQ(stats.pages_allocated, 2u);
+  EXPECT_EQ(stats.pages_reused, 1u);
+  EXPECT_EQ(stats.pages_retained, 2u);
+  DisplayListStorage::ResetPool();
+}
+
+TEST(DisplayListStorage, PoolRespectsMaxPages) {
+  DisplayListStorage::ResetPool();
+  DisplayListStorage::SetMaxPooledPages(1u);
+  {
+    DisplayListStorage storage;
+    storage.allocate(DisplayListStorage::kDLPageSize);
+    storage.allocate(DisplayListStorage::kDLPageSize);
+  }
+  EXPECT_EQ(DisplayListStorage::GetPoolStats().pages_retained, 1u);
+
+  DisplayListStorage::SetMaxPooledPages(0u);
+  EXPECT_EQ(DisplayListStorage::GetPoolStats().pages_retained, 0u);
+
+  DisplayListStorage::SetMaxPooledPages(256u);
+  DisplayListStorage::ResetPool();
+}
+
+TEST(DisplayListStorage, RangeEqualsSpansPages) {
+  DisplayListStorage a;
+  DisplayListStorage b;
+  for (int i = 0; i < 3; i++) {
+    memset(a.allocate(3000u), i, 3000u);
+    memset(b.allocate(3000u), i, 3000u);
+  }
+  EXPECT_TRUE(DisplayListStorage::RangeEquals(a, b, 0u, a.size()));
+
+  *b.at(DisplayListStorage::kDLPageSize + 5u) = 0xFF;
+  EXPECT_FALSE(DisplayListStorage::RangeEquals(a, b, 0u, a.size()));
+  EXPECT_TRUE(DisplayListStorage::RangeEquals(
+      a, b, 0u, DisplayListStorage::kDLPageSize));
+}
+
 TEST(DisplayListStorage, NextPowerOfTwoSize) {
   EXPECT_EQ(DisplayListStorage::NextPowerOfTwoSize(0), 1u);
   EXPECT_EQ(DisplayListStorage::NextPowerOfTwoSize(1), 1u);
@@ -5,10 +5,84 @@
 #include "flutter/display_list/geometry/dl_rtree.h"
 #include "flutter/display_list/geometry/dl_region.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "flutter/fml/logging.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DL_RTREE_USE_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define DL_RTREE_USE_NEON 1
+#endif
+
 namespace flutter {
 
+namespace {
+
+// The number of nodes tested against a query at a time.
+constexpr uint32_t kLanes = 4u;
+
+// Padding bounds fail every "min < query.max" and "max > query.min" test,
+// including against infinite queries.
+constexpr float kPadMin = std::numeric_limits<float>::infinity();
+constexpr float kPadMax = -std::numeric_limits<float>::infinity();
+
+inline uint32_t CountTrailingZeros(uint32_t bits) {
+  FML_DCHECK(bits != 0u);
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;
+  _BitScanForward(&index, bits);
+  return index;
+#else
+  return __builtin_ctz(bits);
+#endif
+}
+
+// Returns a 4 bit mask of which of the 4 nodes starting at the given
+// coordinate pointers intersect the (non-empty) query, using the same
+// strict comparisons as |DlRect::IntersectsWithRect|. Stored nodes are
+// never empty so only the overlap needs to be tested.
+inline uint32_t IntersectLanes(const float* lefts,
+                               const float* tops,
+                               const float* rights,
+                               const float* bottoms,
+                               const DlRect& query) {
+#if DL_RTREE_USE_SSE2
+  __m128 hits = _mm_and_ps(
+      _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(lefts),
+                              _mm_set1_ps(query.GetRight())),
+                 _mm_cmplt_ps(_mm_loadu_ps(tops),
+                              _mm_set1_ps(query.GetBottom()))),
+      _mm_and_ps(_mm_cmpgt_ps(_mm_loadu_ps(rights),
+                              _mm_set1_ps(query.GetLeft())),
+                 _mm_cmpgt_ps(_mm_loadu_ps(bottoms),
+                              _mm_set1_ps(query.GetTop()))));
+  return static_cast<uint32_t>(_mm_movemask_ps(hits));
+#elif DL_RTREE_USE_NEON
+  uint32x4_t hits = vandq_u32(
+      vandq_u32(vcltq_f32(vld1q_f32(lefts), vdupq_n_f32(query.GetRight())),
+                vcltq_f32(vld1q_f32(tops), vdupq_n_f32(query.GetBottom()))),
+      vandq_u32(vcgtq_f32(vld1q_f32(rights), vdupq_n_f32(query.GetLeft())),
+                vcgtq_f32(vld1q_f32(bottoms), vdupq_n_f32(query.GetTop()))));
+  static const uint32_t kLaneBits[4] = {1u, 2u, 4u, 8u};
+  return vaddvq_u32(vandq_u32(hits, vld1q_u32(kLaneBits)));
+#else
+  uint32_t mask = 0u;
+  for (uint32_t i = 0; i < kLanes; i++) {
+    if (lefts[i] < query.GetRight() && tops[i] < query.GetBottom() &&
+        rights[i] > query.GetLeft() && bottoms[i] > query.GetTop()) {
+      mask |= 1u << i;
+    }
+  }
+  return mask;
+#endif
+}
+
+}  // namespace
+
 DlRTree::DlRTree(const DlRect rects[],
                  int N,
                  const int ids[],
@@ -44,7 +118,22 @@ DlRTree::DlRTree(const DlRect rects[],
     gen_count = family_count;
   }
 
-  nodes_.resize(total_node_count);
+  node_count_ = total_node_count;
+
+  // Pad the coordinate arrays so that the last children can always be
+  // loaded as a full group of kLanes values.
+  stride_ = (total_node_count + kLanes - 1u) / kLanes * kLanes + kLanes;
+  coords_.resize(stride_ * 4u);
+  float* lefts = coords_.data();
+  float* tops = lefts + stride_;
+  float* rights = tops + stride_;
+  float* bottoms = rights + stride_;
+  std::fill(lefts, lefts + stride_, kPadMin);
+  std::fill(tops, tops + stride_, kPadMin);
+  std::fill(rights, rights + stride_, kPadMax);
+  std::fill(bottoms, bottoms + stride_, kPadMax);
+  ids_.resize(leaf_count);
+  families_.resize(total_node_count - leaf_count);
 
   // Now place only the tracked rectangles into the nodes array
   // in the first leaf_count_ entries.
@@ -53,9 +142,12 @@ DlRTree::DlRTree(const DlRect rects[],
   for (int i = 0; i < N; i++) {
     if (!rects[i].IsEmpty()) {
       if (ids == nullptr || p(id = ids[i])) {
-        Node& node = nodes_[leaf_index++];
-        node.bounds = rects[i];
-        node.id = id;
+        lefts[leaf_index] = rects[i].GetLeft();
+        tops[leaf_index] = rects[i].GetTop();
+        rights[leaf_index] = rects[i].GetRight();
+        bottoms[leaf_index] = rects[i].GetBottom();
+        ids_[leaf_index] = id;
+        leaf_index++;
       }
     }
   }
@@ -116,19 +208,28 @@ DlRTree::DlRTree(const DlRect rects[],
 
     uint32_t sibling_index = gen_start;
     uint32_t parent_index = gen_end;
-    Node* parent = nullptr;
+    Family* parent = nullptr;
     while (sibling_index < gen_end) {
       if ((D += family_count) > 0) {
         D -= gen_count;
         FML_DCHECK(parent_index < gen_end + family_count);
-        parent = &nodes_[parent_index++];
-        parent->bounds = kEmpty;
-        parent->child.index = sibling_index;
-        parent->child.count = 0;
+        parent = &families_[parent_index - leaf_count];
+        lefts[parent_index] = std::numeric_limits<float>::infinity();
+        tops[parent_index] = std::numeric_limits<float>::infinity();
+        rights[parent_index] = -std::numeric_limits<float>::infinity();
+        bottoms[parent_index] = -std::numeric_limits<float>::infinity();
+        parent->index = sibling_index;
+        parent->count = 0;
+        parent_index++;
       }
       FML_DCHECK(parent != nullptr);
-      parent->bounds = parent->bounds.Union(nodes_[sibling_index++].bounds);
-      parent->child.count++;
+      uint32_t p_index = parent_index - 1;
+      lefts[p_index] = std::min(lefts[p_index], lefts[sibling_index]);
+      tops[p_index] = std::min(tops[p_index], tops[sibling_index]);
+      rights[p_index] = std::max(rights[p_index], rights[sibling_index]);
+      bottoms[p_index] = std::max(bottoms[p_index], bottoms[sibling_index]);
+      sibling_index++;
+      parent->count++;
     }
     FML_DCHECK(D == 0);
     FML_DCHECK(sibling_index == gen_end);
@@ -137,6 +238,9 @@ DlRTree::DlRTree(const DlRect rects[],
     gen_count = family_count;
   }
   FML_DCHECK(gen_start + gen_count == total_node_count);
+  if (total_node_count > 0u) {
+    bounds_ = node_bounds(total_node_count - 1u);
+  }
 }
 
 void DlRTree::search(const DlRect& query, std::vector<int>* results) const {
@@ -144,18 +248,143 @@ void DlRTree::search(const DlRect& query, std::vector<int>* results) const {
   if (query.IsEmpty()) {
     return;
   }
-  if (nodes_.size() <= 0) {
+  if (node_count_ <= 0) {
     FML_DCHECK(leaf_count_ == 0);
     return;
   }
-  const Node& root = nodes_.back();
-  if (root.bounds.IntersectsWithRect(query)) {
-    if (nodes_.size() == 1) {
-      FML_DCHECK(leaf_count_ == 1);
-      // The root node is the only node and it is a leaf node
-      results->push_back(0);
+  uint32_t root_index = node_count_ - 1;
+  if (!bounds_.IntersectsWithRect(query)) {
+    return;
+  }
+  if (node_count_ == 1) {
+    FML_DCHECK(leaf_count_ == 1);
+    // The root node is the only node and it is a leaf node
+    results->push_back(0);
+    return;
+  }
+
+  // Each stack entry records the first child of a node along with the
+  // mask of the children that intersect the query and remain to be
+  // visited. Visiting the children in order produces the leaves in
+  // increasing index order.
+  struct Frame {
+    uint32_t first_child;
+    uint32_t pending;
+  };
+  Frame stack[kMaxDepth];
+  int depth = 0;
+
+  const Family& root = family(root_index);
+  stack[0] = {root.index, IntersectMask(root.index, root.count, query)};
+  while (depth >= 0) {
+    Frame& frame = stack[depth];
+    if (frame.pending == 0u) {
+      depth--;
+      continue;
+    }
+    if (frame.first_child < static_cast<uint32_t>(leaf_count_)) {
+      // All siblings in a generation are of the same kind, leaves here.
+      uint32_t pending = frame.pending;
+      while (pending != 0u) {
+        results->push_back(frame.first_child + CountTrailingZeros(pending));
+        pending &= pending - 1u;
+      }
+      frame.pending = 0u;
+      continue;
+    }
+    uint32_t child = frame.first_child + CountTrailingZeros(frame.pending);
+    frame.pending &= frame.pending - 1u;
+    const Family& node = family(child);
+    FML_DCHECK(depth + 1 < kMaxDepth);
+    stack[++depth] = {node.index, IntersectMask(node.index, node.count, query)};
+  }
+}
+
+void DlRTree::search(const DlRect queries[],
+                     int count,
+                     std::vector<int> results[]) const {
+  FML_DCHECK(count == 0 || queries != nullptr);
+  FML_DCHECK(count == 0 || results != nullptr);
+  for (int start = 0; start < count; start += kMaxBatchSize) {
+    SearchBatch(queries + start, std::min(count - start, kMaxBatchSize),
+                results + start);
+  }
+}
+
+void DlRTree::SearchBatch(const DlRect queries[],
+                          int count,
+                          std::vector<int> results[]) const {
+  FML_DCHECK(count <= kMaxBatchSize);
+  if (node_count_ <= 0) {
+    FML_DCHECK(leaf_count_ == 0);
+    return;
+  }
+
+  // Bit q of |active| is set if queries[q] intersects the current node.
+  uint32_t active = 0u;
+  for (int q = 0; q < count; q++) {
+    if (!queries[q].IsEmpty() && bounds_.IntersectsWithRect(queries[q])) {
+      active |= 1u << q;
+    }
+  }
+  if (active == 0u) {
+    return;
+  }
+  if (node_count_ == 1) {
+    FML_DCHECK(leaf_count_ == 1);
+    for (; active != 0u; active &= active - 1u) {
+      results[CountTrailingZeros(active)].push_back(0);
+    }
+    return;
+  }
+
+  // As with the single query search, but each stack entry tracks which
+  // of the active queries hit each of the children of the node.
+  struct Frame {
+    uint32_t first_child;
+    uint32_t child_count;
+    uint32_t next_child;
+    uint32_t queries[kMaxChildren];
+  };
+  Frame stack[kMaxDepth];
+  int depth = -1;
+
+  auto push = [this, &stack, &depth, queries](uint32_t node_index,
+                                              uint32_t active) {
+    const Family& node = family(node_index);
+    Frame& frame = stack[++depth];
+    FML_DCHECK(depth < kMaxDepth);
+    frame.first_child = node.index;
+    frame.child_count = node.count;
+    frame.next_child = 0u;
+    std::fill(frame.queries, frame.queries + node.count, 0u);
+    for (; active != 0u; active &= active - 1u) {
+      uint32_t q = CountTrailingZeros(active);
+      uint32_t hits = IntersectMask(node.index, node.count, queries[q]);
+      for (; hits != 0u; hits &= hits - 1u) {
+        frame.queries[CountTrailingZeros(hits)] |= 1u << q;
+      }
+    }
+  };
+
+  push(node_count_ - 1, active);
+  while (depth >= 0) {
+    Frame& frame = stack[depth];
+    if (frame.next_child >= frame.child_count) {
+      depth--;
+      continue;
+    }
+    uint32_t child = frame.first_child + frame.next_child;
+    uint32_t child_queries = frame.queries[frame.next_child++];
+    if (child_queries == 0u) {
+      continue;
+    }
+    if (child < static_cast<uint32_t>(leaf_count_)) {
+      for (; child_queries != 0u; child_queries &= child_queries - 1u) {
+        results[CountTrailingZeros(child_queries)].push_back(child);
+      }
     } else {
-      search(root, query, results);
+      push(child, child_queries);
     }
   }
 }
@@ -182,22 +411,25 @@ std::list<DlRect> DlRTree::searchAndConsolidateRects(const DlRect& query,
   return final_results;
 }
 
-void DlRTree::search(const Node& parent,
-                     const DlRect& query,
-                     std::vector<int>* results) const {
+uint32_t DlRTree::IntersectMask(uint32_t start,
+                                uint32_t count,
+                                const DlRect& query) const {
   // Caller protects against empty query
-  int start = parent.child.index;
-  int end = start + parent.child.count;
-  for (int i = start; i < end; i++) {
-    const Node& node = nodes_[i];
-    if (node.bounds.IntersectsWithRect(query)) {
-      if (i < leaf_count_) {
-        results->push_back(i);
-      } else {
-        search(node, query, results);
-      }
-    }
+  FML_DCHECK(count <= static_cast<uint32_t>(kMaxChildren));
+  FML_DCHECK(start + count <= stride_ - kLanes);
+  const float* lefts = this->lefts() + start;
+  const float* tops = this->tops() + start;
+  const float* rights = this->rights() + start;
+  const float* bottoms = this->bottoms() + start;
+  uint32_t mask = 0u;
+  // The arrays are padded so that reading a whole group past |count|
+  // stays in bounds; the extra bits are trimmed below.
+  for (uint32_t i = 0; i < count; i += kLanes) {
+    mask |= IntersectLanes(lefts + i, tops + i, rights + i, bottoms + i,
+                           query)
+            << i;
   }
+  return mask & ((1u << count) - 1u);
 }
 
 const DlRegion& DlRTree::region() const {
@@ -205,7 +437,7 @@ const DlRegion& DlRTree::region() const {
     std::vector<DlIRect> rects;
     rects.resize(leaf_count_);
     for (int i = 0; i < leaf_count_; i++) {
-      rects[i] = DlIRect::RoundOut(nodes_[i].bounds);
+      rects[i] = DlIRect::RoundOut(node_bounds(i));
     }
     region_.emplace(rects);
   }
@@ -213,11 +445,7 @@ const DlRegion& DlRTree::region() const {
 }
 
 const DlRect& DlRTree::bounds() const {
-  if (!nodes_.empty()) {
-    return nodes_.back().bounds;
-  } else {
-    return kEmpty;
-  }
+  return bounds_;
 }
 
 }  // namespace flutter
@@ -28,17 +28,19 @@ class DlRTree : public SkRefCnt {
  private:
   static constexpr int kMaxChildren = 11;
 
-  // Leaf nodes at start of vector have an ID,
-  // Internal nodes after that have child index and count.
-  struct Node {
-    DlRect bounds;
-    union {
-      struct {
-        uint32_t index;
-        uint32_t count;
-      } child;
-      int id;
-    };
+  // The maximum depth of the tree. With kMaxChildren children per node
+  // this covers far more leaves than an int can index.
+  static constexpr int kMaxDepth = 10;
+
+  // The maximum number of queries processed together in a single walk
+  // of the tree by the batched |search|.
+  static constexpr int kMaxBatchSize = 32;
+
+  // Internal nodes hold the index and count of their children, which
+  // are always stored contiguously.
+  struct Family {
+    uint32_t index;
+    uint32_t count;
   };
 
  public:
@@ -76,13 +78,31 @@ class DlRTree : public SkRefCnt {
   /// which they were passed into the constructor. The actual rectangle
   /// and ID associated with each index can be retrieved using the
   /// |DlRTree::id| and |DlRTree::bounds| methods.
+  ///
+  /// The tree is walked iteratively and the only allocations performed
+  /// are those needed to grow the results vector.
   void search(const DlRect& query, std::vector<int>* results) const;
 
+  /// Search the rectangles for each of the |count| queries in a single
+  /// walk of the tree and store the leaf node indices that intersect
+  /// |queries[i]| into |results[i]|, in the same order that the single
+  /// query |search| would produce them.
+  ///
+  /// This is cheaper than searching for each query separately when the
+  /// queries share large parts of the tree, as happens when a list of
+  /// items is culled against the tiles of a scrolling viewport.
+  ///
+  /// The |results| array must have room for |count| vectors. Results
+  /// are appended to any data already in those vectors.
+  void search(const DlRect queries[],
+              int count,
+              std::vector<int> results[]) const;
+
   /// Return the ID for the indicated result of a query or
   /// invalid_id if the index is not a valid leaf node index.
   int id(int result_index) const {
     return (result_index >= 0 && result_index < leaf_count_)
-               ? nodes_[result_index].id
+               ? ids_[result_index]
                : invalid_id_;
   }
 
@@ -92,15 +112,16 @@ class DlRTree : public SkRefCnt {
 
   /// Return the rectangle bounds for the indicated result of a query
   /// or an empty rect if the index is not a valid leaf node index.
-  const DlRect& bounds(int result_index) const {
+  DlRect bounds(int result_index) const {
     return (result_index >= 0 && result_index < leaf_count_)
-               ? nodes_[result_index].bounds
+               ? node_bounds(result_index)
                : kEmpty;
   }
 
   /// Returns the bytes used by the object and all of its node data.
   size_t bytes_used() const {
-    return sizeof(DlRTree) + sizeof(Node) * nodes_.size();
+    return sizeof(DlRTree) + sizeof(float) * coords_.size() +
+           sizeof(int) * ids_.size() + sizeof(Family) * families_.size();
   }
 
   /// Returns the number of leaf nodes corresponding to non-empty
@@ -110,7 +131,7 @@ class DlRTree : public SkRefCnt {
 
   /// Return the total number of nodes used in the R-Tree, both leaf
   /// and internal consolidation nodes.
-  int node_count() const { return nodes_.size(); }
+  int node_count() const { return node_count_; }
 
   /// Finds the rects in the tree that intersect with the query rect.
   ///
@@ -138,11 +159,46 @@ class DlRTree : public SkRefCnt {
  private:
   static constexpr DlRect kEmpty = DlRect();
 
-  void search(const Node& parent,
-              const DlRect& query,
-              std::vector<int>* results) const;
+  DlRect node_bounds(uint32_t index) const {
+    return DlRect::MakeLTRB(lefts()[index], tops()[index],  //
+                            rights()[index], bottoms()[index]);
+  }
+
+  const Family& family(uint32_t index) const {
+    FML_DCHECK(index >= static_cast<uint32_t>(leaf_count_));
+    return families_[index - leaf_count_];
+  }
 
-  std::vector<Node> nodes_;
+  // Returns a bit mask of the nodes in [start, start + count) that
+  // intersect the non-empty query, with bit i representing node start + i.
+  uint32_t IntersectMask(uint32_t start,
+                         uint32_t count,
+                         const DlRect& query) const;
+
+  void SearchBatch(const DlRect queries[],
+                   int count,
+                   std::vector<int> results[]) const;
+
+  const float* lefts() const { return coords_.data(); }
+  const float* tops() const { return coords_.data() + stride_; }
+  const float* rights() const { return coords_.data() + 2 * stride_; }
+  const float* bottoms() const { return coords_.data() + 3 * stride_; }
+
+  // The node bounds stored as 4 consecutive arrays of |stride_| floats
+  // holding the left, top, right and bottom coordinates of each node so
+  // that the children of a node can be tested against a query several at
+  // a time. Leaf nodes are stored first, followed by each generation of
+  // internal nodes with the root node last. The arrays are padded with
+  // bounds that never intersect anything so that the children of a node
+  // can always be loaded in whole vector-width groups.
+  std::vector<float> coords_;
+  size_t stride_ = 0u;
+  // The IDs of the leaf nodes.
+  std::vector<int> ids_;
+  // The children of the internal nodes, indexed from |leaf_count_|.
+  std::vector<Family> families_;
+  DlRect bounds_;
+  int node_count_ = 0;
   int leaf_count_ = 0;
   int invalid_id_;
   mutable std::optional<DlRegion> region_;
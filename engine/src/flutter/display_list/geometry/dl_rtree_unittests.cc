@@ -317,5 +317,66 @@ TEST(DisplayListRTree, Region) {
   EXPECT_EQ(rects.size(), expected_rects.size());
 }
 
+TEST(DisplayListRTree, BatchedSearchMatchesSingleSearch) {
+  // A grid of overlapping 30 x 30 rectangles spaced 20 pixels apart
+  // with some empty rects mixed in that are not stored in the tree.
+  const int ROWS = 40;
+  const int COLS = 40;
+  const int N = ROWS * COLS;
+  std::vector<DlRect> rects(N);
+  for (int r = 0; r < ROWS; r++) {
+    for (int c = 0; c < COLS; c++) {
+      int i = r * COLS + c;
+      rects[i] = (i % 13 == 0) ? DlRect()
+                               : DlRect::MakeXYWH(c * 20, r * 20, 30, 30);
+    }
+  }
+  DlRTree tree(rects.data(), N);
+
+  // More queries than fit in a single batch, including empty and
+  // non-intersecting queries.
+  std::vector<DlRect> queries;
+  for (int i = 0; i < 70; i++) {
+    queries.push_back(DlRect::MakeXYWH(i * 11, i * 7, 45 + i, 60));
+  }
+  queries.push_back(DlRect());
+  queries.push_back(DlRect::MakeXYWH(-100, -100, 50, 50));
+  queries.push_back(DlRect::MakeLTRB(-1e6, -1e6, 1e6, 1e6));
+
+  int count = queries.size();
+  std::vector<std::vector<int>> batched(count);
+  tree.search(queries.data(), count, batched.data());
+  for (int q = 0; q < count; q++) {
+    std::vector<int> single;
+    tree.search(queries[q], &single);
+    EXPECT_EQ(batched[q], single) << "query " << q;
+  }
+  EXPECT_TRUE(batched[count - 3].empty());
+  EXPECT_TRUE(batched[count - 2].empty());
+  EXPECT_EQ(static_cast<int>(batched[count - 1].size()), tree.leaf_count());
+}
+
+TEST(DisplayListRTree, BatchedSearchOnEmptyTree) {
+  DlRTree tree(nullptr, 0);
+  DlRect queries[2] = {DlRect::MakeLTRB(0, 0, 10, 10), DlRect()};
+  std::vector<int> results[2];
+  tree.search(queries, 2, results);
+  EXPECT_TRUE(results[0].empty());
+  EXPECT_TRUE(results[1].empty());
+}
+
+TEST(DisplayListRTree, BatchedSearchOnSingleLeafTree) {
+  DlRect rect = DlRect::MakeLTRB(10, 10, 20, 20);
+  DlRTree tree(&rect, 1);
+  DlRect queries[3] = {DlRect::MakeLTRB(0, 0, 15, 15),
+                       DlRect::MakeLTRB(30, 30, 40, 40),
+                       DlRect::MakeLTRB(12, 12, 18, 18)};
+  std::vector<int> results[3];
+  tree.search(queries, 3, results);
+  EXPECT_EQ(results[0], std::vector<int>{0});
+  EXPECT_TRUE(results[1].empty());
+  EXPECT_EQ(results[2], std::vector<int>{0});
+}
+
 }  // namespace testing
 }  // namespace flutter
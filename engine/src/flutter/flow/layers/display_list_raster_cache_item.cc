@@ -25,7 +25,8 @@ static bool IsDisplayListWorthRasterizing(
     const DisplayList* display_list,
     bool will_change,
     bool is_complex,
-    DisplayListComplexityCalculator* complexity_calculator) {
+    DisplayListComplexityCalculator* complexity_calculator,
+    std::optional<unsigned int>& complexity_score) {
   if (will_change) {
     // If the display list is going to change in the future, there is no point
     // in doing to extra work to rasterize.
@@ -39,14 +40,20 @@ static bool IsDisplayListWorthRasterizing(
     return false;
   }
 
+  // The score is also used by the raster cache to prioritize the entry, so it
+  // is computed even if the caller thinks the display list is complex. Display
+  // lists are immutable, so it only needs to be computed once.
+  if (!complexity_score.has_value()) {
+    complexity_score = complexity_calculator->Compute(display_list);
+  }
+
   if (is_complex) {
     // The caller seems to have extra information about the display list and
     // thinks the display list is always worth rasterizing.
     return true;
   }
 
-  unsigned int complexity_score = complexity_calculator->Compute(display_list);
-  return complexity_calculator->ShouldBeCached(complexity_score);
+  return complexity_calculator->ShouldBeCached(complexity_score.value());
 }
 
 DisplayListRasterCacheItem::DisplayListRasterCacheItem(
@@ -80,7 +87,8 @@ void DisplayListRasterCacheItem::PrerollSetup(PrerollContext* context,
                           : DisplayListComplexityCalculator::GetForSoftware();
 
   if (!IsDisplayListWorthRasterizing(display_list(), will_change_, is_complex_,
-                                     complexity_calculator)) {
+                                     complexity_calculator,
+                                     complexity_score_)) {
     // We only deal with display lists that are worthy of rasterization.
     return;
   }
@@ -109,10 +117,11 @@ void DisplayListRasterCacheItem::PrerollFinalize(PrerollContext* context,
   auto* raster_cache = context->raster_cache;
   DlRect bounds = display_list_->GetBounds().Shift(offset_.x(), offset_.y());
   bool visible = !context->state_stack.content_culled(bounds);
-  RasterCache::CacheInfo cache_info =
-      raster_cache->MarkSeen(key_id_, ToSkMatrix(matrix), visible);
-  if (!visible ||
-      cache_info.accesses_since_visible <= raster_cache->access_threshold()) {
+  unsigned int complexity_score = complexity_score_.value_or(0);
+  RasterCache::CacheInfo cache_info = raster_cache->MarkSeen(
+      key_id_, ToSkMatrix(matrix), visible, complexity_score);
+  if (!visible || cache_info.accesses_since_visible <=
+                      raster_cache->GetAccessThreshold(complexity_score)) {
     cache_state_ = kNone;
   } else {
     if (cache_info.has_image) {
@@ -152,11 +161,14 @@ bool DisplayListRasterCacheItem::TryToPrepareRasterCache(
   // current node. In the current frame, the raster_cache will collect all
   // display_list or picture_list to calculate the memory they used, we
   // shouldn't cache the current node if the memory is more significant than the
-  // limit.
+  // limit. The raster cache also only admits the most expensive display lists
+  // that fit within its per-frame limit.
   auto id = GetId();
   FML_DCHECK(id.has_value());
   if (cache_state_ == kNone || !context.raster_cache || parent_cached ||
-      !context.raster_cache->GenerateNewCacheInThisFrame() || !id.has_value()) {
+      !id.has_value() ||
+      !context.raster_cache->ShouldGenerateNewCache(id.value(),
+                                                    transformation_matrix_)) {
     return false;
   }
   SkRect bounds =
@@ -57,6 +57,8 @@ class DisplayListRasterCacheItem : public RasterCacheItem {
   SkPoint offset_;
   bool is_complex_;
   bool will_change_;
+  // The complexity score of the display list, computed on the first preroll.
+  std::optional<unsigned int> complexity_score_;
 };
 
 }  // namespace flutter
@@ -102,7 +102,7 @@ struct PaintContext {
   const Stopwatch& raster_time;
   const Stopwatch& ui_time;
   std::shared_ptr<TextureRegistry> texture_registry;
-  NOT_SLIMPELLER(const RasterCache* raster_cache);
+  NOT_SLIMPELLER(RasterCache* raster_cache);
 
   bool impeller_enabled = false;
   impeller::AiksContext* aiks_context;
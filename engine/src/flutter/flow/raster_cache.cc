@@ -6,7 +6,10 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <limits>
+#include <utility>
 #include <vector>
 
 #include "flutter/common/constants.h"
@@ -17,6 +20,7 @@
 #include "flutter/flow/paint_utils.h"
 #include "flutter/flow/raster_cache_util.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkColorSpace.h"
 #include "third_party/skia/include/core/SkImage.h"
@@ -72,9 +76,11 @@ void RasterCacheResult::draw(DlCanvas& canvas,
 }
 
 RasterCache::RasterCache(size_t access_threshold,
-                         size_t display_list_cache_limit_per_frame)
+                         size_t display_list_cache_limit_per_frame,
+                         size_t max_bytes)
     : access_threshold_(access_threshold),
-      display_list_cache_limit_per_frame_(display_list_cache_limit_per_frame) {}
+      display_list_cache_limit_per_frame_(display_list_cache_limit_per_frame),
+      max_bytes_(max_bytes) {}
 
 /// @note Procedure doesn't copy all closures.
 std::unique_ptr<RasterCacheResult> RasterCache::Rasterize(
@@ -120,14 +126,31 @@ bool RasterCache::UpdateCacheEntry(
     const RasterCacheKeyID& id,
     const Context& raster_cache_context,
     const std::function<void(DlCanvas*)>& render_function,
-    sk_sp<const DlRTree> rtree) const {
+    sk_sp<const DlRTree> rtree) {
   RasterCacheKey key = RasterCacheKey(id, raster_cache_context.matrix);
   Entry& entry = cache_[key];
   if (!entry.image) {
+    SkRect dest_rect = RasterCacheUtil::GetRoundedOutDeviceBounds(
+        raster_cache_context.logical_rect,
+        RasterCacheUtil::GetIntegralTransCTM(raster_cache_context.matrix));
+    size_t estimated_bytes = static_cast<size_t>(dest_rect.width()) *
+                             static_cast<size_t>(dest_rect.height()) *
+                             SkColorTypeBytesPerPixel(kN32_SkColorType);
+    if (!EvictToFit(key, entry, estimated_bytes)) {
+      GetMetricsForKind(key.kind()).rejected_count++;
+      // Make the entry earn its place again before retrying so that an entry
+      // which does not fit does not take an admission slot on every frame.
+      entry.accesses_since_visible = 0;
+      return false;
+    }
+
     void (*func)(DlCanvas*, const DlRect& rect) = DrawCheckerboard;
+    fml::TimePoint start = fml::TimePoint::Now();
     entry.image = Rasterize(raster_cache_context, std::move(rtree),
                             render_function, func);
     if (entry.image != nullptr) {
+      entry.draw_time = fml::TimePoint::Now() - start;
+      cached_bytes_ += entry.image->image_bytes();
       switch (id.type()) {
         case RasterCacheKeyType::kDisplayList: {
           display_list_cached_this_frame_++;
@@ -149,12 +172,40 @@ RasterCache::CacheInfo RasterCache::MarkSeen(const RasterCacheKeyID& id,
   Entry& entry = cache_[key];
   entry.encountered_this_frame = true;
   entry.visible_this_frame = visible;
+  if (visible) {
+    entry.last_visible_frame = frame_count_;
+  }
+  if (complexity_score > 0) {
+    entry.complexity_score = complexity_score;
+  }
   if (visible || entry.accesses_since_visible > 0) {
     entry.accesses_since_visible++;
   }
   return {entry.accesses_since_visible, entry.image != nullptr};
 }
 
+size_t RasterCache::GetAccessThreshold(unsigned int complexity_score) const {
+  if (complexity_score >= RasterCacheUtil::kExpensiveComplexityScore) {
+    return std::min<size_t>(access_threshold_, 1);
+  }
+  return access_threshold_;
+}
+
+bool RasterCache::ShouldGenerateNewCache(const RasterCacheKeyID& id,
+                                         const SkMatrix& matrix) const {
+  if (!GenerateNewCacheInThisFrame()) {
+    return false;
+  }
+  if (!admission_ranked_this_frame_) {
+    return true;
+  }
+  auto it = cache_.find(RasterCacheKey(id, matrix));
+  if (it == cache_.end()) {
+    return false;
+  }
+  return it->second.image != nullptr || it->second.admitted_this_frame;
+}
+
 int RasterCache::GetAccessCount(const RasterCacheKeyID& id,
                                 const SkMatrix& matrix) const {
   RasterCacheKey key = RasterCacheKey(id, matrix);
@@ -194,6 +245,8 @@ bool RasterCache::Draw(const RasterCacheKeyID& id,
 }
 
 void RasterCache::BeginFrame() {
+  frame_count_++;
+  admission_ranked_this_frame_ = false;
   display_list_cached_this_frame_ = 0;
   picture_metrics_ = {};
   layer_metrics_ = {};
@@ -227,9 +280,115 @@ void RasterCache::EvictUnusedCacheEntries() {
       RasterCacheMetrics& metrics = GetMetricsForKind(it->first.kind());
       metrics.eviction_count++;
       metrics.eviction_bytes += it->second.image->image_bytes();
+      cached_bytes_ -= it->second.image->image_bytes();
     }
     cache_.erase(it);
   }
+
+  RankAdmissionCandidates();
+}
+
+void RasterCache::RankAdmissionCandidates() {
+  std::vector<Entry*> candidates;
+  for (auto& [key, entry] : cache_) {
+    entry.admitted_this_frame = false;
+    if (key.kind() == RasterCacheKeyKind::kDisplayListMetrics &&
+        !entry.image && entry.visible_this_frame &&
+        entry.accesses_since_visible >
+            GetAccessThreshold(entry.complexity_score)) {
+      candidates.push_back(&entry);
+    }
+  }
+
+  size_t slots = display_list_cache_limit_per_frame_ -
+                 std::min(display_list_cached_this_frame_,
+                          display_list_cache_limit_per_frame_);
+  if (candidates.size() > slots) {
+    std::partial_sort(candidates.begin(), candidates.begin() + slots,
+                      candidates.end(), [](const Entry* a, const Entry* b) {
+                        return GetEstimatedCostNanos(*a) >
+                               GetEstimatedCostNanos(*b);
+                      });
+    candidates.resize(slots);
+  }
+  for (Entry* entry : candidates) {
+    entry->admitted_this_frame = true;
+  }
+  admission_ranked_this_frame_ = true;
+}
+
+bool RasterCache::EvictToFit(const RasterCacheKey& key,
+                             const Entry& incoming,
+                             size_t bytes) {
+  if (bytes > max_bytes_) {
+    return false;
+  }
+  if (cached_bytes_ + bytes <= max_bytes_) {
+    return true;
+  }
+
+  // Layers have no complexity score, so there is nothing to estimate their
+  // cost from until they have been rasterized once. They already had to
+  // meet their own caching threshold and are admitted ahead of any entry.
+  double priority =
+      key.kind() == RasterCacheKeyKind::kLayerMetrics &&
+              incoming.draw_time <= fml::TimeDelta::Zero()
+          ? std::numeric_limits<double>::infinity()
+          : GetRetentionPriority(incoming, bytes);
+  std::vector<std::pair<double, RasterCacheKey::Map<Entry>::iterator>> victims;
+  size_t reclaimable_bytes = 0;
+  for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+    const Entry& entry = it->second;
+    if (!entry.image || &entry == &incoming) {
+      continue;
+    }
+    size_t image_bytes = static_cast<size_t>(entry.image->image_bytes());
+    double victim_priority = GetRetentionPriority(entry, image_bytes);
+    if (victim_priority < priority) {
+      victims.emplace_back(victim_priority, it);
+      reclaimable_bytes += image_bytes;
+    }
+  }
+  if (cached_bytes_ - reclaimable_bytes + bytes > max_bytes_) {
+    return false;
+  }
+
+  std::sort(victims.begin(), victims.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  for (auto& [victim_priority, it] : victims) {
+    if (cached_bytes_ + bytes <= max_bytes_) {
+      break;
+    }
+    Entry& entry = it->second;
+    size_t image_bytes = static_cast<size_t>(entry.image->image_bytes());
+    RasterCacheMetrics& metrics = GetMetricsForKind(it->first.kind());
+    metrics.eviction_count++;
+    metrics.budget_eviction_count++;
+    metrics.eviction_bytes += image_bytes;
+    cached_bytes_ -= image_bytes;
+    // The measured draw time is kept so that the entry competes with its
+    // real cost if it is prepared again.
+    entry.image.reset();
+    entry.accesses_since_visible = 0;
+  }
+  return true;
+}
+
+int64_t RasterCache::GetEstimatedCostNanos(const Entry& entry) {
+  if (entry.draw_time > fml::TimeDelta::Zero()) {
+    return entry.draw_time.ToNanoseconds();
+  }
+  int64_t cost = static_cast<int64_t>(entry.complexity_score) * 1000 /
+                 RasterCacheUtil::kComplexityScorePerMicrosecond;
+  return std::max<int64_t>(cost, 1);
+}
+
+double RasterCache::GetRetentionPriority(const Entry& entry,
+                                         size_t bytes) const {
+  size_t frames_since_visible = frame_count_ - entry.last_visible_frame;
+  return static_cast<double>(GetEstimatedCostNanos(entry)) /
+         (static_cast<double>(std::max<size_t>(bytes, 1)) *
+          static_cast<double>(frames_since_visible + 1));
 }
 
 void RasterCache::EndFrame() {
@@ -239,6 +398,7 @@ void RasterCache::EndFrame() {
 
 void RasterCache::Clear() {
   cache_.clear();
+  cached_bytes_ = 0;
   picture_metrics_ = {};
   layer_metrics_ = {};
 }
@@ -16,6 +16,7 @@
 #include "flutter/flow/raster_cache_util.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkMatrix.h"
 #include "third_party/skia/include/core/SkRect.h"
@@ -71,6 +72,18 @@ struct RasterCacheMetrics {
    */
   size_t eviction_bytes = 0;
 
+  /**
+   * The number of cache entries with images evicted in this frame to keep the
+   * cache within its byte budget. These are included in |eviction_count|.
+   */
+  size_t budget_eviction_count = 0;
+
+  /**
+   * The number of images that were not cached in this frame because they
+   * did not fit in the byte budget.
+   */
+  size_t rejected_count = 0;
+
   /**
    * The number of cache entries with images used in this frame.
    */
@@ -107,9 +120,13 @@ struct RasterCacheMetrics {
  *         encountered by the current frame.
  * - Paint stage
  *   - RasterCache::EvictUnusedCacheEntries
- *       Evict cached images that are no longer used.
+ *       Evict cached images that are no longer used, then rank the display
+ *       lists that are waiting to be cached by their estimated cost so that
+ *       the per-frame cache limit is spent on the most expensive ones.
  *   - LayerTree::TryToPrepareRasterCache
- *       Create cache image for each cache entry if it does not exist.
+ *       Create cache image for each cache entry if it does not exist. If the
+ *       new image does not fit in the byte budget, entries that save less
+ *       raster time per byte are evicted to make room for it.
  *   - LayerTree::Paint - for each layer in the tree:
  *       If layers or display lists are cached as cached images, the method
  *       `RasterCache::Draw` will be used to draw those cache images.
@@ -140,7 +157,8 @@ class RasterCache {
   explicit RasterCache(
       size_t access_threshold = 3,
       size_t picture_and_display_list_cache_limit_per_frame =
-          RasterCacheUtil::kDefaultPictureAndDisplayListCacheLimitPerFrame);
+          RasterCacheUtil::kDefaultPictureAndDisplayListCacheLimitPerFrame,
+      size_t max_bytes = RasterCacheUtil::kDefaultMaxBytes);
 
   virtual ~RasterCache() = default;
 
@@ -206,6 +224,17 @@ class RasterCache {
    */
   size_t EstimateLayerCacheByteSize() const;
 
+  /**
+   * @brief The budget for the bytes of all of the images in the cache.
+   */
+  size_t max_bytes() const { return max_bytes_; }
+
+  /**
+   * @brief The bytes of all of the images currently in the cache, as
+   * reported by RasterCacheResult::image_bytes.
+   */
+  size_t GetCachedBytes() const { return cached_bytes_; }
+
   /**
    * @brief Return the number of frames that a picture must be prepared
    * before it will be cached. If the number is 0, then no picture will
@@ -216,12 +245,33 @@ class RasterCache {
    */
   size_t access_threshold() const { return access_threshold_; }
 
+  /**
+   * @brief Return the number of frames that a display list with the given
+   * complexity score must be prepared before it will be cached.
+   *
+   * Display lists that are expensive enough to draw are cached after being
+   * prepared on a single frame, without waiting for |access_threshold|.
+   */
+  size_t GetAccessThreshold(unsigned int complexity_score) const;
+
   bool GenerateNewCacheInThisFrame() const {
     // Disabling caching when access_threshold is zero is historic behavior.
     return access_threshold_ != 0 && display_list_cached_this_frame_ <
                                          display_list_cache_limit_per_frame_;
   }
 
+  /**
+   * @brief Whether the display list entry may be prepared in this frame.
+   *
+   * Once |EvictUnusedCacheEntries| has ranked the display lists that are
+   * waiting to be cached, only the most expensive ones that fit within the
+   * per-frame limit are admitted, along with entries that already have an
+   * image. Before that, entries are admitted in the order they are prepared,
+   * as limited by |GenerateNewCacheInThisFrame|.
+   */
+  bool ShouldGenerateNewCache(const RasterCacheKeyID& id,
+                              const SkMatrix& matrix) const;
+
   /**
    * @brief The entry whose RasterCacheKey is generated by RasterCacheKeyID
    * and matrix is marked as encountered by the current frame. The entry
@@ -229,12 +279,15 @@ class RasterCache {
    * as visible in the current frame if the caller determines that it
    * intersects the cull rect. The access_count of the entry will be
    * increased if it is visible, or if it was ever visible.
+   * The complexity score of display list entries is recorded so that it can
+   * be used to prioritize the entry until its draw time has been measured.
    * @return the number of times the entry has been hit since it was created.
    * For a new entry that will be 1 if it is visible, or zero if non-visible.
    */
   CacheInfo MarkSeen(const RasterCacheKeyID& id,
                      const SkMatrix& matrix,
-                     bool visible) const;
+                     bool visible,
+                     unsigned int complexity_score = 0) const;
 
   /**
    * Returns the access count (i.e. accesses_since_visible) for the given
@@ -245,23 +298,52 @@ class RasterCache {
   bool UpdateCacheEntry(const RasterCacheKeyID& id,
                         const Context& raster_cache_context,
                         const std::function<void(DlCanvas*)>& render_function,
-                        sk_sp<const DlRTree> rtree = nullptr) const;
+                        sk_sp<const DlRTree> rtree = nullptr);
 
  private:
   struct Entry {
     bool encountered_this_frame = false;
     bool visible_this_frame = false;
+    bool admitted_this_frame = false;
     size_t accesses_since_visible = 0;
+    size_t last_visible_frame = 0;
+    unsigned int complexity_score = 0;
+    // The CPU time it took to record and submit the draw of the contents into
+    // the image, or zero if the entry has never been rasterized. This does
+    // not include the time the GPU spends executing the draw.
+    fml::TimeDelta draw_time;
     std::unique_ptr<RasterCacheResult> image;
   };
 
   void UpdateMetrics();
 
+  void RankAdmissionCandidates();
+
+  // Evicts entries until an image of |bytes| for |incoming| fits in the
+  // budget, or returns false without evicting anything if that would require
+  // evicting entries that are worth at least as much as |incoming|. Layers
+  // that have never been rasterized may evict any entry.
+  bool EvictToFit(const RasterCacheKey& key,
+                  const Entry& incoming,
+                  size_t bytes);
+
+  // The estimated raster time saved each frame the entry is drawn from the
+  // cache.
+  static int64_t GetEstimatedCostNanos(const Entry& entry);
+
+  // The raster time saved per byte of the image, discounted by the number
+  // of frames since the entry was last visible.
+  double GetRetentionPriority(const Entry& entry, size_t bytes) const;
+
   RasterCacheMetrics& GetMetricsForKind(RasterCacheKeyKind kind);
 
   const size_t access_threshold_;
   const size_t display_list_cache_limit_per_frame_;
-  mutable size_t display_list_cached_this_frame_ = 0;
+  const size_t max_bytes_;
+  size_t display_list_cached_this_frame_ = 0;
+  size_t cached_bytes_ = 0;
+  size_t frame_count_ = 0;
+  bool admission_ranked_this_frame_ = false;
   RasterCacheMetrics layer_metrics_;
   RasterCacheMetrics picture_metrics_;
   mutable RasterCacheKey::Map<Entry> cache_;
@@ -320,6 +320,278 @@ TEST(RasterCache, EvictUnusedCacheEntries) {
   cache.EndFrame();
 }
 
+TEST(RasterCache, MostExpensiveDisplayListsAreCachedFirst) {
+  size_t threshold = 1;
+  size_t picture_cache_limit_per_frame = 1;
+  flutter::RasterCache cache(threshold, picture_cache_limit_per_frame);
+
+  DlMatrix matrix;
+
+  // Scored by op count with the software complexity calculator.
+  auto cheap_display_list = GetSampleDisplayList(6);
+  auto expensive_display_list = GetSampleDisplayList(50);
+
+  DisplayListBuilder dummy_canvas(1000, 1000);
+  DlPaint paint;
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack paint_state_stack;
+  preroll_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem cheap_item(cheap_display_list, SkPoint(), true,
+                                        false);
+  DisplayListRasterCacheItem expensive_item(expensive_display_list, SkPoint(),
+                                            true, false);
+
+  for (int i = 0; i < 2; i++) {
+    cache.BeginFrame();
+    RasterCacheItemPreroll(cheap_item, preroll_context, matrix);
+    RasterCacheItemPreroll(expensive_item, preroll_context, matrix);
+    cache.EvictUnusedCacheEntries();
+    // The cheap item is prepared first but only one display list may be
+    // cached per frame, so it must wait for the expensive one.
+    ASSERT_FALSE(RasterCacheItemTryToRasterCache(cheap_item, paint_context));
+    ASSERT_EQ(RasterCacheItemTryToRasterCache(expensive_item, paint_context),
+              i == 1);
+    cache.EndFrame();
+  }
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+  ASSERT_TRUE(expensive_item.Draw(paint_context, &dummy_canvas, &paint));
+  ASSERT_FALSE(cheap_item.Draw(paint_context, &dummy_canvas, &paint));
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(cheap_item, preroll_context, matrix);
+  RasterCacheItemPreroll(expensive_item, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  ASSERT_TRUE(RasterCacheItemTryToRasterCache(expensive_item, paint_context));
+  ASSERT_TRUE(RasterCacheItemTryToRasterCache(cheap_item, paint_context));
+  cache.EndFrame();
+  ASSERT_EQ(cache.picture_metrics().total_count(), 2u);
+}
+
+TEST(RasterCache, ExpensiveDisplayListsIgnoreAccessThreshold) {
+  flutter::RasterCache cache(3);
+
+  EXPECT_EQ(cache.GetAccessThreshold(0u), 3u);
+  EXPECT_EQ(cache.GetAccessThreshold(
+                RasterCacheUtil::kExpensiveComplexityScore - 1u),
+            3u);
+  EXPECT_EQ(
+      cache.GetAccessThreshold(RasterCacheUtil::kExpensiveComplexityScore),
+      1u);
+
+  // A threshold of zero still disables caching.
+  flutter::RasterCache disabled_cache(0);
+  EXPECT_EQ(disabled_cache.GetAccessThreshold(
+                RasterCacheUtil::kExpensiveComplexityScore),
+            0u);
+}
+
+namespace {
+
+// Fills the bounds and then draws |ops| - 1 single pixel rects.
+sk_sp<DisplayList> MakeDisplayList(int width, int height, int ops) {
+  DisplayListBuilder builder(DlRect::MakeWH(static_cast<DlScalar>(width),
+                                            static_cast<DlScalar>(height)));
+  builder.DrawColor(DlColor::kWhite(), DlBlendMode::kSrc);
+  for (int i = 1; i < ops; i++) {
+    builder.DrawRect(DlRect::MakeXYWH(static_cast<DlScalar>(i % width),
+                                      static_cast<DlScalar>(i / width % height),
+                                      1, 1),
+                     DlPaint());
+  }
+  return builder.Build();
+}
+
+}  // namespace
+
+TEST(RasterCache, ByteBudgetEvictsEntriesWorthLessPerByte) {
+  // Room for the large display list, but not for both.
+  size_t max_bytes = 400 * 400 * 4 + 5000;
+  flutter::RasterCache cache(1, 3, max_bytes);
+
+  DlMatrix matrix;
+
+  // A single op over a large area saves little raster time per byte, many ops
+  // over a small area save a lot.
+  auto large_display_list = MakeDisplayList(400, 400, 1);
+  auto small_display_list = MakeDisplayList(50, 50, 20000);
+
+  DisplayListBuilder dummy_canvas(1000, 1000);
+  DlPaint paint;
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack paint_state_stack;
+  preroll_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem large_item(large_display_list, SkPoint(), true,
+                                        false);
+  DisplayListRasterCacheItem small_item(small_display_list, SkPoint(), true,
+                                        false);
+
+  for (int i = 0; i < 2; i++) {
+    cache.BeginFrame();
+    ASSERT_EQ(RasterCacheItemPrerollAndTryToRasterCache(
+                  large_item, preroll_context, paint_context, matrix),
+              i == 1);
+    cache.EndFrame();
+  }
+  size_t large_bytes = cache.GetCachedBytes();
+  ASSERT_GE(large_bytes, 400u * 400u * 4u);
+  ASSERT_LE(large_bytes, max_bytes);
+
+  for (int i = 0; i < 2; i++) {
+    cache.BeginFrame();
+    RasterCacheItemPreroll(large_item, preroll_context, matrix);
+    RasterCacheItemPreroll(small_item, preroll_context, matrix);
+    cache.EvictUnusedCacheEntries();
+    ASSERT_TRUE(RasterCacheItemTryToRasterCache(large_item, paint_context));
+    ASSERT_EQ(RasterCacheItemTryToRasterCache(small_item, paint_context),
+              i == 1);
+    if (i == 1) {
+      ASSERT_EQ(cache.picture_metrics().budget_eviction_count, 1u);
+      ASSERT_EQ(cache.picture_metrics().eviction_bytes, large_bytes);
+    }
+    cache.EndFrame();
+  }
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+  ASSERT_LE(cache.GetCachedBytes(), max_bytes);
+  ASSERT_EQ(cache.GetCachedBytes(), cache.EstimatePictureCacheByteSize());
+  ASSERT_FALSE(large_item.Draw(paint_context, &dummy_canvas, &paint));
+  ASSERT_TRUE(small_item.Draw(paint_context, &dummy_canvas, &paint));
+
+  // The large display list now has to earn its place again and is then
+  // rejected because it is worth less than the small one.
+  for (int i = 0; i < 2; i++) {
+    cache.BeginFrame();
+    RasterCacheItemPreroll(large_item, preroll_context, matrix);
+    RasterCacheItemPreroll(small_item, preroll_context, matrix);
+    cache.EvictUnusedCacheEntries();
+    ASSERT_FALSE(RasterCacheItemTryToRasterCache(large_item, paint_context));
+    ASSERT_TRUE(RasterCacheItemTryToRasterCache(small_item, paint_context));
+    ASSERT_EQ(cache.picture_metrics().rejected_count, i == 1 ? 1u : 0u);
+    cache.EndFrame();
+  }
+  ASSERT_TRUE(small_item.Draw(paint_context, &dummy_canvas, &paint));
+}
+
+TEST(RasterCache, ByteBudgetAdmitsLayersBeforeTheirCostIsMeasured) {
+  // Room for one of the display list and the layer, but not for both.
+  size_t max_bytes = 400 * 400 * 4 + 5000;
+  flutter::RasterCache cache(1, 3, max_bytes);
+
+  DlMatrix matrix;
+
+  auto display_list = MakeDisplayList(400, 400, 20000);
+  auto layer = MockLayer::Make(DlPath::MakeRect(DlRect::MakeWH(400, 400)));
+
+  DisplayListBuilder dummy_canvas(1000, 1000);
+  DlPaint paint;
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack paint_state_stack;
+  preroll_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem display_list_item(display_list, SkPoint(), true,
+                                               false);
+  LayerRasterCacheItem layer_item(layer.get(), /*layer_cached_threshold=*/0);
+
+  for (int i = 0; i < 2; i++) {
+    cache.BeginFrame();
+    ASSERT_EQ(RasterCacheItemPrerollAndTryToRasterCache(
+                  display_list_item, preroll_context, paint_context, matrix),
+              i == 1);
+    cache.EndFrame();
+  }
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+
+  // The layer has no estimated cost before it is rasterized, so it is not
+  // rejected in favor of the measured display list.
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item, preroll_context, matrix);
+  layer_item.PrerollSetup(&preroll_context, matrix);
+  layer->Preroll(&preroll_context);
+  layer_item.PrerollFinalize(&preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  ASSERT_TRUE(layer_item.TryToPrepareRasterCache(paint_context));
+  cache.EndFrame();
+
+  ASSERT_EQ(cache.layer_metrics().total_count(), 1u);
+  ASSERT_EQ(cache.layer_metrics().rejected_count, 0u);
+  ASSERT_EQ(cache.picture_metrics().total_count(), 0u);
+  ASSERT_EQ(cache.picture_metrics().budget_eviction_count, 1u);
+  ASSERT_LE(cache.GetCachedBytes(), max_bytes);
+  ASSERT_TRUE(layer_item.Draw(paint_context, &dummy_canvas, &paint));
+  ASSERT_FALSE(display_list_item.Draw(paint_context, &dummy_canvas, &paint));
+}
+
+TEST(RasterCache, DisplayListsLargerThanTheByteBudgetAreNotCached) {
+  flutter::RasterCache cache(1, 3, 100 * 100 * 4);
+
+  DlMatrix matrix;
+
+  auto display_list = MakeDisplayList(200, 200, 10);
+
+  DisplayListBuilder dummy_canvas(1000, 1000);
+  DlPaint paint;
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack paint_state_stack;
+  preroll_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem display_list_item(display_list, SkPoint(), true,
+                                               false);
+
+  for (int i = 0; i < 4; i++) {
+    cache.BeginFrame();
+    ASSERT_FALSE(RasterCacheItemPrerollAndTryToRasterCache(
+        display_list_item, preroll_context, paint_context, matrix));
+    ASSERT_FALSE(display_list_item.Draw(paint_context, &dummy_canvas, &paint));
+    cache.EndFrame();
+  }
+  ASSERT_EQ(cache.GetCachedBytes(), 0u);
+}
+
 TEST(RasterCache, ComputeDeviceRectBasedOnFractionalTranslation) {
   SkRect logical_rect = SkRect::MakeLTRB(0, 0, 300.2, 300.3);
   SkMatrix ctm = SkMatrix::MakeAll(2.0, 0, 0, 0, 2.0, 0, 0, 0, 1);
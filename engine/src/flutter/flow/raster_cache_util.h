@@ -36,6 +36,21 @@ struct RasterCacheUtil {
   // filtered output of this layer.
   static constexpr int kMinimumRendersBeforeCachingFilterLayer = 3;
 
+  // The default budget for the bytes of all of the images in the raster
+  // cache. When a new entry would exceed the budget, entries that save less
+  // raster time per byte are evicted to make room for it, and the new entry is
+  // rejected if evicting those would not be enough.
+  static constexpr size_t kDefaultMaxBytes = 128u * 1024u * 1024u;
+
+  // The complexity scores of the DisplayListComplexityCalculator are scaled
+  // such that a score of 100 is roughly 0.5us of raster time.
+  static constexpr unsigned int kComplexityScorePerMicrosecond = 200u;
+
+  // Display lists with at least this complexity score (roughly 4ms of raster
+  // time) are expensive enough that they are cached on the second frame they
+  // are seen, regardless of the access threshold of the cache.
+  static constexpr unsigned int kExpensiveComplexityScore = 800000u;
+
   static bool CanRasterizeRect(const SkRect& cull_rect) {
     if (cull_rect.isEmpty()) {
       // No point in ever rasterizing an empty display list.
@@ -11,19 +11,26 @@
 
 namespace fml {
 
+namespace {
+// The loop and queue index of the worker running on the current thread.
+thread_local const ConcurrentMessageLoop* tls_worker_loop = nullptr;
+thread_local size_t tls_worker_index = 0u;
+}  // namespace
+
 ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
     : worker_count_(std::max<size_t>(worker_count, 1ul)) {
+  queues_.reserve(worker_count_);
+  for (size_t i = 0; i < worker_count_; ++i) {
+    queues_.emplace_back(std::make_unique<WorkerQueue>());
+  }
+
   for (size_t i = 0; i < worker_count_; ++i) {
     workers_.emplace_back([i, this]() {
       fml::Thread::SetCurrentThreadName(fml::Thread::ThreadConfig(
           std::string{"io.worker." + std::to_string(i + 1)}));
-      WorkerMain();
+      WorkerMain(i);
     });
   }
-
-  for (const auto& worker : workers_) {
-    worker_thread_ids_.emplace_back(worker.get_id());
-  }
 }
 
 ConcurrentMessageLoop::~ConcurrentMessageLoop() {
@@ -42,62 +49,146 @@ std::shared_ptr<ConcurrentTaskRunner> ConcurrentMessageLoop::GetTaskRunner() {
   return std::make_shared<ConcurrentTaskRunner>(weak_from_this());
 }
 
-void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
+void ConcurrentMessageLoop::PostTask(const fml::closure& task,
+                                     ConcurrentTaskPriority priority) {
   if (!task) {
     return;
   }
 
-  std::unique_lock lock(tasks_mutex_);
-
   // Don't just drop tasks on the floor in case of shutdown.
   if (shutdown_) {
     FML_DLOG(WARNING)
         << "Tried to post a task to shutdown concurrent message "
            "loop. The task will be executed on the callers thread.";
-    lock.unlock();
     ExecuteTask(task);
     return;
   }
 
-  tasks_.push(task);
+  // Workers keep the tasks they post for themselves, which keeps the data
+  // they touch in the same cache. Everything else is spread round robin so
+  // that posting threads rarely meet on the same queue lock.
+  size_t index = tls_worker_loop == this
+                     ? tls_worker_index
+                     : next_queue_.fetch_add(1u, std::memory_order_relaxed) %
+                           worker_count_;
+  size_t level = static_cast<size_t>(priority);
+  {
+    WorkerQueue& queue = *queues_[index];
+    std::unique_lock lock = LockQueue(queue);
+    queue.tasks[level].push_back(task);
+    queue.task_counts[level].fetch_add(1u, std::memory_order_relaxed);
+    // Counted under the queue lock so that the count never drops below the
+    // number of tasks a worker can find.
+    pending_tasks_[level].fetch_add(1u);
+  }
+
+  WakeWorkers(/*all=*/false);
+}
+
+void ConcurrentMessageLoop::WakeWorkers(bool all) {
+  // Paired with the increment of |sleeping_workers_| in |WorkerMain|. Either
+  // the worker sees the new task before it goes to sleep, or this sees the
+  // sleeping worker and notifies it.
+  if (sleeping_workers_.load() == 0u) {
+    return;
+  }
 
-  // Unlock the mutex before notifying the condition variable because that mutex
-  // has to be acquired on the other thread anyway. Waiting in this scope till
-  // it is acquired there is a pessimization.
-  lock.unlock();
+  {
+    // A worker between its last check and the wait holds this mutex, so
+    // acquiring it guarantees that the notification is not lost.
+    std::scoped_lock lock(sleep_mutex_);
+  }
 
-  tasks_condition_.notify_one();
+  if (all) {
+    sleep_condition_.notify_all();
+  } else {
+    sleep_condition_.notify_one();
+  }
 }
 
-void ConcurrentMessageLoop::WorkerMain() {
-  while (true) {
-    std::unique_lock lock(tasks_mutex_);
-    tasks_condition_.wait(lock, [&]() {
-      return !tasks_.empty() || shutdown_ || HasThreadTasksLocked();
-    });
+bool ConcurrentMessageLoop::HasPendingTasks() const {
+  for (const auto& pending : pending_tasks_) {
+    if (pending.load() > 0u) {
+      return true;
+    }
+  }
+  return false;
+}
 
-    // Shutdown cannot be read with the task mutex unlocked.
-    bool shutdown_now = shutdown_;
-    fml::closure task;
-    std::vector<fml::closure> thread_tasks;
+std::unique_lock<std::mutex> ConcurrentMessageLoop::LockQueue(
+    WorkerQueue& queue) {
+  std::unique_lock lock(queue.mutex, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    lock_contentions_.fetch_add(1u, std::memory_order_relaxed);
+    lock.lock();
+  }
+  return lock;
+}
 
-    if (!tasks_.empty()) {
-      task = tasks_.front();
-      tasks_.pop();
+fml::closure ConcurrentMessageLoop::TakeTask(size_t index) {
+  for (size_t level = 0; level < kPriorityCount; ++level) {
+    if (pending_tasks_[level].load(std::memory_order_relaxed) == 0u) {
+      continue;
+    }
+    // Start with the queue of this worker, then steal from its neighbours.
+    for (size_t offset = 0; offset < worker_count_; ++offset) {
+      WorkerQueue& queue = *queues_[(index + offset) % worker_count_];
+      if (queue.task_counts[level].load(std::memory_order_relaxed) == 0u) {
+        continue;
+      }
+      std::unique_lock lock = LockQueue(queue);
+      std::deque<fml::closure>& tasks = queue.tasks[level];
+      if (tasks.empty()) {
+        continue;
+      }
+      fml::closure task;
+      if (offset == 0u) {
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      } else {
+        task = std::move(tasks.back());
+        tasks.pop_back();
+        tasks_stolen_.fetch_add(1u, std::memory_order_relaxed);
+      }
+      queue.task_counts[level].fetch_sub(1u, std::memory_order_relaxed);
+      pending_tasks_[level].fetch_sub(1u);
+      return task;
     }
+  }
+  return nullptr;
+}
+
+void ConcurrentMessageLoop::WorkerMain(size_t index) {
+  tls_worker_loop = this;
+  tls_worker_index = index;
+  WorkerQueue& queue = *queues_[index];
 
-    if (HasThreadTasksLocked()) {
-      thread_tasks = GetThreadTasksLocked();
-      FML_DCHECK(!HasThreadTasksLocked());
+  while (true) {
+    fml::closure task = TakeTask(index);
+
+    if (!task && !queue.has_thread_tasks && !shutdown_) {
+      std::unique_lock lock(sleep_mutex_);
+      sleeping_workers_.fetch_add(1u);
+      sleep_condition_.wait(lock, [&]() {
+        return shutdown_ || HasPendingTasks() || queue.has_thread_tasks;
+      });
+      sleeping_workers_.fetch_sub(1u);
+      continue;
     }
 
-    // Don't hold onto the mutex while tasks are being executed as they could
-    // themselves try to post more tasks to the message loop.
-    lock.unlock();
+    bool shutdown_now = shutdown_;
+    std::vector<fml::closure> thread_tasks;
+
+    if (queue.has_thread_tasks) {
+      std::unique_lock lock = LockQueue(queue);
+      std::swap(thread_tasks, queue.thread_tasks);
+      queue.has_thread_tasks = false;
+    }
 
     TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
     // Execute the primary task we woke up for.
     if (task) {
+      tasks_executed_.fetch_add(1u, std::memory_order_relaxed);
       ExecuteTask(task);
     }
 
@@ -117,9 +208,11 @@ void ConcurrentMessageLoop::ExecuteTask(const fml::closure& task) {
 }
 
 void ConcurrentMessageLoop::Terminate() {
-  std::scoped_lock lock(tasks_mutex_);
-  shutdown_ = true;
-  tasks_condition_.notify_all();
+  {
+    std::scoped_lock lock(sleep_mutex_);
+    shutdown_ = true;
+  }
+  sleep_condition_.notify_all();
 }
 
 void ConcurrentMessageLoop::PostTaskToAllWorkers(const fml::closure& task) {
@@ -127,24 +220,20 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(const fml::closure& task) {
     return;
   }
 
-  std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    thread_tasks_[worker_thread_id].emplace_back(task);
+  for (const auto& queue : queues_) {
+    std::unique_lock lock = LockQueue(*queue);
+    queue->thread_tasks.emplace_back(task);
+    queue->has_thread_tasks = true;
   }
-  tasks_condition_.notify_all();
+  WakeWorkers(/*all=*/true);
 }
 
-bool ConcurrentMessageLoop::HasThreadTasksLocked() const {
-  return thread_tasks_.count(std::this_thread::get_id()) > 0;
-}
-
-std::vector<fml::closure> ConcurrentMessageLoop::GetThreadTasksLocked() {
-  auto found = thread_tasks_.find(std::this_thread::get_id());
-  FML_DCHECK(found != thread_tasks_.end());
-  std::vector<fml::closure> pending_tasks;
-  std::swap(pending_tasks, found->second);
-  thread_tasks_.erase(found);
-  return pending_tasks;
+ConcurrentMessageLoop::Stats ConcurrentMessageLoop::GetStats() const {
+  return Stats{
+      .tasks_executed = tasks_executed_.load(std::memory_order_relaxed),
+      .tasks_stolen = tasks_stolen_.load(std::memory_order_relaxed),
+      .lock_contentions = lock_contentions_.load(std::memory_order_relaxed),
+  };
 }
 
 ConcurrentTaskRunner::ConcurrentTaskRunner(
@@ -154,12 +243,17 @@ ConcurrentTaskRunner::ConcurrentTaskRunner(
 ConcurrentTaskRunner::~ConcurrentTaskRunner() = default;
 
 void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
+  PostTask(task, ConcurrentTaskPriority::kNormal);
+}
+
+void ConcurrentTaskRunner::PostTask(const fml::closure& task,
+                                    ConcurrentTaskPriority priority) {
   if (!task) {
     return;
   }
 
   if (auto loop = weak_loop_.lock()) {
-    loop->PostTask(task);
+    loop->PostTask(task, priority);
     return;
   }
 
@@ -170,13 +264,7 @@ void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
 }
 
 bool ConcurrentMessageLoop::RunsTasksOnCurrentThread() {
-  std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    if (worker_thread_id == std::this_thread::get_id()) {
-      return true;
-    }
-  }
-  return false;
+  return tls_worker_loop == this;
 }
 
 }  // namespace fml
@@ -5,10 +5,13 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <atomic>
 #include <condition_variable>
-#include <map>
-#include <queue>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -18,6 +21,21 @@ namespace fml {
 
 class ConcurrentTaskRunner;
 
+/// The relative priority of a task posted to a |ConcurrentMessageLoop|.
+///
+/// Idle workers look for the highest priority task across the queues of all
+/// workers before they consider a task of a lower priority. Tasks of the same
+/// priority are not ordered with respect to each other.
+enum class ConcurrentTaskPriority {
+  /// Work that the raster thread may be waiting on, such as pipeline
+  /// compilation.
+  kHigh,
+  /// The default priority.
+  kNormal,
+  /// Work that is not time critical, such as image decoding.
+  kLow,
+};
+
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
@@ -36,6 +54,21 @@ class ConcurrentMessageLoop
 
   bool RunsTasksOnCurrentThread();
 
+  struct Stats {
+    /// The number of tasks run by the workers.
+    size_t tasks_executed = 0u;
+
+    /// The number of tasks a worker took from the queue of another worker.
+    size_t tasks_stolen = 0u;
+
+    /// The number of times a thread found the lock of a worker queue held by
+    /// another thread and had to wait for it.
+    size_t lock_contentions = 0u;
+  };
+
+  /// @brief Returns a snapshot of the scheduling counters of this loop.
+  Stats GetStats() const;
+
  protected:
   explicit ConcurrentMessageLoop(size_t worker_count);
   virtual void ExecuteTask(const fml::closure& task);
@@ -43,22 +76,53 @@ class ConcurrentMessageLoop
  private:
   friend ConcurrentTaskRunner;
 
+  static constexpr size_t kPriorityCount = 3u;
+
+  // The tasks owned by one worker. The worker takes tasks from the front of
+  // its own queues, idle workers steal from the back.
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<fml::closure> tasks[kPriorityCount];
+    // The sizes of |tasks|, readable without the lock so that idle workers
+    // can skip empty queues.
+    std::atomic<size_t> task_counts[kPriorityCount] = {};
+    std::vector<fml::closure> thread_tasks;
+    std::atomic<bool> has_thread_tasks = false;
+  };
+
   size_t worker_count_ = 0;
   std::vector<std::thread> workers_;
-  std::mutex tasks_mutex_;
-  std::condition_variable tasks_condition_;
-  std::queue<fml::closure> tasks_;
-  std::vector<std::thread::id> worker_thread_ids_;
-  std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
-  bool shutdown_ = false;
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+
+  // The number of queued tasks of each priority across all worker queues.
+  std::atomic<size_t> pending_tasks_[kPriorityCount] = {};
+  // Tasks posted from outside the loop are spread over the worker queues.
+  std::atomic<size_t> next_queue_ = 0u;
+
+  // Guards sleeping workers. Posting only acquires it when a worker is
+  // asleep.
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_condition_;
+  std::atomic<size_t> sleeping_workers_ = 0u;
+  std::atomic<bool> shutdown_ = false;
+
+  std::atomic<size_t> tasks_executed_ = 0u;
+  std::atomic<size_t> tasks_stolen_ = 0u;
+  std::atomic<size_t> lock_contentions_ = 0u;
 
-  void WorkerMain();
+  void WorkerMain(size_t index);
 
-  void PostTask(const fml::closure& task);
+  void PostTask(const fml::closure& task, ConcurrentTaskPriority priority);
 
-  bool HasThreadTasksLocked() const;
+  bool HasPendingTasks() const;
 
-  std::vector<fml::closure> GetThreadTasksLocked();
+  // Takes the highest priority task available to the worker at |index|,
+  // from its own queue if possible and from another worker otherwise.
+  fml::closure TakeTask(size_t index);
+
+  std::unique_lock<std::mutex> LockQueue(WorkerQueue& queue);
+
+  void WakeWorkers(bool all);
 
   FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentMessageLoop);
 };
@@ -71,6 +135,10 @@ class ConcurrentTaskRunner : public BasicTaskRunner {
 
   void PostTask(const fml::closure& task) override;
 
+  /// @brief Posts a task with the given priority. |PostTask| without a
+  ///        priority uses |ConcurrentTaskPriority::kNormal|.
+  void PostTask(const fml::closure& task, ConcurrentTaskPriority priority);
+
  private:
   friend ConcurrentMessageLoop;
 
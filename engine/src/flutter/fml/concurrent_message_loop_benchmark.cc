@@ -0,0 +1,136 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+
+namespace fml {
+namespace benchmarking {
+
+static constexpr size_t kTasksPerIteration = 10000u;
+
+// A small amount of work per task so that the benchmark measures the
+// scheduler rather than the tasks.
+static void SpinTask(std::atomic<size_t>& sink) {
+  size_t value = 0u;
+  for (size_t i = 0; i < 64; i++) {
+    value += i * i;
+  }
+  sink.fetch_add(value, std::memory_order_relaxed);
+}
+
+static void ReportStats(benchmark::State& state,
+                        const ConcurrentMessageLoop::Stats& stats) {
+  state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+  state.counters["Stolen"] =
+      benchmark::Counter(static_cast<double>(stats.tasks_stolen),
+                         benchmark::Counter::kAvgIterations);
+  state.counters["Contentions"] =
+      benchmark::Counter(static_cast<double>(stats.lock_contentions),
+                         benchmark::Counter::kAvgIterations);
+}
+
+// Posts all tasks from the benchmark thread, as the raster and IO threads
+// do when they hand work to the workers.
+static void BM_ConcurrentMessageLoopSingleProducer(
+    benchmark::State& state) {  // NOLINT
+  auto loop = ConcurrentMessageLoop::Create(state.range(0));
+  auto task_runner = loop->GetTaskRunner();
+  std::atomic<size_t> sink = 0u;
+
+  for (auto _ : state) {
+    CountDownLatch latch(kTasksPerIteration);
+    for (size_t i = 0; i < kTasksPerIteration; i++) {
+      task_runner->PostTask([&sink, &latch]() {
+        SpinTask(sink);
+        latch.CountDown();
+      });
+    }
+    latch.Wait();
+  }
+
+  ReportStats(state, loop->GetStats());
+}
+
+// Posts the tasks from as many threads as there are workers.
+static void BM_ConcurrentMessageLoopMultiProducer(
+    benchmark::State& state) {  // NOLINT
+  const size_t worker_count = state.range(0);
+  auto loop = ConcurrentMessageLoop::Create(worker_count);
+  auto task_runner = loop->GetTaskRunner();
+  std::atomic<size_t> sink = 0u;
+
+  for (auto _ : state) {
+    CountDownLatch latch(kTasksPerIteration);
+    std::vector<std::thread> producers;
+    producers.reserve(worker_count);
+    for (size_t p = 0; p < worker_count; p++) {
+      producers.emplace_back([&, p]() {
+        for (size_t i = p; i < kTasksPerIteration; i += worker_count) {
+          task_runner->PostTask([&sink, &latch]() {
+            SpinTask(sink);
+            latch.CountDown();
+          });
+        }
+      });
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    latch.Wait();
+  }
+
+  ReportStats(state, loop->GetStats());
+}
+
+// Each task posted from outside the loop fans out into more tasks posted
+// from the workers, which is where stealing balances the load.
+static void BM_ConcurrentMessageLoopNestedPosts(
+    benchmark::State& state) {  // NOLINT
+  static constexpr size_t kFanOut = 10u;
+  auto loop = ConcurrentMessageLoop::Create(state.range(0));
+  auto task_runner = loop->GetTaskRunner();
+  std::atomic<size_t> sink = 0u;
+
+  for (auto _ : state) {
+    CountDownLatch latch(kTasksPerIteration);
+    for (size_t i = 0; i < kTasksPerIteration / kFanOut; i++) {
+      task_runner->PostTask([&sink, &latch, task_runner]() {
+        for (size_t j = 1; j < kFanOut; j++) {
+          task_runner->PostTask([&sink, &latch]() {
+            SpinTask(sink);
+            latch.CountDown();
+          });
+        }
+        SpinTask(sink);
+        latch.CountDown();
+      });
+    }
+    latch.Wait();
+  }
+
+  ReportStats(state, loop->GetStats());
+}
+
+BENCHMARK(BM_ConcurrentMessageLoopSingleProducer)
+    ->RangeMultiplier(2)
+    ->Range(2, 16)
+    ->UseRealTime();
+BENCHMARK(BM_ConcurrentMessageLoopMultiProducer)
+    ->RangeMultiplier(2)
+    ->Range(2, 16)
+    ->UseRealTime();
+BENCHMARK(BM_ConcurrentMessageLoopNestedPosts)
+    ->RangeMultiplier(2)
+    ->Range(2, 16)
+    ->UseRealTime();
+
+}  // namespace benchmarking
+}  // namespace fml
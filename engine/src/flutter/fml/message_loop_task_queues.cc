@@ -35,6 +35,36 @@ class TaskSourceGradeHolder {
 static thread_local std::unique_ptr<TaskSourceGradeHolder>
     tls_task_source_grade;
 
+/// Locks the entries of the group of merged task queues that contains a
+/// task queue: the owner of the group first, then the queues it subsumes in
+/// ascending order. A queue that is not merged is a group of its own.
+///
+/// The caller must hold the registry lock, which keeps the membership of
+/// the group stable while the locks are held.
+class MessageLoopTaskQueues::GroupLock {
+ public:
+  GroupLock(const MessageLoopTaskQueues& queues, TaskQueueId queue_id) {
+    const auto& entry = queues.queue_entries_.at(queue_id);
+    owner_ = entry->subsumed_by == kUnmerged ? queue_id : entry->subsumed_by;
+    const auto& owner_entry = queues.queue_entries_.at(owner_);
+    owner_lock_ = std::unique_lock(owner_entry->mutex);
+    subsumed_locks_.reserve(owner_entry->owner_of.size());
+    for (TaskQueueId subsumed : owner_entry->owner_of) {
+      subsumed_locks_.emplace_back(queues.queue_entries_.at(subsumed)->mutex);
+    }
+  }
+
+  /// The queue that owns the group.
+  TaskQueueId owner() const { return owner_; }
+
+ private:
+  TaskQueueId owner_ = kUnmerged;
+  std::unique_lock<std::mutex> owner_lock_;
+  std::vector<std::unique_lock<std::mutex>> subsumed_locks_;
+
+  FML_DISALLOW_COPY_ASSIGN_AND_MOVE(GroupLock);
+};
+
 TaskQueueEntry::TaskQueueEntry(TaskQueueId created_for_arg)
     : subsumed_by(kUnmerged), created_for(created_for_arg) {
   wakeable = NULL;
@@ -48,7 +78,7 @@ MessageLoopTaskQueues* MessageLoopTaskQueues::GetInstance() {
 }
 
 TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
-  std::lock_guard guard(queue_mutex_);
+  std::unique_lock registry_lock(registry_mutex_);
   TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_);
   ++task_queue_id_counter_;
   queue_entries_[loop_id] = std::make_unique<TaskQueueEntry>(loop_id);
@@ -63,7 +93,7 @@ MessageLoopTaskQueues::MessageLoopTaskQueues() : order_(0) {
 MessageLoopTaskQueues::~MessageLoopTaskQueues() = default;
 
 void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
+  std::unique_lock registry_lock(registry_mutex_);
   const auto& queue_entry = queue_entries_.at(queue_id);
   FML_DCHECK(queue_entry->subsumed_by == kUnmerged);
   auto& subsumed_set = queue_entry->owner_of;
@@ -75,7 +105,8 @@ void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
 }
 
 void MessageLoopTaskQueues::DisposeTasks(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
+  std::shared_lock registry_lock(registry_mutex_);
+  GroupLock group_lock(*this, queue_id);
   const auto& queue_entry = queue_entries_.at(queue_id);
   FML_DCHECK(queue_entry->subsumed_by == kUnmerged);
   auto& subsumed_set = queue_entry->owner_of;
@@ -94,15 +125,13 @@ void MessageLoopTaskQueues::RegisterTask(
     const fml::closure& task,
     fml::TimePoint target_time,
     fml::TaskSourceGrade task_source_grade) {
-  std::lock_guard guard(queue_mutex_);
+  std::shared_lock registry_lock(registry_mutex_);
+  GroupLock group_lock(*this, queue_id);
   size_t order = order_++;
   const auto& queue_entry = queue_entries_.at(queue_id);
   queue_entry->task_source->RegisterTask(
       {order, task, target_time, task_source_grade});
-  TaskQueueId loop_to_wake = queue_id;
-  if (queue_entry->subsumed_by != kUnmerged) {
-    loop_to_wake = queue_entry->subsumed_by;
-  }
+  TaskQueueId loop_to_wake = group_lock.owner();
 
   // This can happen when the secondary tasks are paused.
   if (HasPendingTasksUnlocked(loop_to_wake)) {
@@ -111,13 +140,15 @@ void MessageLoopTaskQueues::RegisterTask(
 }
 
 bool MessageLoopTaskQueues::HasPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  std::shared_lock registry_lock(registry_mutex_);
+  GroupLock group_lock(*this, queue_id);
   return HasPendingTasksUnlocked(queue_id);
 }
 
 fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
                                                      fml::TimePoint from_time) {
-  std::lock_guard guard(queue_mutex_);
+  std::shared_lock registry_lock(registry_mutex_);
+  GroupLock group_lock(*this, queue_id);
   if (!HasPendingTasksUnlocked(queue_id)) {
     return nullptr;
   }
@@ -147,7 +178,8 @@ void MessageLoopTaskQueues::WakeUpUnlocked(TaskQueueId queue_id,
 }
 
 size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  std::shared_lock registry_lock(registry_mutex_);
+  GroupLock group_lock(*this, queue_id);
   const auto& queue_entry = queue_entries_.at(queue_id);
   if (queue_entry->subsumed_by != kUnmerged) {
     return 0;
@@ -167,20 +199,23 @@ size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
 void MessageLoopTaskQueues::AddTaskObserver(TaskQueueId queue_id,
                                             intptr_t key,
                                             const fml::closure& callback) {
-  std::lock_guard guard(queue_mutex_);
+  std::shared_lock registry_lock(registry_mutex_);
+  std::scoped_lock entry_lock(queue_entries_.at(queue_id)->mutex);
   FML_DCHECK(callback != nullptr) << "Observer callback must be non-null.";
   queue_entries_.at(queue_id)->task_observers[key] = callback;
 }
 
 void MessageLoopTaskQueues::RemoveTaskObserver(TaskQueueId queue_id,
                                                intptr_t key) {
-  std::lock_guard guard(queue_mutex_);
+  std::shared_lock registry_lock(registry_mutex_);
+  std::scoped_lock entry_lock(queue_entries_.at(queue_id)->mutex);
   queue_entries_.at(queue_id)->task_observers.erase(key);
 }
 
 std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
     TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  std::shared_lock registry_lock(registry_mutex_);
+  GroupLock group_lock(*this, queue_id);
   std::vector<fml::closure> observers;
 
   if (queue_entries_.at(queue_id)->subsumed_by != kUnmerged) {
@@ -203,7 +238,8 @@ std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
 
 void MessageLoopTaskQueues::SetWakeable(TaskQueueId queue_id,
                                         fml::Wakeable* wakeable) {
-  std::lock_guard guard(queue_mutex_);
+  std::shared_lock registry_lock(registry_mutex_);
+  std::scoped_lock entry_lock(queue_entries_.at(queue_id)->mutex);
   FML_CHECK(!queue_entries_.at(queue_id)->wakeable)
       << "Wakeable can only be set once.";
   queue_entries_.at(queue_id)->wakeable = wakeable;
@@ -213,7 +249,7 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   if (owner == subsumed) {
     return true;
   }
-  std::lock_guard guard(queue_mutex_);
+  std::unique_lock registry_lock(registry_mutex_);
   auto& owner_entry = queue_entries_.at(owner);
   auto& subsumed_entry = queue_entries_.at(subsumed);
   auto& subsumed_set = owner_entry->owner_of;
@@ -261,7 +297,7 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
 }
 
 bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
-  std::lock_guard guard(queue_mutex_);
+  std::unique_lock registry_lock(registry_mutex_);
   const auto& owner_entry = queue_entries_.at(owner);
   if (owner_entry->owner_of.empty()) {
     FML_LOG(WARNING)
@@ -305,7 +341,7 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
 
 bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
                                  TaskQueueId subsumed) const {
-  std::lock_guard guard(queue_mutex_);
+  std::shared_lock registry_lock(registry_mutex_);
   if (owner == kUnmerged || subsumed == kUnmerged) {
     return false;
   }
@@ -315,17 +351,19 @@ bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
 
 std::set<TaskQueueId> MessageLoopTaskQueues::GetSubsumedTaskQueueId(
     TaskQueueId owner) const {
-  std::lock_guard guard(queue_mutex_);
+  std::shared_lock registry_lock(registry_mutex_);
   return queue_entries_.at(owner)->owner_of;
 }
 
 void MessageLoopTaskQueues::PauseSecondarySource(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
+  std::shared_lock registry_lock(registry_mutex_);
+  GroupLock group_lock(*this, queue_id);
   queue_entries_.at(queue_id)->task_source->PauseSecondary();
 }
 
 void MessageLoopTaskQueues::ResumeSecondarySource(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
+  std::shared_lock registry_lock(registry_mutex_);
+  GroupLock group_lock(*this, queue_id);
   queue_entries_.at(queue_id)->task_source->ResumeSecondary();
   // Schedule a wake as needed.
   if (HasPendingTasksUnlocked(queue_id)) {
@@ -5,10 +5,12 @@
 #ifndef FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 #define FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <shared_mutex>
 #include <vector>
 
 #include "flutter/fml/closure.h"
@@ -45,6 +47,11 @@ class TaskQueueEntry {
 
   TaskQueueId created_for;
 
+  /// Guards |wakeable|, |task_observers| and |task_source|. The merge state in
+  /// |owner_of| and |subsumed_by| is guarded by the registry lock of
+  /// \p fml::MessageLoopTaskQueues instead.
+  std::mutex mutex;
+
   explicit TaskQueueEntry(TaskQueueId created_for);
 
  private:
@@ -138,11 +145,15 @@ class MessageLoopTaskQueues {
 
  private:
   class MergedQueuesRunner;
+  class GroupLock;
 
   MessageLoopTaskQueues();
 
   ~MessageLoopTaskQueues();
 
+  // The methods suffixed with Unlocked expect the caller to hold the registry
+  // lock, and a |GroupLock| for the queues whose tasks they touch.
+
   void WakeUpUnlocked(TaskQueueId queue_id, fml::TimePoint time) const;
 
   bool HasPendingTasksUnlocked(TaskQueueId queue_id) const;
@@ -151,7 +162,11 @@ class MessageLoopTaskQueues {
 
   fml::TimePoint GetNextWakeTimeUnlocked(TaskQueueId queue_id) const;
 
-  mutable std::mutex queue_mutex_;
+  // Guards |queue_entries_| and the merge state of the entries. Creating,
+  // disposing, merging and unmerging queues take it exclusively. Everything
+  // else takes it shared and then locks only the entries it touches, so
+  // threads working on unrelated queues do not contend.
+  mutable std::shared_mutex registry_mutex_;
   std::map<TaskQueueId, std::unique_ptr<TaskQueueEntry>> queue_entries_;
 
   size_t task_queue_id_counter_ = 0;
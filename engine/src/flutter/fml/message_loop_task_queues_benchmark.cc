@@ -66,5 +66,99 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
 
 BENCHMARK(BM_RegisterAndGetTasks);
 
+// Measures contention when several threads post to the same queue while its
+// owner drains it, as happens when multiple task runners post to the
+// platform thread.
+static void BM_RegisterTasksToSharedQueue(
+    benchmark::State& state) {  // NOLINT
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  const TaskQueueId queue_id = task_queues->CreateTaskQueue();
+  const int num_producers = state.range(0);
+  const int num_tasks_per_producer = 1000;
+  const fml::TimePoint past = fml::TimePoint::Now();
+
+  while (state.KeepRunning()) {
+    std::vector<std::thread> producers;
+    producers.reserve(num_producers);
+    for (int i = 0; i < num_producers; i++) {
+      producers.emplace_back([&]() {
+        for (int j = 0; j < num_tasks_per_producer; j++) {
+          task_queues->RegisterTask(queue_id, [] {}, past);
+        }
+      });
+    }
+
+    int num_invocations = 0;
+    while (num_invocations < num_producers * num_tasks_per_producer) {
+      if (task_queues->GetNextTaskToRun(queue_id, fml::TimePoint::Now())) {
+        num_invocations++;
+      }
+    }
+
+    for (auto& producer : producers) {
+      producer.join();
+    }
+  }
+
+  task_queues->Dispose(queue_id);
+  state.SetItemsProcessed(state.iterations() * num_producers *
+                          num_tasks_per_producer);
+}
+
+BENCHMARK(BM_RegisterTasksToSharedQueue)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+
+// Measures posting to independent queues from one thread each. Queues that
+// are not merged do not share a lock, so this should scale with the number
+// of threads.
+static void BM_RegisterTasksToSeparateQueues(
+    benchmark::State& state) {  // NOLINT
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  const int num_queues = state.range(0);
+  const int num_tasks_per_queue = 1000;
+  const fml::TimePoint past = fml::TimePoint::Now();
+
+  std::vector<TaskQueueId> queue_ids;
+  for (int i = 0; i < num_queues; i++) {
+    queue_ids.push_back(task_queues->CreateTaskQueue());
+  }
+
+  while (state.KeepRunning()) {
+    std::vector<std::thread> threads;
+    threads.reserve(num_queues);
+    for (TaskQueueId queue_id : queue_ids) {
+      threads.emplace_back([&task_queues, queue_id, past]() {
+        for (int j = 0; j < num_tasks_per_queue; j++) {
+          task_queues->RegisterTask(queue_id, [] {}, past);
+        }
+        const auto now = fml::TimePoint::Now();
+        while (task_queues->GetNextTaskToRun(queue_id, now)) {
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  for (TaskQueueId queue_id : queue_ids) {
+    task_queues->Dispose(queue_id);
+  }
+  state.SetItemsProcessed(state.iterations() * num_queues *
+                          num_tasks_per_queue);
+}
+
+BENCHMARK(BM_RegisterTasksToSeparateQueues)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+
 }  // namespace benchmarking
 }  // namespace fml
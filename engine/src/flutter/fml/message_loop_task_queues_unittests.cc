@@ -406,6 +406,57 @@ TEST(MessageLoopTaskQueue, ConcurrentQueueAndTaskCreatingCounts) {
   ASSERT_EQ(pending_tasks, kThreadCount * kThreadTaskCount);
 }
 
+TEST(MessageLoopTaskQueue, ConcurrentRegisterAndRunWhileMerging) {
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  auto platform_queue = task_queues->CreateTaskQueue();
+  auto raster_queue = task_queues->CreateTaskQueue();
+
+  // Two producers post to each queue while the queues are merged and
+  // unmerged repeatedly. Every task must run exactly once, no matter which
+  // queue ends up draining it.
+  constexpr size_t kProducersPerQueue = 2;
+  constexpr size_t kTasksPerProducer = 500;
+  constexpr size_t kTotalTasks = 2 * kProducersPerQueue * kTasksPerProducer;
+  std::atomic<size_t> tasks_run = 0u;
+
+  std::vector<std::thread> producers;
+  for (TaskQueueId queue_id : {platform_queue, raster_queue}) {
+    for (size_t i = 0; i < kProducersPerQueue; i++) {
+      producers.emplace_back([&, queue_id]() {
+        for (size_t j = 0; j < kTasksPerProducer; j++) {
+          task_queues->RegisterTask(
+              queue_id, [&tasks_run]() { tasks_run++; },
+              ChronoTicksSinceEpoch());
+        }
+      });
+    }
+  }
+
+  std::thread merger([&]() {
+    while (tasks_run < kTotalTasks) {
+      task_queues->Merge(platform_queue, raster_queue);
+      task_queues->Unmerge(platform_queue, raster_queue);
+    }
+  });
+
+  while (tasks_run < kTotalTasks) {
+    for (TaskQueueId queue_id : {platform_queue, raster_queue}) {
+      const auto now = ChronoTicksSinceEpoch();
+      while (auto invocation = task_queues->GetNextTaskToRun(queue_id, now)) {
+        invocation();
+      }
+    }
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  merger.join();
+  ASSERT_EQ(tasks_run, kTotalTasks);
+  ASSERT_FALSE(task_queues->HasPendingTasks(platform_queue));
+  ASSERT_FALSE(task_queues->HasPendingTasks(raster_queue));
+}
+
 TEST(MessageLoopTaskQueue, RegisterTaskWakesUpOwnerQueue) {
   auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
   auto platform_queue = task_queue->CreateTaskQueue();
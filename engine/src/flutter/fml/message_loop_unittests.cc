@@ -212,3 +212,76 @@ TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   latch.Wait();
   ASSERT_GE(thread_ids.size(), 1u);
 }
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsHigherPriorityTasksFirst) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1u);
+  auto task_runner = loop->GetTaskRunner();
+  fml::AutoResetWaitableEvent worker_blocked;
+  fml::AutoResetWaitableEvent unblock_worker;
+  fml::CountDownLatch latch(3u);
+  std::mutex order_mutex;
+  std::vector<int> order;
+  auto record = [&](int value) {
+    return [&, value]() {
+      {
+        std::scoped_lock lock(order_mutex);
+        order.push_back(value);
+      }
+      latch.CountDown();
+    };
+  };
+
+  task_runner->PostTask([&]() {
+    worker_blocked.Signal();
+    unblock_worker.Wait();
+  });
+  worker_blocked.Wait();
+  task_runner->PostTask(record(3), fml::ConcurrentTaskPriority::kLow);
+  task_runner->PostTask(record(2), fml::ConcurrentTaskPriority::kNormal);
+  task_runner->PostTask(record(1), fml::ConcurrentTaskPriority::kHigh);
+  unblock_worker.Signal();
+  latch.Wait();
+
+  ASSERT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopIdleWorkersStealTasks) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4u);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t kCount = 64u;
+  fml::CountDownLatch latch(kCount);
+  // All of these tasks are posted to the queue of the worker that runs the
+  // outer task. Unless the other workers steal them, they run serially.
+  task_runner->PostTask([&]() {
+    ASSERT_TRUE(loop->RunsTasksOnCurrentThread());
+    for (size_t i = 0; i < kCount; ++i) {
+      task_runner->PostTask([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        latch.CountDown();
+      });
+    }
+  });
+  latch.Wait();
+
+  fml::ConcurrentMessageLoop::Stats stats = loop->GetStats();
+  ASSERT_EQ(stats.tasks_executed, kCount + 1u);
+  ASSERT_GT(stats.tasks_stolen, 0u);
+  ASSERT_FALSE(loop->RunsTasksOnCurrentThread());
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsTasksOnAllWorkers) {
+  const size_t kWorkers = 4u;
+  auto loop = fml::ConcurrentMessageLoop::Create(kWorkers);
+  fml::CountDownLatch latch(kWorkers);
+  std::mutex thread_ids_mutex;
+  std::set<std::thread::id> thread_ids;
+  loop->PostTaskToAllWorkers([&]() {
+    {
+      std::scoped_lock lock(thread_ids_mutex);
+      thread_ids.insert(std::this_thread::get_id());
+    }
+    latch.CountDown();
+  });
+  latch.Wait();
+  ASSERT_EQ(thread_ids.size(), kWorkers);
+}
@@ -11,6 +11,18 @@ struct Flags {
   bool antialiased_lines = false;
   /// Use SDFs for rendering.
   bool use_sdfs = false;
+  /// Tessellate filled paths on the concurrent worker threads of the
+  /// context, when it has any, before dispatching a DisplayList.
+  bool parallel_path_tessellation = false;
+  /// Cache the tessellations of curved filled paths by their contents and
+  /// persist them in the caches directory across launches.
+  bool tessellation_cache = false;
+  /// Record the draws of large Vulkan render passes into secondary command
+  /// buffers on the concurrent worker threads of the context.
+  bool parallel_render_pass_encoding = false;
+  /// Record the pipeline variants created on demand and compile them ahead
+  /// of their first use on the next launch.
+  bool pipeline_variant_warm_up = false;
 };
 }  // namespace impeller
 
@@ -4,9 +4,11 @@
 
 #include "impeller/core/host_buffer.h"
 
+#include <algorithm>
 #include <cstring>
 #include <tuple>
 
+#include "flutter/fml/trace_event.h"
 #include "impeller/base/validation.h"
 #include "impeller/core/allocator.h"
 #include "impeller/core/buffer_view.h"
@@ -16,8 +18,21 @@
 
 namespace impeller {
 
+/// Emplacements larger than this are given a device buffer of their own.
 constexpr size_t kAllocatorBlockSize = 1024000;  // 1024 Kb.
 
+/// The bounds of the adaptive block size.
+constexpr size_t kMinimumBlockSize = 64u * 1024u;
+constexpr size_t kMaximumBlockSize = 4u * 1024u * 1024u;
+
+static size_t ComputeBlockSize(size_t high_water_mark) {
+  size_t block_size = kMinimumBlockSize;
+  while (block_size < high_water_mark && block_size < kMaximumBlockSize) {
+    block_size *= 2;
+  }
+  return block_size;
+}
+
 std::shared_ptr<HostBuffer> HostBuffer::Create(
     const std::shared_ptr<Allocator>& allocator,
     const std::shared_ptr<const IdleWaiter>& idle_waiter,
@@ -32,13 +47,12 @@ HostBuffer::HostBuffer(const std::shared_ptr<Allocator>& allocator,
     : allocator_(allocator),
       idle_waiter_(idle_waiter),
       minimum_uniform_alignment_(minimum_uniform_alignment) {
-  DeviceBufferDescriptor desc;
-  desc.size = kAllocatorBlockSize;
-  desc.storage_mode = StorageMode::kHostVisible;
+  metrics_.block_size = kAllocatorBlockSize;
   for (auto i = 0u; i < kHostBufferArenaSize; i++) {
-    std::shared_ptr<DeviceBuffer> device_buffer = allocator->CreateBuffer(desc);
+    std::shared_ptr<DeviceBuffer> device_buffer =
+        CreateBlock(metrics_.block_size);
     FML_CHECK(device_buffer) << "Failed to allocate device buffer.";
-    device_buffers_[i].push_back(device_buffer);
+    device_buffers_[i].push_back(Block{.buffer = std::move(device_buffer)});
   }
 }
 
@@ -98,19 +112,59 @@ HostBuffer::TestStateQuery HostBuffer::GetStateForTest() {
   };
 }
 
-bool HostBuffer::MaybeCreateNewBuffer() {
+HostBuffer::Metrics HostBuffer::GetMetrics() const {
+  Metrics metrics = metrics_;
+  for (const std::vector<Block>& arena : device_buffers_) {
+    for (const Block& block : arena) {
+      metrics.retained_bytes += block.buffer->GetDeviceBufferDescriptor().size;
+    }
+  }
+  return metrics;
+}
+
+std::shared_ptr<DeviceBuffer> HostBuffer::CreateBlock(size_t size) {
+  DeviceBufferDescriptor desc;
+  desc.size = size;
+  desc.storage_mode = StorageMode::kHostVisible;
+  std::shared_ptr<DeviceBuffer> buffer = allocator_->CreateBuffer(desc);
+  if (!buffer) {
+    VALIDATION_LOG << "Failed to allocate host buffer of size " << desc.size;
+    return nullptr;
+  }
+  metrics_.block_allocation_count++;
+  return buffer;
+}
+
+std::shared_ptr<DeviceBuffer> HostBuffer::CreateOneOffBuffer(size_t length) {
+  DeviceBufferDescriptor desc;
+  desc.size = length;
+  desc.storage_mode = StorageMode::kHostVisible;
+  metrics_.one_off_allocation_count++;
+  return allocator_->CreateBuffer(desc);
+}
+
+bool HostBuffer::MaybeCreateNewBuffer(size_t min_size) {
+  std::vector<Block>& arena = device_buffers_[frame_index_];
   current_buffer_++;
-  if (current_buffer_ >= device_buffers_[frame_index_].size()) {
-    DeviceBufferDescriptor desc;
-    desc.size = kAllocatorBlockSize;
-    desc.storage_mode = StorageMode::kHostVisible;
-    std::shared_ptr<DeviceBuffer> buffer = allocator_->CreateBuffer(desc);
+  if (current_buffer_ >= arena.size() ||
+      arena[current_buffer_].buffer->GetDeviceBufferDescriptor().size <
+          min_size) {
+    // The blocks of this arena were last used kHostBufferArenaSize frames
+    // ago, so a block that is too small can be replaced.
+    std::shared_ptr<DeviceBuffer> buffer =
+        CreateBlock(std::max(metrics_.block_size, min_size));
     if (!buffer) {
-      VALIDATION_LOG << "Failed to allocate host buffer of size " << desc.size;
+      current_buffer_--;
       return false;
     }
-    device_buffers_[frame_index_].push_back(std::move(buffer));
+    if (current_buffer_ < arena.size()) {
+      arena[current_buffer_].buffer = std::move(buffer);
+    } else {
+      arena.push_back(Block{.buffer = std::move(buffer)});
+    }
   }
+  arena[current_buffer_].last_used_frame = frame_count_;
+  frame_bytes_used_ += offset_;
   offset_ = 0;
   return true;
 }
@@ -122,15 +176,13 @@ HostBuffer::EmplaceInternal(size_t length,
   if (!cb) {
     return {};
   }
+  metrics_.emplace_count++;
+  metrics_.bytes_emplaced += length;
 
   // If the requested allocation is bigger than the block size, create a one-off
   // device buffer and write to that.
   if (length > kAllocatorBlockSize) {
-    DeviceBufferDescriptor desc;
-    desc.size = length;
-    desc.storage_mode = StorageMode::kHostVisible;
-    std::shared_ptr<DeviceBuffer> device_buffer =
-        allocator_->CreateBuffer(desc);
+    std::shared_ptr<DeviceBuffer> device_buffer = CreateOneOffBuffer(length);
     if (!device_buffer) {
       return {};
     }
@@ -145,8 +197,8 @@ HostBuffer::EmplaceInternal(size_t length,
   if (align > 0 && offset_ % align) {
     padding = align - (offset_ % align);
   }
-  if (offset_ + padding + length > kAllocatorBlockSize) {
-    if (!MaybeCreateNewBuffer()) {
+  if (offset_ + padding + length > GetCurrentBlockSize()) {
+    if (!MaybeCreateNewBuffer(length)) {
       return {};
     }
   } else {
@@ -165,14 +217,13 @@ HostBuffer::EmplaceInternal(size_t length,
 
 std::tuple<Range, std::shared_ptr<DeviceBuffer>, DeviceBuffer*>
 HostBuffer::EmplaceInternal(const void* buffer, size_t length) {
+  metrics_.emplace_count++;
+  metrics_.bytes_emplaced += length;
+
   // If the requested allocation is bigger than the block size, create a one-off
   // device buffer and write to that.
   if (length > kAllocatorBlockSize) {
-    DeviceBufferDescriptor desc;
-    desc.size = length;
-    desc.storage_mode = StorageMode::kHostVisible;
-    std::shared_ptr<DeviceBuffer> device_buffer =
-        allocator_->CreateBuffer(desc);
+    std::shared_ptr<DeviceBuffer> device_buffer = CreateOneOffBuffer(length);
     if (!device_buffer) {
       return {};
     }
@@ -186,8 +237,8 @@ HostBuffer::EmplaceInternal(const void* buffer, size_t length) {
   }
 
   auto old_length = GetLength();
-  if (old_length + length > kAllocatorBlockSize) {
-    if (!MaybeCreateNewBuffer()) {
+  if (old_length + length > GetCurrentBlockSize()) {
+    if (!MaybeCreateNewBuffer(length)) {
       return {};
     }
   }
@@ -212,9 +263,9 @@ HostBuffer::EmplaceInternal(const void* buffer, size_t length, size_t align) {
 
   {
     auto padding = align - (GetLength() % align);
-    if (offset_ + padding < kAllocatorBlockSize) {
+    if (offset_ + padding < GetCurrentBlockSize()) {
       offset_ += padding;
-    } else if (!MaybeCreateNewBuffer()) {
+    } else if (!MaybeCreateNewBuffer(length)) {
       return {};
     }
   }
@@ -223,19 +274,60 @@ HostBuffer::EmplaceInternal(const void* buffer, size_t length, size_t align) {
 }
 
 const std::shared_ptr<DeviceBuffer>& HostBuffer::GetCurrentBuffer() const {
-  return device_buffers_[frame_index_][current_buffer_];
+  return device_buffers_[frame_index_][current_buffer_].buffer;
+}
+
+size_t HostBuffer::GetCurrentBlockSize() const {
+  return GetCurrentBuffer()->GetDeviceBufferDescriptor().size;
+}
+
+void HostBuffer::UpdateBlockSize() {
+  usage_history_[frame_count_ % kHostBufferUsageHistoryLength] =
+      frame_bytes_used_ + offset_;
+  metrics_.high_water_mark =
+      *std::max_element(usage_history_.begin(), usage_history_.end());
+  metrics_.block_size = ComputeBlockSize(metrics_.high_water_mark);
 }
 
 void HostBuffer::Reset() {
+  UpdateBlockSize();
+
   // When resetting the host buffer state at the end of the frame, check if
-  // there are any unused buffers and remove them.
-  while (device_buffers_[frame_index_].size() > current_buffer_ + 1) {
-    device_buffers_[frame_index_].pop_back();
+  // there are any buffers that have gone unused for a while and remove them.
+  // Blocks are used in order, so the last block is the least recently used.
+  std::vector<Block>& arena = device_buffers_[frame_index_];
+  while (arena.size() > current_buffer_ + 1 &&
+         frame_count_ - arena.back().last_used_frame >=
+             kHostBufferIdleFramesBeforeTrim) {
+    arena.pop_back();
+    metrics_.trimmed_block_count++;
   }
 
   offset_ = 0u;
   current_buffer_ = 0u;
+  frame_bytes_used_ = 0u;
+  frame_count_++;
   frame_index_ = (frame_index_ + 1) % kHostBufferArenaSize;
+
+  // The arena that is about to be reused was last used kHostBufferArenaSize
+  // frames ago. If its first block is far from the current block size,
+  // replace it so that light scenes give memory back and heavy scenes fit in
+  // fewer blocks.
+  Block& first_block = device_buffers_[frame_index_].front();
+  size_t first_block_size =
+      first_block.buffer->GetDeviceBufferDescriptor().size;
+  if (first_block_size > 2 * metrics_.block_size ||
+      2 * first_block_size < metrics_.block_size) {
+    if (std::shared_ptr<DeviceBuffer> buffer =
+            CreateBlock(metrics_.block_size)) {
+      first_block.buffer = std::move(buffer);
+    }
+  }
+
+  FML_TRACE_COUNTER("impeller", "HostBuffer",
+                    reinterpret_cast<int64_t>(this),  // Trace Counter ID
+                    "BlockSize", metrics_.block_size,
+                    "HighWaterMark", metrics_.high_water_mark);
 }
 
 size_t HostBuffer::GetMinimumUniformAlignment() const {
@@ -19,10 +19,20 @@ namespace impeller {
 /// Approximately the same size as the max frames in flight.
 static const constexpr size_t kHostBufferArenaSize = 4u;
 
-/// The host buffer class manages one more 1024 Kb blocks of device buffer
-/// allocations.
+/// The number of frames over which the peak usage of the host buffer is
+/// tracked to size its blocks.
+static const constexpr size_t kHostBufferUsageHistoryLength = 16u;
+
+/// The number of frames a block may go unused before it is released.
+static const constexpr size_t kHostBufferIdleFramesBeforeTrim = 16u;
+
+/// The host buffer class manages a ring of per-frame arenas, each made of one
+/// or more blocks of device buffer allocations.
 ///
-/// These are reset per-frame.
+/// These are reset per-frame. The size of the blocks follows the peak usage of
+/// recent frames, so that heavy scenes need few blocks per frame and light
+/// scenes do not hold on to large ones. Blocks that go unused for
+/// |kHostBufferIdleFramesBeforeTrim| frames are released.
 class HostBuffer {
  public:
   static std::shared_ptr<HostBuffer> Create(
@@ -125,6 +135,39 @@ class HostBuffer {
   ///        reused.
   void Reset();
 
+  struct Metrics {
+    /// The number of emplacements since the host buffer was created.
+    size_t emplace_count = 0u;
+
+    /// The number of bytes emplaced since the host buffer was created, not
+    /// counting alignment padding.
+    size_t bytes_emplaced = 0u;
+
+    /// The number of emplacements that were too large for a block and were
+    /// given a device buffer of their own.
+    size_t one_off_allocation_count = 0u;
+
+    /// The number of blocks that have been allocated.
+    size_t block_allocation_count = 0u;
+
+    /// The number of blocks that have been released after going unused.
+    size_t trimmed_block_count = 0u;
+
+    /// The size of newly allocated blocks.
+    size_t block_size = 0u;
+
+    /// The most bytes of blocks used by a single frame within the last
+    /// |kHostBufferUsageHistoryLength| frames.
+    size_t high_water_mark = 0u;
+
+    /// The total size of the blocks held by all arenas.
+    size_t retained_bytes = 0u;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief Retrieve the allocation counters of the host buffer.
+  Metrics GetMetrics() const;
+
   /// Test only internal state.
   struct TestStateQuery {
     size_t current_frame;
@@ -145,16 +188,32 @@ class HostBuffer {
   std::tuple<Range, std::shared_ptr<DeviceBuffer>, DeviceBuffer*>
   EmplaceInternal(const void* buffer, size_t length, size_t align);
 
+  struct Block {
+    std::shared_ptr<DeviceBuffer> buffer;
+    size_t last_used_frame = 0u;
+  };
+
   size_t GetLength() const { return offset_; }
 
-  /// Attempt to create a new internal buffer if the existing capacity is not
-  /// sufficient.
+  /// Move on to the next block of the current arena, creating it if the arena
+  /// does not have a block of at least |min_size| bytes there.
   ///
   /// A false return value indicates an unrecoverable allocation failure.
-  [[nodiscard]] bool MaybeCreateNewBuffer();
+  [[nodiscard]] bool MaybeCreateNewBuffer(size_t min_size);
+
+  std::shared_ptr<DeviceBuffer> CreateBlock(size_t size);
 
   const std::shared_ptr<DeviceBuffer>& GetCurrentBuffer() const;
 
+  size_t GetCurrentBlockSize() const;
+
+  /// Returns the one-off device buffer for an emplacement that is too large
+  /// for a block.
+  std::shared_ptr<DeviceBuffer> CreateOneOffBuffer(size_t length);
+
+  /// Recompute the block size from the usage of the frame that just ended.
+  void UpdateBlockSize();
+
   [[nodiscard]] BufferView Emplace(const void* buffer, size_t length);
 
   explicit HostBuffer(const std::shared_ptr<Allocator>& allocator,
@@ -167,12 +226,18 @@ class HostBuffer {
 
   std::shared_ptr<Allocator> allocator_;
   std::shared_ptr<const IdleWaiter> idle_waiter_;
-  std::array<std::vector<std::shared_ptr<DeviceBuffer>>, kHostBufferArenaSize>
-      device_buffers_;
+  std::array<std::vector<Block>, kHostBufferArenaSize> device_buffers_;
   size_t current_buffer_ = 0u;
   size_t offset_ = 0u;
   size_t frame_index_ = 0u;
   size_t minimum_uniform_alignment_ = 0u;
+
+  // The number of frames that have been reset.
+  size_t frame_count_ = 0u;
+  // The bytes of blocks used by the current frame, including padding.
+  size_t frame_bytes_used_ = 0u;
+  std::array<size_t, kHostBufferUsageHistoryLength> usage_history_ = {};
+  Metrics metrics_;
 };
 
 }  // namespace impeller
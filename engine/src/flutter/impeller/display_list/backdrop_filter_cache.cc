@@ -0,0 +1,88 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/display_list/backdrop_filter_cache.h"
+
+#include <algorithm>
+
+namespace impeller {
+
+void BackdropFilterCache::Invalidate(
+    const std::optional<IRect32>& frame_damage) {
+  if (!frame_damage.has_value()) {
+    entries_.clear();
+    damage_reported_ = false;
+    return;
+  }
+  const IRect32& damage = frame_damage.value();
+  entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                [&damage](const BackdropFilterCacheData& data) {
+                                  return data.readback.IntersectsWithRect(
+                                      damage);
+                                }),
+                 entries_.end());
+  damage_reported_ = true;
+}
+
+void BackdropFilterCache::MarkFrameStart() {
+  enabled_ = damage_reported_;
+  damage_reported_ = false;
+  for (BackdropFilterCacheData& entry : entries_) {
+    entry.used_this_frame = false;
+  }
+}
+
+void BackdropFilterCache::MarkFrameEnd() {
+  if (!enabled_) {
+    // Nothing validated the entries against this frame, so they may be
+    // stale the next time damage is reported.
+    entries_.clear();
+    return;
+  }
+  entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                [](const BackdropFilterCacheData& data) {
+                                  return !data.used_this_frame;
+                                }),
+                 entries_.end());
+  enabled_ = false;
+}
+
+std::optional<Entity> BackdropFilterCache::Lookup(
+    const flutter::DlImageFilter& filter,
+    const Matrix& transform,
+    const Rect& coverage) {
+  if (!enabled_) {
+    return std::nullopt;
+  }
+  // Entries already drawn this frame are skipped so that identical backdrop
+  // filters stacked on top of each other each find their own entry, in the
+  // order they were inserted.
+  for (BackdropFilterCacheData& entry : entries_) {
+    if (!entry.used_this_frame && entry.coverage == coverage &&
+        entry.transform == transform && *entry.filter == filter) {
+      entry.used_this_frame = true;
+      return entry.entity.Clone();
+    }
+  }
+  return std::nullopt;
+}
+
+void BackdropFilterCache::Insert(const flutter::DlImageFilter& filter,
+                                 const Matrix& transform,
+                                 const Rect& coverage,
+                                 const IRect32& readback,
+                                 const Entity& entity) {
+  if (!enabled_) {
+    return;
+  }
+  entries_.push_back(BackdropFilterCacheData{
+      .filter = filter.shared(),
+      .transform = transform,
+      .coverage = coverage,
+      .readback = readback,
+      .entity = entity.Clone(),
+  });
+}
+
+}  // namespace impeller
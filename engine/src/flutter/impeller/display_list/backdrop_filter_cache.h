@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_DISPLAY_LIST_BACKDROP_FILTER_CACHE_H_
+#define FLUTTER_IMPELLER_DISPLAY_LIST_BACKDROP_FILTER_CACHE_H_
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "flutter/display_list/effects/dl_image_filter.h"
+#include "impeller/entity/entity.h"
+#include "impeller/geometry/matrix.h"
+#include "impeller/geometry/rect.h"
+
+namespace impeller {
+
+/// @brief A cache of filtered backdrops that re-uses them across frames for
+///        as long as the content under the backdrop is unchanged.
+///
+/// A backdrop filter reads back what was already rendered to the target, so
+/// its result cannot be keyed by the filter alone. Instead, the owner of the
+/// render target reports the damage of every frame (the area that differs
+/// from the previous frame, as computed by flutter::DiffContext) through
+/// |Invalidate|, and any entry whose backdrop overlaps the damage is dropped.
+/// An entry that survives was filtered from identical pixels and can be drawn
+/// again without flipping the render pass or running the filter.
+///
+/// Only backdrops of the root pass are cached, and an instance must only be
+/// used with the frames of a single surface. Frames for which no damage was
+/// reported do not use the cache.
+///
+/// This object is not thread safe.
+class BackdropFilterCache {
+ public:
+  BackdropFilterCache() = default;
+
+  ~BackdropFilterCache() = default;
+
+  /// @brief Report the damage of the next frame, evicting every entry whose
+  ///        backdrop overlaps it.
+  ///
+  /// If the damage is unknown, all entries are evicted and the next frame
+  /// does not use the cache.
+  void Invalidate(const std::optional<IRect32>& frame_damage);
+
+  /// @brief Mark all entries as unused this frame. The cache is enabled for
+  ///        the frame if its damage was reported since the last frame.
+  void MarkFrameStart();
+
+  /// @brief Remove all entries that were not referenced during the frame.
+  void MarkFrameEnd();
+
+  /// @brief Whether the current frame may look up and insert entries.
+  bool IsEnabled() const { return enabled_; }
+
+  /// @brief Look up the filtered backdrop of a backdrop filter applied with
+  ///        the given transform to a save layer covering |coverage| in the
+  ///        root pass.
+  std::optional<Entity> Lookup(const flutter::DlImageFilter& filter,
+                               const Matrix& transform,
+                               const Rect& coverage);
+
+  /// @brief Add the filtered backdrop of a backdrop filter.
+  ///
+  /// @param[in]  readback  The area of the render target that the filter
+  ///                       samples to produce |coverage|.
+  void Insert(const flutter::DlImageFilter& filter,
+              const Matrix& transform,
+              const Rect& coverage,
+              const IRect32& readback,
+              const Entity& entity);
+
+  // Visible for testing.
+  size_t GetCacheSizeForTesting() const { return entries_.size(); }
+
+ private:
+  BackdropFilterCache(const BackdropFilterCache&) = delete;
+
+  BackdropFilterCache& operator=(const BackdropFilterCache&) = delete;
+
+  struct BackdropFilterCacheData {
+    std::shared_ptr<flutter::DlImageFilter> filter;
+    Matrix transform;
+    Rect coverage;
+    IRect32 readback;
+    Entity entity;
+    bool used_this_frame = true;
+  };
+
+  // A handful of backdrops are on screen at a time, so a linear search is
+  // cheaper than hashing the filters.
+  std::vector<BackdropFilterCacheData> entries_;
+  bool damage_reported_ = false;
+  bool enabled_ = false;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_DISPLAY_LIST_BACKDROP_FILTER_CACHE_H_
@@ -16,6 +16,7 @@
 #include "display_list/effects/dl_color_source.h"
 #include "display_list/effects/dl_image_filter.h"
 #include "display_list/image/dl_image.h"
+#include "flutter/fml/closure.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/impeller/geometry/round_superellipse_param.h"
@@ -855,6 +856,12 @@ void Canvas::DrawRect(const Rect& rect, const Paint& paint) {
     StrokeRectGeometry geom(rect, paint.stroke);
     AddRenderEntityWithFiltersToCurrentPass(entity, &geom, paint);
   } else {
+    if (AttemptBatchSolidFill(paint, [&rect](BatchedFillGeometry& batch,
+                                             const Matrix& transform) {
+          return batch.AddRect(transform, rect);
+        })) {
+      return;
+    }
     FillRectGeometry geom(rect);
     AddRenderEntityWithFiltersToCurrentPass(entity, &geom, paint);
   }
@@ -910,6 +917,15 @@ void Canvas::DrawOval(const Rect& rect, const Paint& paint) {
     StrokeEllipseGeometry geom(rect, paint.stroke);
     AddRenderEntityWithFiltersToCurrentPass(entity, &geom, paint);
   } else {
+    if (AttemptBatchSolidFill(
+            paint, [this, &rect](BatchedFillGeometry& batch,
+                                 const Matrix& transform) {
+              return batch.AddVertices(
+                  transform,
+                  renderer_.GetTessellator().FilledEllipse(transform, rect));
+            })) {
+      return;
+    }
     EllipseGeometry geom(rect);
     AddRenderEntityWithFiltersToCurrentPass(entity, &geom, paint);
   }
@@ -991,6 +1007,17 @@ void Canvas::DrawRoundRect(const RoundRect& round_rect, const Paint& paint) {
 
   if (round_rect.GetRadii().AreAllCornersSame() &&
       paint.style == Paint::Style::kFill) {
+    if (AttemptBatchSolidFill(
+            paint, [this, &round_rect](BatchedFillGeometry& batch,
+                                       const Matrix& transform) {
+              return batch.AddVertices(
+                  transform, renderer_.GetTessellator().FilledRoundRect(
+                                 transform, round_rect.GetBounds(),
+                                 round_rect.GetRadii().top_left));
+            })) {
+      return;
+    }
+
     Entity entity;
     entity.SetTransform(GetCurrentTransform());
     entity.SetBlendMode(paint.blend_mode);
@@ -1127,6 +1154,7 @@ void Canvas::DrawCircle(const Point& center,
 void Canvas::ClipGeometry(const Geometry& geometry,
                           Entity::ClipOperation clip_op,
                           bool is_aa) {
+  FlushPendingDraws();
   if (IsSkipping()) {
     return;
   }
@@ -1550,6 +1578,7 @@ void Canvas::SaveLayer(const Paint& paint,
                        bool can_distribute_opacity,
                        std::optional<int64_t> backdrop_id) {
   TRACE_EVENT0("flutter", "Canvas::saveLayer");
+  FlushPendingDraws();
   if (IsSkipping()) {
     return SkipUntilMatchingRestore(total_content_depth);
   }
@@ -1630,7 +1659,31 @@ void Canvas::SaveLayer(const Paint& paint,
   Point local_position = Point(0, 0);
   if (backdrop_filter) {
     local_position = subpass_coverage.GetOrigin() - GetGlobalPassPosition();
+  }
+
+  // A backdrop of the root pass that does not share its texture with other
+  // backdrops can be drawn from a previous frame if nothing under it changed
+  // since. On a hit, the backdrop is neither flipped nor filtered. On a miss,
+  // the area the filter samples from is recorded so that its result can be
+  // cached once rendered.
+  std::optional<Entity> cached_backdrop_entity;
+  std::optional<IRect32> backdrop_cache_readback;
+  if (backdrop_filter && CanCacheBackdrop(backdrop_id)) {
+    cached_backdrop_entity = backdrop_filter_cache_->Lookup(
+        *backdrop_filter, transform_stack_.back().transform, subpass_coverage);
+    if (cached_backdrop_entity.has_value()) {
+      backdrop_count_ -= 1;
+    } else {
+      IRect32 readback;
+      if (backdrop_filter->get_input_device_bounds(
+              IRect32::RoundOut(subpass_coverage),
+              transform_stack_.back().transform, readback)) {
+        backdrop_cache_readback = readback;
+      }
+    }
+  }
 
+  if (backdrop_filter && !cached_backdrop_entity.has_value()) {
     std::shared_ptr<Texture> input_texture;
 
     // If the backdrop ID is not nullopt and there is more than one usage
@@ -1759,19 +1812,69 @@ void Canvas::SaveLayer(const Paint& paint,
   // the subpass will affect in the parent pass.
   clip_coverage_stack_.PushSubpass(subpass_coverage, GetClipHeight());
 
+  if (cached_backdrop_entity.has_value()) {
+    cached_backdrop_entity->Render(renderer_, GetCurrentRenderPass());
+    return;
+  }
+
   if (!backdrop_filter_contents) {
     return;
   }
 
   // Render the backdrop entity.
   Entity backdrop_entity;
-  backdrop_entity.SetContents(std::move(backdrop_filter_contents));
+  backdrop_entity.SetContents(backdrop_filter_contents);
   backdrop_entity.SetTransform(
       Matrix::MakeTranslation(Vector3(-local_position)));
   backdrop_entity.SetClipDepth(std::numeric_limits<uint32_t>::max());
+
+  if (backdrop_cache_readback.has_value()) {
+    RenderAndCacheBackdrop(*backdrop_filter, *backdrop_filter_contents,
+                           subpass_coverage, backdrop_cache_readback.value(),
+                           backdrop_entity);
+    return;
+  }
+
   backdrop_entity.Render(renderer_, GetCurrentRenderPass());
 }
 
+bool Canvas::CanCacheBackdrop(std::optional<int64_t> backdrop_id) const {
+  if (!backdrop_filter_cache_ || !backdrop_filter_cache_->IsEnabled() ||
+      render_passes_.size() != 1u) {
+    return false;
+  }
+  if (backdrop_id.has_value()) {
+    auto backdrop_data_it = backdrop_data_.find(backdrop_id.value());
+    if (backdrop_data_it != backdrop_data_.end() &&
+        backdrop_data_it->second.backdrop_count > 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Canvas::RenderAndCacheBackdrop(const flutter::DlImageFilter& filter,
+                                    const FilterContents& filter_contents,
+                                    const Rect& coverage,
+                                    const IRect32& readback,
+                                    const Entity& backdrop_entity) {
+  // Execute the filter to produce an entity that can be re-used on subsequent
+  // frames. To prevent its textures from being re-used by the render target
+  // cache, we temporarily disable any RT caching.
+  renderer_.GetRenderTargetCache()->DisableCache();
+  fml::ScopedCleanupClosure closure(
+      [&] { renderer_.GetRenderTargetCache()->EnableCache(); });
+  std::optional<Entity> filtered_entity = filter_contents.GetEntity(
+      renderer_, backdrop_entity, filter_contents.GetCoverageHint());
+  if (!filtered_entity.has_value()) {
+    return;
+  }
+  filtered_entity->SetClipDepth(backdrop_entity.GetClipDepth());
+  backdrop_filter_cache_->Insert(filter, GetCurrentTransform(), coverage,
+                                 readback, filtered_entity.value());
+  filtered_entity->Render(renderer_, GetCurrentRenderPass());
+}
+
 bool Canvas::Restore() {
   FML_DCHECK(transform_stack_.size() > 0);
   if (transform_stack_.size() == 1) {
@@ -1804,6 +1907,7 @@ bool Canvas::Restore() {
           Entity::RenderingMode::kSubpassAppendSnapshotTransform ||
       transform_stack_.back().rendering_mode ==
           Entity::RenderingMode::kSubpassPrependSnapshotTransform) {
+    FlushPendingDraws();
     auto lazy_render_pass = std::move(render_passes_.back());
     render_passes_.pop_back();
     // Force the render pass to be constructed if it never was.
@@ -1895,6 +1999,8 @@ bool Canvas::Restore() {
   transform_stack_.pop_back();
 
   if (num_clips > 0) {
+    // Text rendered after this restore is not subject to the restored clips.
+    FlushPendingDraws();
     EntityPassClipStack::ClipStateResult clip_state_result =
         clip_coverage_stack_.RecordRestore(GetGlobalPassPosition(),
                                            GetClipHeight());
@@ -1999,10 +2105,151 @@ void Canvas::DrawTextFrame(const std::shared_ptr<TextFrame>& text_frame,
     return;
   }
 
+  if (!paint.mask_blur_descriptor.has_value() &&  //
+      paint.image_filter == nullptr &&             //
+      paint.color_filter == nullptr &&             //
+      !paint.invert_colors &&                      //
+      paint.blend_mode <= Entity::kLastPipelineBlendMode) {
+    entity.SetContents(text_contents);
+    AddTextEntityToCurrentPass(entity, text_contents);
+    return;
+  }
+
   entity.SetContents(paint.WithFilters(renderer_, std::move(text_contents)));
   AddRenderEntityToCurrentPass(entity, false);
 }
 
+void Canvas::AddTextEntityToCurrentPass(
+    Entity& entity,
+    const std::shared_ptr<TextContents>& text_contents) {
+  if (IsSkipping()) {
+    return;
+  }
+
+  entity.SetTransform(
+      Matrix::MakeTranslation(Vector3(-GetGlobalPassPosition())) *
+      entity.GetTransform());
+  entity.SetInheritedOpacity(transform_stack_.back().distributed_opacity);
+
+  ++current_depth_;
+  FML_DCHECK(current_depth_ <= transform_stack_.back().clip_depth)
+      << current_depth_ << " <=? " << transform_stack_.back().clip_depth;
+  entity.SetClipDepth(current_depth_);
+  text_frame_count_++;
+
+  if (pending_text_entity_.has_value() &&
+      pending_text_contents_->CanBatch(pending_text_entity_.value(),
+                                       *text_contents, entity)) {
+    pending_text_contents_->AddBatchedText(*text_contents,
+                                           entity.GetTransform());
+    // Nothing that changes the clips was rendered since the pending text, so
+    // the whole batch can be rendered at the depth of its last text.
+    pending_text_entity_->SetClipDepth(current_depth_);
+    return;
+  }
+
+  FlushPendingDraws();
+  pending_text_entity_ = entity;
+  pending_text_contents_ = text_contents;
+}
+
+void Canvas::FlushPendingText() {
+  if (!pending_text_entity_.has_value()) {
+    return;
+  }
+  Entity entity = std::move(pending_text_entity_.value());
+  pending_text_entity_.reset();
+  pending_text_contents_.reset();
+  text_draw_count_++;
+
+  const std::shared_ptr<RenderPass>& result =
+      render_passes_.back().GetInlinePassContext()->GetRenderPass();
+  if (!result) {
+    return;
+  }
+  entity.Render(renderer_, *result);
+}
+
+bool Canvas::AttemptBatchSolidFill(
+    const Paint& paint,
+    const std::function<bool(BatchedFillGeometry&, const Matrix&)>&
+        add_shape) {
+  // Fills that may become the clear color of the pass are left to
+  // AddRenderEntityToCurrentPass, as are fills with inherited opacity.
+  if (paint.color_source || paint.HasColorFilter() || paint.invert_colors ||
+      paint.image_filter || paint.mask_blur_descriptor.has_value() ||
+      paint.blend_mode > Entity::kLastPipelineBlendMode || IsSkipping() ||
+      transform_stack_.back().distributed_opacity < 1.0 ||
+      render_passes_.back().IsApplyingClearColor()) {
+    return false;
+  }
+
+  BlendMode blend_mode = paint.blend_mode;
+  if (blend_mode == BlendMode::kSrcOver && paint.color.IsOpaque()) {
+    blend_mode = BlendMode::kSrc;
+  }
+  Matrix transform =
+      Matrix::MakeTranslation(Vector3(-GetGlobalPassPosition())) *
+      GetCurrentTransform();
+
+  FlushPendingText();
+  bool can_merge = pending_fill_entity_.has_value() &&
+                   pending_fill_entity_->GetBlendMode() == blend_mode &&
+                   pending_fill_contents_->GetColor() == paint.color;
+  if (!can_merge || !add_shape(*pending_fill_geometry_, transform)) {
+    auto geometry = std::make_unique<BatchedFillGeometry>();
+    if (!add_shape(*geometry, transform)) {
+      return false;
+    }
+    FlushPendingFills();
+    auto contents = std::make_shared<SolidColorContents>(geometry.get());
+    contents->SetColor(paint.color);
+    // The shapes are transformed by the batch, so the entity transform is
+    // left as the identity.
+    Entity entity;
+    entity.SetBlendMode(blend_mode);
+    entity.SetContents(contents);
+    pending_fill_entity_ = std::move(entity);
+    pending_fill_contents_ = std::move(contents);
+    pending_fill_geometry_ = std::move(geometry);
+  }
+
+  ++current_depth_;
+  FML_DCHECK(current_depth_ <= transform_stack_.back().clip_depth)
+      << current_depth_ << " <=? " << transform_stack_.back().clip_depth;
+  // Nothing that changes the clips was rendered since the pending fills, so
+  // the whole batch can be rendered at the depth of its last fill.
+  pending_fill_entity_->SetClipDepth(current_depth_);
+  batched_fill_count_++;
+  return true;
+}
+
+void Canvas::FlushPendingFills() {
+  if (!pending_fill_entity_.has_value()) {
+    return;
+  }
+  Entity entity = std::move(pending_fill_entity_.value());
+  pending_fill_entity_.reset();
+  pending_fill_contents_.reset();
+  // The contents refer to the geometry, so it is kept alive until the batch
+  // is rendered.
+  std::unique_ptr<BatchedFillGeometry> geometry =
+      std::move(pending_fill_geometry_);
+  batched_fill_draw_count_++;
+
+  const std::shared_ptr<RenderPass>& result =
+      render_passes_.back().GetInlinePassContext()->GetRenderPass();
+  if (!result) {
+    return;
+  }
+  entity.Render(renderer_, *result);
+}
+
+void Canvas::FlushPendingDraws() {
+  FlushPendingText();
+  FlushPendingFills();
+}
+
 void Canvas::AddRenderSDFEntityToCurrentPass(const Paint& paint,
                                              UberSDFParameters params) {
   Entity entity;
@@ -2132,6 +2379,7 @@ void Canvas::AddRenderEntityWithFiltersToCurrentPass(
 }
 
 void Canvas::AddRenderEntityToCurrentPass(Entity& entity, bool reuse_depth) {
+  FlushPendingDraws();
   if (IsSkipping()) {
     return;
   }
@@ -2240,10 +2488,16 @@ void Canvas::SetBackdropData(
   backdrop_count_ = backdrop_count;
 }
 
+void Canvas::SetBackdropFilterCache(
+    BackdropFilterCache* backdrop_filter_cache) {
+  backdrop_filter_cache_ = backdrop_filter_cache;
+}
+
 std::shared_ptr<Texture> Canvas::FlipBackdrop(Point global_pass_position,
                                               bool should_remove_texture,
                                               bool should_use_onscreen,
                                               bool post_depth_increment) {
+  FlushPendingDraws();
   LazyRenderingConfig rendering_config = std::move(render_passes_.back());
   render_passes_.pop_back();
 
@@ -2434,6 +2688,15 @@ bool Canvas::EnsureFinalMipmapGeneration() const {
 
 void Canvas::EndReplay() {
   FML_DCHECK(render_passes_.size() == 1u);
+  FlushPendingDraws();
+  FML_TRACE_COUNTER("impeller", "Canvas::TextDraws",
+                    reinterpret_cast<int64_t>(this),  // Trace Counter ID
+                    "TextFrames", text_frame_count_,  //
+                    "DrawCalls", text_draw_count_);
+  FML_TRACE_COUNTER("impeller", "Canvas::BatchedFills",
+                    reinterpret_cast<int64_t>(this),  // Trace Counter ID
+                    "Fills", batched_fill_count_,     //
+                    "DrawCalls", batched_fill_draw_count_);
   render_passes_.back().GetInlinePassContext()->GetRenderPass();
   render_passes_.back().GetInlinePassContext()->EndPass(
       /*is_onscreen=*/!requires_readback_ && is_onscreen_);
@@ -15,14 +15,18 @@
 #include "flutter/display_list/effects/dl_image_filter.h"
 #include "flutter/display_list/geometry/dl_path.h"
 #include "impeller/core/sampler_descriptor.h"
+#include "impeller/display_list/backdrop_filter_cache.h"
 #include "impeller/display_list/paint.h"
 #include "impeller/entity/contents/atlas_contents.h"
 #include "impeller/entity/contents/clip_contents.h"
+#include "impeller/entity/contents/filters/filter_contents.h"
+#include "impeller/entity/contents/solid_color_contents.h"
 #include "impeller/entity/contents/solid_rrect_like_blur_contents.h"
 #include "impeller/entity/contents/text_contents.h"
 #include "impeller/entity/contents/uber_sdf_parameters.h"
 #include "impeller/entity/entity.h"
 #include "impeller/entity/entity_pass_clip_stack.h"
+#include "impeller/entity/geometry/batched_fill_geometry.h"
 #include "impeller/entity/geometry/geometry.h"
 #include "impeller/entity/geometry/round_rect_geometry.h"
 #include "impeller/entity/geometry/round_superellipse_geometry.h"
@@ -144,6 +148,10 @@ class Canvas {
   void SetBackdropData(std::unordered_map<int64_t, BackdropData> backdrop_data,
                        size_t backdrop_count);
 
+  /// @brief Set the cache used to re-use the filtered backdrops of the root
+  ///        pass from previous frames, or nullptr to always filter them.
+  void SetBackdropFilterCache(BackdropFilterCache* backdrop_filter_cache);
+
   /// @brief Return the culling bounds of the current render target, or nullopt
   ///        if there is no coverage.
   std::optional<Rect> GetLocalCoverageLimit() const;
@@ -283,6 +291,31 @@ class Canvas {
   /// Visible for testing.
   static bool IsCompatibleWithSDFRendering(const Paint& paint);
 
+  /// The number of unfiltered text frames drawn since the canvas was created.
+  ///
+  /// Visible for testing.
+  size_t GetTextFrameCount() const { return text_frame_count_; }
+
+  /// The number of draw calls issued for unfiltered text frames since the
+  /// canvas was created. Adjacent compatible text frames are drawn by one
+  /// draw call.
+  ///
+  /// Visible for testing.
+  size_t GetTextDrawCount() const { return text_draw_count_; }
+
+  /// The number of unfiltered solid color fills that were batched since the
+  /// canvas was created.
+  ///
+  /// Visible for testing.
+  size_t GetBatchedFillCount() const { return batched_fill_count_; }
+
+  /// The number of draw calls issued for batched solid color fills since the
+  /// canvas was created. Adjacent fills of the same color and blend mode are
+  /// drawn by one draw call.
+  ///
+  /// Visible for testing.
+  size_t GetBatchedFillDrawCount() const { return batched_fill_draw_count_; }
+
  private:
   class BlurShape {
    public:
@@ -324,6 +357,10 @@ class Canvas {
   /// fetch (iOS Simulator and certain OpenGLES devices).
   size_t backdrop_count_ = 0u;
 
+  /// Filtered backdrops of the root pass that are kept across frames. Owned
+  /// by the surface that this canvas renders to.
+  BackdropFilterCache* backdrop_filter_cache_ = nullptr;
+
   // All geometry objects created for regular draws can be stack allocated,
   // but clip geometries must be cached for record/replay for backdrop filters
   // and so must be kept alive longer.
@@ -331,6 +368,23 @@ class Canvas {
 
   uint64_t current_depth_ = 0u;
 
+  /// Text that has been added to the current pass but not rendered yet, so
+  /// that the text of following compatible draws can be rendered by the same
+  /// draw call. Must be flushed before anything else touches the render pass.
+  std::optional<Entity> pending_text_entity_;
+  std::shared_ptr<TextContents> pending_text_contents_;
+  size_t text_frame_count_ = 0u;
+  size_t text_draw_count_ = 0u;
+
+  /// Solid color fills that have been added to the current pass but not
+  /// rendered yet, see |pending_text_entity_|. At most one of the pending
+  /// text and the pending fills is set at any time.
+  std::optional<Entity> pending_fill_entity_;
+  std::shared_ptr<SolidColorContents> pending_fill_contents_;
+  std::unique_ptr<BatchedFillGeometry> pending_fill_geometry_;
+  size_t batched_fill_count_ = 0u;
+  size_t batched_fill_draw_count_ = 0u;
+
   Point GetGlobalPassPosition() const;
 
   // clip depth of the previous save or 0.
@@ -367,6 +421,18 @@ class Canvas {
                                         bool should_use_onscreen = false,
                                         bool post_depth_increment = false);
 
+  /// Whether the backdrop filter of a save layer at the current position may
+  /// be looked up in and added to the backdrop filter cache.
+  bool CanCacheBackdrop(std::optional<int64_t> backdrop_id) const;
+
+  /// Render the backdrop entity of a save layer into the current render pass
+  /// and add its filtered result to the backdrop filter cache.
+  void RenderAndCacheBackdrop(const flutter::DlImageFilter& filter,
+                              const FilterContents& filter_contents,
+                              const Rect& coverage,
+                              const IRect32& readback,
+                              const Entity& backdrop_entity);
+
   bool BlitToOnscreen(bool is_onscreen = false);
 
   size_t GetClipHeight() const;
@@ -387,6 +453,35 @@ class Canvas {
 
   void AddRenderEntityToCurrentPass(Entity& entity, bool reuse_depth = false);
 
+  /// Adds an unfiltered text entity to the current pass, batching it with
+  /// the pending text if possible.
+  void AddTextEntityToCurrentPass(
+      Entity& entity,
+      const std::shared_ptr<TextContents>& text_contents);
+
+  /// Renders the pending text, if any.
+  void FlushPendingText();
+
+  /// Adds an unfiltered solid color fill to the pending fills of the current
+  /// pass, so that it can be rendered by the same draw call as the fills
+  /// around it.
+  ///
+  /// |add_shape| appends the triangles of the shape, transformed by the given
+  /// matrix, to a batch and returns whether it could.
+  ///
+  /// @return Whether the fill was batched. If not, the caller must draw it.
+  bool AttemptBatchSolidFill(
+      const Paint& paint,
+      const std::function<bool(BatchedFillGeometry&, const Matrix&)>&
+          add_shape);
+
+  /// Renders the pending fills, if any.
+  void FlushPendingFills();
+
+  /// Renders the pending text and fills, if any. Must be called before
+  /// anything else touches the render pass.
+  void FlushPendingDraws();
+
   /// Returns true if this operation is consistent with a DrawShadow-like
   /// operation.
   static bool IsShadowBlurDrawOperation(const Paint& paint);
@@ -11,15 +11,20 @@
 #include "impeller/core/formats.h"
 #include "impeller/core/texture_descriptor.h"
 #include "impeller/display_list/aiks_unittests.h"
+#include "impeller/display_list/backdrop_filter_cache.h"
 #include "impeller/display_list/canvas.h"
 #include "impeller/display_list/dl_image_impeller.h"
 #include "impeller/display_list/dl_runtime_effect_impeller.h"
 #include "impeller/display_list/dl_vertices_geometry.h"
+#include "impeller/entity/geometry/rect_geometry.h"
 #include "impeller/geometry/geometry_asserts.h"
 #include "impeller/playground/playground.h"
 #include "impeller/playground/widgets.h"
 #include "impeller/renderer/render_target.h"
+#include "impeller/typographer/backends/skia/text_frame_skia.h"
+#include "impeller/typographer/backends/skia/typographer_context_skia.h"
 #include "third_party/abseil-cpp/absl/status/status_matchers.h"
+#include "txt/platform.h"
 
 namespace impeller {
 namespace testing {
@@ -283,6 +288,189 @@ TEST_P(AiksTest, BackdropCountDownWithNestedSaveLayers) {
   EXPECT_TRUE(canvas->RequiresReadback());
 }
 
+TEST(BackdropFilterCacheTest, IsOnlyEnabledForFramesWithDamage) {
+  BackdropFilterCache cache;
+  auto blur =
+      flutter::DlImageFilter::MakeBlur(4, 4, flutter::DlTileMode::kClamp);
+  Rect coverage = Rect::MakeLTRB(0, 0, 50, 50);
+  IRect32 readback = IRect32::MakeLTRB(-12, -12, 62, 62);
+
+  cache.MarkFrameStart();
+  EXPECT_FALSE(cache.IsEnabled());
+  cache.Insert(*blur, Matrix(), coverage, readback, Entity());
+  cache.MarkFrameEnd();
+  EXPECT_EQ(cache.GetCacheSizeForTesting(), 0u);
+
+  cache.Invalidate(IRect32::MakeLTRB(0, 0, 100, 100));
+  cache.MarkFrameStart();
+  EXPECT_TRUE(cache.IsEnabled());
+  cache.Insert(*blur, Matrix(), coverage, readback, Entity());
+  cache.MarkFrameEnd();
+  EXPECT_FALSE(cache.IsEnabled());
+  EXPECT_EQ(cache.GetCacheSizeForTesting(), 1u);
+
+  // A frame that does not report its damage may have changed anything.
+  cache.Invalidate(std::nullopt);
+  EXPECT_EQ(cache.GetCacheSizeForTesting(), 0u);
+}
+
+TEST(BackdropFilterCacheTest, EvictsDamagedAndUnusedEntries) {
+  BackdropFilterCache cache;
+  auto blur =
+      flutter::DlImageFilter::MakeBlur(4, 4, flutter::DlTileMode::kClamp);
+  auto other_blur =
+      flutter::DlImageFilter::MakeBlur(8, 8, flutter::DlTileMode::kClamp);
+  Rect top = Rect::MakeLTRB(0, 0, 50, 50);
+  Rect bottom = Rect::MakeLTRB(0, 100, 50, 150);
+
+  cache.Invalidate(IRect32::MakeLTRB(0, 0, 200, 200));
+  cache.MarkFrameStart();
+  cache.Insert(*blur, Matrix(), top, IRect32::MakeLTRB(-12, -12, 62, 62),
+               Entity());
+  cache.Insert(*blur, Matrix(), bottom, IRect32::MakeLTRB(-12, 88, 62, 162),
+               Entity());
+  cache.MarkFrameEnd();
+  ASSERT_EQ(cache.GetCacheSizeForTesting(), 2u);
+
+  // Damage under the bottom backdrop only.
+  cache.Invalidate(IRect32::MakeLTRB(0, 150, 10, 160));
+  EXPECT_EQ(cache.GetCacheSizeForTesting(), 1u);
+  cache.MarkFrameStart();
+  EXPECT_FALSE(cache.Lookup(*blur, Matrix(), bottom).has_value());
+  EXPECT_FALSE(cache.Lookup(*other_blur, Matrix(), top).has_value());
+  EXPECT_FALSE(
+      cache.Lookup(*blur, Matrix::MakeTranslation({1, 0}), top).has_value());
+  EXPECT_TRUE(cache.Lookup(*blur, Matrix(), top).has_value());
+  // Each entry is only drawn once per frame.
+  EXPECT_FALSE(cache.Lookup(*blur, Matrix(), top).has_value());
+  cache.MarkFrameEnd();
+  EXPECT_EQ(cache.GetCacheSizeForTesting(), 1u);
+
+  // Entries that are not drawn in a frame are evicted.
+  cache.Invalidate(IRect32());
+  cache.MarkFrameStart();
+  cache.MarkFrameEnd();
+  EXPECT_EQ(cache.GetCacheSizeForTesting(), 0u);
+}
+
+TEST_P(AiksTest, BackdropFilterIsReusedWhileBackdropIsUndamaged) {
+  ContentContext context(GetContext(), nullptr);
+  BackdropFilterCache cache;
+  auto blur =
+      flutter::DlImageFilter::MakeBlur(4, 4, flutter::DlTileMode::kClamp);
+  flutter::DlRect rect = flutter::DlRect::MakeLTRB(0, 0, 50, 50);
+
+  // Renders a frame and returns the number of cache entries right after the
+  // backdrop filter, before unused entries are evicted.
+  auto render_frame = [&](std::optional<IRect32> damage) {
+    cache.Invalidate(damage);
+    cache.MarkFrameStart();
+    auto canvas = CreateTestCanvas(context, Rect::MakeLTRB(0, 0, 100, 100),
+                                   /*requires_readback=*/true);
+    canvas->SetBackdropData({}, 1);
+    canvas->SetBackdropFilterCache(&cache);
+    canvas->DrawRect(rect, {.color = Color::Azure()});
+    // Backdrop filters flood their clip, as under an app bar.
+    canvas->ClipGeometry(FillRectGeometry(rect),
+                         Entity::ClipOperation::kIntersect);
+    canvas->SaveLayer({}, rect, blur.get(),
+                      ContentBoundsPromise::kContainsContents,
+                      /*total_content_depth=*/1);
+    canvas->Restore();
+    size_t entries = cache.GetCacheSizeForTesting();
+    cache.MarkFrameEnd();
+    return entries;
+  };
+
+  EXPECT_EQ(render_frame(IRect32::MakeLTRB(0, 0, 100, 100)), 1u);
+
+  // Damage outside of the area sampled by the blur. The entry is re-used
+  // rather than a second one being inserted.
+  EXPECT_EQ(render_frame(IRect32::MakeLTRB(80, 80, 100, 100)), 1u);
+  EXPECT_EQ(cache.GetCacheSizeForTesting(), 1u);
+
+  // Damage within the blur radius of the backdrop invalidates the entry.
+  EXPECT_EQ(render_frame(IRect32::MakeLTRB(55, 0, 60, 10)), 1u);
+  EXPECT_EQ(cache.GetCacheSizeForTesting(), 1u);
+
+  // Without damage the backdrop is always filtered.
+  EXPECT_EQ(render_frame(std::nullopt), 0u);
+  EXPECT_EQ(cache.GetCacheSizeForTesting(), 0u);
+}
+
+TEST_P(AiksTest, BatchesAdjacentSolidFills) {
+  ContentContext context(GetContext(), nullptr);
+  if (context.GetContext()->GetFlags().use_sdfs) {
+    GTEST_SKIP() << "Test requires fills that are not rendered as SDFs";
+  }
+  auto canvas = CreateTestCanvas(context);
+
+  // The first fill of the pass may become its clear color, so it is not
+  // batched.
+  canvas->DrawRect(Rect::MakeXYWH(0, 0, 10, 10), {.color = Color::Red()});
+  EXPECT_EQ(canvas->GetBatchedFillCount(), 0u);
+
+  canvas->DrawRect(Rect::MakeXYWH(20, 0, 10, 10), {.color = Color::Blue()});
+  canvas->DrawRoundRect(
+      RoundRect::MakeRectRadius(Rect::MakeXYWH(40, 0, 10, 10), 2),
+      {.color = Color::Blue()});
+  canvas->DrawOval(Rect::MakeXYWH(60, 0, 20, 10), {.color = Color::Blue()});
+  // A different color starts a new batch.
+  canvas->DrawRect(Rect::MakeXYWH(0, 20, 10, 10), {.color = Color::Green()});
+  // Filtered fills are not batched.
+  canvas->DrawRect(Rect::MakeXYWH(20, 20, 10, 10),
+                   {.color = Color::Green(), .invert_colors = true});
+  canvas->DrawRect(Rect::MakeXYWH(40, 20, 10, 10), {.color = Color::Green()});
+  canvas->EndReplay();
+
+  EXPECT_EQ(canvas->GetBatchedFillCount(), 5u);
+  EXPECT_EQ(canvas->GetBatchedFillDrawCount(), 3u);
+}
+
+TEST_P(AiksTest, BatchesAdjacentTextFrames) {
+  ContentContext context(GetContext(),
+                         std::make_shared<TypographerContextSkia>());
+  auto mapping = flutter::testing::OpenFixtureAsSkData("Roboto-Regular.ttf");
+  ASSERT_TRUE(mapping);
+  sk_sp<SkFontMgr> font_mgr = txt::GetDefaultFontManager();
+  SkFont sk_font(font_mgr->makeFromData(mapping), 16);
+  std::shared_ptr<TextFrame> text_frame =
+      MakeTextFrameFromTextBlobSkia(SkTextBlob::MakeFromString("Hi", sk_font));
+  ASSERT_TRUE(text_frame);
+  // Every text frame is drawn at the same scale, so it is prepared once.
+  context.GetLazyGlyphAtlas()->AddTextFrame(text_frame, Point(), Matrix(),
+                                            std::nullopt);
+  auto canvas = CreateTestCanvas(context);
+
+  Paint paint = {.color = Color::Black()};
+  auto draw_text = [&](Point position) {
+    canvas->DrawTextFrame(text_frame, position, paint);
+  };
+
+  draw_text({0, 20});
+  draw_text({30, 20});
+  draw_text({60, 20});
+  EXPECT_EQ(canvas->GetTextFrameCount(), 3u);
+  EXPECT_EQ(canvas->GetTextDrawCount(), 0u);
+
+  // A clip applies to the text drawn after it only, so it ends the batch.
+  canvas->Save();
+  canvas->ClipGeometry(FillRectGeometry(Rect::MakeXYWH(0, 40, 100, 30)),
+                       Entity::ClipOperation::kIntersect);
+  EXPECT_EQ(canvas->GetTextDrawCount(), 1u);
+  draw_text({0, 50});
+  draw_text({30, 50});
+
+  // Restoring the clip ends the batch of the clipped text.
+  canvas->Restore();
+  EXPECT_EQ(canvas->GetTextDrawCount(), 2u);
+  draw_text({0, 80});
+  canvas->EndReplay();
+
+  EXPECT_EQ(canvas->GetTextFrameCount(), 6u);
+  EXPECT_EQ(canvas->GetTextDrawCount(), 3u);
+}
+
 TEST_P(AiksTest, DrawVerticesLinearGradientWithEmptySize) {
   RenderCallback callback = [&](RenderTarget& render_target) {
     ContentContext context(GetContext(), nullptr);
@@ -5,14 +5,19 @@
 #include "impeller/display_list/dl_dispatcher.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <memory>
 #include <optional>
+#include <thread>
 #include <vector>
 
 #include "display_list/dl_sampling_options.h"
 #include "display_list/effects/dl_image_filter.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/trace_event.h"
 #include "fml/closure.h"
 #include "impeller/core/formats.h"
 #include "impeller/display_list/aiks_context.h"
@@ -36,6 +41,7 @@
 #include "impeller/geometry/color.h"
 #include "impeller/geometry/scalar.h"
 #include "impeller/geometry/sigma.h"
+#include "impeller/tessellator/tessellator.h"
 #include "impeller/typographer/font_glyph_pair.h"
 
 namespace impeller {
@@ -975,6 +981,11 @@ void CanvasDlDispatcher::SetBackdropData(
   GetCanvas().SetBackdropData(std::move(backdrop), backdrop_count);
 }
 
+void CanvasDlDispatcher::SetBackdropFilterCache(
+    BackdropFilterCache* backdrop_filter_cache) {
+  GetCanvas().SetBackdropFilterCache(backdrop_filter_cache);
+}
+
 //// Text Frame Dispatcher
 
 FirstPassDispatcher::FirstPassDispatcher(const ContentContext& renderer,
@@ -1154,6 +1165,19 @@ void FirstPassDispatcher::drawDisplayList(
   FML_DCHECK(stack_depth == stack_.size());
 }
 
+// |flutter::DlOpReceiver|
+void FirstPassDispatcher::drawPath(const DlPath& path) {
+  if (!collect_fill_paths_ || paint_.style != Paint::Style::kFill ||
+      path.GetBounds().IsEmpty()) {
+    return;
+  }
+  // Matches the tolerance used by FillPathSourceGeometry.
+  fill_paths_.push_back(FillPath{
+      .path = path,
+      .tolerance = matrix_.GetMaxBasisLengthXY(),
+  });
+}
+
 // |flutter::DlOpReceiver|
 void FirstPassDispatcher::setDrawStyle(flutter::DlDrawStyle style) {
   paint_.style = ToStyle(style);
@@ -1217,6 +1241,108 @@ namespace {
 bool PixelFormatSupportsMSAA(std::optional<PixelFormat> pixel_format) {
   return !pixel_format.has_value();
 }
+
+// The minimum number of filled paths in a frame before their tessellation
+// is spread across the worker threads.
+static constexpr size_t kMinParallelFillPaths = 32u;
+
+// The minimum number of paths handed to a worker at a time, so that short
+// paths are not dominated by the cost of waking a worker up.
+static constexpr size_t kMinFillPathsPerChunk = 8u;
+
+bool ShouldPretessellateFillPaths(const ContentContext& renderer) {
+  return renderer.GetContext()->GetFlags().parallel_path_tessellation &&
+         renderer.GetContext()->GetConcurrentWorkerTaskRunner() != nullptr;
+}
+
+// Tessellates the filled paths collected by the first pass on the worker
+// threads of the context and registers the results with the Tessellator,
+// so that the second pass only copies them into the host buffers.
+//
+// The raster thread claims chunks of paths alongside the workers and only
+// waits for chunks that are already being processed, so a busy worker pool
+// never delays the frame by more than one chunk. The Entities and the
+// commands that use the vertices are still produced in order by the second
+// pass on the raster thread.
+void PretessellateFillPaths(
+    const ContentContext& renderer,
+    const std::vector<FirstPassDispatcher::FillPath>& fill_paths) {
+  if (fill_paths.size() < kMinParallelFillPaths) {
+    return;
+  }
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner =
+      renderer.GetContext()->GetConcurrentWorkerTaskRunner();
+  if (!worker_task_runner) {
+    return;
+  }
+  TRACE_EVENT0("impeller", "PretessellateFillPaths");
+
+  Tessellator& tessellator = renderer.GetTessellator();
+  bool supports_primitive_restart =
+      renderer.GetDeviceCapabilities().SupportsPrimitiveRestart();
+  bool supports_triangle_fan =
+      renderer.GetDeviceCapabilities().SupportsTriangleFan() &&
+      supports_primitive_restart;
+
+  struct State {
+    State(const std::vector<FirstPassDispatcher::FillPath>& p_fill_paths,
+          size_t p_chunk_count)
+        : fill_paths(p_fill_paths),
+          results(p_fill_paths.size()),
+          chunk_count(p_chunk_count),
+          chunk_size((p_fill_paths.size() + p_chunk_count - 1) /
+                     p_chunk_count),
+          chunks_done(p_chunk_count) {}
+
+    const std::vector<FirstPassDispatcher::FillPath>& fill_paths;
+    std::vector<Tessellator::ConvexVertices> results;
+    const size_t chunk_count;
+    const size_t chunk_size;
+    std::atomic<size_t> next_chunk = 0u;
+    fml::CountDownLatch chunks_done;
+  };
+
+  size_t chunk_count =
+      std::min(static_cast<size_t>(std::thread::hardware_concurrency()) * 2u,
+               fill_paths.size() / kMinFillPathsPerChunk);
+  chunk_count = std::max(chunk_count, static_cast<size_t>(2u));
+  auto state = std::make_shared<State>(fill_paths, chunk_count);
+
+  // Returns false once every chunk has been claimed. Late workers only
+  // touch the atomic counter and never the paths or results, which may no
+  // longer exist by then.
+  auto run_next_chunk = [state, &tessellator, supports_primitive_restart,
+                         supports_triangle_fan]() -> bool {
+    size_t chunk = state->next_chunk.fetch_add(1u);
+    if (chunk >= state->chunk_count) {
+      return false;
+    }
+    size_t start = chunk * state->chunk_size;
+    size_t end = std::min(start + state->chunk_size, state->results.size());
+    for (size_t i = start; i < end; i++) {
+      const FirstPassDispatcher::FillPath& fill_path = state->fill_paths[i];
+      state->results[i] = tessellator.TessellateConvexToVertices(
+          fill_path.path, fill_path.tolerance, supports_primitive_restart,
+          supports_triangle_fan);
+    }
+    state->chunks_done.CountDown();
+    return true;
+  };
+
+  for (size_t i = 1; i < chunk_count; i++) {
+    worker_task_runner->PostTask([run_next_chunk]() { run_next_chunk(); },
+                                 fml::ConcurrentTaskPriority::kHigh);
+  }
+  while (run_next_chunk()) {
+  }
+  state->chunks_done.Wait();
+
+  for (size_t i = 0; i < fill_paths.size(); i++) {
+    tessellator.AddPretessellatedConvex(&fill_paths[i].path.GetSkPath(),
+                                        fill_paths[i].tolerance,
+                                        std::move(state->results[i]));
+  }
+}
 }  // namespace
 
 std::pair<std::unordered_map<int64_t, BackdropData>, size_t>
@@ -1226,6 +1352,17 @@ FirstPassDispatcher::TakeBackdropData() {
   return std::make_pair(temp, backdrop_count_);
 }
 
+void FirstPassDispatcher::SetCollectFillPaths(bool collect) {
+  collect_fill_paths_ = collect;
+}
+
+std::vector<FirstPassDispatcher::FillPath>
+FirstPassDispatcher::TakeFillPaths() {
+  std::vector<FillPath> temp;
+  std::swap(temp, fill_paths_);
+  return temp;
+}
+
 std::shared_ptr<Texture> DisplayListToTexture(
     const sk_sp<flutter::DisplayList>& display_list,
     ISize size,
@@ -1279,7 +1416,12 @@ std::shared_ptr<Texture> DisplayListToTexture(
   DlIRect cull_rect = DlIRect::MakeWH(size.width, size.height);
   impeller::FirstPassDispatcher collector(
       context.GetContentContext(), impeller::Matrix(), Rect::MakeSize(size));
+  collector.SetCollectFillPaths(
+      ShouldPretessellateFillPaths(context.GetContentContext()));
   display_list->Dispatch(collector, cull_rect);
+  std::vector<FirstPassDispatcher::FillPath> fill_paths =
+      collector.TakeFillPaths();
+  PretessellateFillPaths(context.GetContentContext(), fill_paths);
   impeller::CanvasDlDispatcher impeller_dispatcher(
       context.GetContentContext(),               //
       target,                                    //
@@ -1298,6 +1440,7 @@ std::shared_ptr<Texture> DisplayListToTexture(
     }
     context.GetContentContext().GetTextShadowCache().MarkFrameEnd();
     context.GetContentContext().GetLazyGlyphAtlas()->ResetTextFrames();
+    context.GetContentContext().GetTessellator().ClearPretessellatedConvex();
     context.GetContext()->DisposeThreadLocalCachedResources();
   });
 
@@ -1312,9 +1455,14 @@ bool RenderToTarget(ContentContext& context,
                     const sk_sp<flutter::DisplayList>& display_list,
                     Rect cull_rect,
                     bool reset_host_buffer,
-                    bool is_onscreen) {
+                    bool is_onscreen,
+                    BackdropFilterCache* backdrop_filter_cache) {
   FirstPassDispatcher collector(context, impeller::Matrix(), cull_rect);
+  collector.SetCollectFillPaths(ShouldPretessellateFillPaths(context));
   display_list->Dispatch(collector, cull_rect);
+  std::vector<FirstPassDispatcher::FillPath> fill_paths =
+      collector.TakeFillPaths();
+  PretessellateFillPaths(context, fill_paths);
 
   impeller::CanvasDlDispatcher impeller_dispatcher(
       context,                                   //
@@ -1326,12 +1474,23 @@ bool RenderToTarget(ContentContext& context,
   );
   const auto& [data, count] = collector.TakeBackdropData();
   impeller_dispatcher.SetBackdropData(data, count);
+  impeller_dispatcher.SetBackdropFilterCache(backdrop_filter_cache);
   context.GetTextShadowCache().MarkFrameStart();
+  if (backdrop_filter_cache) {
+    backdrop_filter_cache->MarkFrameStart();
+  }
   fml::ScopedCleanupClosure cleanup([&] {
     if (reset_host_buffer) {
       context.ResetTransientsBuffers();
     }
     context.GetTextShadowCache().MarkFrameEnd();
+    if (backdrop_filter_cache) {
+      backdrop_filter_cache->MarkFrameEnd();
+    }
+    context.GetTessellator().ClearPretessellatedConvex();
+    if (is_onscreen) {
+      context.MarkOnscreenFrameEnd();
+    }
   });
 
   display_list->Dispatch(impeller_dispatcher, cull_rect);
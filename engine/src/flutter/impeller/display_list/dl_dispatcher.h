@@ -320,6 +320,8 @@ class CanvasDlDispatcher : public DlDispatcherBase {
   void SetBackdropData(std::unordered_map<int64_t, BackdropData> backdrop,
                        size_t backdrop_count);
 
+  void SetBackdropFilterCache(BackdropFilterCache* backdrop_filter_cache);
+
   // |flutter::DlOpReceiver|
   void save() override {
     // This dispatcher should never be used with the save() variant
@@ -360,6 +362,13 @@ class FirstPassDispatcher : public flutter::IgnoreAttributeDispatchHelper,
                             public flutter::IgnoreClipDispatchHelper,
                             public flutter::IgnoreDrawDispatchHelper {
  public:
+  /// A filled path drawn by the display list, along with the tolerance it
+  /// will be tessellated at by the second pass.
+  struct FillPath {
+    DlPath path;
+    Scalar tolerance;
+  };
+
   FirstPassDispatcher(const ContentContext& renderer,
                       const Matrix& initial_matrix,
                       const Rect cull_rect);
@@ -407,6 +416,9 @@ class FirstPassDispatcher : public flutter::IgnoreAttributeDispatchHelper,
   void drawDisplayList(const sk_sp<flutter::DisplayList> display_list,
                        DlScalar opacity) override;
 
+  // |flutter::DlOpReceiver|
+  void drawPath(const DlPath& path) override;
+
   // |flutter::DlOpReceiver|
   void setDrawStyle(flutter::DlDrawStyle style) override;
 
@@ -431,6 +443,12 @@ class FirstPassDispatcher : public flutter::IgnoreAttributeDispatchHelper,
   std::pair<std::unordered_map<int64_t, BackdropData>, size_t>
   TakeBackdropData();
 
+  /// Enables the collection of filled paths for |TakeFillPaths|. Disabled
+  /// by default.
+  void SetCollectFillPaths(bool collect);
+
+  std::vector<FillPath> TakeFillPaths();
+
  private:
   const Rect GetCurrentLocalCullingBounds() const;
 
@@ -443,6 +461,8 @@ class FirstPassDispatcher : public flutter::IgnoreAttributeDispatchHelper,
   bool has_image_filter_ = false;
   size_t backdrop_count_ = 0;
   Paint paint_;
+  bool collect_fill_paths_ = false;
+  std::vector<FillPath> fill_paths_;
 };
 
 /// Render the provided display list to a texture with the given size.
@@ -458,12 +478,18 @@ std::shared_ptr<Texture> DisplayListToTexture(
 ///
 /// If [is_onscreen] is true, then the onscreen command buffer will be
 /// submitted via Context::SubmitOnscreen.
+///
+/// If [backdrop_filter_cache] is not null, filtered backdrops of the root
+/// pass are re-used from previous frames rendered with the same cache. The
+/// caller must report the damage of the frame to the cache beforehand, see
+/// BackdropFilterCache::Invalidate.
 bool RenderToTarget(ContentContext& context,
                     RenderTarget render_target,
                     const sk_sp<flutter::DisplayList>& display_list,
                     Rect cull_rect,
                     bool reset_host_buffer,
-                    bool is_onscreen = true);
+                    bool is_onscreen = true,
+                    BackdropFilterCache* backdrop_filter_cache = nullptr);
 
 }  // namespace impeller
 
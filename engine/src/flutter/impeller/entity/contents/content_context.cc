@@ -5,15 +5,19 @@
 #include "impeller/entity/contents/content_context.h"
 
 #include <format>
+#include <functional>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "flutter/display_list/image/dl_image.h"
+#include "flutter/fml/paths.h"
 #include "fml/trace_event.h"
 #include "impeller/base/validation.h"
 #include "impeller/core/formats.h"
 #include "impeller/core/texture_descriptor.h"
 #include "impeller/entity/contents/framebuffer_blend_contents.h"
+#include "impeller/entity/contents/pipeline_variant_record.h"
 #include "impeller/entity/contents/pipelines.h"
 #include "impeller/entity/contents/text_shadow_cache.h"
 #include "impeller/entity/entity.h"
@@ -24,6 +28,7 @@
 #include "impeller/renderer/pipeline_library.h"
 #include "impeller/renderer/render_target.h"
 #include "impeller/renderer/texture_util.h"
+#include "impeller/tessellator/tessellation_cache.h"
 #include "impeller/tessellator/tessellator.h"
 #include "impeller/typographer/typographer_context.h"
 
@@ -74,11 +79,59 @@ class GenericVariants {
            opts.ToKey() == default_options_.value().ToKey();
   }
 
+  /// The stable key of the default pipeline, if it was created from a
+  /// descriptor.
+  std::optional<uint64_t> GetPipelineKey() const { return pipeline_key_; }
+
+  void SetVariantRecord(PipelineVariantRecord* record) { record_ = record; }
+
+  /// Records the use of a variant created on demand, if there is a record.
+  void RecordVariant(const ContentContextOptions& opts) {
+    if (record_ != nullptr && pipeline_key_.has_value()) {
+      record_->RecordUse({.pipeline_key = pipeline_key_.value(),
+                          .options_key = opts.ToKey()});
+    }
+  }
+
+  /// Records the use of every variant that has been waited on.
+  void RecordUsedVariants(PipelineVariantRecord& record) const {
+    if (!pipeline_key_.has_value()) {
+      return;
+    }
+    for (const auto& [key, pipeline] : pipelines_) {
+      if (pipeline->WasWaitedOn() && (!default_options_.has_value() ||
+                                      key != default_options_->ToKey())) {
+        record.RecordUse(
+            {.pipeline_key = pipeline_key_.value(), .options_key = key});
+      }
+    }
+  }
+
+  /// Creates a variant from the default descriptor without waiting for the
+  /// default pipeline. The variant is compiled asynchronously.
+  void CreateVariantAsync(const Context& context,
+                          const ContentContextOptions& opts) {
+    if (!desc_.has_value() || make_handle_ == nullptr || Get(opts) != nullptr) {
+      return;
+    }
+    PipelineDescriptor desc = desc_.value();
+    opts.ApplyToPipelineDescriptor(desc);
+    desc.SetLabel(std::format("{} V#{}", desc.GetLabel(), pipelines_.size()));
+    Set(opts, make_handle_(context, std::move(desc)));
+  }
+
  protected:
+  using HandleFactory = std::unique_ptr<GenericRenderPipelineHandle> (*)(
+      const Context& context,
+      std::optional<PipelineDescriptor> desc);
+
   std::optional<PipelineDescriptor> desc_;
   std::optional<ContentContextOptions> default_options_;
   std::vector<std::pair<uint64_t, std::unique_ptr<GenericRenderPipelineHandle>>>
       pipelines_;
+  std::optional<uint64_t> pipeline_key_;
+  HandleFactory make_handle_ = nullptr;
+  PipelineVariantRecord* record_ = nullptr;
 };
 
 /// Holds multiple Pipelines associated with the same PipelineHandle types.
@@ -127,6 +180,13 @@ class Variants : public GenericVariants {
       return;
     }
     context.GetPipelineLibrary()->LogPipelineCreation(*desc);
+    pipeline_key_ = PipelineVariantRecord::ComputePipelineKey(*desc);
+    make_handle_ = [](const Context& context,
+                      std::optional<PipelineDescriptor> desc)
+        -> std::unique_ptr<GenericRenderPipelineHandle> {
+      return std::make_unique<PipelineHandleT>(context, std::move(desc),
+                                               /*async=*/true);
+    };
     options.ApplyToPipelineDescriptor(*desc);
     desc_ = desc;
     SetDefault(options, std::make_unique<PipelineHandleT>(context, desc_,
@@ -195,6 +255,7 @@ RenderPipelineHandleT* CreateIfNeeded(
   std::unique_ptr<RenderPipelineHandleT> variant =
       std::make_unique<RenderPipelineHandleT>(std::move(variant_future));
   container.Set(opts, std::move(variant));
+  container.RecordVariant(opts);
   return container.Get(opts);
 }
 
@@ -265,6 +326,8 @@ struct ContentContext::Pipelines {
   Variants<FramebufferBlendSoftLightPipeline> framebuffer_blend_softlight;
   Variants<GaussianBlurPipeline> gaussian_blur;
   Variants<GlyphAtlasPipeline> glyph_atlas;
+  Variants<KawaseDownsamplePipeline> kawase_downsample;
+  Variants<KawaseUpsamplePipeline> kawase_upsample;
   Variants<LinePipeline> line;
   Variants<LinearGradientFillPipeline> linear_gradient_fill;
   Variants<LinearGradientSSBOFillPipeline> linear_gradient_ssbo_fill;
@@ -316,9 +379,142 @@ struct ContentContext::Pipelines {
 #if defined(IMPELLER_ENABLE_OPENGLES)
   Variants<TextureDownsampleGlesPipeline> texture_downsample_gles;
 #endif  // IMPELLER_ENABLE_OPENGLES
+
+  /// Returns all of the containers above.
+  std::vector<GenericVariants*> GetAll() {
+    return {
+        &blend_colorburn,
+        &blend_colordodge,
+        &blend_color,
+        &blend_darken,
+        &blend_difference,
+        &blend_exclusion,
+        &blend_hardlight,
+        &blend_hue,
+        &blend_lighten,
+        &blend_luminosity,
+        &blend_multiply,
+        &blend_overlay,
+        &blend_saturation,
+        &blend_screen,
+        &blend_softlight,
+        &border_mask_blur,
+        &circle,
+        &clip,
+        &color_matrix_color_filter,
+        &conical_gradient_fill,
+        &conical_gradient_fill_radial,
+        &conical_gradient_fill_strip,
+        &conical_gradient_fill_strip_and_radial,
+        &conical_gradient_ssbo_fill,
+        &conical_gradient_ssbo_fill_radial,
+        &conical_gradient_ssbo_fill_strip_and_radial,
+        &conical_gradient_ssbo_fill_strip,
+        &conical_gradient_uniform_fill,
+        &conical_gradient_uniform_fill_radial,
+        &conical_gradient_uniform_fill_strip,
+        &conical_gradient_uniform_fill_strip_and_radial,
+        &fast_gradient,
+        &framebuffer_blend_colorburn,
+        &framebuffer_blend_colordodge,
+        &framebuffer_blend_color,
+        &framebuffer_blend_darken,
+        &framebuffer_blend_difference,
+        &framebuffer_blend_exclusion,
+        &framebuffer_blend_hardlight,
+        &framebuffer_blend_hue,
+        &framebuffer_blend_lighten,
+        &framebuffer_blend_luminosity,
+        &framebuffer_blend_multiply,
+        &framebuffer_blend_overlay,
+        &framebuffer_blend_saturation,
+        &framebuffer_blend_screen,
+        &framebuffer_blend_softlight,
+        &gaussian_blur,
+        &glyph_atlas,
+        &kawase_downsample,
+        &kawase_upsample,
+        &line,
+        &linear_gradient_fill,
+        &linear_gradient_ssbo_fill,
+        &linear_gradient_uniform_fill,
+        &linear_to_srgb_filter,
+        &morphology_filter,
+        &clear_blend,
+        &destination_a_top_blend,
+        &destination_blend,
+        &destination_in_blend,
+        &destination_out_blend,
+        &destination_over_blend,
+        &modulate_blend,
+        &plus_blend,
+        &screen_blend,
+        &source_a_top_blend,
+        &source_blend,
+        &source_in_blend,
+        &source_out_blend,
+        &source_over_blend,
+        &xor_blend,
+        &radial_gradient_fill,
+        &radial_gradient_ssbo_fill,
+        &radial_gradient_uniform_fill,
+        &rrect_blur,
+        &rsuperellipse_blur,
+        &shadow_vertices_,
+        &solid_fill,
+        &srgb_to_linear_filter,
+        &sweep_gradient_fill,
+        &sweep_gradient_ssbo_fill,
+        &sweep_gradient_uniform_fill,
+        &texture_downsample,
+        &texture_downsample_bounded,
+        &texture,
+        &texture_strict_src,
+        &tiled_texture,
+        &vertices_uber_1_,
+        &vertices_uber_2_,
+        &uber_sdf,
+        &yuv_to_rgb_filter,
+#if defined(IMPELLER_ENABLE_OPENGLES) && !defined(FML_OS_EMSCRIPTEN)
+        &tiled_texture_external,
+        &tiled_texture_uv_external,
+#endif
+#if defined(IMPELLER_ENABLE_OPENGLES)
+        &texture_downsample_gles,
+#endif  // IMPELLER_ENABLE_OPENGLES
+    };
+  }
   // clang-format on
 };
 
+std::optional<ContentContextOptions> ContentContextOptions::FromKey(
+    uint64_t key) {
+  ContentContextOptions options{
+      .sample_count = static_cast<SampleCount>((key >> 48) & 0xff),
+      .blend_mode = static_cast<BlendMode>((key >> 40) & 0xff),
+      .depth_compare = static_cast<CompareFunction>((key >> 32) & 0xff),
+      .stencil_mode = static_cast<StencilMode>((key >> 24) & 0xff),
+      .primitive_type = static_cast<PrimitiveType>((key >> 16) & 0xff),
+      .color_attachment_pixel_format =
+          static_cast<PixelFormat>((key >> 8) & 0xff),
+      .has_depth_stencil_attachments = ((key >> 2) & 1) != 0,
+      .depth_write_enabled = ((key >> 3) & 1) != 0,
+      .is_for_rrect_blur_clear = (key & 1) != 0,
+  };
+  if (options.ToKey() != key ||
+      (options.sample_count != SampleCount::kCount1 &&
+       options.sample_count != SampleCount::kCount4) ||
+      options.blend_mode > Entity::kLastPipelineBlendMode ||
+      options.depth_compare > CompareFunction::kGreaterEqual ||
+      options.stencil_mode > StencilMode::kCoverCompareInverted ||
+      options.primitive_type > PrimitiveType::kTriangleFan ||
+      options.color_attachment_pixel_format == PixelFormat::kUnknown ||
+      options.color_attachment_pixel_format > PixelFormat::kR32Float) {
+    return std::nullopt;
+  }
+  return options;
+}
+
 void ContentContextOptions::ApplyToPipelineDescriptor(
     PipelineDescriptor& desc) const {
   auto pipeline_blend = blend_mode;
@@ -581,6 +777,11 @@ ContentContext::ContentContext(
                 context_->GetResourceAllocator(), context_->GetIdleWaiter(),
                 context_->GetCapabilities()->GetMinimumUniformAlignment())
           : data_host_buffer_;
+  if (context_->GetFlags().tessellation_cache) {
+    // The persisted file lives next to the pipeline and shader caches.
+    tessellator_->SetTessellationCache(std::make_shared<TessellationCache>(
+        TessellationCache::kDefaultMaxBytes, fml::paths::GetCachesDirectory()));
+  }
   {
     TextureDescriptor desc;
     desc.storage_mode = StorageMode::kDevicePrivate;
@@ -712,6 +913,10 @@ ContentContext::ContentContext(
                                             {supports_decal});
     pipelines_->gaussian_blur.CreateDefault(
         *context_, options_no_msaa_no_depth_stencil, {supports_decal});
+    pipelines_->kawase_downsample.CreateDefault(
+        *context_, options_no_msaa_no_depth_stencil);
+    pipelines_->kawase_upsample.CreateDefault(*context_,
+                                              options_no_msaa_no_depth_stencil);
     pipelines_->border_mask_blur.CreateDefault(*context_,
                                                options_trianglestrip);
     pipelines_->color_matrix_color_filter.CreateDefault(*context_,
@@ -873,6 +1078,12 @@ ContentContext::ContentContext(
   }
 
   is_valid_ = true;
+  if (context_->GetFlags().pipeline_variant_warm_up) {
+    // The persisted file lives next to the pipeline and shader caches.
+    pipeline_variant_record_ = std::make_unique<PipelineVariantRecord>(
+        fml::paths::GetCachesDirectory());
+    CreateRecordedPipelineVariants();
+  }
   InitializeCommonlyUsedShadersIfNeeded();
 }
 
@@ -1021,6 +1232,89 @@ void ContentContext::InitializeCommonlyUsedShadersIfNeeded() const {
   GetContext()->InitializeCommonlyUsedShadersIfNeeded();
 }
 
+void ContentContext::CreateRecordedPipelineVariants() {
+  TRACE_EVENT0("impeller", "CreateRecordedPipelineVariants");
+  std::unordered_map<uint64_t, GenericVariants*> containers;
+  for (GenericVariants* container : pipelines_->GetAll()) {
+    if (std::optional<uint64_t> key = container->GetPipelineKey()) {
+      container->SetVariantRecord(pipeline_variant_record_.get());
+      containers[key.value()] = container;
+    }
+  }
+
+  // The defaults were posted to the compile queue first, so the recorded
+  // variants are compiled after them. A variant that is needed before it was
+  // compiled is compiled eagerly by |GenericRenderPipelineHandle::WaitAndGet|.
+  for (const PipelineVariantRecord::Variant& variant :
+       pipeline_variant_record_->GetPersistedVariants()) {
+    auto found = containers.find(variant.pipeline_key);
+    if (found == containers.end()) {
+      continue;
+    }
+    std::optional<ContentContextOptions> options =
+        ContentContextOptions::FromKey(variant.options_key);
+    if (!options.has_value()) {
+      continue;
+    }
+    found->second->CreateVariantAsync(*context_, options.value());
+  }
+}
+
+void ContentContext::MarkOnscreenFrameEnd() {
+  onscreen_frame_count_++;
+  if (onscreen_frame_count_ < kPersistCachesAfterFrameCount ||
+      (onscreen_frame_count_ - kPersistCachesAfterFrameCount) %
+              kPersistCachesIntervalFrameCount !=
+          0u) {
+    return;
+  }
+  // Writes of the same file must not overlap. The caches stay dirty and are
+  // written at the next interval instead.
+  if (persisting_caches_->load()) {
+    return;
+  }
+  // The caches are serialized on the raster thread, which owns them, and
+  // only the file writes are moved off of it. Caches that did not change
+  // since they were last written are not serialized.
+  std::vector<std::function<bool()>> writes;
+  if (const auto& cache = tessellator_->GetTessellationCache()) {
+    if (std::function<bool()> write = cache->SerializeForPersist()) {
+      writes.push_back(std::move(write));
+    }
+  }
+  if (pipeline_variant_record_) {
+    RecordUsedPipelineVariants();
+    if (std::function<bool()> write =
+            pipeline_variant_record_->SerializeForPersist()) {
+      writes.push_back(std::move(write));
+    }
+  }
+  if (writes.empty()) {
+    return;
+  }
+  persisting_caches_->store(true);
+  auto persist = [writes = std::move(writes),
+                  persisting_caches = persisting_caches_]() {
+    TRACE_EVENT0("impeller", "PersistContentContextCaches");
+    for (const std::function<bool()>& write : writes) {
+      write();
+    }
+    persisting_caches->store(false);
+  };
+  if (std::shared_ptr<fml::ConcurrentTaskRunner> runner =
+          context_->GetConcurrentWorkerTaskRunner()) {
+    runner->PostTask(std::move(persist));
+  } else {
+    persist();
+  }
+}
+
+void ContentContext::RecordUsedPipelineVariants() const {
+  for (GenericVariants* container : pipelines_->GetAll()) {
+    container->RecordUsedVariants(*pipeline_variant_record_);
+  }
+}
+
 PipelineRef ContentContext::GetFastGradientPipeline(
     ContentContextOptions opts) const {
   return GetPipeline(this, pipelines_->fast_gradient, opts);
@@ -1163,6 +1457,16 @@ PipelineRef ContentContext::GetGaussianBlurPipeline(
   return GetPipeline(this, pipelines_->gaussian_blur, opts);
 }
 
+PipelineRef ContentContext::GetKawaseDownsamplePipeline(
+    ContentContextOptions opts) const {
+  return GetPipeline(this, pipelines_->kawase_downsample, opts);
+}
+
+PipelineRef ContentContext::GetKawaseUpsamplePipeline(
+    ContentContextOptions opts) const {
+  return GetPipeline(this, pipelines_->kawase_upsample, opts);
+}
+
 PipelineRef ContentContext::GetBorderMaskBlurPipeline(
     ContentContextOptions opts) const {
   return GetPipeline(this, pipelines_->border_mask_blur, opts);
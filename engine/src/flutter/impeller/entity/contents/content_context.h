@@ -5,6 +5,7 @@
 #ifndef FLUTTER_IMPELLER_ENTITY_CONTENTS_CONTENT_CONTEXT_H_
 #define FLUTTER_IMPELLER_ENTITY_CONTENTS_CONTENT_CONTEXT_H_
 
+#include <atomic>
 #include <initializer_list>
 #include <memory>
 #include <optional>
@@ -107,6 +108,10 @@ struct ContentContextOptions {
            static_cast<uint64_t>(sample_count) << 48;
   }
 
+  /// Returns the options of a key produced by |ToKey|, or std::nullopt if the
+  /// key does not describe valid options.
+  static std::optional<ContentContextOptions> FromKey(uint64_t key);
+
   void ApplyToPipelineDescriptor(PipelineDescriptor& desc) const;
 };
 
@@ -119,6 +124,7 @@ enum ConicalKind {
 
 class Tessellator;
 class RenderTargetCache;
+class PipelineVariantRecord;
 
 class ContentContext {
  public:
@@ -184,6 +190,8 @@ class ContentContext {
   PipelineRef GetFramebufferBlendSoftLightPipeline(ContentContextOptions opts) const;
   PipelineRef GetGaussianBlurPipeline(ContentContextOptions opts) const;
   PipelineRef GetGlyphAtlasPipeline(ContentContextOptions opts) const;
+  PipelineRef GetKawaseDownsamplePipeline(ContentContextOptions opts) const;
+  PipelineRef GetKawaseUpsamplePipeline(ContentContextOptions opts) const;
   PipelineRef GetLinePipeline(ContentContextOptions opts) const;
   PipelineRef GetLinearGradientFillPipeline(ContentContextOptions opts) const;
   PipelineRef GetLinearGradientSSBOFillPipeline(ContentContextOptions opts) const;
@@ -320,6 +328,22 @@ class ContentContext {
   /// @brief Resets the transients buffers held onto by the content context.
   void ResetTransientsBuffers();
 
+  /// @brief Marks the end of a frame rendered to an onscreen surface.
+  ///
+  /// The caches that are persisted across launches are first written after
+  /// |kPersistCachesAfterFrameCount| onscreen frames, and then every
+  /// |kPersistCachesIntervalFrameCount| onscreen frames if they changed, on a
+  /// worker thread of the context if it has one.
+  void MarkOnscreenFrameEnd();
+
+  /// The number of onscreen frames after which the caches that are persisted
+  /// across launches are first written to disk.
+  static constexpr uint32_t kPersistCachesAfterFrameCount = 120u;
+
+  /// The number of onscreen frames between later writes of the caches that
+  /// are persisted across launches.
+  static constexpr uint32_t kPersistCachesIntervalFrameCount = 1800u;
+
   TextShadowCache& GetTextShadowCache() const { return *text_shadow_cache_; }
 
  protected:
@@ -345,6 +369,13 @@ class ContentContext {
   /// shader variants, as well as forcing driver initialization.
   void InitializeCommonlyUsedShadersIfNeeded() const;
 
+  /// Creates the pipeline variants recorded by previous launches on the
+  /// pipeline compile queue, in the order in which they were recorded.
+  void CreateRecordedPipelineVariants();
+
+  /// Records the pipeline variants that were used in this launch.
+  void RecordUsedPipelineVariants() const;
+
   struct RuntimeEffectPipelineKey {
     std::string unique_entrypoint_name;
     ContentContextOptions options;
@@ -381,6 +412,11 @@ class ContentContext {
   std::shared_ptr<HostBuffer> indexes_host_buffer_;
   std::shared_ptr<Texture> empty_texture_;
   std::unique_ptr<TextShadowCache> text_shadow_cache_;
+  std::unique_ptr<PipelineVariantRecord> pipeline_variant_record_;
+  uint32_t onscreen_frame_count_ = 0u;
+  // Whether the caches are being written on a worker thread.
+  std::shared_ptr<std::atomic<bool>> persisting_caches_ =
+      std::make_shared<std::atomic<bool>>(false);
 
   bool is_texture_caching_enabled_ = false;
   mutable std::unordered_map<const flutter::DlImage*, std::shared_ptr<Texture>>
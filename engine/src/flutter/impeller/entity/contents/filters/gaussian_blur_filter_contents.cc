@@ -4,7 +4,9 @@
 
 #include "impeller/entity/contents/filters/gaussian_blur_filter_contents.h"
 
+#include <array>
 #include <cmath>
+#include <vector>
 
 #include "flutter/fml/make_copyable.h"
 #include "impeller/entity/contents/clip_contents.h"
@@ -27,6 +29,50 @@ namespace {
 
 constexpr Scalar kMaxSigma = 500.0f;
 
+// The variance of a Kawase blur along one axis divided by (4^n - 1) / 3, the
+// growth of the variance with the number of iterations n, for offsets from
+// kKawaseBlurMinOffset to kKawaseBlurMaxOffset in steps of kKawaseOffsetStep.
+//
+// These were measured by applying the passes to an impulse. The bilinear
+// filtering of the samples makes the variance depend on the offset in a way
+// that has no simple closed form, but it is smooth enough between these
+// points to interpolate linearly.
+constexpr Scalar kKawaseOffsetStep = 0.125f;
+constexpr std::array<Scalar, 11> kKawaseVariances = {
+    2.09423f, 2.48541f, 2.83333f, 3.16931f, 3.50293f, 3.91961f,
+    4.33627f, 5.50931f, 6.50000f, 7.45343f, 8.33039f,
+};
+static_assert(kKawaseBlurMinOffset +
+                  kKawaseOffsetStep *
+                      static_cast<Scalar>(kKawaseVariances.size() - 1) ==
+              kKawaseBlurMaxOffset);
+
+// How much the variance of the axis with the larger sigma may exceed what the
+// largest offset reaches before the Kawase blur is rejected, about 5% in sigma.
+constexpr Scalar kKawaseVarianceTolerance = 1.1f;
+
+Scalar GetKawaseIterationsScale(int iterations) {
+  return (std::pow(4.0f, iterations) - 1.0f) / 3.0f;
+}
+
+/// The inverse of CalculateKawaseBlurVariance for a given number of
+/// iterations, clamped to the supported offsets.
+Scalar CalculateKawaseBlurOffset(int iterations, Scalar variance) {
+  Scalar scaled_variance = variance / GetKawaseIterationsScale(iterations);
+  if (scaled_variance <= kKawaseVariances.front()) {
+    return kKawaseBlurMinOffset;
+  }
+  for (size_t i = 1; i < kKawaseVariances.size(); i++) {
+    if (scaled_variance < kKawaseVariances[i]) {
+      Scalar fraction = (scaled_variance - kKawaseVariances[i - 1]) /
+                        (kKawaseVariances[i] - kKawaseVariances[i - 1]);
+      return kKawaseBlurMinOffset +
+             kKawaseOffsetStep * (static_cast<Scalar>(i - 1) + fraction);
+    }
+  }
+  return kKawaseBlurMaxOffset;
+}
+
 SamplerDescriptor MakeSamplerDescriptor(MinMagFilter filter,
                                         SamplerAddressMode address_mode) {
   SamplerDescriptor sampler_desc;
@@ -314,17 +360,13 @@ struct DownsamplePassArgs {
 
 /// Calculates info required for the down-sampling pass.
 DownsamplePassArgs CalculateDownsamplePassArgs(
-    Vector2 scaled_sigma,
+    Scalar desired_scalar,
     Vector2 padding,
     const Snapshot& input_snapshot,
     const std::optional<Rect>& source_expanded_coverage_hint,
     const std::optional<Quad>& source_bounds,
     const std::shared_ptr<FilterInput>& input,
     const Entity& snapshot_entity) {
-  Scalar desired_scalar =
-      std::min(GaussianBlurFilterContents::CalculateScale(scaled_sigma.x),
-               GaussianBlurFilterContents::CalculateScale(scaled_sigma.y));
-
   // TODO(jonahwilliams): If desired_scalar is 1.0 and we fully acquired the
   // gutter from the expanded_coverage_hint, we can skip the downsample pass.
   // pass.
@@ -661,6 +703,218 @@ int ScaleBlurRadius(Scalar radius, Scalar scalar) {
   return static_cast<int>(std::round(radius * scalar));
 }
 
+/// Blurs |input_pass| with a Y-direction blur pass followed by an X-direction
+/// blur pass, appending the command buffer of each pass to |command_buffers|.
+fml::StatusOr<RenderTarget> MakeSeparableBlurSubpasses(
+    const ContentContext& renderer,
+    const RenderTarget& input_pass,
+    const SamplerDescriptor& sampler_descriptor,
+    const BlurInfo& blur_info,
+    Vector2 effective_scalar,
+    bool apply_unpremultiply,
+    std::vector<std::shared_ptr<CommandBuffer>>& command_buffers) {
+  Vector2 input_pixel_size =
+      1.0 / Vector2(input_pass.GetRenderTargetTexture()->GetSize());
+
+  Quad blur_uvs = {Point(0, 0), Point(1, 0), Point(0, 1), Point(1, 1)};
+
+  std::shared_ptr<CommandBuffer> command_buffer_y =
+      renderer.GetContext()->CreateCommandBuffer();
+  if (!command_buffer_y) {
+    return fml::Status(fml::StatusCode::kUnavailable,
+                       "Failed to create command buffer.");
+  }
+
+  fml::StatusOr<RenderTarget> pass_y_out = MakeBlurSubpass(
+      renderer, command_buffer_y, input_pass, sampler_descriptor,
+      BlurParameters{
+          .blur_uv_offset = Point(0.0, input_pixel_size.y),
+          .blur_sigma = blur_info.scaled_sigma.y * effective_scalar.y,
+          .blur_radius =
+              ScaleBlurRadius(blur_info.blur_radius.y, effective_scalar.y),
+          .step_size = 1,
+          .apply_unpremultiply = false,
+      },
+      /*destination_target=*/std::nullopt, blur_uvs);
+
+  if (!pass_y_out.ok()) {
+    return pass_y_out;
+  }
+  command_buffers.push_back(std::move(command_buffer_y));
+
+  std::shared_ptr<CommandBuffer> command_buffer_x =
+      renderer.GetContext()->CreateCommandBuffer();
+  if (!command_buffer_x) {
+    return fml::Status(fml::StatusCode::kUnavailable,
+                       "Failed to create command buffer.");
+  }
+
+  // Only ping pong if the first pass actually created a render target.
+  auto pass_x_destination =
+      pass_y_out.value().GetRenderTargetTexture() !=
+              input_pass.GetRenderTargetTexture()
+          ? std::optional<RenderTarget>(input_pass)
+          : std::optional<RenderTarget>(std::nullopt);
+
+  fml::StatusOr<RenderTarget> pass_x_out = MakeBlurSubpass(
+      renderer, command_buffer_x, /*input_pass=*/pass_y_out.value(),
+      sampler_descriptor,
+      BlurParameters{
+          .blur_uv_offset = Point(input_pixel_size.x, 0.0),
+          .blur_sigma = blur_info.scaled_sigma.x * effective_scalar.x,
+          .blur_radius =
+              ScaleBlurRadius(blur_info.blur_radius.x, effective_scalar.x),
+          .step_size = 1,
+          .apply_unpremultiply = apply_unpremultiply,
+      },
+      pass_x_destination, blur_uvs);
+
+  if (!pass_x_out.ok()) {
+    return pass_x_out;
+  }
+  command_buffers.push_back(std::move(command_buffer_x));
+
+  // The ping-pong approach requires that each render pass output has the same
+  // size.
+  FML_DCHECK((input_pass.GetRenderTargetSize() ==
+              pass_y_out.value().GetRenderTargetSize()) &&
+             (pass_y_out.value().GetRenderTargetSize() ==
+              pass_x_out.value().GetRenderTargetSize()));
+
+  return pass_x_out;
+}
+
+/// Renders one pass of a Kawase blur of |input_texture| with its own command
+/// buffer, which is appended to |command_buffers|.
+///
+/// Downsample passes render into a new target of half the size of the input.
+/// Upsample passes render into |destination_target|, which is the level of
+/// the pyramid that the matching downsample pass read from.
+fml::StatusOr<RenderTarget> MakeKawaseSubpass(
+    const ContentContext& renderer,
+    const std::shared_ptr<Texture>& input_texture,
+    Vector2 offset,
+    std::optional<RenderTarget> destination_target,
+    bool apply_unpremultiply,
+    std::vector<std::shared_ptr<CommandBuffer>>& command_buffers) {
+  using VS = KawaseDownsamplePipeline::VertexShader;
+  using DownsampleFS = KawaseDownsamplePipeline::FragmentShader;
+  using UpsampleFS = KawaseUpsamplePipeline::FragmentShader;
+
+  std::shared_ptr<CommandBuffer> command_buffer =
+      renderer.GetContext()->CreateCommandBuffer();
+  if (!command_buffer) {
+    return fml::Status(fml::StatusCode::kUnavailable,
+                       "Failed to create command buffer.");
+  }
+
+  const bool is_upsample = destination_target.has_value();
+  ContentContext::SubpassCallback subpass_callback =
+      [&](const ContentContext& renderer, RenderPass& pass) {
+        HostBuffer& data_host_buffer = renderer.GetTransientsDataBuffer();
+
+        ContentContextOptions options = OptionsFromPass(pass);
+        options.primitive_type = PrimitiveType::kTriangleStrip;
+
+        VS::FrameInfo frame_info;
+        frame_info.mvp = Matrix::MakeOrthographic(ISize(1, 1));
+        frame_info.texture_sampler_y_coord_scale =
+            input_texture->GetYCoordScale();
+        VS::BindFrameInfo(pass, data_host_buffer.EmplaceUniform(frame_info));
+
+        std::array<VS::PerVertexData, 4> vertices = {
+            VS::PerVertexData{Point(0, 0), Point(0, 0)},
+            VS::PerVertexData{Point(1, 0), Point(1, 0)},
+            VS::PerVertexData{Point(0, 1), Point(0, 1)},
+            VS::PerVertexData{Point(1, 1), Point(1, 1)},
+        };
+        pass.SetVertexBuffer(CreateVertexBuffer(vertices, data_host_buffer));
+
+        // The downsample pass already padded the input with the gutter for
+        // the tile mode, so the pyramid only needs to clamp.
+        raw_ptr<const Sampler> sampler =
+            renderer.GetContext()->GetSamplerLibrary()->GetSampler(
+                MakeSamplerDescriptor(MinMagFilter::kLinear,
+                                      SamplerAddressMode::kClampToEdge));
+        Point uv_offset = offset / Vector2(input_texture->GetSize());
+
+        if (is_upsample) {
+          pass.SetCommandLabel("Kawase blur upsample");
+          pass.SetPipeline(renderer.GetKawaseUpsamplePipeline(options));
+
+          UpsampleFS::FragInfo frag_info;
+          frag_info.offset = uv_offset;
+          frag_info.unpremultiply = apply_unpremultiply ? 1.0f : 0.0f;
+          UpsampleFS::BindFragInfo(pass,
+                                   data_host_buffer.EmplaceUniform(frag_info));
+          UpsampleFS::BindTextureSampler(pass, input_texture, sampler);
+        } else {
+          pass.SetCommandLabel("Kawase blur downsample");
+          pass.SetPipeline(renderer.GetKawaseDownsamplePipeline(options));
+
+          DownsampleFS::FragInfo frag_info;
+          frag_info.offset = uv_offset;
+          DownsampleFS::BindFragInfo(
+              pass, data_host_buffer.EmplaceUniform(frag_info));
+          DownsampleFS::BindTextureSampler(pass, input_texture, sampler);
+        }
+        return pass.Draw().ok();
+      };
+
+  ISize input_size = input_texture->GetSize();
+  ISize downsample_size(std::max<int64_t>(1, (input_size.width + 1) / 2),
+                        std::max<int64_t>(1, (input_size.height + 1) / 2));
+  fml::StatusOr<RenderTarget> result =
+      is_upsample
+          ? renderer.MakeSubpass("Kawase Blur Filter",
+                                 destination_target.value(), command_buffer,
+                                 subpass_callback)
+          : renderer.MakeSubpass("Kawase Blur Filter", downsample_size,
+                                 command_buffer, subpass_callback,
+                                 /*msaa_enabled=*/false,
+                                 /*depth_stencil_enabled=*/false);
+  if (result.ok()) {
+    command_buffers.push_back(std::move(command_buffer));
+  }
+  return result;
+}
+
+/// Blurs |input_pass| with a Kawase blur, appending the command buffer of each
+/// pass to |command_buffers|. The result is rendered into |input_pass|.
+fml::StatusOr<RenderTarget> MakeKawaseBlurSubpasses(
+    const ContentContext& renderer,
+    const RenderTarget& input_pass,
+    const KawaseBlurParameters& parameters,
+    bool apply_unpremultiply,
+    std::vector<std::shared_ptr<CommandBuffer>>& command_buffers) {
+  // Each level of the pyramid is read by the downsample pass that makes the
+  // next level, and then overwritten by the upsample pass that comes back up
+  // to it.
+  std::vector<RenderTarget> levels = {input_pass};
+  for (int i = 0; i < parameters.iterations; i++) {
+    fml::StatusOr<RenderTarget> level = MakeKawaseSubpass(
+        renderer, levels.back().GetRenderTargetTexture(), parameters.offset,
+        /*destination_target=*/std::nullopt,
+        /*apply_unpremultiply=*/false, command_buffers);
+    if (!level.ok()) {
+      return level;
+    }
+    levels.push_back(level.value());
+  }
+  for (size_t i = levels.size() - 1; i > 0; i--) {
+    fml::StatusOr<RenderTarget> level = MakeKawaseSubpass(
+        renderer, levels[i].GetRenderTargetTexture(), parameters.offset,
+        /*destination_target=*/levels[i - 1],
+        /*apply_unpremultiply=*/apply_unpremultiply && i == 1,
+        command_buffers);
+    if (!level.ok()) {
+      return level;
+    }
+    levels[i - 1] = level.value();
+  }
+  return levels[0];
+}
+
 Entity ApplyClippedBlurStyle(Entity::ClipOperation clip_operation,
                              const Entity& entity,
                              const std::shared_ptr<FilterInput>& input,
@@ -896,12 +1150,34 @@ std::optional<Entity> GaussianBlurFilterContents::RenderFilter(
     return result;
   }
 
-  // Note: The code below uses three different command buffers when it would be
+  Scalar downsample_scalar = std::min(CalculateScale(blur_info.scaled_sigma.x),
+                                      CalculateScale(blur_info.scaled_sigma.y));
+  std::optional<KawaseBlurParameters> kawase_parameters;
+  if (algorithm_ == Algorithm::kKawase ||
+      (algorithm_ == Algorithm::kAutomatic &&
+       std::min(blur_info.scaled_sigma.x, blur_info.scaled_sigma.y) >=
+           kKawaseBlurMinSigma)) {
+    // The Kawase blur starts from a half size copy of the input and does the
+    // rest of the downsampling in its pyramid.
+    DownsamplePassArgs kawase_downsample_pass_args =
+        CalculateDownsamplePassArgs(
+            /*desired_scalar=*/0.5f, blur_info.padding, input_snapshot.value(),
+            source_expanded_coverage_hint, source_bounds, inputs[0],
+            snapshot_entity);
+    kawase_parameters = CalculateKawaseBlurParameters(
+        blur_info.scaled_sigma * kawase_downsample_pass_args.effective_scalar,
+        kawase_downsample_pass_args.subpass_size);
+    if (kawase_parameters.has_value()) {
+      downsample_scalar = 0.5f;
+    }
+  }
+
+  // Note: The code below uses a command buffer per pass when it would be
   // possible to combine the operations into a single buffer. From testing and
   // user bug reports (see https://github.com/flutter/flutter/issues/154046 ),
   // this sometimes causes deviceLost errors on older Adreno devices. Breaking
-  // the work up into three different command buffers seems to prevent this
-  // crash.
+  // the work up into different command buffers seems to prevent this crash.
+  std::vector<std::shared_ptr<CommandBuffer>> command_buffers;
   std::shared_ptr<CommandBuffer> command_buffer_1 =
       renderer.GetContext()->CreateCommandBuffer();
   if (!command_buffer_1) {
@@ -909,7 +1185,7 @@ std::optional<Entity> GaussianBlurFilterContents::RenderFilter(
   }
 
   DownsamplePassArgs downsample_pass_args = CalculateDownsamplePassArgs(
-      blur_info.scaled_sigma, blur_info.padding, input_snapshot.value(),
+      downsample_scalar, blur_info.padding, input_snapshot.value(),
       source_expanded_coverage_hint, source_bounds, inputs[0], snapshot_entity);
 
   fml::StatusOr<RenderTarget> pass1_out = MakeDownsampleSubpass(
@@ -919,87 +1195,35 @@ std::optional<Entity> GaussianBlurFilterContents::RenderFilter(
   if (!pass1_out.ok()) {
     return std::nullopt;
   }
-
-  Vector2 pass1_pixel_size =
-      1.0 / Vector2(pass1_out.value().GetRenderTargetTexture()->GetSize());
-
-  Quad blur_uvs = {Point(0, 0), Point(1, 0), Point(0, 1), Point(1, 1)};
-
-  std::shared_ptr<CommandBuffer> command_buffer_2 =
-      renderer.GetContext()->CreateCommandBuffer();
-  if (!command_buffer_2) {
-    return std::nullopt;
-  }
-
-  fml::StatusOr<RenderTarget> pass2_out = MakeBlurSubpass(
-      renderer, command_buffer_2, /*input_pass=*/pass1_out.value(),
-      input_snapshot->sampler_descriptor,
-      BlurParameters{
-          .blur_uv_offset = Point(0.0, pass1_pixel_size.y),
-          .blur_sigma = blur_info.scaled_sigma.y *
-                        downsample_pass_args.effective_scalar.y,
-          .blur_radius = ScaleBlurRadius(
-              blur_info.blur_radius.y, downsample_pass_args.effective_scalar.y),
-          .step_size = 1,
-          .apply_unpremultiply = false,
-      },
-      /*destination_target=*/std::nullopt, blur_uvs);
-
-  if (!pass2_out.ok()) {
-    return std::nullopt;
-  }
-
-  std::shared_ptr<CommandBuffer> command_buffer_3 =
-      renderer.GetContext()->CreateCommandBuffer();
-  if (!command_buffer_3) {
-    return std::nullopt;
-  }
-
-  // Only ping pong if the first pass actually created a render target.
-  auto pass3_destination = pass2_out.value().GetRenderTargetTexture() !=
-                                   pass1_out.value().GetRenderTargetTexture()
-                               ? std::optional<RenderTarget>(pass1_out.value())
-                               : std::optional<RenderTarget>(std::nullopt);
-
-  fml::StatusOr<RenderTarget> pass3_out = MakeBlurSubpass(
-      renderer, command_buffer_3, /*input_pass=*/pass2_out.value(),
-      input_snapshot->sampler_descriptor,
-      BlurParameters{
-          .blur_uv_offset = Point(pass1_pixel_size.x, 0.0),
-          .blur_sigma = blur_info.scaled_sigma.x *
-                        downsample_pass_args.effective_scalar.x,
-          .blur_radius = ScaleBlurRadius(
-              blur_info.blur_radius.x, downsample_pass_args.effective_scalar.x),
-          .step_size = 1,
-          .apply_unpremultiply = bounds_.has_value(),
-      },
-      pass3_destination, blur_uvs);
-
-  if (!pass3_out.ok()) {
+  command_buffers.push_back(std::move(command_buffer_1));
+
+  fml::StatusOr<RenderTarget> blur_out =
+      kawase_parameters.has_value()
+          ? MakeKawaseBlurSubpasses(renderer, pass1_out.value(),
+                                    kawase_parameters.value(),
+                                    /*apply_unpremultiply=*/bounds_.has_value(),
+                                    command_buffers)
+          : MakeSeparableBlurSubpasses(
+                renderer, pass1_out.value(), input_snapshot->sampler_descriptor,
+                blur_info, downsample_pass_args.effective_scalar,
+                /*apply_unpremultiply=*/bounds_.has_value(), command_buffers);
+
+  if (!blur_out.ok()) {
     return std::nullopt;
   }
 
-  if (!(renderer.GetContext()->EnqueueCommandBuffer(
-            std::move(command_buffer_1)) &&
-        renderer.GetContext()->EnqueueCommandBuffer(
-            std::move(command_buffer_2)) &&
-        renderer.GetContext()->EnqueueCommandBuffer(
-            std::move(command_buffer_3)))) {
-    return std::nullopt;
+  for (std::shared_ptr<CommandBuffer>& command_buffer : command_buffers) {
+    if (!renderer.GetContext()->EnqueueCommandBuffer(
+            std::move(command_buffer))) {
+      return std::nullopt;
+    }
   }
 
-  // The ping-pong approach requires that each render pass output has the same
-  // size.
-  FML_DCHECK((pass1_out.value().GetRenderTargetSize() ==
-              pass2_out.value().GetRenderTargetSize()) &&
-             (pass2_out.value().GetRenderTargetSize() ==
-              pass3_out.value().GetRenderTargetSize()));
-
   SamplerDescriptor sampler_desc = MakeSamplerDescriptor(
       MinMagFilter::kLinear, SamplerAddressMode::kClampToEdge);
 
   Entity blur_output_entity = Entity::FromSnapshot(
-      Snapshot{.texture = pass3_out.value().GetRenderTargetTexture(),
+      Snapshot{.texture = blur_out.value().GetRenderTargetTexture(),
                .transform =
                    entity.GetTransform() *                                   //
                    Matrix::MakeScale(1.f / blur_info.source_space_scalar) *  //
@@ -1128,4 +1352,54 @@ GaussianBlurPipeline::FragmentShader::KernelSamples LerpHackKernelSamples(
   return result;
 }
 
+Scalar CalculateKawaseBlurVariance(int iterations, Scalar offset) {
+  Scalar clamped_offset =
+      std::clamp(offset, kKawaseBlurMinOffset, kKawaseBlurMaxOffset);
+  Scalar position = (clamped_offset - kKawaseBlurMinOffset) / kKawaseOffsetStep;
+  size_t index = std::min(static_cast<size_t>(position),
+                          kKawaseVariances.size() - 2);
+  Scalar fraction = position - static_cast<Scalar>(index);
+  Scalar scaled_variance = kKawaseVariances[index] * (1.0f - fraction) +
+                           kKawaseVariances[index + 1] * fraction;
+  return GetKawaseIterationsScale(iterations) * scaled_variance;
+}
+
+std::optional<KawaseBlurParameters> CalculateKawaseBlurParameters(
+    Vector2 sigma,
+    ISize input_size) {
+  Scalar min_variance = std::min(sigma.x, sigma.y) * std::min(sigma.x, sigma.y);
+  Scalar max_variance = std::max(sigma.x, sigma.y) * std::max(sigma.x, sigma.y);
+
+  // Every iteration halves the size of the image, which must not go below a
+  // pixel.
+  int64_t min_dimension = std::min(input_size.width, input_size.height);
+  int max_iterations = 0;
+  while ((min_dimension >> (max_iterations + 1)) > 0) {
+    max_iterations++;
+  }
+
+  // Use as many iterations as the axis with the smaller sigma allows, since
+  // each one is cheaper than the last, and make up the difference with the
+  // offsets.
+  int iterations = 0;
+  while (iterations < max_iterations &&
+         CalculateKawaseBlurVariance(iterations + 1, kKawaseBlurMinOffset) <=
+             min_variance) {
+    iterations++;
+  }
+  if (iterations == 0 ||
+      max_variance >
+          CalculateKawaseBlurVariance(iterations, kKawaseBlurMaxOffset) *
+              kKawaseVarianceTolerance) {
+    return std::nullopt;
+  }
+
+  return KawaseBlurParameters{
+      .iterations = iterations,
+      .offset = Vector2(
+          CalculateKawaseBlurOffset(iterations, sigma.x * sigma.x),
+          CalculateKawaseBlurOffset(iterations, sigma.y * sigma.y)),
+  };
+}
+
 }  // namespace impeller
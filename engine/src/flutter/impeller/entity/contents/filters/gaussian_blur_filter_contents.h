@@ -50,6 +50,40 @@ KernelSamples GenerateBlurInfo(BlurParameters parameters);
 GaussianBlurPipeline::FragmentShader::KernelSamples LerpHackKernelSamples(
     KernelSamples samples);
 
+/// The smallest sigma, after scaling, for which
+/// |GaussianBlurFilterContents::Algorithm::kAutomatic| uses a Kawase blur.
+static constexpr Scalar kKawaseBlurMinSigma = 32.0f;
+
+/// The range of the sample offsets of the Kawase blur passes, in texels of
+/// their input. Smaller offsets barely blur and larger ones skip over texels,
+/// which produces visible ringing. The range covers a factor of four in
+/// variance, which is what one more iteration adds.
+static constexpr Scalar kKawaseBlurMinOffset = 0.75f;
+static constexpr Scalar kKawaseBlurMaxOffset = 2.0f;
+
+struct KawaseBlurParameters {
+  /// The number of downsample passes, which is also the number of upsample
+  /// passes.
+  int iterations;
+  /// The sample offset of every pass, in texels of the pass's input.
+  Vector2 offset;
+};
+
+/// Returns the variance, in pixels of the blur's input, of a Kawase blur
+/// with the given number of iterations and sample offset along one axis.
+/// The offset is clamped to the range supported by the blur.
+Scalar CalculateKawaseBlurVariance(int iterations, Scalar offset);
+
+/// Returns the parameters of the Kawase blur that best approximates a
+/// Gaussian blur with the given sigma, in pixels of the blur's input.
+///
+/// Returns std::nullopt if the sigma is too small for a single iteration, or
+/// if the sigmas of the two axes are too different, or the input too small,
+/// to reach them without exceeding |kKawaseBlurMaxOffset|.
+std::optional<KawaseBlurParameters> CalculateKawaseBlurParameters(
+    Vector2 sigma,
+    ISize input_size);
+
 /// Performs a bidirectional Gaussian blur.
 //
 // ## Implementation notes
@@ -60,6 +94,17 @@ GaussianBlurPipeline::FragmentShader::KernelSamples LerpHackKernelSamples(
 // 2. A Y-direction blur pass (in canvas coordinates).
 // 3. An X-direction blur pass (in canvas coordinates).
 //
+// ### Kawase Blur
+//
+// For large sigmas the separable passes are replaced by a dual filter, or
+// Kawase, blur. After downsampling to half size, a pyramid of passes that each
+// halve the image while blurring it is followed by passes that double it
+// again, and the sample offset of every pass is tuned so that the variance of
+// the whole pyramid matches the requested sigma. Each pass reads at most 8
+// texels regardless of the sigma, and most of them run at a fraction of the
+// size of the input, which makes it much cheaper than the separable blur for
+// frosted glass backdrops. See |CalculateKawaseBlurParameters|.
+//
 // ### Lerp Hack
 //
 // The blur passes use a "lerp hack" to optimize the number of texture
@@ -89,6 +134,17 @@ GaussianBlurPipeline::FragmentShader::KernelSamples LerpHackKernelSamples(
 //     varying alpha introduced by the weights.
 class GaussianBlurFilterContents final : public FilterContents {
  public:
+  enum class Algorithm {
+    /// Uses the Kawase blur for sigmas of at least |kKawaseBlurMinSigma| and
+    /// the separable blur otherwise.
+    kAutomatic,
+    /// Always uses the separable blur.
+    kSeparable,
+    /// Uses the Kawase blur whenever |CalculateKawaseBlurParameters| finds
+    /// parameters for the sigma.
+    kKawase,
+  };
+
   explicit GaussianBlurFilterContents(Scalar sigma_x,
                                       Scalar sigma_y,
                                       Entity::TileMode tile_mode,
@@ -100,6 +156,9 @@ class GaussianBlurFilterContents final : public FilterContents {
   Scalar GetSigmaX() const { return sigma_.x; }
   Scalar GetSigmaY() const { return sigma_.y; }
 
+  void SetAlgorithm(Algorithm algorithm) { algorithm_ = algorithm; }
+  Algorithm GetAlgorithm() const { return algorithm_; }
+
   // |FilterContents|
   std::optional<Rect> GetFilterSourceCoverage(
       const Matrix& effect_transform,
@@ -154,6 +213,7 @@ class GaussianBlurFilterContents final : public FilterContents {
   const std::optional<Rect> bounds_ = std::nullopt;
   const BlurStyle mask_blur_style_;
   const Geometry* mask_geometry_ = nullptr;
+  Algorithm algorithm_ = Algorithm::kAutomatic;
 };
 
 }  // namespace impeller
@@ -2,6 +2,10 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string>
+
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/testing/testing.h"
 #include "fml/status_or.h"
 #include "gmock/gmock.h"
@@ -107,6 +111,66 @@ class GaussianBlurFilterContentsTest : public EntityPlayground {
     }
     return nullptr;
   }
+
+  /// Renders the output of |contents| into a texture of the given size with
+  /// the origin at its top left corner and reads back its pixels.
+  std::optional<std::vector<uint8_t>> RenderToPixels(
+      const FilterContents& contents,
+      ISize size) {
+    std::shared_ptr<ContentContext> renderer = GetContentContext();
+    std::shared_ptr<Context> context = renderer->GetContext();
+    std::optional<Entity> result =
+        contents.GetEntity(*renderer, Entity(), /*coverage_hint=*/{});
+    std::shared_ptr<CommandBuffer> command_buffer =
+        context->CreateCommandBuffer();
+    if (!result.has_value() || !command_buffer) {
+      return std::nullopt;
+    }
+
+    fml::StatusOr<RenderTarget> render_target = renderer->MakeSubpass(
+        "Readback Subpass", size, command_buffer,
+        [&result](const ContentContext& renderer, RenderPass& pass) {
+          return result->Render(renderer, pass);
+        },
+        /*msaa_enabled=*/false);
+    if (!render_target.ok()) {
+      return std::nullopt;
+    }
+    std::shared_ptr<Texture> texture =
+        render_target.value().GetRenderTargetTexture();
+
+    DeviceBufferDescriptor buffer_desc;
+    buffer_desc.size =
+        texture->GetTextureDescriptor().GetByteSizeOfBaseMipLevel();
+    buffer_desc.readback = true;
+    buffer_desc.storage_mode = StorageMode::kHostVisible;
+    std::shared_ptr<DeviceBuffer> device_buffer =
+        context->GetResourceAllocator()->CreateBuffer(buffer_desc);
+    std::shared_ptr<BlitPass> blit_pass = command_buffer->CreateBlitPass();
+    if (!device_buffer || !blit_pass ||
+        !blit_pass->AddCopy(texture, device_buffer) ||
+        !blit_pass->EncodeCommands()) {
+      return std::nullopt;
+    }
+
+    // The filter enqueues its own command buffers, which must run first.
+    if (!context->FlushCommandBuffers()) {
+      return std::nullopt;
+    }
+    fml::CountDownLatch latch(1u);
+    if (!context->GetCommandQueue()
+             ->Submit({command_buffer},
+                      [&latch](CommandBuffer::Status) { latch.CountDown(); })
+             .ok()) {
+      return std::nullopt;
+    }
+    latch.Wait();
+
+    device_buffer->Invalidate();
+    const uint8_t* contents_data = device_buffer->OnGetContents();
+    return std::vector<uint8_t>(contents_data,
+                                contents_data + buffer_desc.size);
+  }
 };
 INSTANTIATE_PLAYGROUND_SUITE(GaussianBlurFilterContentsTest);
 
@@ -664,5 +728,146 @@ TEST(GaussianBlurFilterContentsTest, ChopHugeBlurs) {
   EXPECT_TRUE(frag_kernel_samples.sample_count <= kGaussianBlurMaxKernelSize);
 }
 
+TEST(GaussianBlurFilterContentsTest, KawaseBlurParametersMatchSigma) {
+  // The offsets of consecutive iteration counts only overlap once there are a
+  // few of them, and the blur is only used for larger sigmas anyway.
+  for (Scalar sigma = 8.0f; sigma <= 300.0f; sigma += 0.5f) {
+    std::optional<KawaseBlurParameters> parameters =
+        CalculateKawaseBlurParameters(Vector2(sigma, sigma), ISize(4096, 4096));
+    ASSERT_TRUE(parameters.has_value()) << sigma;
+    EXPECT_GE(parameters->offset.x, kKawaseBlurMinOffset) << sigma;
+    EXPECT_LE(parameters->offset.x, kKawaseBlurMaxOffset) << sigma;
+    EXPECT_EQ(parameters->offset.x, parameters->offset.y) << sigma;
+    Scalar kawase_sigma = std::sqrt(CalculateKawaseBlurVariance(
+        parameters->iterations, parameters->offset.x));
+    EXPECT_NEAR(kawase_sigma, sigma, sigma * 0.01f) << sigma;
+  }
+}
+
+TEST(GaussianBlurFilterContentsTest, KawaseBlurVarianceGrowsWithOffset) {
+  for (int iterations = 1; iterations < 8; iterations++) {
+    Scalar last_variance = 0.0f;
+    for (Scalar offset = kKawaseBlurMinOffset; offset <= kKawaseBlurMaxOffset;
+         offset += 0.05f) {
+      Scalar variance = CalculateKawaseBlurVariance(iterations, offset);
+      EXPECT_GT(variance, last_variance);
+      last_variance = variance;
+    }
+    // One more iteration at the smallest offset picks up about where the
+    // largest offset leaves off.
+    EXPECT_NEAR(
+        CalculateKawaseBlurVariance(iterations + 1, kKawaseBlurMinOffset) /
+            CalculateKawaseBlurVariance(iterations, kKawaseBlurMaxOffset),
+        1.0f, 0.3f);
+  }
+}
+
+TEST(GaussianBlurFilterContentsTest, KawaseBlurParametersRejectedCases) {
+  // Too small for a single iteration.
+  EXPECT_FALSE(
+      CalculateKawaseBlurParameters(Vector2(1.0f, 1.0f), ISize(1000, 1000))
+          .has_value());
+  // Too anisotropic for the offsets to make up the difference.
+  EXPECT_FALSE(
+      CalculateKawaseBlurParameters(Vector2(20.0f, 60.0f), ISize(1000, 1000))
+          .has_value());
+  // Too small an input for enough iterations.
+  EXPECT_FALSE(
+      CalculateKawaseBlurParameters(Vector2(100.0f, 100.0f), ISize(20, 1000))
+          .has_value());
+
+  std::optional<KawaseBlurParameters> parameters =
+      CalculateKawaseBlurParameters(Vector2(20.0f, 24.0f), ISize(1000, 1000));
+  ASSERT_TRUE(parameters.has_value());
+  EXPECT_LT(parameters->offset.x, parameters->offset.y);
+}
+
+TEST_P(GaussianBlurFilterContentsTest,
+       KawaseBlurRenderCoverageMatchesGetCoverage) {
+  std::shared_ptr<Texture> texture = MakeTexture(ISize(400, 400));
+  auto contents = std::make_unique<GaussianBlurFilterContents>(
+      /*sigma_x=*/80.0f, /*sigma_y=*/80.0f, Entity::TileMode::kDecal,
+      /*bounds=*/std::nullopt, FilterContents::BlurStyle::kNormal,
+      /*mask_geometry=*/nullptr);
+  EXPECT_EQ(contents->GetAlgorithm(),
+            GaussianBlurFilterContents::Algorithm::kAutomatic);
+  contents->SetInputs({FilterInput::Make(texture)});
+  std::shared_ptr<ContentContext> renderer = GetContentContext();
+
+  Entity entity;
+  std::optional<Entity> result =
+      contents->GetEntity(*renderer, entity, /*coverage_hint=*/{});
+  ASSERT_TRUE(result.has_value());
+  std::optional<Rect> result_coverage = result.value().GetCoverage();
+  std::optional<Rect> contents_coverage = contents->GetCoverage(entity);
+  ASSERT_TRUE(result_coverage.has_value());
+  ASSERT_TRUE(contents_coverage.has_value());
+  // The Kawase pyramid works at half the size of the input, so its output
+  // may be padded by a texel of that size.
+  EXPECT_TRUE(
+      result_coverage->Expand(0.01f).Contains(contents_coverage.value()));
+  EXPECT_TRUE(
+      contents_coverage->Expand(2.0f).Contains(result_coverage.value()));
+}
+
+// Compares the Kawase blur with the separable blur across a range of sigmas.
+// How long each takes to render and read back, and the mean difference of the
+// Kawase result from the separable one as a fraction of the channel range, are
+// recorded as test properties, which are written to the XML output. Disabled
+// by default; run on SwiftShader with
+//
+//   --gtest_filter='*KawaseBlurBenchmark/Vulkan' --use_swiftshader
+//   --gtest_also_run_disabled_tests --gtest_output=xml
+TEST_P(GaussianBlurFilterContentsTest, DISABLED_KawaseBlurBenchmark) {
+  if (GetBackend() != PlaygroundBackend::kVulkan) {
+    GTEST_SKIP() << "The benchmark only runs on Vulkan.";
+  }
+  std::shared_ptr<Texture> texture = CreateTextureForFixture("boston.jpg");
+  ASSERT_TRUE(texture);
+  ISize size = texture->GetSize();
+
+  for (Scalar sigma : {40.0f, 80.0f, 160.0f, 320.0f, 500.0f}) {
+    std::array<std::vector<uint8_t>, 2> pixels;
+    std::array<fml::TimeDelta, 2> durations;
+    for (GaussianBlurFilterContents::Algorithm algorithm :
+         {GaussianBlurFilterContents::Algorithm::kSeparable,
+          GaussianBlurFilterContents::Algorithm::kKawase}) {
+      size_t index =
+          algorithm == GaussianBlurFilterContents::Algorithm::kKawase ? 1 : 0;
+      GaussianBlurFilterContents contents(
+          sigma, sigma, Entity::TileMode::kDecal, /*bounds=*/std::nullopt,
+          FilterContents::BlurStyle::kNormal, /*mask_geometry=*/nullptr);
+      contents.SetAlgorithm(algorithm);
+      contents.SetInputs({FilterInput::Make(texture)});
+
+      // The first render creates the pipelines, so only time the second.
+      ASSERT_TRUE(RenderToPixels(contents, size).has_value());
+      fml::TimePoint start = fml::TimePoint::Now();
+      std::optional<std::vector<uint8_t>> result =
+          RenderToPixels(contents, size);
+      durations[index] = fml::TimePoint::Now() - start;
+      ASSERT_TRUE(result.has_value());
+      pixels[index] = std::move(result.value());
+    }
+
+    ASSERT_EQ(pixels[0].size(), pixels[1].size());
+    double total_difference = 0.0;
+    for (size_t i = 0; i < pixels[0].size(); i++) {
+      total_difference += std::abs(static_cast<int>(pixels[0][i]) -
+                                   static_cast<int>(pixels[1][i]));
+    }
+    double mean_difference = total_difference / pixels[0].size() / 255.0;
+
+    std::string sigma_name = std::to_string(static_cast<int>(sigma));
+    RecordProperty("separable_us_sigma_" + sigma_name,
+                   static_cast<int>(durations[0].ToMicroseconds()));
+    RecordProperty("kawase_us_sigma_" + sigma_name,
+                   static_cast<int>(durations[1].ToMicroseconds()));
+    RecordProperty("mean_difference_sigma_" + sigma_name,
+                   std::to_string(mean_difference));
+    EXPECT_LT(mean_difference, 0.05) << sigma;
+  }
+}
+
 }  // namespace testing
 }  // namespace impeller
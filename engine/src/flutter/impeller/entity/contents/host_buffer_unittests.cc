@@ -166,15 +166,86 @@ TEST_P(HostBufferTest, UnusedBuffersAreDiscardedWhenResetting) {
   EXPECT_EQ(buffer->GetStateForTest().total_buffer_count, 2u);
   EXPECT_EQ(buffer->GetStateForTest().current_frame, 0u);
 
+  // The buffer is kept until it has gone unused for a while.
+  for (auto i = 4u; i < kHostBufferIdleFramesBeforeTrim; i++) {
+    buffer->Reset();
+  }
+
+  EXPECT_EQ(buffer->GetStateForTest().total_buffer_count, 2u);
+  EXPECT_EQ(buffer->GetStateForTest().current_frame, 0u);
+
   // Now when we reset, the buffer should get dropped.
   // Reset until we get back to this frame.
-  for (auto i = 0; i < 4; i++) {
+  for (auto i = 0u; i < kHostBufferArenaSize; i++) {
     buffer->Reset();
   }
 
   EXPECT_EQ(buffer->GetStateForTest().current_buffer, 0u);
   EXPECT_EQ(buffer->GetStateForTest().total_buffer_count, 1u);
   EXPECT_EQ(buffer->GetStateForTest().current_frame, 0u);
+  EXPECT_EQ(buffer->GetMetrics().trimmed_block_count, 1u);
+}
+
+TEST_P(HostBufferTest, BlockSizeShrinksForLightFrames) {
+  auto buffer = HostBuffer::Create(GetContext()->GetResourceAllocator(),
+                                   GetContext()->GetIdleWaiter(), 256);
+  const size_t initial_bytes = buffer->GetMetrics().retained_bytes;
+
+  for (auto i = 0u; i < kHostBufferArenaSize; i++) {
+    auto view = buffer->Emplace(std::array<char, 1024>());
+    ASSERT_TRUE(view);
+    buffer->Reset();
+  }
+
+  HostBuffer::Metrics metrics = buffer->GetMetrics();
+  EXPECT_EQ(metrics.high_water_mark, 1024u);
+  EXPECT_LT(metrics.block_size, 1024000u);
+  EXPECT_LT(metrics.retained_bytes, initial_bytes);
+  EXPECT_EQ(metrics.retained_bytes, kHostBufferArenaSize * metrics.block_size);
+}
+
+TEST_P(HostBufferTest, BlockSizeGrowsForHeavyFrames) {
+  auto buffer = HostBuffer::Create(GetContext()->GetResourceAllocator(),
+                                   GetContext()->GetIdleWaiter(), 256);
+
+  auto emplace_frame = [&buffer]() {
+    for (auto i = 0; i < 6; i++) {
+      auto view = buffer->Emplace(500000, 0, [](uint8_t* data) {});
+      ASSERT_TRUE(view);
+    }
+  };
+
+  // 3MB of data does not fit in the initial blocks.
+  emplace_frame();
+  EXPECT_EQ(buffer->GetStateForTest().total_buffer_count, 3u);
+  EXPECT_EQ(buffer->GetMetrics().block_allocation_count,
+            kHostBufferArenaSize + 2u);
+
+  for (auto i = 0u; i < kHostBufferArenaSize; i++) {
+    buffer->Reset();
+  }
+  EXPECT_GE(buffer->GetMetrics().block_size, 3000000u);
+
+  // Once the blocks have grown, the same frame fits in a single block.
+  emplace_frame();
+  EXPECT_EQ(buffer->GetStateForTest().current_buffer, 0u);
+}
+
+TEST_P(HostBufferTest, MetricsCountEmplacements) {
+  auto buffer = HostBuffer::Create(GetContext()->GetResourceAllocator(),
+                                   GetContext()->GetIdleWaiter(), 256);
+
+  auto small_view = buffer->Emplace(std::array<char, 21>());
+  auto aligned_view = buffer->Emplace(64, 16, [](uint8_t*) {});
+  auto large_view = buffer->Emplace(nullptr, 1024000 + 10, 0);
+
+  HostBuffer::Metrics metrics = buffer->GetMetrics();
+  EXPECT_EQ(metrics.emplace_count, 3u);
+  EXPECT_EQ(metrics.bytes_emplaced, 21u + 64u + 1024000u + 10u);
+  EXPECT_EQ(metrics.one_off_allocation_count, 1u);
+  EXPECT_EQ(metrics.block_allocation_count, kHostBufferArenaSize);
+  EXPECT_EQ(metrics.block_size, 1024000u);
+  EXPECT_EQ(metrics.retained_bytes, kHostBufferArenaSize * 1024000u);
 }
 
 TEST_P(HostBufferTest, EmplaceWithProcIsAligned) {
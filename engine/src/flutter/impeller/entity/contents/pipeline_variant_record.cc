@@ -0,0 +1,205 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/contents/pipeline_variant_record.h"
+
+#include <cstring>
+#include <memory>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/mapping.h"
+
+namespace impeller {
+
+namespace {
+
+static constexpr const char* kPipelineVariantRecordFileName =
+    "flutter.impeller.pipelinevariants";
+
+// Bump the version whenever the pipeline key or the layout of the options key
+// changes so that stale files are ignored.
+static constexpr uint32_t kFileMagic = 0x50564152;  // 'PVAR'
+static constexpr uint32_t kFileVersion = 1u;
+
+struct FileHeader {
+  uint32_t magic = kFileMagic;
+  uint32_t version = kFileVersion;
+  uint32_t entry_count = 0u;
+  uint32_t reserved = 0u;
+};
+
+struct EntryHeader {
+  uint64_t pipeline_key = 0u;
+  uint64_t options_key = 0u;
+  uint32_t unused_launches = 0u;
+  uint32_t reserved = 0u;
+};
+
+static_assert(sizeof(EntryHeader) == 24u);
+
+// A 64-bit FNV-1a hash. Unlike std::hash, the result is stable across
+// processes so that it can be persisted.
+class StableHasher {
+ public:
+  uint64_t GetHash() const { return hash_; }
+
+  void AddBytes(const void* data, size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+      hash_ = (hash_ ^ bytes[i]) * kPrime;
+    }
+  }
+
+ private:
+  static constexpr uint64_t kOffsetBasis = 0xcbf29ce484222325ull;
+  static constexpr uint64_t kPrime = 0x100000001b3ull;
+
+  uint64_t hash_ = kOffsetBasis;
+};
+
+}  // namespace
+
+std::size_t PipelineVariantRecord::VariantHash::operator()(
+    const Variant& variant) const {
+  return fml::HashCombine(variant.pipeline_key, variant.options_key);
+}
+
+// static
+uint64_t PipelineVariantRecord::ComputePipelineKey(
+    const PipelineDescriptor& desc) {
+  StableHasher hasher;
+  std::string_view label = desc.GetLabel();
+  uint64_t label_size = label.size();
+  hasher.AddBytes(&label_size, sizeof(label_size));
+  hasher.AddBytes(label.data(), label.size());
+  for (Scalar constant : desc.GetSpecializationConstants()) {
+    hasher.AddBytes(&constant, sizeof(constant));
+  }
+  return hasher.GetHash();
+}
+
+PipelineVariantRecord::PipelineVariantRecord(fml::UniqueFD cache_directory)
+    : cache_directory_(std::move(cache_directory)) {
+  LoadPersistedEntries();
+}
+
+PipelineVariantRecord::~PipelineVariantRecord() = default;
+
+const std::vector<PipelineVariantRecord::Variant>&
+PipelineVariantRecord::GetPersistedVariants() const {
+  return persisted_variants_;
+}
+
+void PipelineVariantRecord::RecordUse(const Variant& variant) {
+  if (auto found = index_.find(variant); found != index_.end()) {
+    Entry& entry = entries_[found->second];
+    if (!entry.used) {
+      entry.used = true;
+      dirty_ = true;
+    }
+    return;
+  }
+  if (entries_.size() >= kMaxVariants) {
+    return;
+  }
+  index_.emplace(variant, entries_.size());
+  entries_.push_back(Entry{.variant = variant, .used = true});
+  dirty_ = true;
+}
+
+void PipelineVariantRecord::LoadPersistedEntries() {
+  if (!cache_directory_.is_valid()) {
+    return;
+  }
+  std::unique_ptr<fml::FileMapping> mapping = fml::FileMapping::CreateReadOnly(
+      cache_directory_, kPipelineVariantRecordFileName);
+  if (!mapping || mapping->GetSize() < sizeof(FileHeader)) {
+    return;
+  }
+
+  const uint8_t* data = mapping->GetMapping();
+  FileHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != kFileMagic || header.version != kFileVersion) {
+    FML_LOG(INFO) << "Ignoring pipeline variant record of a different version.";
+    return;
+  }
+  if (header.entry_count > kMaxVariants ||
+      mapping->GetSize() !=
+          sizeof(FileHeader) + header.entry_count * sizeof(EntryHeader)) {
+    FML_LOG(WARNING) << "Ignoring corrupt pipeline variant record.";
+    return;
+  }
+
+  for (uint32_t i = 0; i < header.entry_count; i++) {
+    EntryHeader entry_header;
+    std::memcpy(&entry_header,
+                data + sizeof(FileHeader) + i * sizeof(EntryHeader),
+                sizeof(entry_header));
+    Variant variant{.pipeline_key = entry_header.pipeline_key,
+                    .options_key = entry_header.options_key};
+    if (!index_.emplace(variant, entries_.size()).second) {
+      continue;
+    }
+    entries_.push_back(Entry{.variant = variant,
+                             .unused_launches = entry_header.unused_launches});
+    persisted_variants_.push_back(variant);
+  }
+}
+
+std::function<bool()> PipelineVariantRecord::SerializeForPersist() {
+  if (!cache_directory_.is_valid() || !dirty_) {
+    return nullptr;
+  }
+  dirty_ = false;
+
+  std::vector<EntryHeader> entry_headers;
+  entry_headers.reserve(entries_.size());
+  for (const Entry& entry : entries_) {
+    uint32_t unused_launches = entry.used ? 0u : entry.unused_launches + 1u;
+    if (unused_launches >= kMaxUnusedLaunches) {
+      continue;
+    }
+    entry_headers.push_back(EntryHeader{
+        .pipeline_key = entry.variant.pipeline_key,
+        .options_key = entry.variant.options_key,
+        .unused_launches = unused_launches,
+    });
+  }
+
+  FileHeader header;
+  header.entry_count = entry_headers.size();
+  auto data = std::make_shared<std::vector<uint8_t>>(
+      sizeof(FileHeader) + entry_headers.size() * sizeof(EntryHeader));
+  std::memcpy(data->data(), &header, sizeof(header));
+  if (!entry_headers.empty()) {
+    std::memcpy(data->data() + sizeof(FileHeader), entry_headers.data(),
+                entry_headers.size() * sizeof(EntryHeader));
+  }
+
+  // The directory is shared because the closure has to be copyable.
+  auto directory =
+      std::make_shared<fml::UniqueFD>(fml::Duplicate(cache_directory_.get()));
+  return [directory, data]() {
+    fml::NonOwnedMapping mapping(data->data(), data->size());
+    if (!fml::WriteAtomically(*directory, kPipelineVariantRecordFileName,
+                              mapping)) {
+      FML_LOG(ERROR) << "Could not write the pipeline variant record to disk.";
+      return false;
+    }
+    return true;
+  };
+}
+
+bool PipelineVariantRecord::Persist() {
+  if (!cache_directory_.is_valid()) {
+    return false;
+  }
+  std::function<bool()> write = SerializeForPersist();
+  return write ? write() : true;
+}
+
+}  // namespace impeller
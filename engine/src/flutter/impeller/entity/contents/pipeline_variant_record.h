@@ -0,0 +1,134 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_ENTITY_CONTENTS_PIPELINE_VARIANT_RECORD_H_
+#define FLUTTER_IMPELLER_ENTITY_CONTENTS_PIPELINE_VARIANT_RECORD_H_
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/unique_fd.h"
+#include "impeller/renderer/pipeline_descriptor.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      A record of the pipeline variants that the |ContentContext|
+///             had to create on demand, persisted across launches so that
+///             the next launch can compile them ahead of their first use.
+///
+///             A variant is identified by the key of the default pipeline it
+///             was derived from and the key of the |ContentContextOptions|
+///             it was created with. Both keys are stable across processes.
+///
+///             Variants are kept in the order in which they were first
+///             recorded, which is the order in which they should be
+///             compiled. Variants that go unused for
+///             |kMaxUnusedLaunches| launches in a row are dropped.
+///
+///             This object is not thread safe.
+///
+class PipelineVariantRecord {
+ public:
+  /// The maximum number of variants that are recorded.
+  static constexpr size_t kMaxVariants = 512u;
+
+  /// The number of launches in a row a variant may go unused before it is
+  /// dropped from the record.
+  static constexpr uint32_t kMaxUnusedLaunches = 4u;
+
+  struct Variant {
+    uint64_t pipeline_key = 0u;
+    uint64_t options_key = 0u;
+
+    constexpr bool operator==(const Variant& other) const {
+      return pipeline_key == other.pipeline_key &&
+             options_key == other.options_key;
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Computes the key of a default pipeline from its label and
+  ///             specialization constants.
+  ///
+  ///             The descriptor must not have had any options applied that
+  ///             change its label.
+  static uint64_t ComputePipelineKey(const PipelineDescriptor& desc);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a record.
+  ///
+  /// @param[in]  cache_directory  The directory of the persisted file. If
+  ///                              invalid, nothing is loaded or persisted.
+  explicit PipelineVariantRecord(fml::UniqueFD cache_directory = {});
+
+  ~PipelineVariantRecord();
+
+  //----------------------------------------------------------------------------
+  /// @brief      The variants recorded by previous launches, in the order in
+  ///             which they should be compiled.
+  const std::vector<Variant>& GetPersistedVariants() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Marks a variant as used in this launch. Variants that are
+  ///             not in the record yet are appended to it.
+  void RecordUse(const Variant& variant);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Serializes the record and returns a closure that writes it
+  ///             to the cache directory.
+  ///
+  ///             The closure owns the serialized record and a duplicate of the
+  ///             directory, so it may run on any thread, including after the
+  ///             record has been destroyed.
+  ///
+  ///             The first call always serializes the record, so that the
+  ///             variants that went unused in this launch are aged. Later
+  ///             calls only do so if a variant was added or first used since
+  ///             the previous one.
+  ///
+  /// @return     The closure, which returns whether the file was written, or
+  ///             null if the record has no directory or nothing new to write.
+  std::function<bool()> SerializeForPersist();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Writes the record to the cache directory on the calling
+  ///             thread.
+  ///
+  /// @return     True if the file was written or there was nothing new to
+  ///             write, false if the record has no directory or the write
+  ///             failed.
+  bool Persist();
+
+ private:
+  struct Entry {
+    Variant variant;
+    uint32_t unused_launches = 0u;
+    bool used = false;
+  };
+
+  struct VariantHash {
+    std::size_t operator()(const Variant& variant) const;
+  };
+
+  const fml::UniqueFD cache_directory_;
+  std::vector<Variant> persisted_variants_;
+  // In the order in which the variants were first recorded.
+  std::vector<Entry> entries_;
+  std::unordered_map<Variant, size_t, VariantHash> index_;
+  // Whether the record changed since it was last serialized.
+  bool dirty_ = true;
+
+  void LoadPersistedEntries();
+
+  PipelineVariantRecord(const PipelineVariantRecord&) = delete;
+
+  PipelineVariantRecord& operator=(const PipelineVariantRecord&) = delete;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_ENTITY_CONTENTS_PIPELINE_VARIANT_RECORD_H_
@@ -0,0 +1,179 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <functional>
+
+#include "flutter/testing/testing.h"
+#include "gtest/gtest.h"
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "impeller/entity/contents/pipeline_variant_record.h"
+
+namespace impeller {
+namespace testing {
+
+namespace {
+
+static constexpr const char* kFileName = "flutter.impeller.pipelinevariants";
+
+std::vector<PipelineVariantRecord::Variant> PersistAndReload(
+    const fml::ScopedTemporaryDirectory& temp_dir,
+    PipelineVariantRecord& record) {
+  EXPECT_TRUE(record.Persist());
+  PipelineVariantRecord reloaded(fml::Duplicate(temp_dir.fd().get()));
+  return reloaded.GetPersistedVariants();
+}
+
+}  // namespace
+
+TEST(PipelineVariantRecordTest, PipelineKeyDependsOnLabelAndConstants) {
+  PipelineDescriptor desc_a;
+  desc_a.SetLabel("Solid Fill Pipeline");
+  PipelineDescriptor desc_b;
+  desc_b.SetLabel("Solid Fill Pipeline");
+  PipelineDescriptor desc_c;
+  desc_c.SetLabel("Texture Fill Pipeline");
+  PipelineDescriptor desc_d;
+  desc_d.SetLabel("Solid Fill Pipeline");
+  desc_d.SetSpecializationConstants({1.0f});
+
+  uint64_t key_a = PipelineVariantRecord::ComputePipelineKey(desc_a);
+  EXPECT_EQ(key_a, PipelineVariantRecord::ComputePipelineKey(desc_b));
+  EXPECT_NE(key_a, PipelineVariantRecord::ComputePipelineKey(desc_c));
+  EXPECT_NE(key_a, PipelineVariantRecord::ComputePipelineKey(desc_d));
+}
+
+TEST(PipelineVariantRecordTest, PersistsVariantsInRecordedOrder) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  PipelineVariantRecord::Variant variant_a{.pipeline_key = 1u,
+                                           .options_key = 2u};
+  PipelineVariantRecord::Variant variant_b{.pipeline_key = 3u,
+                                           .options_key = 4u};
+
+  PipelineVariantRecord record(fml::Duplicate(temp_dir.fd().get()));
+  EXPECT_TRUE(record.GetPersistedVariants().empty());
+  record.RecordUse(variant_b);
+  record.RecordUse(variant_a);
+  record.RecordUse(variant_b);
+
+  std::vector<PipelineVariantRecord::Variant> expected = {variant_b,
+                                                          variant_a};
+  EXPECT_EQ(PersistAndReload(temp_dir, record), expected);
+}
+
+TEST(PipelineVariantRecordTest, DropsVariantsThatGoUnused) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  PipelineVariantRecord::Variant used{.pipeline_key = 1u, .options_key = 2u};
+  PipelineVariantRecord::Variant unused{.pipeline_key = 3u,
+                                        .options_key = 4u};
+  {
+    PipelineVariantRecord record(fml::Duplicate(temp_dir.fd().get()));
+    record.RecordUse(unused);
+    record.RecordUse(used);
+    ASSERT_TRUE(record.Persist());
+  }
+
+  for (uint32_t i = 1; i < PipelineVariantRecord::kMaxUnusedLaunches; i++) {
+    PipelineVariantRecord record(fml::Duplicate(temp_dir.fd().get()));
+    std::vector<PipelineVariantRecord::Variant> expected = {unused, used};
+    ASSERT_EQ(record.GetPersistedVariants(), expected);
+    record.RecordUse(used);
+    ASSERT_TRUE(record.Persist());
+  }
+
+  PipelineVariantRecord record(fml::Duplicate(temp_dir.fd().get()));
+  std::vector<PipelineVariantRecord::Variant> expected = {used};
+  EXPECT_EQ(record.GetPersistedVariants(), expected);
+}
+
+TEST(PipelineVariantRecordTest, RecordsAtMostMaxVariants) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  PipelineVariantRecord record(fml::Duplicate(temp_dir.fd().get()));
+  for (size_t i = 0; i < PipelineVariantRecord::kMaxVariants + 1u; i++) {
+    record.RecordUse({.pipeline_key = i, .options_key = 0u});
+  }
+
+  std::vector<PipelineVariantRecord::Variant> reloaded =
+      PersistAndReload(temp_dir, record);
+  ASSERT_EQ(reloaded.size(), PipelineVariantRecord::kMaxVariants);
+  EXPECT_EQ(reloaded.back().pipeline_key,
+            PipelineVariantRecord::kMaxVariants - 1u);
+}
+
+TEST(PipelineVariantRecordTest, IgnoresCorruptFiles) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  {
+    PipelineVariantRecord record(fml::Duplicate(temp_dir.fd().get()));
+    record.RecordUse({.pipeline_key = 1u, .options_key = 2u});
+    ASSERT_TRUE(record.Persist());
+  }
+
+  // Truncate the file in the middle of the entry.
+  std::unique_ptr<fml::FileMapping> mapping =
+      fml::FileMapping::CreateReadOnly(temp_dir.fd(), kFileName);
+  ASSERT_TRUE(mapping);
+  fml::NonOwnedMapping truncated(mapping->GetMapping(),
+                                 mapping->GetSize() - 4u);
+  ASSERT_TRUE(fml::WriteAtomically(temp_dir.fd(), kFileName, truncated));
+
+  PipelineVariantRecord record(fml::Duplicate(temp_dir.fd().get()));
+  EXPECT_TRUE(record.GetPersistedVariants().empty());
+}
+
+TEST(PipelineVariantRecordTest, OnlySerializesAgainAfterAChange) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  PipelineVariantRecord::Variant variant_a{.pipeline_key = 1u,
+                                           .options_key = 2u};
+  PipelineVariantRecord::Variant variant_b{.pipeline_key = 3u,
+                                           .options_key = 4u};
+  {
+    PipelineVariantRecord record(fml::Duplicate(temp_dir.fd().get()));
+    record.RecordUse(variant_a);
+    ASSERT_TRUE(record.Persist());
+  }
+
+  PipelineVariantRecord record(fml::Duplicate(temp_dir.fd().get()));
+  // The first serialization ages the variants that were not used yet.
+  EXPECT_TRUE(record.SerializeForPersist());
+  EXPECT_FALSE(record.SerializeForPersist());
+
+  // First uses of persisted variants and new variants are written.
+  record.RecordUse(variant_a);
+  EXPECT_TRUE(record.SerializeForPersist());
+  record.RecordUse(variant_a);
+  EXPECT_FALSE(record.SerializeForPersist());
+  record.RecordUse(variant_b);
+  std::vector<PipelineVariantRecord::Variant> expected = {variant_a,
+                                                          variant_b};
+  EXPECT_EQ(PersistAndReload(temp_dir, record), expected);
+}
+
+TEST(PipelineVariantRecordTest, DoesNotPersistWithoutDirectory) {
+  PipelineVariantRecord record;
+  record.RecordUse({.pipeline_key = 1u, .options_key = 2u});
+  EXPECT_FALSE(record.SerializeForPersist());
+  EXPECT_FALSE(record.Persist());
+}
+
+TEST(PipelineVariantRecordTest, SerializedRecordIsWrittenAfterTheRecordIsGone) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  PipelineVariantRecord::Variant variant{.pipeline_key = 1u,
+                                         .options_key = 2u};
+  std::function<bool()> write;
+  {
+    PipelineVariantRecord record(fml::Duplicate(temp_dir.fd().get()));
+    record.RecordUse(variant);
+    write = record.SerializeForPersist();
+    ASSERT_TRUE(write);
+  }
+  ASSERT_TRUE(write());
+
+  PipelineVariantRecord record(fml::Duplicate(temp_dir.fd().get()));
+  std::vector<PipelineVariantRecord::Variant> expected = {variant};
+  EXPECT_EQ(record.GetPersistedVariants(), expected);
+}
+
+}  // namespace testing
+}  // namespace impeller
@@ -32,6 +32,8 @@
 #include "impeller/entity/gaussian.frag.h"
 #include "impeller/entity/glyph_atlas.frag.h"
 #include "impeller/entity/glyph_atlas.vert.h"
+#include "impeller/entity/kawase_downsample.frag.h"
+#include "impeller/entity/kawase_upsample.frag.h"
 #include "impeller/entity/gradient_fill.vert.h"
 #include "impeller/entity/line.frag.h"
 #include "impeller/entity/line.vert.h"
@@ -136,6 +138,8 @@ using FramebufferBlendScreenPipeline = FramebufferBlendPipelineHandle;
 using FramebufferBlendSoftLightPipeline = FramebufferBlendPipelineHandle;
 using GaussianBlurPipeline = RenderPipelineHandle<FilterPositionUvVertexShader, GaussianFragmentShader>;
 using GlyphAtlasPipeline = RenderPipelineHandle<GlyphAtlasVertexShader, GlyphAtlasFragmentShader>;
+using KawaseDownsamplePipeline = RenderPipelineHandle<FilterPositionUvVertexShader, KawaseDownsampleFragmentShader>;
+using KawaseUpsamplePipeline = RenderPipelineHandle<FilterPositionUvVertexShader, KawaseUpsampleFragmentShader>;
 using LinePipeline = RenderPipelineHandle<LineVertexShader, LineFragmentShader>;
 using LinearGradientFillPipeline = GradientPipelineHandle<LinearGradientFillFragmentShader>;
 using LinearGradientSSBOFillPipeline = GradientPipelineHandle<LinearGradientSsboFillFragmentShader>;
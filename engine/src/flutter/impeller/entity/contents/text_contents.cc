@@ -8,6 +8,7 @@
 #include <optional>
 #include <utility>
 
+#include "flutter/fml/logging.h"
 #include "impeller/core/buffer_view.h"
 #include "impeller/core/formats.h"
 #include "impeller/core/sampler_descriptor.h"
@@ -60,7 +61,12 @@ void TextContents::SetForceTextColor(bool value) {
 std::optional<Rect> TextContents::GetCoverage(const Entity& entity) const {
   const Matrix entity_offset_transform =
       entity.GetTransform() * Matrix::MakeTranslation(position_);
-  return frame_->GetBounds().TransformBounds(entity_offset_transform);
+  Rect coverage = frame_->GetBounds().TransformBounds(entity_offset_transform);
+  for (const BatchedText& text : batched_text_) {
+    coverage = coverage.Union(text.frame->GetBounds().TransformBounds(
+        text.entity_transform * Matrix::MakeTranslation(text.position)));
+  }
+  return coverage;
 }
 
 void TextContents::SetTextProperties(
@@ -75,6 +81,55 @@ void TextContents::SetTextProperties(
 }
 
 namespace {
+size_t CountGlyphs(const TextFrame& frame) {
+  size_t glyph_count = 0;
+  for (const auto& run : frame.GetRuns()) {
+    glyph_count += run.GetGlyphPositions().size();
+  }
+  return glyph_count;
+}
+
+SamplerDescriptor GetGlyphSamplerDescriptor(const Matrix& entity_transform) {
+  SamplerDescriptor sampler_desc;
+  if (entity_transform.IsTranslationScaleOnly()) {
+    // When the transform is translation+scale only, we normally use nearest-
+    // neighbor sampling for pixel-perfect text. However, if the X and Y
+    // scales differ significantly (non-uniform / anisotropic scaling, e.g.
+    // Transform.scale(scaleY: 2)), the glyph atlas entry is rasterized at
+    // max(|scaleX|,|scaleY|) uniformly and the compensating unscaled_basis
+    // squeezes one axis, causing a minification. Nearest-neighbor during
+    // minification discards texel columns/rows, producing jagged diagonals
+    // and varying stroke weights. Fall back to bilinear in that case.
+    // See https://github.com/flutter/flutter/issues/182143
+    constexpr Scalar kMinScaleForRatio = 0.001f;
+    constexpr Scalar kAnisotropicScaleThreshold = 1.15f;
+    const Scalar sx = entity_transform.GetBasisX().GetLength();
+    const Scalar sy = entity_transform.GetBasisY().GetLength();
+    const Scalar ratio = (sx > sy) ? sx / std::max(sy, kMinScaleForRatio)
+                                   : sy / std::max(sx, kMinScaleForRatio);
+    if (ratio > kAnisotropicScaleThreshold) {
+      // Non-uniform scale — use bilinear to avoid aliasing.
+      sampler_desc.min_filter = MinMagFilter::kLinear;
+      sampler_desc.mag_filter = MinMagFilter::kLinear;
+    } else {
+      sampler_desc.min_filter = MinMagFilter::kNearest;
+      sampler_desc.mag_filter = MinMagFilter::kNearest;
+    }
+  } else {
+    // Currently, we only propagate the scale of the transform to the atlas
+    // renderer, so if the transform has more than just a translation, we turn
+    // on linear sampling to prevent crunchiness caused by the pixel grid not
+    // being perfectly aligned.
+    // The downside is that this slightly over-blurs rotated/skewed text.
+    sampler_desc.min_filter = MinMagFilter::kLinear;
+    sampler_desc.mag_filter = MinMagFilter::kLinear;
+  }
+
+  // No mipmaps for glyph atlas (glyphs are generated at exact scales).
+  sampler_desc.mip_filter = MipFilter::kBase;
+  return sampler_desc;
+}
+
 Scalar AttractToOne(Scalar x) {
   // Epsilon was decided by looking at the floating point inaccuracies in
   // the ScaledK test.
@@ -256,8 +311,6 @@ bool TextContents::Render(const ContentContext& renderer,
   VS::FrameInfo frame_info;
   frame_info.mvp =
       Entity::GetShaderTransform(entity.GetShaderClipDepth(), pass, Matrix());
-  const Matrix& entity_transform = entity.GetTransform();
-  bool is_translation_scale = entity_transform.IsTranslationScaleOnly();
 
   VS::BindFrameInfo(
       pass, renderer.GetTransientsDataBuffer().EmplaceUniform(frame_info));
@@ -270,57 +323,16 @@ bool TextContents::Render(const ContentContext& renderer,
   FS::BindFragInfo(
       pass, renderer.GetTransientsDataBuffer().EmplaceUniform(frag_info));
 
-  SamplerDescriptor sampler_desc;
-  if (is_translation_scale) {
-    // When the transform is translation+scale only, we normally use nearest-
-    // neighbor sampling for pixel-perfect text. However, if the X and Y
-    // scales differ significantly (non-uniform / anisotropic scaling, e.g.
-    // Transform.scale(scaleY: 2)), the glyph atlas entry is rasterized at
-    // max(|scaleX|,|scaleY|) uniformly and the compensating unscaled_basis
-    // squeezes one axis, causing a minification. Nearest-neighbor during
-    // minification discards texel columns/rows, producing jagged diagonals
-    // and varying stroke weights. Fall back to bilinear in that case.
-    // See https://github.com/flutter/flutter/issues/182143
-    constexpr Scalar kMinScaleForRatio = 0.001f;
-    constexpr Scalar kAnisotropicScaleThreshold = 1.15f;
-    const Scalar sx = entity_transform.GetBasisX().GetLength();
-    const Scalar sy = entity_transform.GetBasisY().GetLength();
-    const Scalar ratio = (sx > sy) ? sx / std::max(sy, kMinScaleForRatio)
-                                   : sy / std::max(sx, kMinScaleForRatio);
-    if (ratio > kAnisotropicScaleThreshold) {
-      // Non-uniform scale — use bilinear to avoid aliasing.
-      sampler_desc.min_filter = MinMagFilter::kLinear;
-      sampler_desc.mag_filter = MinMagFilter::kLinear;
-    } else {
-      sampler_desc.min_filter = MinMagFilter::kNearest;
-      sampler_desc.mag_filter = MinMagFilter::kNearest;
-    }
-  } else {
-    // Currently, we only propagate the scale of the transform to the atlas
-    // renderer, so if the transform has more than just a translation, we turn
-    // on linear sampling to prevent crunchiness caused by the pixel grid not
-    // being perfectly aligned.
-    // The downside is that this slightly over-blurs rotated/skewed text.
-    sampler_desc.min_filter = MinMagFilter::kLinear;
-    sampler_desc.mag_filter = MinMagFilter::kLinear;
-  }
-
-  // No mipmaps for glyph atlas (glyphs are generated at exact scales).
-  sampler_desc.mip_filter = MipFilter::kBase;
-
   FS::BindGlyphAtlasSampler(
       pass,                 // command
       atlas->GetTexture(),  // texture
       renderer.GetContext()->GetSamplerLibrary()->GetSampler(
-          sampler_desc)  // sampler
+          GetGlyphSamplerDescriptor(entity.GetTransform()))  // sampler
   );
 
   HostBuffer& data_host_buffer = renderer.GetTransientsDataBuffer();
   HostBuffer& indexes_host_buffer = renderer.GetTransientsIndexesBuffer();
-  size_t glyph_count = 0;
-  for (const auto& run : frame_->GetRuns()) {
-    glyph_count += run.GetGlyphPositions().size();
-  }
+  size_t glyph_count = GetGlyphCount();
   size_t vertex_count = glyph_count * 4;
   size_t index_count = glyph_count * 6;
 
@@ -336,6 +348,17 @@ bool TextContents::Render(const ContentContext& renderer,
                           /*screen_transform=*/screen_transform_,
                           /*glyph_properties=*/GetGlyphProperties(),
                           /*atlas=*/atlas);
+        vtx_contents += CountGlyphs(*frame_) * 4;
+        for (const BatchedText& text : batched_text_) {
+          ComputeVertexData(/*vtx_contents=*/vtx_contents,
+                            /*entity_transform=*/text.entity_transform,
+                            /*frame=*/text.frame,
+                            /*position=*/text.position,
+                            /*screen_transform=*/text.screen_transform,
+                            /*glyph_properties=*/text.glyph_properties,
+                            /*atlas=*/atlas);
+          vtx_contents += CountGlyphs(*text.frame) * 4;
+        }
       });
   BufferView index_buffer_view = indexes_host_buffer.Emplace(
       index_count * sizeof(uint16_t), alignof(uint16_t), [&](uint8_t* data) {
@@ -359,6 +382,50 @@ bool TextContents::Render(const ContentContext& renderer,
   return pass.Draw().ok();
 }
 
+bool TextContents::CanBatch(const Entity& entity,
+                            const TextContents& other,
+                            const Entity& other_entity) const {
+  if (entity.GetBlendMode() != other_entity.GetBlendMode() ||
+      entity.GetBlendMode() > Entity::kLastPipelineBlendMode) {
+    return false;
+  }
+  if (frame_->GetAtlasType() != other.frame_->GetAtlasType() ||
+      force_text_color_ != other.force_text_color_ ||
+      GetColor() != other.GetColor()) {
+    return false;
+  }
+  if (GetGlyphCount() + other.GetGlyphCount() > kMaxBatchedGlyphCount) {
+    return false;
+  }
+  const SamplerDescriptor sampler =
+      GetGlyphSamplerDescriptor(entity.GetTransform());
+  const SamplerDescriptor other_sampler =
+      GetGlyphSamplerDescriptor(other_entity.GetTransform());
+  return sampler.min_filter == other_sampler.min_filter &&
+         sampler.mag_filter == other_sampler.mag_filter;
+}
+
+void TextContents::AddBatchedText(const TextContents& other,
+                                  const Matrix& entity_transform) {
+  FML_DCHECK(other.batched_text_.empty());
+  batched_text_.push_back(BatchedText{
+      .frame = other.frame_,
+      .position = other.position_,
+      .screen_transform = other.screen_transform_,
+      .entity_transform = entity_transform,
+      .glyph_properties = other.GetGlyphProperties(),
+  });
+  batched_glyph_count_ += CountGlyphs(*other.frame_);
+}
+
+size_t TextContents::GetTextFrameCount() const {
+  return 1u + batched_text_.size();
+}
+
+size_t TextContents::GetGlyphCount() const {
+  return CountGlyphs(*frame_) + batched_glyph_count_;
+}
+
 std::optional<GlyphProperties> TextContents::GetGlyphProperties() const {
   return (properties_.stroke || frame_->HasColor())
              ? std::optional<GlyphProperties>(properties_)
@@ -6,6 +6,7 @@
 #define FLUTTER_IMPELLER_ENTITY_CONTENTS_TEXT_CONTENTS_H_
 
 #include <memory>
+#include <vector>
 
 #include "impeller/entity/contents/content_context.h"
 #include "impeller/entity/contents/contents.h"
@@ -54,6 +55,35 @@ class TextContents final : public Contents {
   // from the DrawTextFrame call.
   void SetScreenTransform(const Matrix& transform);
 
+  /// The maximum number of glyphs drawn by one draw call, as limited by the
+  /// 16-bit index buffer.
+  static constexpr size_t kMaxBatchedGlyphCount = 65536 / 4;
+
+  /// @brief  Whether |other| drawn by |other_entity| can be drawn in the same
+  ///         draw call as this contents drawn by |entity|.
+  ///
+  ///         Text can be batched when it samples the same glyph atlas with the
+  ///         same sampler, and uses the same color and blend mode. The caller
+  ///         is responsible for ensuring that nothing else is drawn between
+  ///         the two, and that both are subject to the same clips.
+  bool CanBatch(const Entity& entity,
+                const TextContents& other,
+                const Entity& other_entity) const;
+
+  /// @brief  Draws the text frame of |other| in the same draw call as this
+  ///         contents, after any text that was already added. Must only be
+  ///         called if |CanBatch| returned true.
+  ///
+  /// @param other             The text to add to the batch.
+  /// @param entity_transform  The transform of the entity that would have
+  ///                          drawn |other|.
+  void AddBatchedText(const TextContents& other,
+                      const Matrix& entity_transform);
+
+  /// @brief  The number of text frames drawn by this contents, including its
+  ///         own.
+  size_t GetTextFrameCount() const;
+
   // |Contents|
   std::optional<Rect> GetCoverage(const Entity& entity) const override;
 
@@ -99,8 +129,19 @@ class TextContents final : public Contents {
       const std::shared_ptr<GlyphAtlas>& atlas);
 
  private:
+  // Text from other contents that is drawn in the same draw call.
+  struct BatchedText {
+    std::shared_ptr<TextFrame> frame;
+    Point position;
+    Matrix screen_transform;
+    Matrix entity_transform;
+    std::optional<GlyphProperties> glyph_properties;
+  };
+
   std::optional<GlyphProperties> GetGlyphProperties() const;
 
+  size_t GetGlyphCount() const;
+
   std::shared_ptr<TextFrame> frame_;
   Scalar inherited_opacity_ = 1.0;
   Point position_;
@@ -108,6 +149,8 @@ class TextContents final : public Contents {
   bool force_text_color_ = false;
   Color color_;
   GlyphProperties properties_;
+  std::vector<BatchedText> batched_text_;
+  size_t batched_glyph_count_ = 0;
 
   TextContents(const TextContents&) = delete;
 
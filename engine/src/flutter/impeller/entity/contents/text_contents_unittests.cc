@@ -6,6 +6,7 @@
 #include "flutter/impeller/renderer/testing/mocks.h"
 #include "flutter/testing/testing.h"
 #include "impeller/entity/contents/text_contents.h"
+#include "impeller/entity/entity.h"
 #include "impeller/playground/playground_test.h"
 #include "impeller/typographer/backends/skia/text_frame_skia.h"
 #include "impeller/typographer/backends/skia/typographer_context_skia.h"
@@ -400,5 +401,56 @@ TEST_P(TextContentsTest, SimpleSubpixel80) {
   EXPECT_RECT_NEAR(uv_rect, Rect::MakeXYWH(1.0, 1.0, 54, 52));
 }
 
+TEST_P(TextContentsTest, CanBatchCompatibleText) {
+  std::shared_ptr<TextFrame> frame =
+      MakeTextFrame("1", "ahem.ttf", TextOptions{.font_size = 50});
+  ASSERT_TRUE(frame);
+
+  auto make_contents = [&frame](Color color, Point position) {
+    auto contents = std::make_shared<TextContents>();
+    contents->SetTextFrame(frame);
+    contents->SetColor(color);
+    contents->SetPosition(position);
+    return contents;
+  };
+  auto make_entity = [](const Matrix& transform, BlendMode blend_mode) {
+    Entity entity;
+    entity.SetTransform(transform);
+    entity.SetBlendMode(blend_mode);
+    return entity;
+  };
+
+  std::shared_ptr<TextContents> first = make_contents(Color::Red(), {0, 0});
+  Entity first_entity = make_entity(Matrix(), BlendMode::kSrcOver);
+
+  std::shared_ptr<TextContents> second = make_contents(Color::Red(), {100, 0});
+  Entity second_entity =
+      make_entity(Matrix::MakeTranslation({0, 50}), BlendMode::kSrcOver);
+  EXPECT_TRUE(first->CanBatch(first_entity, *second, second_entity));
+
+  // The color is a uniform of the draw.
+  std::shared_ptr<TextContents> blue = make_contents(Color::Blue(), {0, 0});
+  EXPECT_FALSE(first->CanBatch(first_entity, *blue, second_entity));
+
+  // The blend mode is part of the pipeline.
+  Entity plus_entity = make_entity(Matrix(), BlendMode::kPlus);
+  EXPECT_FALSE(first->CanBatch(first_entity, *second, plus_entity));
+
+  // Rotated text is sampled with a different filter.
+  Entity rotated_entity =
+      make_entity(Matrix::MakeRotationZ(Degrees(45)), BlendMode::kSrcOver);
+  EXPECT_FALSE(first->CanBatch(first_entity, *second, rotated_entity));
+
+  std::optional<Rect> first_coverage = first->GetCoverage(first_entity);
+  std::optional<Rect> second_coverage = second->GetCoverage(second_entity);
+  ASSERT_TRUE(first_coverage.has_value() && second_coverage.has_value());
+
+  EXPECT_EQ(first->GetTextFrameCount(), 1u);
+  first->AddBatchedText(*second, second_entity.GetTransform());
+  EXPECT_EQ(first->GetTextFrameCount(), 2u);
+  EXPECT_EQ(first->GetCoverage(first_entity),
+            first_coverage->Union(second_coverage.value()));
+}
+
 }  // namespace testing
 }  // namespace impeller
@@ -2269,6 +2269,30 @@ TEST_P(EntityTest, ContentContextOptionsHasReasonableHashFunctions) {
   EXPECT_NE(hash_c, hash_d);
 }
 
+TEST_P(EntityTest, ContentContextOptionsRoundTripThroughKeys) {
+  ContentContextOptions opts{
+      .sample_count = SampleCount::kCount4,
+      .blend_mode = BlendMode::kColorBurn,
+      .stencil_mode = ContentContextOptions::StencilMode::kCoverCompare,
+      .primitive_type = PrimitiveType::kTriangleStrip,
+      .color_attachment_pixel_format = PixelFormat::kB8G8R8A8UNormInt,
+      .has_depth_stencil_attachments = false,
+      .is_for_rrect_blur_clear = true,
+  };
+  std::optional<ContentContextOptions> round_trip =
+      ContentContextOptions::FromKey(opts.ToKey());
+  ASSERT_TRUE(round_trip.has_value());
+  EXPECT_EQ(round_trip->ToKey(), opts.ToKey());
+
+  // Keys of blend modes without a pipeline or of unknown formats are invalid.
+  opts.blend_mode = Entity::kLastAdvancedBlendMode;
+  EXPECT_FALSE(ContentContextOptions::FromKey(opts.ToKey()).has_value());
+  opts.blend_mode = BlendMode::kSrcOver;
+  opts.color_attachment_pixel_format = PixelFormat::kUnknown;
+  EXPECT_FALSE(ContentContextOptions::FromKey(opts.ToKey()).has_value());
+  EXPECT_FALSE(ContentContextOptions::FromKey(1llu << 63).has_value());
+}
+
 #ifdef FML_OS_LINUX
 TEST_P(EntityTest, FramebufferFetchVulkanBindingOffsetIsTheSame) {
   // Using framebuffer fetch on Vulkan requires that we maintain a subpass input
@@ -0,0 +1,116 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/geometry/batched_fill_geometry.h"
+
+#include "impeller/renderer/render_pass.h"
+
+namespace impeller {
+
+BatchedFillGeometry::BatchedFillGeometry() = default;
+
+BatchedFillGeometry::~BatchedFillGeometry() = default;
+
+bool BatchedFillGeometry::AddRect(const Matrix& transform, const Rect& rect) {
+  if (transform.HasPerspective2D() ||
+      vertices_.size() + 4u > kMaxVertexCount) {
+    return false;
+  }
+  // The points are ordered top left, top right, bottom left, bottom right.
+  constexpr uint16_t kRectIndices[6] = {0, 1, 2, 1, 2, 3};
+  auto base = static_cast<uint16_t>(vertices_.size());
+  for (const Point& point : rect.GetTransformedPoints(transform)) {
+    vertices_.push_back(point);
+  }
+  for (uint16_t index : kRectIndices) {
+    indices_.push_back(base + index);
+  }
+  std::optional<Rect> bounds = rect.TransformBounds(transform);
+  bounds_ = bounds_.has_value() ? bounds_->Union(bounds.value()) : bounds;
+  shape_count_++;
+  return true;
+}
+
+bool BatchedFillGeometry::AddVertices(
+    const Matrix& transform,
+    const Tessellator::VertexGenerator& generator) {
+  PrimitiveType type = generator.GetTriangleType();
+  if (transform.HasPerspective2D() || (type != PrimitiveType::kTriangle &&
+                                       type != PrimitiveType::kTriangleStrip)) {
+    return false;
+  }
+  size_t base = vertices_.size();
+  if (base + generator.GetVertexCount() > kMaxVertexCount) {
+    return false;
+  }
+  generator.GenerateVertices([this, &transform](const Point& p) {
+    vertices_.push_back(transform * p);
+  });
+  // The vertex count of the generator is only an estimate.
+  if (vertices_.size() > kMaxVertexCount) {
+    vertices_.resize(base);
+    return false;
+  }
+
+  size_t end = vertices_.size();
+  if (type == PrimitiveType::kTriangleStrip) {
+    for (size_t i = base + 2u; i < end; i++) {
+      indices_.push_back(static_cast<uint16_t>(i - 2));
+      indices_.push_back(static_cast<uint16_t>(i - 1));
+      indices_.push_back(static_cast<uint16_t>(i));
+    }
+  } else {
+    for (size_t i = base; i < end; i++) {
+      indices_.push_back(static_cast<uint16_t>(i));
+    }
+  }
+
+  std::optional<Rect> bounds =
+      Rect::MakePointBounds(vertices_.begin() + base, vertices_.end());
+  if (bounds.has_value()) {
+    bounds_ = bounds_.has_value() ? bounds_->Union(bounds.value()) : bounds;
+  }
+  shape_count_++;
+  return true;
+}
+
+GeometryResult BatchedFillGeometry::GetPositionBuffer(
+    const ContentContext& renderer,
+    const Entity& entity,
+    RenderPass& pass) const {
+  if (indices_.empty()) {
+    return kEmptyResult;
+  }
+  auto& data_host_buffer = renderer.GetTransientsDataBuffer();
+  auto& indexes_host_buffer = renderer.GetTransientsIndexesBuffer();
+  return GeometryResult{
+      .type = PrimitiveType::kTriangle,
+      .vertex_buffer =
+          {
+              .vertex_buffer = data_host_buffer.Emplace(
+                  vertices_.data(), vertices_.size() * sizeof(Point),
+                  alignof(Point)),
+              .index_buffer = indexes_host_buffer.Emplace(
+                  indices_.data(), indices_.size() * sizeof(uint16_t),
+                  alignof(uint16_t)),
+              .vertex_count = indices_.size(),
+              .index_type = IndexType::k16bit,
+          },
+      .transform = entity.GetShaderTransform(pass),
+  };
+}
+
+std::optional<Rect> BatchedFillGeometry::GetCoverage(
+    const Matrix& transform) const {
+  if (!bounds_.has_value()) {
+    return std::nullopt;
+  }
+  return bounds_->TransformBounds(transform);
+}
+
+bool BatchedFillGeometry::CanApplyMaskFilter() const {
+  return false;
+}
+
+}  // namespace impeller
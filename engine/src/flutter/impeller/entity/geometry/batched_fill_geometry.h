@@ -0,0 +1,75 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_ENTITY_GEOMETRY_BATCHED_FILL_GEOMETRY_H_
+#define FLUTTER_IMPELLER_ENTITY_GEOMETRY_BATCHED_FILL_GEOMETRY_H_
+
+#include <vector>
+
+#include "impeller/entity/geometry/geometry.h"
+#include "impeller/tessellator/tessellator.h"
+
+namespace impeller {
+
+/// @brief A geometry that accumulates the triangles of several filled shapes
+///        so that they can be rendered by a single draw call.
+///
+///        Each shape is transformed on the CPU when it is added, so the
+///        geometry is drawn with an identity entity transform. Shapes are
+///        drawn in the order they were added.
+class BatchedFillGeometry final : public Geometry {
+ public:
+  /// The maximum number of vertices that can be addressed by the 16 bit
+  /// indices of the batch.
+  static constexpr size_t kMaxVertexCount = 65536u;
+
+  BatchedFillGeometry();
+
+  ~BatchedFillGeometry() override;
+
+  /// @brief  Adds a filled rect, transformed by |transform|.
+  ///
+  /// @return Whether the rect was added. Shapes are not added once the batch
+  ///         is full or if the transform has perspective.
+  bool AddRect(const Matrix& transform, const Rect& rect);
+
+  /// @brief  Adds the triangles produced by |generator|, transformed by
+  ///         |transform|.
+  ///
+  /// @return Whether the triangles were added. Shapes are not added once the
+  ///         batch is full or if the transform has perspective.
+  bool AddVertices(const Matrix& transform,
+                   const Tessellator::VertexGenerator& generator);
+
+  /// The number of shapes added to the batch.
+  size_t GetShapeCount() const { return shape_count_; }
+
+  /// The number of vertices added to the batch.
+  size_t GetVertexCount() const { return vertices_.size(); }
+
+  // |Geometry|
+  GeometryResult GetPositionBuffer(const ContentContext& renderer,
+                                   const Entity& entity,
+                                   RenderPass& pass) const override;
+
+  // |Geometry|
+  std::optional<Rect> GetCoverage(const Matrix& transform) const override;
+
+  // |Geometry|
+  bool CanApplyMaskFilter() const override;
+
+ private:
+  std::vector<Point> vertices_;
+  std::vector<uint16_t> indices_;
+  std::optional<Rect> bounds_;
+  size_t shape_count_ = 0u;
+
+  BatchedFillGeometry(const BatchedFillGeometry&) = delete;
+
+  BatchedFillGeometry& operator=(const BatchedFillGeometry&) = delete;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_ENTITY_GEOMETRY_BATCHED_FILL_GEOMETRY_H_
@@ -47,7 +47,8 @@ GeometryResult FillPathSourceGeometry::GetPositionBuffer(
       GetSource(), data_host_buffer, indexes_host_buffer,
       entity.GetTransform().GetMaxBasisLengthXY(),
       /*supports_primitive_restart=*/supports_primitive_restart,
-      /*supports_triangle_fan=*/supports_triangle_fan);
+      /*supports_triangle_fan=*/supports_triangle_fan,
+      /*path_identity=*/GetSourceIdentity());
 
   return GeometryResult{
       .type = supports_triangle_fan ? PrimitiveType::kTriangleFan
@@ -58,6 +59,10 @@ GeometryResult FillPathSourceGeometry::GetPositionBuffer(
   };
 }
 
+const void* FillPathSourceGeometry::GetSourceIdentity() const {
+  return nullptr;
+}
+
 GeometryResult::Mode FillPathSourceGeometry::GetResultMode() const {
   const PathSource& source = GetSource();
   const auto& bounding_box = source.GetBounds();
@@ -107,6 +112,11 @@ const PathSource& FillPathGeometry::GetSource() const {
   return path_;
 }
 
+const void* FillPathGeometry::GetSourceIdentity() const {
+  // Copies of a DlPath share the underlying SkPath.
+  return &path_.GetSkPath();
+}
+
 FillDiffRoundRectGeometry::FillDiffRoundRectGeometry(const RoundRect& outer,
                                                      const RoundRect& inner)
     : FillPathSourceGeometry(std::nullopt), source_(outer, inner) {}
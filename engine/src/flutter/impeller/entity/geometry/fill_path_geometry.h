@@ -30,6 +30,11 @@ class FillPathSourceGeometry : public Geometry {
   /// vertices.
   virtual const PathSource& GetSource() const = 0;
 
+  /// A pointer that identifies the path data for the duration of a frame,
+  /// used to look up vertices that were tessellated ahead of time, or
+  /// nullptr if the source has no stable identity.
+  virtual const void* GetSourceIdentity() const;
+
  private:
   // |Geometry|
   GeometryResult GetPositionBuffer(const ContentContext& renderer,
@@ -73,6 +78,8 @@ class FillPathGeometry final : public FillPathSourceGeometry {
  protected:
   const PathSource& GetSource() const override;
 
+  const void* GetSourceIdentity() const override;
+
  private:
   const flutter::DlPath path_;
 };
@@ -10,6 +10,7 @@
 #include "impeller/entity/contents/content_context.h"
 #include "impeller/entity/contents/pipelines.h"
 #include "impeller/entity/contents/uber_sdf_parameters.h"
+#include "impeller/entity/geometry/batched_fill_geometry.h"
 #include "impeller/entity/geometry/geometry.h"
 #include "impeller/entity/geometry/rect_geometry.h"
 #include "impeller/entity/geometry/round_rect_geometry.h"
@@ -574,6 +575,42 @@ TEST(EntityGeometryTest, RoundRectGeometryCoversArea) {
   EXPECT_TRUE(geometry->CoversArea({}, Rect::MakeLTRB(1, 30, 99, 70)));
 }
 
+TEST(EntityGeometryTest, BatchedFillGeometryTransformsShapes) {
+  BatchedFillGeometry geometry;
+  EXPECT_FALSE(geometry.GetCoverage({}).has_value());
+
+  EXPECT_TRUE(geometry.AddRect(Matrix::MakeTranslation({10, 20}),
+                               Rect::MakeXYWH(0, 0, 10, 10)));
+  EXPECT_EQ(geometry.GetShapeCount(), 1u);
+  EXPECT_EQ(geometry.GetVertexCount(), 4u);
+  EXPECT_EQ(geometry.GetCoverage({}), Rect::MakeLTRB(10, 20, 20, 30));
+
+  Tessellator tessellator;
+  Matrix transform = Matrix::MakeScale({2, 2, 1});
+  auto generator =
+      tessellator.FilledCircle(transform, Point(50, 50), /*radius=*/10);
+  EXPECT_TRUE(geometry.AddVertices(transform, generator));
+  EXPECT_EQ(geometry.GetShapeCount(), 2u);
+  EXPECT_EQ(geometry.GetVertexCount(), 4u + generator.GetVertexCount());
+  EXPECT_RECT_NEAR(geometry.GetCoverage({}).value(),
+                   Rect::MakeLTRB(10, 20, 120, 120));
+
+  // Perspective transforms can not be applied on the CPU.
+  Matrix perspective = Matrix::MakePerspective(Degrees(60), {100, 100}, 1, 10);
+  EXPECT_FALSE(geometry.AddRect(perspective, Rect::MakeXYWH(0, 0, 10, 10)));
+  EXPECT_EQ(geometry.GetShapeCount(), 2u);
+}
+
+TEST(EntityGeometryTest, BatchedFillGeometryRejectsShapesOnceFull) {
+  BatchedFillGeometry geometry;
+  for (size_t i = 0; i < BatchedFillGeometry::kMaxVertexCount / 4; i++) {
+    ASSERT_TRUE(geometry.AddRect({}, Rect::MakeXYWH(i, 0, 1, 1)));
+  }
+  EXPECT_EQ(geometry.GetVertexCount(), BatchedFillGeometry::kMaxVertexCount);
+  EXPECT_FALSE(geometry.AddRect({}, Rect::MakeXYWH(0, 0, 1, 1)));
+  EXPECT_EQ(geometry.GetShapeCount(), BatchedFillGeometry::kMaxVertexCount / 4);
+}
+
 TEST(EntityGeometryTest, GeometryResultHasReasonableDefaults) {
   GeometryResult result;
   EXPECT_EQ(result.type, PrimitiveType::kTriangleStrip);
@@ -0,0 +1,34 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// The downsample pass of a dual filter (Kawase) blur.
+//
+// Renders at half the size of the input and averages the center of each 2x2
+// block of input texels with four diagonal samples around it.
+
+#include <impeller/types.glsl>
+
+uniform f16sampler2D texture_sampler;
+
+uniform FragInfo {
+  // The distance of the diagonal samples from the center, in UVs.
+  vec2 offset;
+}
+frag_info;
+
+in vec2 v_texture_coords;
+
+out f16vec4 frag_color;
+
+void main() {
+  vec2 offset = frag_info.offset;
+  f16vec4 total_color = texture(texture_sampler, v_texture_coords) * 4.0hf;
+  total_color += texture(texture_sampler, v_texture_coords - offset);
+  total_color += texture(texture_sampler, v_texture_coords + offset);
+  total_color +=
+      texture(texture_sampler, v_texture_coords + vec2(offset.x, -offset.y));
+  total_color +=
+      texture(texture_sampler, v_texture_coords + vec2(-offset.x, offset.y));
+  frag_color = total_color * 0.125hf;
+}
@@ -0,0 +1,53 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// The upsample pass of a dual filter (Kawase) blur.
+//
+// Renders at twice the size of the input with a tent of four samples on the
+// axes and four diagonal samples at half the distance, which are weighted
+// twice as much.
+
+#include <impeller/color.glsl>
+#include <impeller/types.glsl>
+
+uniform f16sampler2D texture_sampler;
+
+uniform FragInfo {
+  // The distance of the samples on the axes from the center, in UVs.
+  vec2 offset;
+  float unpremultiply;
+}
+frag_info;
+
+in vec2 v_texture_coords;
+
+out f16vec4 frag_color;
+
+void main() {
+  vec2 offset = frag_info.offset;
+  vec2 half_offset = offset * 0.5;
+  f16vec4 total_color =
+      texture(texture_sampler, v_texture_coords + vec2(-offset.x, 0.0));
+  total_color +=
+      texture(texture_sampler, v_texture_coords + vec2(offset.x, 0.0));
+  total_color +=
+      texture(texture_sampler, v_texture_coords + vec2(0.0, -offset.y));
+  total_color +=
+      texture(texture_sampler, v_texture_coords + vec2(0.0, offset.y));
+  f16vec4 diagonal_color =
+      texture(texture_sampler, v_texture_coords - half_offset);
+  diagonal_color += texture(texture_sampler, v_texture_coords + half_offset);
+  diagonal_color += texture(
+      texture_sampler, v_texture_coords + vec2(half_offset.x, -half_offset.y));
+  diagonal_color += texture(
+      texture_sampler, v_texture_coords + vec2(-half_offset.x, half_offset.y));
+  total_color += diagonal_color * 2.0hf;
+  total_color *= float16_t(1.0 / 12.0);
+
+  if (frag_info.unpremultiply > 0.5) {
+    frag_color = IPHalfUnpremultiplyOpaque(total_color);
+  } else {
+    frag_color = total_color;
+  }
+}
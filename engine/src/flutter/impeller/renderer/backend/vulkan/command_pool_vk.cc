@@ -98,7 +98,8 @@ CommandPoolVK::~CommandPoolVK() {
 }
 
 // TODO(matanlurey): Return a status_or<> instead of {} when we have one.
-vk::UniqueCommandBuffer CommandPoolVK::CreateCommandBuffer() {
+vk::UniqueCommandBuffer CommandPoolVK::CreateCommandBuffer(
+    vk::CommandBufferLevel level) {
   auto const context = context_.lock();
   if (!context) {
     return {};
@@ -108,7 +109,8 @@ vk::UniqueCommandBuffer CommandPoolVK::CreateCommandBuffer() {
   if (!pool_) {
     return {};
   }
-  if (!unused_command_buffers_.empty()) {
+  if (level == vk::CommandBufferLevel::ePrimary &&
+      !unused_command_buffers_.empty()) {
     vk::UniqueCommandBuffer buffer = std::move(unused_command_buffers_.back());
     unused_command_buffers_.pop_back();
     return buffer;
@@ -118,7 +120,7 @@ vk::UniqueCommandBuffer CommandPoolVK::CreateCommandBuffer() {
   vk::CommandBufferAllocateInfo info;
   info.setCommandPool(pool_.get());
   info.setCommandBufferCount(1u);
-  info.setLevel(vk::CommandBufferLevel::ePrimary);
+  info.setLevel(level);
   auto [result, buffers] = device.allocateCommandBuffersUnique(info);
   if (result != vk::Result::eSuccess) {
     return {};
@@ -222,6 +224,18 @@ std::shared_ptr<CommandPoolVK> CommandPoolRecyclerVK::Get() {
   return resource;
 }
 
+std::shared_ptr<CommandPoolVK> CommandPoolRecyclerVK::CreateDetached() {
+  if (context_.expired()) {
+    return nullptr;
+  }
+  auto data = Create();
+  if (!data || !data->pool) {
+    return nullptr;
+  }
+  return std::make_shared<CommandPoolVK>(std::move(data->pool),
+                                         std::move(data->buffers), context_);
+}
+
 // TODO(matanlurey): Return a status_or<> instead of nullopt when we have one.
 std::optional<CommandPoolRecyclerVK::RecycledData>
 CommandPoolRecyclerVK::Create() {
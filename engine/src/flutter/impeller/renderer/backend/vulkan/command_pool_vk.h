@@ -46,10 +46,17 @@ class CommandPoolVK final {
 
   /// @brief      Creates and returns a new |vk::CommandBuffer|.
   ///
+  /// Only primary command buffers are recycled. Secondary command buffers are
+  /// always newly allocated, and must be destroyed instead of collected before
+  /// the pool is dropped.
+  ///
+  /// @param[in]  level   The level of the command buffer.
+  ///
   /// @return     Always returns a new |vk::CommandBuffer|, but if for any
   ///             reason a valid command buffer could not be created, it will be
   ///             a `{}` default instance (i.e. while being torn down).
-  vk::UniqueCommandBuffer CreateCommandBuffer();
+  vk::UniqueCommandBuffer CreateCommandBuffer(
+      vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary);
 
   /// @brief      Collects the given |vk::CommandBuffer| to be retained.
   ///
@@ -123,6 +130,16 @@ class CommandPoolRecyclerVK final
   /// @warning    Returns a |nullptr| if a pool could not be created.
   std::shared_ptr<CommandPoolVK> Get();
 
+  /// @brief      Creates a command pool that is not associated with any
+  ///             thread.
+  ///
+  /// The pool is recycled once the last reference to it is dropped. It is
+  /// meant for recording secondary command buffers on worker threads, and may
+  /// only be used by one thread at a time.
+  ///
+  /// @warning    Returns a |nullptr| if a pool could not be created.
+  std::shared_ptr<CommandPoolVK> CreateDetached();
+
   /// @brief      Returns a command pool to be reset on a background thread.
   ///
   /// @param[in]  pool The pool to recycle.
@@ -238,5 +238,42 @@ TEST(CommandPoolRecyclerVKTest, RecyclerGlobalPoolMapSize) {
   context->Shutdown();
 }
 
+TEST(CommandPoolRecyclerVKTest, DetachedPoolsAreNotThreadLocal) {
+  auto context = MockVulkanContextBuilder().Build();
+  auto const recycler = context->GetCommandPoolRecycler();
+
+  auto pool = recycler->Get();
+  auto detached_pool1 = recycler->CreateDetached();
+  auto detached_pool2 = recycler->CreateDetached();
+  ASSERT_NE(detached_pool1, nullptr);
+  ASSERT_NE(detached_pool2, nullptr);
+  EXPECT_NE(detached_pool1, pool);
+  EXPECT_NE(detached_pool1, detached_pool2);
+
+  // Only the pool of this thread is in the global map.
+  EXPECT_EQ(CommandPoolRecyclerVK::GetGlobalPoolCount(*context), 1);
+
+  // Secondary command buffers are never reused.
+  auto buffer = detached_pool1->CreateCommandBuffer(
+      vk::CommandBufferLevel::eSecondary);
+  EXPECT_TRUE(buffer);
+  buffer.reset();
+  buffer = detached_pool1->CreateCommandBuffer(
+      vk::CommandBufferLevel::eSecondary);
+  EXPECT_TRUE(buffer);
+  buffer.reset();
+
+  auto const called = GetMockVulkanFunctions(context->GetDevice());
+  EXPECT_EQ(
+      std::count(called->begin(), called->end(), "vkAllocateCommandBuffers"),
+      2u);
+
+  detached_pool1.reset();
+  detached_pool2.reset();
+  pool.reset();
+  recycler->Dispose();
+  context->Shutdown();
+}
+
 }  // namespace testing
 }  // namespace impeller
@@ -4,9 +4,15 @@
 
 #include "impeller/renderer/backend/vulkan/render_pass_vk.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <thread>
 
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/trace_event.h"
 #include "fml/status.h"
 #include "impeller/base/validation.h"
 #include "impeller/core/buffer_view.h"
@@ -16,6 +22,7 @@
 #include "impeller/core/vertex_buffer.h"
 #include "impeller/renderer/backend/vulkan/barrier_vk.h"
 #include "impeller/renderer/backend/vulkan/command_buffer_vk.h"
+#include "impeller/renderer/backend/vulkan/command_pool_vk.h"
 #include "impeller/renderer/backend/vulkan/context_vk.h"
 #include "impeller/renderer/backend/vulkan/device_buffer_vk.h"
 #include "impeller/renderer/backend/vulkan/formats_vk.h"
@@ -34,6 +41,28 @@ namespace impeller {
 // See: impeller/entity/shaders/blending/framebuffer_blend.frag
 static constexpr size_t kMagicSubpassInputBinding = 64u;
 
+// A secondary command buffer along with the detached command pool it was
+// allocated from. The command buffer is freed before the pool is recycled.
+class SecondaryCommandBufferVK final : public SharedObjectVK {
+ public:
+  SecondaryCommandBufferVK(std::shared_ptr<CommandPoolVK> pool,
+                           vk::UniqueCommandBuffer buffer)
+      : pool_(std::move(pool)), buffer_(std::move(buffer)) {}
+
+  ~SecondaryCommandBufferVK() override { buffer_.reset(); }
+
+  vk::CommandBuffer Get() const { return *buffer_; }
+
+ private:
+  std::shared_ptr<CommandPoolVK> pool_;
+  vk::UniqueCommandBuffer buffer_;
+
+  SecondaryCommandBufferVK(const SecondaryCommandBufferVK&) = delete;
+
+  SecondaryCommandBufferVK& operator=(const SecondaryCommandBufferVK&) =
+      delete;
+};
+
 static vk::ClearColorValue VKClearValueFromColor(Color color) {
   vk::ClearColorValue value;
   value.setFloat32(
@@ -139,6 +168,7 @@ RenderPassVK::RenderPassVK(const std::shared_ptr<const Context>& context,
 
   const auto& vk_context = ContextVK::Cast(*context);
   command_buffer_vk_ = command_buffer_->GetCommandBuffer();
+  is_deferred_ = context->GetFlags().parallel_render_pass_encoding;
   render_target_.IterateAllAttachments([&](const auto& attachment) -> bool {
     command_buffer_->Track(attachment.texture);
     command_buffer_->Track(attachment.resolve_texture);
@@ -184,6 +214,7 @@ RenderPassVK::RenderPassVK(const std::shared_ptr<const Context>& context,
     return;
   }
 
+  framebuffer_ = framebuffer;
   frame_data.framebuffer = framebuffer;
   frame_data.render_pass = render_pass_;
 
@@ -213,8 +244,7 @@ RenderPassVK::RenderPassVK(const std::shared_ptr<const Context>& context,
     }
   }
 
-  std::array<vk::ClearValue, kMaxAttachments> clears;
-  size_t clear_count = GetVKClearValues(render_target_, clears);
+  clear_value_count_ = GetVKClearValues(render_target_, clear_values_);
 
   vk::RenderPassBeginInfo pass_info;
   pass_info.renderPass = *render_pass_;
@@ -222,10 +252,14 @@ RenderPassVK::RenderPassVK(const std::shared_ptr<const Context>& context,
   pass_info.renderArea.extent.width = static_cast<uint32_t>(target_size.width);
   pass_info.renderArea.extent.height =
       static_cast<uint32_t>(target_size.height);
-  pass_info.setPClearValues(clears.data());
-  pass_info.setClearValueCount(clear_count);
+  pass_info.setPClearValues(clear_values_.data());
+  pass_info.setClearValueCount(clear_value_count_);
 
-  command_buffer_vk_.beginRenderPass(pass_info, vk::SubpassContents::eInline);
+  // Deferred passes are begun once their draws are known, as the contents of
+  // the subpass depend on how they are recorded.
+  if (!is_deferred_) {
+    command_buffer_vk_.beginRenderPass(pass_info, vk::SubpassContents::eInline);
+  }
 
   if (resolve_image_vk_) {
     TextureVK::Cast(*resolve_image_vk_)
@@ -240,25 +274,28 @@ RenderPassVK::RenderPassVK(const std::shared_ptr<const Context>& context,
 
   // Set the initial viewport.
   const auto vp = Viewport{.rect = Rect::MakeSize(target_size)};
-  vk::Viewport viewport = vk::Viewport()
-                              .setWidth(vp.rect.GetWidth())
-                              .setHeight(-vp.rect.GetHeight())
-                              .setY(vp.rect.GetHeight())
-                              .setMinDepth(0.0f)
-                              .setMaxDepth(1.0f);
-  command_buffer_vk_.setViewport(0, 1, &viewport);
+  current_viewport_ = vk::Viewport()
+                          .setWidth(vp.rect.GetWidth())
+                          .setHeight(-vp.rect.GetHeight())
+                          .setY(vp.rect.GetHeight())
+                          .setMinDepth(0.0f)
+                          .setMaxDepth(1.0f);
 
   // Set the initial scissor.
   const auto sc = IRect32::MakeSize(target_size);
-  vk::Rect2D scissor =
+  current_scissor_ =
       vk::Rect2D()
           .setOffset(vk::Offset2D(sc.GetX(), sc.GetY()))
           .setExtent(vk::Extent2D(sc.GetWidth(), sc.GetHeight()));
-  command_buffer_vk_.setScissor(0, 1, &scissor);
 
-  // Set the initial stencil reference.
-  command_buffer_vk_.setStencilReference(
-      vk::StencilFaceFlagBits::eVkStencilFrontAndBack, 0u);
+  if (!is_deferred_) {
+    command_buffer_vk_.setViewport(0, 1, &current_viewport_);
+    command_buffer_vk_.setScissor(0, 1, &current_scissor_);
+
+    // Set the initial stencil reference.
+    command_buffer_vk_.setStencilReference(
+        vk::StencilFaceFlagBits::eVkStencilFrontAndBack, 0u);
+  }
 
   is_valid_ = true;
 }
@@ -365,6 +402,11 @@ void RenderPassVK::SetPipeline(PipelineRef pipeline) {
 // |RenderPass|
 void RenderPassVK::SetCommandLabel(std::string_view label) {
 #ifdef IMPELLER_DEBUG
+  // Debug groups are recorded into the primary command buffer, so they are
+  // not available for deferred draws.
+  if (is_deferred_) {
+    return;
+  }
   command_buffer_->PushDebugGroup(label);
   has_label_ = true;
 #endif  // IMPELLER_DEBUG
@@ -376,6 +418,9 @@ void RenderPassVK::SetStencilReference(uint32_t value) {
     return;
   }
   current_stencil_ = value;
+  if (is_deferred_) {
+    return;
+  }
   command_buffer_vk_.setStencilReference(
       vk::StencilFaceFlagBits::eVkStencilFrontAndBack, value);
 }
@@ -387,22 +432,28 @@ void RenderPassVK::SetBaseVertex(uint64_t value) {
 
 // |RenderPass|
 void RenderPassVK::SetViewport(Viewport viewport) {
-  vk::Viewport viewport_vk = vk::Viewport()
-                                 .setWidth(viewport.rect.GetWidth())
-                                 .setHeight(-viewport.rect.GetHeight())
-                                 .setY(viewport.rect.GetHeight())
-                                 .setMinDepth(0.0f)
-                                 .setMaxDepth(1.0f);
-  command_buffer_vk_.setViewport(0, 1, &viewport_vk);
+  current_viewport_ = vk::Viewport()
+                          .setWidth(viewport.rect.GetWidth())
+                          .setHeight(-viewport.rect.GetHeight())
+                          .setY(viewport.rect.GetHeight())
+                          .setMinDepth(0.0f)
+                          .setMaxDepth(1.0f);
+  if (is_deferred_) {
+    return;
+  }
+  command_buffer_vk_.setViewport(0, 1, &current_viewport_);
 }
 
 // |RenderPass|
 void RenderPassVK::SetScissor(IRect32 scissor) {
-  vk::Rect2D scissor_vk =
+  current_scissor_ =
       vk::Rect2D()
           .setOffset(vk::Offset2D(scissor.GetX(), scissor.GetY()))
           .setExtent(vk::Extent2D(scissor.GetWidth(), scissor.GetHeight()));
-  command_buffer_vk_.setScissor(0, 1, &scissor_vk);
+  if (is_deferred_) {
+    return;
+  }
+  command_buffer_vk_.setScissor(0, 1, &current_scissor_);
 }
 
 // |RenderPass|
@@ -435,6 +486,17 @@ bool RenderPassVK::SetVertexBuffer(BufferView vertex_buffers[],
     }
   }
 
+  if (is_deferred_) {
+    current_vertex_buffer_offset_ = deferred_vertex_buffers_.size();
+    current_vertex_buffer_count_ = vertex_buffer_count;
+    deferred_vertex_buffers_.insert(deferred_vertex_buffers_.end(), buffers,
+                                    buffers + vertex_buffer_count);
+    deferred_vertex_buffer_offsets_.insert(
+        deferred_vertex_buffer_offsets_.end(), vertex_buffer_offsets,
+        vertex_buffer_offsets + vertex_buffer_count);
+    return true;
+  }
+
   // Bind the vertex buffers.
   command_buffer_vk_.bindVertexBuffers(0u, vertex_buffer_count, buffers,
                                        vertex_buffer_offsets);
@@ -471,6 +533,12 @@ bool RenderPassVK::SetIndexBuffer(BufferView index_buffer,
 
     vk::Buffer index_buffer_handle =
         DeviceBufferVK::Cast(*index_buffer_view.GetBuffer()).GetBuffer();
+    if (is_deferred_) {
+      current_index_buffer_ = index_buffer_handle;
+      current_index_buffer_offset_ = index_buffer_view.GetRange().offset;
+      current_index_type_ = ToVKIndexType(index_type);
+      return true;
+    }
     command_buffer_vk_.bindIndexBuffer(index_buffer_handle,
                                        index_buffer_view.GetRange().offset,
                                        ToVKIndexType(index_type));
@@ -528,6 +596,34 @@ fml::Status RenderPassVK::Draw() {
                        "Could not allocate descriptor sets.");
   }
   const auto descriptor_set = descriptor_result.value();
+  if (is_deferred_) {
+    DeferDraw(descriptor_set, pipeline_vk);
+  } else {
+    EncodeDraw(descriptor_set, pipeline_vk);
+  }
+
+#ifdef IMPELLER_DEBUG
+  if (has_label_) {
+    command_buffer_->PopDebugGroup();
+  }
+#endif  // IMPELLER_DEBUG
+  has_label_ = false;
+  has_index_buffer_ = false;
+  bound_image_offset_ = 0u;
+  bound_buffer_offset_ = 0u;
+  descriptor_write_offset_ = 0u;
+  instance_count_ = 1u;
+  base_vertex_ = 0u;
+  element_count_ = 0u;
+  pipeline_ = PipelineRef(nullptr);
+  pipeline_uses_input_attachments_ = false;
+  immutable_sampler_ = nullptr;
+  return fml::Status();
+}
+
+void RenderPassVK::EncodeDraw(vk::DescriptorSet descriptor_set,
+                              const PipelineVK& pipeline_vk) {
+  const auto& context_vk = ContextVK::Cast(*context_);
   const auto pipeline_layout = pipeline_vk.GetPipelineLayout();
   command_buffer_vk_.bindPipeline(vk::PipelineBindPoint::eGraphics,
                                   pipeline_vk.GetPipeline());
@@ -568,24 +664,247 @@ fml::Status RenderPassVK::Draw() {
                             0u                // first instance
     );
   }
+}
 
-#ifdef IMPELLER_DEBUG
-  if (has_label_) {
-    command_buffer_->PopDebugGroup();
+void RenderPassVK::DeferDraw(vk::DescriptorSet descriptor_set,
+                             const PipelineVK& pipeline_vk) {
+  DeferredDraw& draw = deferred_draws_.emplace_back();
+  draw.pipeline = pipeline_vk.GetPipeline();
+  draw.pipeline_layout = pipeline_vk.GetPipelineLayout();
+  draw.descriptor_set = descriptor_set;
+
+  // The workspaces are reused by the next draw, so the descriptor writes are
+  // copied. Their pointers to the image and buffer infos are resolved when
+  // the writes are applied.
+  draw.write_offset = deferred_writes_.size();
+  draw.write_count = descriptor_write_offset_;
+  for (auto i = 0u; i < descriptor_write_offset_; i++) {
+    vk::WriteDescriptorSet write = write_workspace_[i];
+    write.dstSet = descriptor_set;
+    if (write.pImageInfo) {
+      deferred_write_infos_.push_back(deferred_images_.size());
+      deferred_images_.push_back(*write.pImageInfo);
+      write.pImageInfo = nullptr;
+    } else {
+      deferred_write_infos_.push_back(deferred_buffers_.size());
+      deferred_buffers_.push_back(*write.pBufferInfo);
+      write.pBufferInfo = nullptr;
+    }
+    deferred_writes_.push_back(write);
   }
-#endif  // IMPELLER_DEBUG
-  has_label_ = false;
-  has_index_buffer_ = false;
-  bound_image_offset_ = 0u;
-  bound_buffer_offset_ = 0u;
-  descriptor_write_offset_ = 0u;
-  instance_count_ = 1u;
-  base_vertex_ = 0u;
-  element_count_ = 0u;
-  pipeline_ = PipelineRef(nullptr);
-  pipeline_uses_input_attachments_ = false;
-  immutable_sampler_ = nullptr;
-  return fml::Status();
+
+  draw.vertex_buffer_offset = current_vertex_buffer_offset_;
+  draw.vertex_buffer_count = current_vertex_buffer_count_;
+  draw.has_index_buffer = has_index_buffer_;
+  if (has_index_buffer_) {
+    draw.index_buffer = current_index_buffer_;
+    draw.index_buffer_offset = current_index_buffer_offset_;
+    draw.index_type = current_index_type_;
+  }
+  draw.uses_input_attachments = pipeline_uses_input_attachments_;
+  has_input_attachment_draws_ |= pipeline_uses_input_attachments_;
+  draw.viewport = current_viewport_;
+  draw.scissor = current_scissor_;
+  draw.stencil_reference = current_stencil_;
+  draw.element_count = element_count_;
+  draw.instance_count = instance_count_;
+  draw.base_vertex = base_vertex_;
+}
+
+void RenderPassVK::EncodeDeferredDraws(vk::CommandBuffer buffer,
+                                       size_t start,
+                                       size_t end) const {
+  if (start >= end) {
+    return;
+  }
+  const auto& context_vk = ContextVK::Cast(*context_);
+
+  // The draws of a range have contiguous descriptor writes, which are applied
+  // at once.
+  const DeferredDraw& last = deferred_draws_[end - 1];
+  size_t write_start = deferred_draws_[start].write_offset;
+  size_t write_end = last.write_offset + last.write_count;
+  std::vector<vk::WriteDescriptorSet> writes(
+      deferred_writes_.begin() + write_start,
+      deferred_writes_.begin() + write_end);
+  for (size_t i = 0u; i < writes.size(); i++) {
+    size_t info = deferred_write_infos_[write_start + i];
+    if (writes[i].descriptorType == vk::DescriptorType::eCombinedImageSampler ||
+        writes[i].descriptorType == vk::DescriptorType::eInputAttachment) {
+      writes[i].pImageInfo = &deferred_images_[info];
+    } else {
+      writes[i].pBufferInfo = &deferred_buffers_[info];
+    }
+  }
+  context_vk.GetDevice().updateDescriptorSets(writes.size(), writes.data(), 0u,
+                                              {});
+
+  // Dynamic state is not inherited by secondary command buffers, so it is
+  // always set for the first draw of a range.
+  const DeferredDraw* previous = nullptr;
+  for (size_t i = start; i < end; i++) {
+    const DeferredDraw& draw = deferred_draws_[i];
+    if (!previous || previous->viewport != draw.viewport) {
+      buffer.setViewport(0, 1, &draw.viewport);
+    }
+    if (!previous || previous->scissor != draw.scissor) {
+      buffer.setScissor(0, 1, &draw.scissor);
+    }
+    if (!previous || previous->stencil_reference != draw.stencil_reference) {
+      buffer.setStencilReference(
+          vk::StencilFaceFlagBits::eVkStencilFrontAndBack,
+          draw.stencil_reference);
+    }
+    if (!previous || previous->pipeline != draw.pipeline) {
+      buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, draw.pipeline);
+    }
+    buffer.bindDescriptorSets(
+        vk::PipelineBindPoint::eGraphics,  // bind point
+        draw.pipeline_layout,              // layout
+        0,                                 // first set
+        1,                                 // set count
+        &draw.descriptor_set,              // sets
+        0,                                 // offset count
+        nullptr                            // offsets
+    );
+    if (draw.vertex_buffer_count > 0u &&
+        (!previous ||
+         previous->vertex_buffer_offset != draw.vertex_buffer_offset)) {
+      buffer.bindVertexBuffers(
+          0u, draw.vertex_buffer_count,
+          &deferred_vertex_buffers_[draw.vertex_buffer_offset],
+          &deferred_vertex_buffer_offsets_[draw.vertex_buffer_offset]);
+    }
+    if (draw.uses_input_attachments) {
+      InsertBarrierForInputAttachmentRead(
+          buffer, TextureVK::Cast(*color_image_vk_).GetImage());
+    }
+    if (draw.has_index_buffer) {
+      buffer.bindIndexBuffer(draw.index_buffer, draw.index_buffer_offset,
+                             draw.index_type);
+      buffer.drawIndexed(draw.element_count,   // index count
+                         draw.instance_count,  // instance count
+                         0u,                   // first index
+                         draw.base_vertex,     // vertex offset
+                         0u                    // first instance
+      );
+    } else {
+      buffer.draw(draw.element_count,   // vertex count
+                  draw.instance_count,  // instance count
+                  draw.base_vertex,     // vertex offset
+                  0u                    // first instance
+      );
+    }
+    previous = &draw;
+  }
+}
+
+std::vector<vk::CommandBuffer> RenderPassVK::RecordSecondaryCommandBuffers()
+    const {
+  // Barriers for input attachments are only recorded inline.
+  if (deferred_draws_.size() < kMinParallelEncodingDraws ||
+      has_input_attachment_draws_) {
+    return {};
+  }
+  const auto& context_vk = ContextVK::Cast(*context_);
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner =
+      context_vk.GetConcurrentWorkerTaskRunner();
+  std::shared_ptr<CommandPoolRecyclerVK> recycler =
+      context_vk.GetCommandPoolRecycler();
+  if (!worker_task_runner || !recycler) {
+    return {};
+  }
+  TRACE_EVENT0("impeller", "RenderPassVK::RecordSecondaryCommandBuffers");
+
+  size_t chunk_count = std::min(
+      std::max(static_cast<size_t>(std::thread::hardware_concurrency()),
+               static_cast<size_t>(2u)),
+      deferred_draws_.size() / kMinDrawsPerSecondaryCommandBuffer);
+
+  // Command pools are not thread safe, so each secondary command buffer is
+  // allocated from its own pool. They are allocated up front so that the
+  // draws can still be recorded inline if that fails.
+  std::vector<std::shared_ptr<SecondaryCommandBufferVK>> buffers;
+  buffers.reserve(chunk_count);
+  for (size_t i = 0; i < chunk_count; i++) {
+    std::shared_ptr<CommandPoolVK> pool = recycler->CreateDetached();
+    if (!pool) {
+      return {};
+    }
+    vk::UniqueCommandBuffer buffer =
+        pool->CreateCommandBuffer(vk::CommandBufferLevel::eSecondary);
+    if (!buffer) {
+      return {};
+    }
+    buffers.push_back(std::make_shared<SecondaryCommandBufferVK>(
+        std::move(pool), std::move(buffer)));
+  }
+
+  struct State {
+    explicit State(size_t p_chunk_count)
+        : chunk_count(p_chunk_count), chunks_done(p_chunk_count) {}
+
+    const size_t chunk_count;
+    std::atomic<size_t> next_chunk = 0u;
+    std::atomic<bool> failed = false;
+    fml::CountDownLatch chunks_done;
+  };
+  auto state = std::make_shared<State>(chunk_count);
+  size_t chunk_size = (deferred_draws_.size() + chunk_count - 1) / chunk_count;
+
+  vk::CommandBufferInheritanceInfo inheritance_info;
+  inheritance_info.renderPass = *render_pass_;
+  inheritance_info.subpass = 0u;
+  inheritance_info.framebuffer = *framebuffer_;
+
+  // Returns false once every chunk has been claimed. Late workers only touch
+  // the atomic counter and never the pass, which may no longer exist by then.
+  auto record_next_chunk = [this, state, &buffers, &inheritance_info,
+                            chunk_size]() -> bool {
+    size_t chunk = state->next_chunk.fetch_add(1u);
+    if (chunk >= state->chunk_count) {
+      return false;
+    }
+    size_t start = std::min(chunk * chunk_size, deferred_draws_.size());
+    size_t end = std::min(start + chunk_size, deferred_draws_.size());
+    vk::CommandBuffer buffer = buffers[chunk]->Get();
+
+    vk::CommandBufferBeginInfo begin_info;
+    begin_info.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit |
+                       vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+    begin_info.pInheritanceInfo = &inheritance_info;
+    if (buffer.begin(begin_info) != vk::Result::eSuccess) {
+      state->failed = true;
+    } else {
+      EncodeDeferredDraws(buffer, start, end);
+      if (buffer.end() != vk::Result::eSuccess) {
+        state->failed = true;
+      }
+    }
+    state->chunks_done.CountDown();
+    return true;
+  };
+
+  for (size_t i = 1; i < chunk_count; i++) {
+    worker_task_runner->PostTask([record_next_chunk]() { record_next_chunk(); },
+                                 fml::ConcurrentTaskPriority::kHigh);
+  }
+  while (record_next_chunk()) {
+  }
+  state->chunks_done.Wait();
+
+  if (state->failed) {
+    VALIDATION_LOG << "Could not record secondary command buffers.";
+    return {};
+  }
+
+  std::vector<vk::CommandBuffer> result;
+  result.reserve(buffers.size());
+  for (const std::shared_ptr<SecondaryCommandBufferVK>& buffer : buffers) {
+    command_buffer_->Track(buffer);
+    result.push_back(buffer->Get());
+  }
+  return result;
 }
 
 // The RenderPassVK binding methods only need the binding, set, and buffer type
@@ -690,7 +1009,35 @@ bool RenderPassVK::BindResource(ShaderStage stage,
 }
 
 bool RenderPassVK::OnEncodeCommands(const Context& context) const {
-  command_buffer_->GetCommandBuffer().endRenderPass();
+  if (!is_deferred_) {
+    command_buffer_->GetCommandBuffer().endRenderPass();
+    return true;
+  }
+
+  std::vector<vk::CommandBuffer> secondary_buffers =
+      RecordSecondaryCommandBuffers();
+
+  const auto& target_size = render_target_.GetRenderTargetSize();
+  vk::RenderPassBeginInfo pass_info;
+  pass_info.renderPass = *render_pass_;
+  pass_info.framebuffer = *framebuffer_;
+  pass_info.renderArea.extent.width = static_cast<uint32_t>(target_size.width);
+  pass_info.renderArea.extent.height =
+      static_cast<uint32_t>(target_size.height);
+  pass_info.setPClearValues(clear_values_.data());
+  pass_info.setClearValueCount(clear_value_count_);
+
+  vk::CommandBuffer primary = command_buffer_->GetCommandBuffer();
+  if (secondary_buffers.empty()) {
+    primary.beginRenderPass(pass_info, vk::SubpassContents::eInline);
+    EncodeDeferredDraws(primary, 0u, deferred_draws_.size());
+  } else {
+    primary.beginRenderPass(pass_info,
+                            vk::SubpassContents::eSecondaryCommandBuffers);
+    primary.executeCommands(secondary_buffers.size(),
+                            secondary_buffers.data());
+  }
+  primary.endRenderPass();
   return true;
 }
 
@@ -5,6 +5,8 @@
 #ifndef FLUTTER_IMPELLER_RENDERER_BACKEND_VULKAN_RENDER_PASS_VK_H_
 #define FLUTTER_IMPELLER_RENDERER_BACKEND_VULKAN_RENDER_PASS_VK_H_
 
+#include <vector>
+
 #include "impeller/core/buffer_view.h"
 #include "impeller/renderer/backend/vulkan/context_vk.h"
 #include "impeller/renderer/backend/vulkan/pipeline_vk.h"
@@ -20,16 +22,52 @@ class SamplerVK;
 
 class RenderPassVK final : public RenderPass {
  public:
+  /// The minimum number of draws in a deferred render pass before they are
+  /// recorded into secondary command buffers on the worker threads.
+  static constexpr size_t kMinParallelEncodingDraws = 1024u;
+
+  /// The minimum number of draws recorded into each secondary command
+  /// buffer.
+  static constexpr size_t kMinDrawsPerSecondaryCommandBuffer = 256u;
+
   // |RenderPass|
   ~RenderPassVK() override;
 
  private:
   friend class CommandBufferVK;
 
+  /// The state of a draw recorded by a deferred pass.
+  struct DeferredDraw {
+    vk::Pipeline pipeline;
+    vk::PipelineLayout pipeline_layout;
+    vk::DescriptorSet descriptor_set;
+    /// The range of the descriptor writes of the draw in |deferred_writes_|.
+    size_t write_offset = 0u;
+    size_t write_count = 0u;
+    /// The range of the vertex buffers of the draw in
+    /// |deferred_vertex_buffers_|.
+    size_t vertex_buffer_offset = 0u;
+    size_t vertex_buffer_count = 0u;
+    vk::Buffer index_buffer;
+    vk::DeviceSize index_buffer_offset = 0u;
+    vk::IndexType index_type = vk::IndexType::eUint16;
+    bool has_index_buffer = false;
+    bool uses_input_attachments = false;
+    vk::Viewport viewport;
+    vk::Rect2D scissor;
+    uint32_t stencil_reference = 0u;
+    size_t element_count = 0u;
+    size_t instance_count = 1u;
+    size_t base_vertex = 0u;
+  };
+
   std::shared_ptr<CommandBufferVK> command_buffer_;
   std::string debug_label_;
   SharedHandleVK<vk::RenderPass> render_pass_;
   bool is_valid_ = false;
+  // Whether draws are recorded when the pass is encoded instead of as they
+  // are issued. See |Flags::parallel_render_pass_encoding|.
+  bool is_deferred_ = false;
 
   vk::CommandBuffer command_buffer_vk_;
   std::shared_ptr<Texture> color_image_vk_;
@@ -53,6 +91,27 @@ class RenderPassVK final : public RenderPass {
   bool pipeline_uses_input_attachments_ = false;
   std::shared_ptr<SamplerVK> immutable_sampler_;
 
+  // Deferred state. The render pass is only begun once the pass is encoded.
+  SharedHandleVK<vk::Framebuffer> framebuffer_;
+  std::array<vk::ClearValue, kMaxAttachments> clear_values_;
+  size_t clear_value_count_ = 0u;
+  vk::Viewport current_viewport_;
+  vk::Rect2D current_scissor_;
+  size_t current_vertex_buffer_offset_ = 0u;
+  size_t current_vertex_buffer_count_ = 0u;
+  vk::Buffer current_index_buffer_;
+  vk::DeviceSize current_index_buffer_offset_ = 0u;
+  vk::IndexType current_index_type_ = vk::IndexType::eUint16;
+  bool has_input_attachment_draws_ = false;
+  std::vector<DeferredDraw> deferred_draws_;
+  std::vector<vk::WriteDescriptorSet> deferred_writes_;
+  // The index of the image or buffer info of each of |deferred_writes_|.
+  std::vector<size_t> deferred_write_infos_;
+  std::vector<vk::DescriptorImageInfo> deferred_images_;
+  std::vector<vk::DescriptorBufferInfo> deferred_buffers_;
+  std::vector<vk::Buffer> deferred_vertex_buffers_;
+  std::vector<vk::DeviceSize> deferred_vertex_buffer_offsets_;
+
   RenderPassVK(const std::shared_ptr<const Context>& context,
                const RenderTarget& target,
                std::shared_ptr<CommandBufferVK> command_buffer);
@@ -142,6 +201,25 @@ class RenderPassVK final : public RenderPass {
       const ContextVK& context,
       const vk::RenderPass& pass) const;
 
+  void EncodeDraw(vk::DescriptorSet descriptor_set,
+                  const PipelineVK& pipeline_vk);
+
+  void DeferDraw(vk::DescriptorSet descriptor_set,
+                 const PipelineVK& pipeline_vk);
+
+  /// @brief  Records the deferred draws in [start, end) into |buffer|, which
+  ///         must be inside of this render pass.
+  void EncodeDeferredDraws(vk::CommandBuffer buffer,
+                           size_t start,
+                           size_t end) const;
+
+  /// @brief  Records the deferred draws into secondary command buffers on the
+  ///         worker threads of the context.
+  ///
+  /// @return The recorded command buffers, in order, or an empty vector if the
+  ///         draws should be recorded into the primary command buffer.
+  std::vector<vk::CommandBuffer> RecordSecondaryCommandBuffers() const;
+
   RenderPassVK(const RenderPassVK&) = delete;
 
   RenderPassVK& operator=(const RenderPassVK&) = delete;
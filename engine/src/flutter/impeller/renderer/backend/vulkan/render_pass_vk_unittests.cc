@@ -8,6 +8,7 @@
 #include "impeller/renderer/backend/vulkan/render_pass_builder_vk.h"
 #include "impeller/renderer/backend/vulkan/render_pass_vk.h"
 #include "impeller/renderer/backend/vulkan/test/mock_vulkan.h"
+#include "impeller/renderer/pipeline_library.h"
 #include "impeller/renderer/render_target.h"
 #include "vulkan/vulkan_enums.hpp"
 
@@ -49,5 +50,85 @@ TEST(RenderPassVK, DoesNotRedundantlySetStencil) {
             2);
 }
 
+namespace {
+
+size_t CountCalls(const std::shared_ptr<std::vector<std::string>>& functions,
+                  const std::string& name) {
+  return std::count(functions->begin(), functions->end(), name);
+}
+
+void RecordDraws(const std::shared_ptr<ContextVK>& context, size_t draw_count) {
+  PipelineDescriptor pipeline_desc;
+  pipeline_desc.SetVertexDescriptor(std::make_shared<VertexDescriptor>());
+  std::shared_ptr<Pipeline<PipelineDescriptor>> pipeline =
+      context->GetPipelineLibrary()->GetPipeline(pipeline_desc).Get();
+  ASSERT_TRUE(pipeline);
+
+  std::shared_ptr<Context> copy = context;
+  auto cmd_buffer = context->CreateCommandBuffer();
+  RenderTargetAllocator allocator(context->GetResourceAllocator());
+  RenderTarget target = allocator.CreateOffscreenMSAA(*copy.get(), {1, 1}, 1);
+  std::shared_ptr<RenderPass> render_pass =
+      cmd_buffer->CreateRenderPass(target);
+
+  for (size_t i = 0; i < draw_count; i++) {
+    render_pass->SetPipeline(pipeline);
+    render_pass->SetStencilReference(i % 2);
+    render_pass->SetElementCount(3);
+    ASSERT_TRUE(render_pass->Draw().ok());
+  }
+  ASSERT_TRUE(render_pass->EncodeCommands());
+}
+
+}  // namespace
+
+TEST(RenderPassVK, DefersSmallPassesIntoPrimaryCommandBuffer) {
+  std::shared_ptr<ContextVK> context =
+      MockVulkanContextBuilder()
+          .SetSettingsCallback([](ContextVK::Settings& settings) {
+            settings.flags.parallel_render_pass_encoding = true;
+          })
+          .Build();
+
+  RecordDraws(context, 16u);
+
+  auto called_functions = GetMockVulkanFunctions(context->GetDevice());
+  EXPECT_EQ(CountCalls(called_functions, "vkCmdBeginRenderPass"), 1u);
+  EXPECT_EQ(CountCalls(called_functions, "vkCmdExecuteCommands"), 0u);
+  EXPECT_EQ(CountCalls(called_functions, "vkCmdDraw"), 16u);
+  // The pipeline is only bound once and the stencil reference is only set
+  // when it changes.
+  EXPECT_EQ(CountCalls(called_functions, "vkCmdBindPipeline"), 1u);
+  EXPECT_EQ(CountCalls(called_functions, "vkCmdSetStencilReference"), 16u);
+}
+
+TEST(RenderPassVK, RecordsLargePassesIntoSecondaryCommandBuffers) {
+  std::shared_ptr<ContextVK> context =
+      MockVulkanContextBuilder()
+          .SetSettingsCallback([](ContextVK::Settings& settings) {
+            settings.flags.parallel_render_pass_encoding = true;
+          })
+          .Build();
+
+  size_t draw_count = RenderPassVK::kMinParallelEncodingDraws * 4u;
+  RecordDraws(context, draw_count);
+
+  auto called_functions = GetMockVulkanFunctions(context->GetDevice());
+  EXPECT_EQ(CountCalls(called_functions, "vkCmdBeginRenderPass"), 0u);
+  EXPECT_EQ(CountCalls(called_functions,
+                       "vkCmdBeginRenderPassSecondaryCommandBuffers"),
+            1u);
+  EXPECT_EQ(CountCalls(called_functions, "vkCmdExecuteCommands"), 1u);
+  EXPECT_EQ(CountCalls(called_functions, "vkCmdEndRenderPass"), 1u);
+  EXPECT_EQ(CountCalls(called_functions, "vkCmdDraw"), draw_count);
+
+  // Each secondary command buffer sets its own dynamic state.
+  size_t secondary_count = CountCalls(called_functions, "vkCmdSetViewport");
+  EXPECT_GE(secondary_count, 2u);
+  EXPECT_EQ(CountCalls(called_functions, "vkCmdSetScissor"), secondary_count);
+  EXPECT_EQ(CountCalls(called_functions, "vkCmdBindPipeline"),
+            secondary_count);
+}
+
 }  // namespace testing
 }  // namespace impeller
@@ -4,8 +4,13 @@
 
 #include "impeller/renderer/backend/vulkan/swapchain/surface_vk.h"
 
+#include "impeller/base/validation.h"
 #include "impeller/core/formats.h"
+#include "impeller/renderer/backend/vulkan/barrier_vk.h"
+#include "impeller/renderer/backend/vulkan/command_buffer_vk.h"
 #include "impeller/renderer/backend/vulkan/texture_vk.h"
+#include "impeller/renderer/blit_pass.h"
+#include "impeller/renderer/command_buffer.h"
 #include "impeller/renderer/surface.h"
 
 namespace impeller {
@@ -13,7 +18,8 @@ namespace impeller {
 std::unique_ptr<SurfaceVK> SurfaceVK::WrapSwapchainImage(
     const std::shared_ptr<SwapchainTransientsVK>& transients,
     const std::shared_ptr<TextureSourceVK>& swapchain_image,
-    SwapCallback swap_callback) {
+    SwapCallback swap_callback,
+    std::optional<IRect> clip_rect) {
   if (!transients || !swapchain_image || !swap_callback) {
     return nullptr;
   }
@@ -35,15 +41,28 @@ std::unique_ptr<SurfaceVK> SurfaceVK::WrapSwapchainImage(
   resolve_tex_desc.sample_count = SampleCount::kCount1;
   resolve_tex_desc.storage_mode = StorageMode::kDevicePrivate;
 
-  std::shared_ptr<Texture> resolve_tex =
+  std::shared_ptr<Texture> swapchain_tex =
       std::make_shared<TextureVK>(context,         //
                                   swapchain_image  //
       );
 
+  if (!swapchain_tex) {
+    return nullptr;
+  }
+  swapchain_tex->SetLabel("ImpellerOnscreenResolve");
+
+  // The resolve of the root pass covers the whole render target. To keep the
+  // undamaged contents of the swapchain image, resolve to an offscreen texture
+  // and only blit the clip rect to the swapchain image.
+  if (!ShouldPerformPartialRepaint(clip_rect) ||
+      clip_rect->Contains(IRect::MakeSize(swapchain_tex_desc.size))) {
+    clip_rect = std::nullopt;
+  }
+  std::shared_ptr<Texture> resolve_tex =
+      clip_rect.has_value() ? transients->GetResolveTexture() : swapchain_tex;
   if (!resolve_tex) {
     return nullptr;
   }
-  resolve_tex->SetLabel("ImpellerOnscreenResolve");
 
   ColorAttachment color0;
   color0.clear_color = Color::DarkSlateGray();
@@ -72,15 +91,87 @@ std::unique_ptr<SurfaceVK> SurfaceVK::WrapSwapchainImage(
 
   // The constructor is private. So make_unique may not be used.
   return std::unique_ptr<SurfaceVK>(
-      new SurfaceVK(render_target_desc, std::move(swap_callback)));
+      new SurfaceVK(render_target_desc, context, std::move(resolve_tex),
+                    std::move(swapchain_tex), std::move(swap_callback),
+                    clip_rect));
 }
 
-SurfaceVK::SurfaceVK(const RenderTarget& target, SwapCallback swap_callback)
-    : Surface(target), swap_callback_(std::move(swap_callback)) {}
+SurfaceVK::SurfaceVK(const RenderTarget& target,
+                     std::weak_ptr<Context> context,
+                     std::shared_ptr<Texture> resolve_texture,
+                     std::shared_ptr<Texture> swapchain_texture,
+                     SwapCallback swap_callback,
+                     std::optional<IRect> clip_rect)
+    : Surface(target),
+      context_(std::move(context)),
+      resolve_texture_(std::move(resolve_texture)),
+      swapchain_texture_(std::move(swapchain_texture)),
+      swap_callback_(std::move(swap_callback)),
+      clip_rect_(clip_rect) {}
 
 SurfaceVK::~SurfaceVK() = default;
 
+bool SurfaceVK::ShouldPerformPartialRepaint(std::optional<IRect> damage_rect) {
+  // compositor_context.cc disables partial repaint if the damage region is
+  // large, in which case a nullopt damage rect is provided here. An empty
+  // damage rect leaves the swapchain image as it is, so there is nothing to
+  // blit either.
+  return damage_rect.has_value() && !damage_rect->IsEmpty();
+}
+
+bool SurfaceVK::PreparePresent() const {
+  if (prepared_) {
+    return true;
+  }
+  prepared_ = true;
+  if (!clip_rect_.has_value()) {
+    return true;
+  }
+
+  auto context = context_.lock();
+  if (!context) {
+    return false;
+  }
+  auto blit_command_buffer = context->CreateCommandBuffer();
+  if (!blit_command_buffer) {
+    return false;
+  }
+  blit_command_buffer->SetLabel("SurfaceVK PartialRepaintBlit");
+  auto blit_pass = blit_command_buffer->CreateBlitPass();
+  if (!blit_pass) {
+    return false;
+  }
+  if (!blit_pass->AddCopy(resolve_texture_, swapchain_texture_, clip_rect_,
+                          clip_rect_->GetOrigin())) {
+    VALIDATION_LOG << "Could not blit the damaged region to the swapchain.";
+    return false;
+  }
+  if (!blit_pass->EncodeCommands()) {
+    return false;
+  }
+
+  // The copy leaves swapchain images in the transfer destination layout.
+  // Transition it to the layout the root pass leaves it in when it renders to
+  // the swapchain image directly, so that the owner of the surface finds the
+  // image in the same layout either way.
+  BarrierVK barrier;
+  barrier.cmd_buffer =
+      CommandBufferVK::Cast(*blit_command_buffer).GetCommandBuffer();
+  barrier.new_layout = vk::ImageLayout::eGeneral;
+  barrier.src_access = vk::AccessFlagBits::eTransferWrite;
+  barrier.src_stage = vk::PipelineStageFlagBits::eTransfer;
+  barrier.dst_access = vk::AccessFlagBits::eColorAttachmentWrite;
+  barrier.dst_stage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+  if (!TextureVK::Cast(*swapchain_texture_).SetLayout(barrier)) {
+    return false;
+  }
+  return context->GetCommandQueue()->Submit({blit_command_buffer}).ok();
+}
+
 bool SurfaceVK::Present() const {
+  if (!PreparePresent()) {
+    return false;
+  }
   return swap_callback_ ? swap_callback_() : false;
 }
 
@@ -6,6 +6,7 @@
 #define FLUTTER_IMPELLER_RENDERER_BACKEND_VULKAN_SWAPCHAIN_SURFACE_VK_H_
 
 #include <memory>
+#include <optional>
 
 #include "impeller/renderer/backend/vulkan/context_vk.h"
 #include "impeller/renderer/backend/vulkan/swapchain/swapchain_transients_vk.h"
@@ -23,18 +24,49 @@ class SurfaceVK final : public Surface {
   ///        target by Impeller.
   ///
   ///        This creates the associated MSAA and depth+stencil texture.
+  ///
+  ///        If a non-empty |clip_rect| is provided, only that region of the
+  ///        swapchain image is updated and the rest of its contents are
+  ///        preserved. The root pass then renders to an offscreen texture and
+  ///        the clip rect is blitted to the swapchain image by
+  ///        |PreparePresent|.
   static std::unique_ptr<SurfaceVK> WrapSwapchainImage(
       const std::shared_ptr<SwapchainTransientsVK>& transients,
       const std::shared_ptr<TextureSourceVK>& swapchain_image,
-      SwapCallback swap_callback);
+      SwapCallback swap_callback,
+      std::optional<IRect> clip_rect = std::nullopt);
 
   // |Surface|
   ~SurfaceVK() override;
 
+  /// @brief Whether a partial repaint of |damage_rect| requires rendering to
+  ///        an offscreen texture first.
+  static bool ShouldPerformPartialRepaint(std::optional<IRect> damage_rect);
+
+  /// @brief Perform the blit of the clip rect to the swapchain image, if one
+  ///        is required. This is called by |Present|, but must be called
+  ///        explicitly when the swapchain image is presented by the owner of
+  ///        the surface instead.
+  ///
+  ///        Once rendered, the swapchain image is in
+  ///        `vk::ImageLayout::eGeneral` whether or not a blit was performed,
+  ///        and its tracked layout says so.
+  bool PreparePresent() const;
+
  private:
+  std::weak_ptr<Context> context_;
+  std::shared_ptr<Texture> resolve_texture_;
+  std::shared_ptr<Texture> swapchain_texture_;
   SwapCallback swap_callback_;
+  std::optional<IRect> clip_rect_;
+  mutable bool prepared_ = false;
 
-  SurfaceVK(const RenderTarget& target, SwapCallback swap_callback);
+  SurfaceVK(const RenderTarget& target,
+            std::weak_ptr<Context> context,
+            std::shared_ptr<Texture> resolve_texture,
+            std::shared_ptr<Texture> swapchain_texture,
+            SwapCallback swap_callback,
+            std::optional<IRect> clip_rect);
 
   // |Surface|
   bool Present() const override;
@@ -32,6 +32,14 @@ SwapchainTransientsVK::GetDepthStencilTexture() {
   return cached_depth_stencil_;
 }
 
+const std::shared_ptr<Texture>& SwapchainTransientsVK::GetResolveTexture() {
+  if (cached_resolve_texture_) {
+    return cached_resolve_texture_;
+  }
+  cached_resolve_texture_ = CreateResolveTexture();
+  return cached_resolve_texture_;
+}
+
 std::shared_ptr<Texture> SwapchainTransientsVK::CreateMSAATexture() const {
   TRACE_EVENT0("impeller", __FUNCTION__);
   if (!enable_msaa_) {
@@ -87,6 +95,28 @@ std::shared_ptr<Texture> SwapchainTransientsVK::CreateDepthStencilTexture()
   return texture;
 }
 
+std::shared_ptr<Texture> SwapchainTransientsVK::CreateResolveTexture() const {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  TextureDescriptor resolve_desc;
+  resolve_desc.storage_mode = StorageMode::kDevicePrivate;
+  resolve_desc.type = TextureType::kTexture2D;
+  resolve_desc.sample_count = SampleCount::kCount1;
+  resolve_desc.format = desc_.format;
+  resolve_desc.size = desc_.size;
+  resolve_desc.usage = TextureUsage::kRenderTarget;
+
+  auto context = context_.lock();
+  if (!context) {
+    return nullptr;
+  }
+  auto texture = context->GetResourceAllocator()->CreateTexture(resolve_desc);
+  if (!texture) {
+    return nullptr;
+  }
+  texture->SetLabel("SwapchainResolve");
+  return texture;
+}
+
 bool SwapchainTransientsVK::IsMSAAEnabled() const {
   return enable_msaa_;
 }
@@ -16,7 +16,8 @@ namespace impeller {
 ///             wrapped swapchain images, that are intuitively cheap to create
 ///             but have been observed to be time consuming to construct on some
 ///             Vulkan drivers. This includes the device-transient MSAA and
-///             depth-stencil textures.
+///             depth-stencil textures, as well as the offscreen resolve
+///             texture used for partial repaint.
 ///
 ///             The same textures are used for all swapchain images.
 ///
@@ -40,16 +41,25 @@ class SwapchainTransientsVK {
 
   const std::shared_ptr<Texture>& GetDepthStencilTexture();
 
+  /// @brief  A single sample texture the size of the swapchain images that
+  ///         the root pass resolves to when only part of a swapchain image is
+  ///         redrawn. The damaged region is then blitted to the swapchain
+  ///         image, which keeps the rest of its contents.
+  const std::shared_ptr<Texture>& GetResolveTexture();
+
  private:
   std::weak_ptr<Context> context_;
   const TextureDescriptor desc_;
   const bool enable_msaa_;
   std::shared_ptr<Texture> cached_msaa_texture_;
   std::shared_ptr<Texture> cached_depth_stencil_;
+  std::shared_ptr<Texture> cached_resolve_texture_;
 
   std::shared_ptr<Texture> CreateMSAATexture() const;
 
   std::shared_ptr<Texture> CreateDepthStencilTexture() const;
+
+  std::shared_ptr<Texture> CreateResolveTexture() const;
 };
 
 }  // namespace impeller
@@ -20,11 +20,16 @@ namespace testing {
 
 namespace {
 
+class MockDevice;
+
 struct MockCommandBuffer {
-  explicit MockCommandBuffer(
-      std::shared_ptr<std::vector<std::string>> called_functions)
-      : called_functions_(std::move(called_functions)) {}
-  std::shared_ptr<std::vector<std::string>> called_functions_;
+  explicit MockCommandBuffer(MockDevice* device) : device_(device) {}
+
+  // Command buffers may be recorded on several threads at once, so the calls
+  // are recorded by the device.
+  void AddCalledFunction(const std::string& function);
+
+  MockDevice* device_;
   std::vector<VkImageMemoryBarrier> image_memory_barriers_;
 };
 
@@ -54,7 +59,7 @@ class MockDevice final {
   explicit MockDevice() : called_functions_(new std::vector<std::string>()) {}
 
   MockCommandBuffer* NewCommandBuffer() {
-    auto buffer = std::make_unique<MockCommandBuffer>(called_functions_);
+    auto buffer = std::make_unique<MockCommandBuffer>(this);
     MockCommandBuffer* result = buffer.get();
     Lock lock(command_buffers_mutex_);
     command_buffers_.emplace_back(std::move(buffer));
@@ -107,6 +112,10 @@ class MockDevice final {
       IPLR_GUARDED_BY(commmand_pools_mutex_);
 };
 
+void MockCommandBuffer::AddCalledFunction(const std::string& function) {
+  device_->AddCalledFunction(function);
+}
+
 struct MockVulkanState {
   std::vector<std::string> instance_extensions;
   std::vector<std::string> instance_layers;
@@ -521,7 +530,7 @@ void vkCmdBindPipeline(VkCommandBuffer commandBuffer,
                        VkPipeline pipeline) {
   MockCommandBuffer* mock_command_buffer =
       reinterpret_cast<MockCommandBuffer*>(commandBuffer);
-  mock_command_buffer->called_functions_->push_back("vkCmdBindPipeline");
+  mock_command_buffer->AddCalledFunction("vkCmdBindPipeline");
 }
 
 void vkCmdPipelineBarrier(VkCommandBuffer commandBuffer,
@@ -536,7 +545,7 @@ void vkCmdPipelineBarrier(VkCommandBuffer commandBuffer,
                           const VkImageMemoryBarrier* pImageMemoryBarriers) {
   MockCommandBuffer* mock_command_buffer =
       reinterpret_cast<MockCommandBuffer*>(commandBuffer);
-  mock_command_buffer->called_functions_->push_back("vkCmdPipelineBarrier");
+  mock_command_buffer->AddCalledFunction("vkCmdPipelineBarrier");
   if (pImageMemoryBarriers) {
     for (uint32_t i = 0; i < imageMemoryBarrierCount; ++i) {
       mock_command_buffer->image_memory_barriers_.push_back(
@@ -550,7 +559,7 @@ void vkCmdSetStencilReference(VkCommandBuffer commandBuffer,
                               uint32_t reference) {
   MockCommandBuffer* mock_command_buffer =
       reinterpret_cast<MockCommandBuffer*>(commandBuffer);
-  mock_command_buffer->called_functions_->push_back("vkCmdSetStencilReference");
+  mock_command_buffer->AddCalledFunction("vkCmdSetStencilReference");
 }
 
 void vkCmdSetScissor(VkCommandBuffer commandBuffer,
@@ -559,7 +568,19 @@ void vkCmdSetScissor(VkCommandBuffer commandBuffer,
                      const VkRect2D* pScissors) {
   MockCommandBuffer* mock_command_buffer =
       reinterpret_cast<MockCommandBuffer*>(commandBuffer);
-  mock_command_buffer->called_functions_->push_back("vkCmdSetScissor");
+  mock_command_buffer->AddCalledFunction("vkCmdSetScissor");
+}
+
+void vkCmdCopyImage(VkCommandBuffer commandBuffer,
+                    VkImage srcImage,
+                    VkImageLayout srcImageLayout,
+                    VkImage dstImage,
+                    VkImageLayout dstImageLayout,
+                    uint32_t regionCount,
+                    const VkImageCopy* pRegions) {
+  MockCommandBuffer* mock_command_buffer =
+      reinterpret_cast<MockCommandBuffer*>(commandBuffer);
+  mock_command_buffer->AddCalledFunction("vkCmdCopyImage");
 }
 
 void vkCmdSetViewport(VkCommandBuffer commandBuffer,
@@ -568,7 +589,44 @@ void vkCmdSetViewport(VkCommandBuffer commandBuffer,
                       const VkViewport* pViewports) {
   MockCommandBuffer* mock_command_buffer =
       reinterpret_cast<MockCommandBuffer*>(commandBuffer);
-  mock_command_buffer->called_functions_->push_back("vkCmdSetViewport");
+  mock_command_buffer->AddCalledFunction("vkCmdSetViewport");
+}
+
+void vkCmdBeginRenderPass(VkCommandBuffer commandBuffer,
+                          const VkRenderPassBeginInfo* pRenderPassBegin,
+                          VkSubpassContents contents) {
+  MockCommandBuffer* mock_command_buffer =
+      reinterpret_cast<MockCommandBuffer*>(commandBuffer);
+  if (contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS) {
+    mock_command_buffer->AddCalledFunction(
+        "vkCmdBeginRenderPassSecondaryCommandBuffers");
+  } else {
+    mock_command_buffer->AddCalledFunction("vkCmdBeginRenderPass");
+  }
+}
+
+void vkCmdEndRenderPass(VkCommandBuffer commandBuffer) {
+  MockCommandBuffer* mock_command_buffer =
+      reinterpret_cast<MockCommandBuffer*>(commandBuffer);
+  mock_command_buffer->AddCalledFunction("vkCmdEndRenderPass");
+}
+
+void vkCmdExecuteCommands(VkCommandBuffer commandBuffer,
+                          uint32_t commandBufferCount,
+                          const VkCommandBuffer* pCommandBuffers) {
+  MockCommandBuffer* mock_command_buffer =
+      reinterpret_cast<MockCommandBuffer*>(commandBuffer);
+  mock_command_buffer->AddCalledFunction("vkCmdExecuteCommands");
+}
+
+void vkCmdDraw(VkCommandBuffer commandBuffer,
+               uint32_t vertexCount,
+               uint32_t instanceCount,
+               uint32_t firstVertex,
+               uint32_t firstInstance) {
+  MockCommandBuffer* mock_command_buffer =
+      reinterpret_cast<MockCommandBuffer*>(commandBuffer);
+  mock_command_buffer->AddCalledFunction("vkCmdDraw");
 }
 
 void vkFreeCommandBuffers(VkDevice device,
@@ -976,8 +1034,18 @@ PFN_vkVoidFunction GetMockVulkanProcAddress(VkInstance instance,
     return reinterpret_cast<PFN_vkVoidFunction>(vkCmdSetStencilReference);
   } else if (strcmp("vkCmdSetScissor", pName) == 0) {
     return reinterpret_cast<PFN_vkVoidFunction>(vkCmdSetScissor);
+  } else if (strcmp("vkCmdCopyImage", pName) == 0) {
+    return reinterpret_cast<PFN_vkVoidFunction>(vkCmdCopyImage);
   } else if (strcmp("vkCmdSetViewport", pName) == 0) {
     return reinterpret_cast<PFN_vkVoidFunction>(vkCmdSetViewport);
+  } else if (strcmp("vkCmdBeginRenderPass", pName) == 0) {
+    return reinterpret_cast<PFN_vkVoidFunction>(vkCmdBeginRenderPass);
+  } else if (strcmp("vkCmdEndRenderPass", pName) == 0) {
+    return reinterpret_cast<PFN_vkVoidFunction>(vkCmdEndRenderPass);
+  } else if (strcmp("vkCmdExecuteCommands", pName) == 0) {
+    return reinterpret_cast<PFN_vkVoidFunction>(vkCmdExecuteCommands);
+  } else if (strcmp("vkCmdDraw", pName) == 0) {
+    return reinterpret_cast<PFN_vkVoidFunction>(vkCmdDraw);
   } else if (strcmp("vkDestroyCommandPool", pName) == 0) {
     return reinterpret_cast<PFN_vkVoidFunction>(vkDestroyCommandPool);
   } else if (strcmp("vkFreeCommandBuffers", pName) == 0) {
@@ -2,10 +2,15 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
 #include "flutter/testing/testing.h"  // IWYU pragma: keep
 #include "gtest/gtest.h"
 #include "impeller/core/formats.h"
+#include "impeller/renderer/backend/vulkan/swapchain/khr/khr_swapchain_image_vk.h"
 #include "impeller/renderer/backend/vulkan/swapchain/khr/khr_swapchain_vk.h"
+#include "impeller/renderer/backend/vulkan/swapchain/surface_vk.h"
+#include "impeller/renderer/backend/vulkan/swapchain/swapchain_transients_vk.h"
 #include "impeller/renderer/backend/vulkan/test/mock_vulkan.h"
 #include "impeller/renderer/backend/vulkan/texture_vk.h"
 #include "impeller/renderer/render_pass.h"
@@ -163,5 +168,65 @@ TEST(SwapchainTest, NoFenceWaitAfterAcquireNextImageFailure) {
   EXPECT_FALSE(wait_for_fences_called);
 }
 
+TEST(SwapchainTest, PartialRepaintBlitsClipRectToSwapchainImage) {
+  auto const context = MockVulkanContextBuilder().Build();
+
+  TextureDescriptor desc;
+  desc.format = PixelFormat::kB8G8R8A8UNormInt;
+  desc.size = ISize{100, 100};
+  desc.usage = TextureUsage::kRenderTarget;
+  desc.storage_mode = StorageMode::kDevicePrivate;
+  auto transients = std::make_shared<SwapchainTransientsVK>(
+      context, desc, /*enable_msaa=*/false);
+
+  // Back the swapchain image with the image of an ordinary texture.
+  auto image_texture = context->GetResourceAllocator()->CreateTexture(desc);
+  ASSERT_TRUE(image_texture);
+  vk::Image image = TextureVK::Cast(*image_texture).GetImage();
+  auto swapchain_image =
+      std::make_shared<KHRSwapchainImageVK>(desc, context->GetDevice(), image);
+  ASSERT_TRUE(swapchain_image->IsValid());
+
+  auto count_copies = [&context]() {
+    auto functions = GetMockVulkanFunctions(context->GetDevice());
+    return std::count(functions->begin(), functions->end(), "vkCmdCopyImage");
+  };
+  auto render_target_image = [](const Surface& surface) {
+    return TextureVK::Cast(
+               *surface.GetRenderTarget().GetColorAttachment(0).texture)
+        .GetImage();
+  };
+
+  // Without a clip rect, the root pass renders to the swapchain image.
+  std::unique_ptr<Surface> surface = SurfaceVK::WrapSwapchainImage(
+      transients, swapchain_image, []() { return true; });
+  ASSERT_TRUE(surface);
+  EXPECT_EQ(render_target_image(*surface), image);
+  ASSERT_TRUE(surface->Present());
+  EXPECT_EQ(count_copies(), 0);
+
+  // A clip rect covering the whole image is not a partial repaint.
+  surface = SurfaceVK::WrapSwapchainImage(
+      transients, swapchain_image, []() { return true; },
+      IRect::MakeWH(100, 100));
+  ASSERT_TRUE(surface);
+  EXPECT_EQ(render_target_image(*surface), image);
+
+  // With a clip rect, the root pass renders to an offscreen texture, and only
+  // the clip rect is blitted to the swapchain image when it is presented.
+  surface = SurfaceVK::WrapSwapchainImage(
+      transients, swapchain_image, []() { return true; },
+      IRect::MakeLTRB(10, 10, 20, 20));
+  ASSERT_TRUE(surface);
+  EXPECT_NE(render_target_image(*surface), image);
+  EXPECT_EQ(surface->GetRenderTarget().GetColorAttachment(0).texture,
+            transients->GetResolveTexture());
+  EXPECT_EQ(count_copies(), 0);
+  ASSERT_TRUE(surface->Present());
+  EXPECT_EQ(count_copies(), 1);
+  // The copy leaves the image in the layout a full root pass leaves it in.
+  EXPECT_EQ(swapchain_image->GetLayout(), vk::ImageLayout::eGeneral);
+}
+
 }  // namespace testing
 }  // namespace impeller
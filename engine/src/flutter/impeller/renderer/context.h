@@ -9,6 +9,7 @@
 #include <memory>
 #include <string>
 
+#include "flutter/fml/concurrent_message_loop.h"
 #include "fml/closure.h"
 #include "impeller/base/flags.h"
 #include "impeller/base/thread_safety.h"
@@ -249,6 +250,16 @@ class Context {
 
   virtual std::shared_ptr<const IdleWaiter> GetIdleWaiter() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief Returns a task runner for the pool of worker threads owned by
+  ///        this context, or nullptr if the backend does not have one.
+  ///
+  /// Tasks posted to this runner may run concurrently with the raster thread
+  /// and with each other, so they must only perform CPU work that does not
+  /// touch the GPU or any other state owned by the context.
+  virtual std::shared_ptr<fml::ConcurrentTaskRunner>
+  GetConcurrentWorkerTaskRunner() const;
+
   //----------------------------------------------------------------------------
   /// Resets any thread local state that may interfere with embedders.
   ///
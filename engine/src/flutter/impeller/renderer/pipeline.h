@@ -145,6 +145,9 @@ class GenericRenderPipelineHandle {
     return pipeline_future_.descriptor;
   }
 
+  /// Whether the pipeline has been requested through |WaitAndGet|.
+  bool WasWaitedOn() const { return did_wait_; }
+
  private:
   PipelineFuture<PipelineDescriptor> pipeline_future_;
   std::shared_ptr<Pipeline<PipelineDescriptor>> pipeline_;
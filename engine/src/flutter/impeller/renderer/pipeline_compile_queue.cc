@@ -41,16 +41,20 @@ bool PipelineCompileQueue::PostJobForDescriptor(const PipelineDescriptor& desc,
                         "Running eagerly.";
       // Don't invoke the job here has there are we have currently acquired a
       // mutex.
-      worker_task_runner_->PostTask(job);
+      worker_task_runner_->PostTask(job, fml::ConcurrentTaskPriority::kHigh);
       return true;
     }
   }
 
-  worker_task_runner_->PostTask([weak_queue = weak_from_this()]() {
-    if (auto queue = weak_queue.lock()) {
-      queue->DoOneJob();
-    }
-  });
+  // Frames block on pipelines that are still compiling, so compile jobs go
+  // ahead of other background work such as image decoding.
+  worker_task_runner_->PostTask(
+      [weak_queue = weak_from_this()]() {
+        if (auto queue = weak_queue.lock()) {
+          queue->DoOneJob();
+        }
+      },
+      fml::ConcurrentTaskPriority::kHigh);
   return true;
 }
 
@@ -0,0 +1,485 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/tessellator/tessellation_cache.h"
+
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/logging.h"
+
+namespace impeller {
+
+namespace {
+
+static constexpr const char* kTessellationCacheFileName =
+    "flutter.impeller.tesscache";
+
+// Bump the version whenever the layout of the file changes. Files written by
+// a different engine are ignored as well, since its tessellator may produce
+// different vertices.
+static constexpr uint32_t kFileMagic = 0x54455353;  // 'TESS'
+static constexpr uint32_t kFileVersion = 2u;
+
+#ifdef IMPELLER_ENGINE_CONTENT_HASH
+static constexpr const char* kEngineContentHash = IMPELLER_ENGINE_CONTENT_HASH;
+#else
+static constexpr const char* kEngineContentHash = "";
+#endif  // IMPELLER_ENGINE_CONTENT_HASH
+
+// The range of scale buckets that are cached, 2^-16 to 2^16.
+static constexpr int32_t kMaxScaleBucket =
+    16 * TessellationCache::kScaleBucketsPerOctave;
+
+struct FileHeader {
+  uint32_t magic = kFileMagic;
+  uint32_t version = kFileVersion;
+  uint32_t entry_count = 0u;
+  uint32_t reserved = 0u;
+  uint64_t engine_hash = 0u;
+};
+
+static_assert(sizeof(FileHeader) == 24u);
+
+struct EntryHeader {
+  uint64_t path_hash = 0u;
+  int32_t scale_bucket = 0;
+  uint8_t fill_type = 0u;
+  uint8_t flags = 0u;
+  uint16_t reserved = 0u;
+  uint32_t point_count = 0u;
+  uint32_t index_bytes = 0u;
+  uint32_t vertex_count = 0u;
+  uint32_t path_bytes = 0u;
+};
+
+static_assert(sizeof(EntryHeader) == 32u);
+
+enum EntryFlags : uint8_t {
+  kPrimitiveRestart = 1 << 0,
+  kTriangleFan = 1 << 1,
+  k32BitIndices = 1 << 2,
+};
+
+// Every block of the file starts at a multiple of 4 bytes so that the mapped
+// points and indices are suitably aligned.
+template <typename T>
+T AlignTo4(T size) {
+  return (size + 3u) & ~static_cast<T>(3u);
+}
+
+static constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ull;
+static constexpr uint64_t kFnvPrime = 0x100000001b3ull;
+
+// Computes a 64-bit FNV-1a hash. Unlike std::hash, the result is stable
+// across processes so that it can be persisted.
+uint64_t HashBytes(const uint8_t* bytes, size_t length) {
+  uint64_t hash = kFnvOffsetBasis;
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ bytes[i]) * kFnvPrime;
+  }
+  return hash;
+}
+
+uint64_t GetEngineHash() {
+  return HashBytes(reinterpret_cast<const uint8_t*>(kEngineContentHash),
+                   std::strlen(kEngineContentHash));
+}
+
+// Encodes the segments of a path into bytes that identify it.
+class PathEncoder : public PathReceiver {
+ public:
+  std::vector<uint8_t> TakeData() { return std::move(data_); }
+
+  bool HasCurves() const { return has_curves_; }
+
+  void MoveTo(const Point& p2, bool will_be_closed) override {
+    Add(will_be_closed ? 'M' : 'm');
+    Add(p2);
+  }
+
+  void LineTo(const Point& p2) override {
+    Add('L');
+    Add(p2);
+  }
+
+  void QuadTo(const Point& cp, const Point& p2) override {
+    has_curves_ = true;
+    Add('Q');
+    Add(cp);
+    Add(p2);
+  }
+
+  bool ConicTo(const Point& cp, const Point& p2, Scalar weight) override {
+    has_curves_ = true;
+    Add('K');
+    Add(cp);
+    Add(p2);
+    AddBytes(&weight, sizeof(weight));
+    return true;
+  }
+
+  void CubicTo(const Point& cp1, const Point& cp2, const Point& p2) override {
+    has_curves_ = true;
+    Add('C');
+    Add(cp1);
+    Add(cp2);
+    Add(p2);
+  }
+
+  void Close() override { Add('Z'); }
+
+ private:
+  std::vector<uint8_t> data_;
+  bool has_curves_ = false;
+
+  void Add(char verb) { AddBytes(&verb, sizeof(verb)); }
+
+  void Add(const Point& point) {
+    AddBytes(&point.x, sizeof(point.x));
+    AddBytes(&point.y, sizeof(point.y));
+  }
+
+  void AddBytes(const void* data, size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    data_.insert(data_.end(), bytes, bytes + length);
+  }
+};
+
+}  // namespace
+
+bool TessellationCache::Key::operator==(const Key& other) const {
+  if (path_hash != other.path_hash || scale_bucket != other.scale_bucket ||
+      fill_type != other.fill_type ||
+      supports_primitive_restart != other.supports_primitive_restart ||
+      supports_triangle_fan != other.supports_triangle_fan ||
+      uses_32bit_indices != other.uses_32bit_indices) {
+    return false;
+  }
+  if (path_data == other.path_data) {
+    return true;
+  }
+  return path_data && other.path_data && *path_data == *other.path_data;
+}
+
+std::size_t TessellationCache::Key::Hash::operator()(const Key& key) const {
+  return fml::HashCombine(key.path_hash, key.scale_bucket,
+                          static_cast<int>(key.fill_type),
+                          key.supports_primitive_restart,
+                          key.supports_triangle_fan, key.uses_32bit_indices);
+}
+
+// static
+std::optional<TessellationCache::Key> TessellationCache::ComputeKey(
+    const PathSource& path,
+    Scalar scale,
+    bool supports_primitive_restart,
+    bool supports_triangle_fan,
+    bool uses_32bit_indices) {
+  if (!std::isfinite(scale) || scale <= 0.0f) {
+    return std::nullopt;
+  }
+  double bucket = std::ceil(std::log2(scale) * kScaleBucketsPerOctave);
+  if (bucket < -kMaxScaleBucket || bucket > kMaxScaleBucket) {
+    return std::nullopt;
+  }
+
+  PathEncoder encoder;
+  path.Dispatch(encoder);
+  if (!encoder.HasCurves()) {
+    return std::nullopt;
+  }
+  auto path_data =
+      std::make_shared<const std::vector<uint8_t>>(encoder.TakeData());
+
+  return Key{
+      .path_hash = HashBytes(path_data->data(), path_data->size()),
+      .path_data = std::move(path_data),
+      .scale_bucket = static_cast<int32_t>(bucket),
+      .fill_type = path.GetFillType(),
+      .supports_primitive_restart = supports_primitive_restart,
+      .supports_triangle_fan = supports_triangle_fan,
+      .uses_32bit_indices = uses_32bit_indices,
+  };
+}
+
+// static
+Scalar TessellationCache::GetBucketScale(int32_t scale_bucket) {
+  return std::exp2(static_cast<Scalar>(scale_bucket) / kScaleBucketsPerOctave);
+}
+
+TessellationCache::TessellationCache(size_t max_bytes,
+                                     fml::UniqueFD cache_directory)
+    : max_bytes_(max_bytes), cache_directory_(std::move(cache_directory)) {
+  LoadPersistedEntries();
+}
+
+TessellationCache::~TessellationCache() = default;
+
+std::optional<TessellationCache::Vertices> TessellationCache::Find(
+    const Key& key) {
+  auto found = index_.find(key);
+  if (found == index_.end()) {
+    stats_.misses++;
+    return std::nullopt;
+  }
+  stats_.hits++;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->vertices;
+}
+
+bool TessellationCache::CanInsert(
+    const Key& key,
+    const Tessellator::ConvexVertices& vertices) const {
+  return GetEntrySize(GetPathBytes(key), vertices.points.size(),
+                      vertices.indices.size()) <= max_bytes_ / 4u;
+}
+
+TessellationCache::Vertices TessellationCache::Insert(
+    const Key& key,
+    Tessellator::ConvexVertices vertices) {
+  FML_DCHECK(CanInsert(key, vertices));
+  const size_t size = GetEntrySize(GetPathBytes(key), vertices.points.size(),
+                                   vertices.indices.size());
+
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    RemoveEntry(found->second);
+  }
+  EvictToFit(size);
+
+  Entry& entry = entries_.emplace_front();
+  entry.key = key;
+  entry.storage = std::move(vertices);
+  entry.vertices = Vertices{
+      .points = entry.storage.points.data(),
+      .point_count = entry.storage.points.size(),
+      .indices = entry.storage.indices.data(),
+      .index_bytes = entry.storage.indices.size(),
+      .vertex_count = entry.storage.vertex_count,
+  };
+  index_[key] = entries_.begin();
+  bytes_used_ += size;
+  dirty_ = true;
+  return entry.vertices;
+}
+
+void TessellationCache::EvictToFit(size_t bytes) {
+  while (!entries_.empty() && bytes_used_ + bytes > max_bytes_) {
+    RemoveEntry(std::prev(entries_.end()));
+  }
+}
+
+void TessellationCache::RemoveEntry(std::list<Entry>::iterator entry) {
+  bytes_used_ -=
+      GetEntrySize(GetPathBytes(entry->key), entry->vertices.point_count,
+                   entry->vertices.index_bytes);
+  if (entry->mapped && --mapped_entry_count_ == 0u) {
+    // No entry points into the persisted file any more.
+    mapping_.reset();
+  }
+  index_.erase(entry->key);
+  entries_.erase(entry);
+}
+
+// static
+size_t TessellationCache::GetEntrySize(size_t path_bytes,
+                                       size_t point_count,
+                                       size_t index_bytes) {
+  return sizeof(EntryHeader) + AlignTo4(path_bytes) +
+         sizeof(Point) * point_count + AlignTo4(index_bytes);
+}
+
+// static
+size_t TessellationCache::GetPathBytes(const Key& key) {
+  return key.path_data ? key.path_data->size() : 0u;
+}
+
+void TessellationCache::LoadPersistedEntries() {
+  if (!cache_directory_.is_valid()) {
+    return;
+  }
+  std::shared_ptr<fml::FileMapping> mapping = fml::FileMapping::CreateReadOnly(
+      cache_directory_, kTessellationCacheFileName);
+  if (!mapping || mapping->GetSize() < sizeof(FileHeader)) {
+    return;
+  }
+
+  const uint8_t* data = mapping->GetMapping();
+  const size_t size = mapping->GetSize();
+  FileHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != kFileMagic || header.version != kFileVersion ||
+      header.engine_hash != GetEngineHash()) {
+    FML_LOG(INFO) << "Ignoring tessellation cache of a different version.";
+    return;
+  }
+
+  std::vector<Entry> loaded;
+  size_t offset = sizeof(FileHeader);
+  size_t bytes = 0u;
+  for (uint32_t i = 0; i < header.entry_count; i++) {
+    EntryHeader entry_header;
+    if (size - offset < sizeof(entry_header)) {
+      break;
+    }
+    std::memcpy(&entry_header, data + offset, sizeof(entry_header));
+    // The counts come from the file, so the sizes are computed in 64 bits
+    // where products of 32-bit counts cannot wrap, and compared to the size
+    // of the rest of the file before they are narrowed.
+    const uint64_t index_size =
+        entry_header.flags & k32BitIndices ? sizeof(uint32_t)
+                                           : sizeof(uint16_t);
+    const uint64_t entry_size_64 =
+        sizeof(EntryHeader) + AlignTo4<uint64_t>(entry_header.path_bytes) +
+        sizeof(Point) * static_cast<uint64_t>(entry_header.point_count) +
+        AlignTo4<uint64_t>(entry_header.index_bytes);
+    if (entry_size_64 > size - offset ||
+        entry_header.index_bytes !=
+            entry_header.vertex_count * static_cast<uint64_t>(index_size) ||
+        entry_header.fill_type > static_cast<uint8_t>(FillType::kOdd) ||
+        entry_header.path_bytes == 0u ||
+        bytes + entry_size_64 > max_bytes_) {
+      break;
+    }
+    const size_t points_size = sizeof(Point) * entry_header.point_count;
+    const size_t entry_size = static_cast<size_t>(entry_size_64);
+    const uint8_t* path_data = data + offset + sizeof(EntryHeader);
+    auto path = std::make_shared<const std::vector<uint8_t>>(
+        path_data, path_data + entry_header.path_bytes);
+    if (HashBytes(path->data(), path->size()) != entry_header.path_hash) {
+      break;
+    }
+    const uint8_t* points =
+        path_data + AlignTo4<size_t>(entry_header.path_bytes);
+    loaded.push_back(Entry{
+        .key =
+            Key{
+                .path_hash = entry_header.path_hash,
+                .path_data = std::move(path),
+                .scale_bucket = entry_header.scale_bucket,
+                .fill_type = static_cast<FillType>(entry_header.fill_type),
+                .supports_primitive_restart =
+                    (entry_header.flags & kPrimitiveRestart) != 0,
+                .supports_triangle_fan =
+                    (entry_header.flags & kTriangleFan) != 0,
+                .uses_32bit_indices = (entry_header.flags & k32BitIndices) != 0,
+            },
+        .vertices =
+            Vertices{
+                .points = reinterpret_cast<const Point*>(points),
+                .point_count = entry_header.point_count,
+                .indices = points + points_size,
+                .index_bytes = entry_header.index_bytes,
+                .vertex_count = entry_header.vertex_count,
+            },
+        .mapped = true,
+    });
+    offset += entry_size;
+    bytes += entry_size;
+  }
+  if (loaded.size() != header.entry_count) {
+    FML_LOG(WARNING) << "Ignoring corrupt tessellation cache.";
+    return;
+  }
+
+  for (Entry& entry : loaded) {
+    auto position = entries_.insert(entries_.end(), std::move(entry));
+    if (!index_.emplace(position->key, position).second) {
+      entries_.erase(position);
+      continue;
+    }
+    bytes_used_ += GetEntrySize(GetPathBytes(position->key),
+                                position->vertices.point_count,
+                                position->vertices.index_bytes);
+  }
+  stats_.entries_loaded = entries_.size();
+  mapped_entry_count_ = entries_.size();
+  if (mapped_entry_count_ > 0u) {
+    mapping_ = std::move(mapping);
+  }
+}
+
+std::function<bool()> TessellationCache::SerializeForPersist() {
+  if (!cache_directory_.is_valid() || !dirty_) {
+    return nullptr;
+  }
+
+  auto data =
+      std::make_shared<std::vector<uint8_t>>(sizeof(FileHeader) + bytes_used_);
+  FileHeader header;
+  header.entry_count = entries_.size();
+  header.engine_hash = GetEngineHash();
+  std::memcpy(data->data(), &header, sizeof(header));
+  size_t offset = sizeof(FileHeader);
+  for (const Entry& entry : entries_) {
+    const Vertices& vertices = entry.vertices;
+    EntryHeader entry_header;
+    entry_header.path_hash = entry.key.path_hash;
+    entry_header.scale_bucket = entry.key.scale_bucket;
+    entry_header.fill_type = static_cast<uint8_t>(entry.key.fill_type);
+    entry_header.flags =
+        (entry.key.supports_primitive_restart ? kPrimitiveRestart : 0) |
+        (entry.key.supports_triangle_fan ? kTriangleFan : 0) |
+        (entry.key.uses_32bit_indices ? k32BitIndices : 0);
+    entry_header.point_count = vertices.point_count;
+    entry_header.index_bytes = vertices.index_bytes;
+    entry_header.vertex_count = vertices.vertex_count;
+    entry_header.path_bytes = GetPathBytes(entry.key);
+    std::memcpy(data->data() + offset, &entry_header, sizeof(entry_header));
+    offset += sizeof(entry_header);
+    if (entry_header.path_bytes > 0u) {
+      std::memcpy(data->data() + offset, entry.key.path_data->data(),
+                  entry_header.path_bytes);
+    }
+    offset += AlignTo4<size_t>(entry_header.path_bytes);
+    if (vertices.point_count > 0u) {
+      std::memcpy(data->data() + offset, vertices.points,
+                  sizeof(Point) * vertices.point_count);
+      offset += sizeof(Point) * vertices.point_count;
+    }
+    if (vertices.index_bytes > 0u) {
+      std::memcpy(data->data() + offset, vertices.indices,
+                  vertices.index_bytes);
+    }
+    offset += AlignTo4(vertices.index_bytes);
+  }
+  FML_DCHECK(offset == data->size());
+  dirty_ = false;
+
+  // The directory is shared rather than captured by value because the
+  // closure has to be copyable.
+  auto directory =
+      std::make_shared<fml::UniqueFD>(fml::Duplicate(cache_directory_.get()));
+  return [directory, data]() {
+    fml::NonOwnedMapping mapping(data->data(), data->size());
+    if (!fml::WriteAtomically(*directory, kTessellationCacheFileName,
+                              mapping)) {
+      FML_LOG(ERROR) << "Could not write the tessellation cache to disk.";
+      return false;
+    }
+    return true;
+  };
+}
+
+bool TessellationCache::Persist() {
+  if (!cache_directory_.is_valid()) {
+    return false;
+  }
+  std::function<bool()> write = SerializeForPersist();
+  return write ? write() : true;
+}
+
+TessellationCache::Stats TessellationCache::GetStats() const {
+  Stats stats = stats_;
+  stats.entry_count = entries_.size();
+  stats.bytes_used = bytes_used_;
+  return stats;
+}
+
+}  // namespace impeller
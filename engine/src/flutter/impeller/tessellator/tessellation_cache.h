@@ -0,0 +1,217 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_TESSELLATOR_TESSELLATION_CACHE_H_
+#define FLUTTER_IMPELLER_TESSELLATOR_TESSELLATION_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+#include "impeller/geometry/path_source.h"
+#include "impeller/tessellator/tessellator.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      A least recently used cache of the vertices produced by
+///             |Tessellator::TessellateConvex|, keyed by the contents of the
+///             path rather than its identity.
+///
+///             Paths are tessellated at a scale that is rounded up to one of
+///             a few buckets per doubling of the scale so that paths which
+///             are drawn under slightly different transforms share an
+///             entry. Rounding up only ever adds vertices, so a cached
+///             tessellation is always at least as fine as the one it
+///             replaces.
+///
+///             Entries are found by a hash of the segments of the path and
+///             the segments themselves are compared on every hit, so paths
+///             whose hashes collide never share an entry.
+///
+///             When constructed with a cache directory, the entries of a
+///             previous run are memory mapped from a file in that directory
+///             and served without copying until they are evicted, and
+///             |Persist| writes the current entries back. Files written by a
+///             different version of the file format or of the engine are
+///             ignored.
+///
+///             This object is not thread safe.
+///
+class TessellationCache {
+ public:
+  /// The default memory budget of the cache.
+  static constexpr size_t kDefaultMaxBytes = 2u * 1024u * 1024u;
+
+  /// The number of scale buckets per doubling of the scale.
+  static constexpr int kScaleBucketsPerOctave = 4;
+
+  struct Key {
+    uint64_t path_hash = 0u;
+    /// The encoded segments of the path. Shared between the copies of the
+    /// key and compared by value.
+    std::shared_ptr<const std::vector<uint8_t>> path_data;
+    int32_t scale_bucket = 0;
+    FillType fill_type = FillType::kNonZero;
+    bool supports_primitive_restart = false;
+    bool supports_triangle_fan = false;
+    bool uses_32bit_indices = false;
+
+    bool operator==(const Key& other) const;
+
+    struct Hash {
+      std::size_t operator()(const Key& key) const;
+    };
+  };
+
+  /// A view of the cached vertices of one path. The pointers remain valid
+  /// until the next call to |Insert| on the cache.
+  struct Vertices {
+    const Point* points = nullptr;
+    size_t point_count = 0u;
+    const uint8_t* indices = nullptr;
+    size_t index_bytes = 0u;
+    size_t vertex_count = 0u;
+  };
+
+  struct Stats {
+    /// The number of lookups that found an entry.
+    size_t hits = 0u;
+
+    /// The number of lookups that did not find an entry.
+    size_t misses = 0u;
+
+    /// The number of entries that were loaded from the persisted file.
+    size_t entries_loaded = 0u;
+
+    /// The number of entries currently in the cache.
+    size_t entry_count = 0u;
+
+    /// The number of bytes of vertex and index data in the cache.
+    size_t bytes_used = 0u;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Computes the cache key of a path.
+  ///
+  /// @param[in]  path   The path that will be tessellated.
+  /// @param[in]  scale  The scale the path is drawn at, as passed to
+  ///                    |Tessellator::TessellateConvex| as its tolerance.
+  ///
+  /// @return     The key, or std::nullopt if the path is not worth caching.
+  ///             Paths made only of straight lines are cheaper to tessellate
+  ///             than to look up and are never cached.
+  static std::optional<Key> ComputeKey(const PathSource& path,
+                                       Scalar scale,
+                                       bool supports_primitive_restart,
+                                       bool supports_triangle_fan,
+                                       bool uses_32bit_indices);
+
+  /// @brief      Returns the scale at which the paths of the given bucket
+  ///             are tessellated.
+  static Scalar GetBucketScale(int32_t scale_bucket);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a cache.
+  ///
+  /// @param[in]  max_bytes        The budget for the vertex and index data of
+  ///                              the entries, both in memory and on disk.
+  /// @param[in]  cache_directory  The directory of the persisted file. If
+  ///                              invalid, the cache is in memory only.
+  explicit TessellationCache(size_t max_bytes = kDefaultMaxBytes,
+                             fml::UniqueFD cache_directory = {});
+
+  ~TessellationCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Looks up the vertices of a path and marks the entry as the
+  ///             most recently used.
+  std::optional<Vertices> Find(const Key& key);
+
+  /// @brief      Whether the vertices are small enough to be cached. Vertices
+  ///             that are larger than a quarter of the budget are not.
+  bool CanInsert(const Key& key,
+                 const Tessellator::ConvexVertices& vertices) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds the vertices of a path, evicting the least recently
+  ///             used entries to stay within the budget. The vertices must
+  ///             satisfy |CanInsert|.
+  ///
+  /// @return     A view of the inserted vertices.
+  Vertices Insert(const Key& key, Tessellator::ConvexVertices vertices);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Serializes the entries of the cache, most recently used
+  ///             first, and returns a closure that writes them to the cache
+  ///             directory.
+  ///
+  ///             The closure owns the serialized entries and a duplicate of
+  ///             the directory, so it may run on any thread, including after
+  ///             the cache has been destroyed.
+  ///
+  /// @return     The closure, which returns whether the file was written, or
+  ///             null if the cache has no directory or nothing new to write.
+  std::function<bool()> SerializeForPersist();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Writes the entries of the cache, most recently used first,
+  ///             to the cache directory on the calling thread.
+  ///
+  /// @return     True if the file was written or there was nothing new to
+  ///             write, false if the cache has no directory or the write
+  ///             failed.
+  bool Persist();
+
+  /// @brief      Returns a snapshot of the counters of the cache.
+  Stats GetStats() const;
+
+ private:
+  struct Entry {
+    Key key;
+    Vertices vertices;
+    // Empty for entries that point into |mapping_|.
+    Tessellator::ConvexVertices storage;
+    bool mapped = false;
+  };
+
+  const size_t max_bytes_;
+  const fml::UniqueFD cache_directory_;
+  // The persisted file, kept alive while any entry points into it.
+  std::shared_ptr<fml::Mapping> mapping_;
+  size_t mapped_entry_count_ = 0u;
+
+  // Most recently used first.
+  std::list<Entry> entries_;
+  std::unordered_map<Key, std::list<Entry>::iterator, Key::Hash> index_;
+  size_t bytes_used_ = 0u;
+  bool dirty_ = false;
+  Stats stats_;
+
+  void LoadPersistedEntries();
+
+  void EvictToFit(size_t bytes);
+
+  void RemoveEntry(std::list<Entry>::iterator entry);
+
+  static size_t GetEntrySize(size_t path_bytes,
+                             size_t point_count,
+                             size_t index_bytes);
+
+  static size_t GetPathBytes(const Key& key);
+
+  TessellationCache(const TessellationCache&) = delete;
+
+  TessellationCache& operator=(const TessellationCache&) = delete;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_TESSELLATOR_TESSELLATION_CACHE_H_
@@ -0,0 +1,326 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstring>
+#include <functional>
+
+#include "flutter/testing/testing.h"
+#include "gtest/gtest.h"
+
+#include "flutter/display_list/geometry/dl_path_builder.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "impeller/tessellator/tessellation_cache.h"
+
+namespace impeller {
+namespace testing {
+
+namespace {
+
+flutter::DlPath MakeCurvedPath(Scalar offset) {
+  flutter::DlPathBuilder builder;
+  builder.MoveTo(Point(offset, 0));
+  builder.QuadraticCurveTo(Point(offset + 50, 100), Point(offset + 100, 0));
+  builder.Close();
+  return builder.TakePath();
+}
+
+std::optional<TessellationCache::Key> ComputeKey(const PathSource& path,
+                                                 Scalar scale) {
+  return TessellationCache::ComputeKey(path, scale,
+                                       /*supports_primitive_restart=*/false,
+                                       /*supports_triangle_fan=*/false,
+                                       /*uses_32bit_indices=*/true);
+}
+
+Tessellator::ConvexVertices Tessellate(const PathSource& path,
+                                       const TessellationCache::Key& key) {
+  Tessellator tessellator(/*supports_32bit_primitive_indices=*/true);
+  return tessellator.TessellateConvexToVertices(
+      path, TessellationCache::GetBucketScale(key.scale_bucket),
+      /*supports_primitive_restart=*/false,
+      /*supports_triangle_fan=*/false);
+}
+
+std::vector<uint8_t> ReadPersistedFile(const fml::UniqueFD& directory) {
+  std::unique_ptr<fml::FileMapping> mapping =
+      fml::FileMapping::CreateReadOnly(directory, "flutter.impeller.tesscache");
+  if (!mapping) {
+    return {};
+  }
+  return std::vector<uint8_t>(mapping->GetMapping(),
+                              mapping->GetMapping() + mapping->GetSize());
+}
+
+bool WritePersistedFile(const fml::UniqueFD& directory,
+                        const std::vector<uint8_t>& data) {
+  fml::NonOwnedMapping mapping(data.data(), data.size());
+  return fml::WriteAtomically(directory, "flutter.impeller.tesscache",
+                              mapping);
+}
+
+}  // namespace
+
+TEST(TessellationCacheTest, KeyDependsOnPathContentsNotIdentity) {
+  flutter::DlPath path_a = MakeCurvedPath(0);
+  flutter::DlPath path_b = MakeCurvedPath(0);
+  flutter::DlPath path_c = MakeCurvedPath(1);
+
+  std::optional<TessellationCache::Key> key_a = ComputeKey(path_a, 1.0f);
+  std::optional<TessellationCache::Key> key_b = ComputeKey(path_b, 1.0f);
+  std::optional<TessellationCache::Key> key_c = ComputeKey(path_c, 1.0f);
+  ASSERT_TRUE(key_a.has_value());
+  ASSERT_TRUE(key_b.has_value());
+  ASSERT_TRUE(key_c.has_value());
+  EXPECT_EQ(key_a.value(), key_b.value());
+  EXPECT_FALSE(key_a.value() == key_c.value());
+}
+
+TEST(TessellationCacheTest, ScalesAreRoundedUpToBuckets) {
+  flutter::DlPath path = MakeCurvedPath(0);
+
+  std::optional<TessellationCache::Key> key_1 = ComputeKey(path, 1.0f);
+  std::optional<TessellationCache::Key> key_1_1 = ComputeKey(path, 1.1f);
+  std::optional<TessellationCache::Key> key_1_15 = ComputeKey(path, 1.15f);
+  std::optional<TessellationCache::Key> key_2 = ComputeKey(path, 2.0f);
+  ASSERT_TRUE(key_1.has_value());
+  ASSERT_TRUE(key_1_1.has_value());
+  ASSERT_TRUE(key_1_15.has_value());
+  ASSERT_TRUE(key_2.has_value());
+
+  EXPECT_EQ(key_1_1.value(), key_1_15.value());
+  EXPECT_FALSE(key_1.value() == key_1_1.value());
+  EXPECT_FALSE(key_1_1.value() == key_2.value());
+
+  EXPECT_FLOAT_EQ(TessellationCache::GetBucketScale(key_1->scale_bucket),
+                  1.0f);
+  EXPECT_FLOAT_EQ(TessellationCache::GetBucketScale(key_2->scale_bucket),
+                  2.0f);
+  EXPECT_GE(TessellationCache::GetBucketScale(key_1_15->scale_bucket), 1.15f);
+}
+
+TEST(TessellationCacheTest, StraightLinePathsAreNotCached) {
+  flutter::DlPathBuilder builder;
+  builder.AddRect(Rect::MakeLTRB(0, 0, 10, 10));
+  flutter::DlPath path = builder.TakePath();
+
+  EXPECT_FALSE(ComputeKey(path, 1.0f).has_value());
+  EXPECT_FALSE(ComputeKey(MakeCurvedPath(0), 0.0f).has_value());
+}
+
+TEST(TessellationCacheTest, EvictsLeastRecentlyUsedEntries) {
+  std::vector<flutter::DlPath> paths;
+  std::vector<TessellationCache::Key> keys;
+  for (int i = 0; i < 5; i++) {
+    paths.push_back(MakeCurvedPath(i));
+    keys.push_back(ComputeKey(paths.back(), 1.0f).value());
+  }
+
+  // All of the paths tessellate to the same number of vertices.
+  TessellationCache probe;
+  probe.Insert(keys[0], Tessellate(paths[0], keys[0]));
+  const size_t entry_size = probe.GetStats().bytes_used;
+
+  // Entries may use up to a quarter of the budget, so this holds 4 of them.
+  TessellationCache cache(entry_size * 4u);
+  for (size_t i = 0; i < 4; i++) {
+    cache.Insert(keys[i], Tessellate(paths[i], keys[i]));
+  }
+  EXPECT_EQ(cache.GetStats().entry_count, 4u);
+
+  // Touch the oldest entry so that the second one is evicted next.
+  EXPECT_TRUE(cache.Find(keys[0]).has_value());
+  cache.Insert(keys[4], Tessellate(paths[4], keys[4]));
+
+  EXPECT_EQ(cache.GetStats().entry_count, 4u);
+  EXPECT_EQ(cache.GetStats().bytes_used, entry_size * 4u);
+  EXPECT_TRUE(cache.Find(keys[0]).has_value());
+  EXPECT_FALSE(cache.Find(keys[1]).has_value());
+  EXPECT_TRUE(cache.Find(keys[4]).has_value());
+}
+
+TEST(TessellationCacheTest, RejectsEntriesLargerThanAQuarterOfTheBudget) {
+  flutter::DlPath path = MakeCurvedPath(0);
+  TessellationCache::Key key = ComputeKey(path, 1.0f).value();
+  Tessellator::ConvexVertices vertices = Tessellate(path, key);
+
+  TessellationCache probe;
+  probe.Insert(key, Tessellate(path, key));
+  const size_t entry_size = probe.GetStats().bytes_used;
+
+  EXPECT_TRUE(TessellationCache(entry_size * 4u).CanInsert(key, vertices));
+  EXPECT_FALSE(
+      TessellationCache(entry_size * 4u - 4u).CanInsert(key, vertices));
+}
+
+TEST(TessellationCacheTest, PersistsAndMapsEntries) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  flutter::DlPath path_a = MakeCurvedPath(0);
+  flutter::DlPath path_b = MakeCurvedPath(1);
+  TessellationCache::Key key_a = ComputeKey(path_a, 1.0f).value();
+  TessellationCache::Key key_b = ComputeKey(path_b, 3.0f).value();
+  Tessellator::ConvexVertices vertices_a = Tessellate(path_a, key_a);
+  Tessellator::ConvexVertices vertices_b = Tessellate(path_b, key_b);
+
+  {
+    TessellationCache cache(TessellationCache::kDefaultMaxBytes,
+                            fml::Duplicate(temp_dir.fd().get()));
+    EXPECT_EQ(cache.GetStats().entries_loaded, 0u);
+    cache.Insert(key_a, vertices_a);
+    cache.Insert(key_b, vertices_b);
+    ASSERT_TRUE(cache.Persist());
+  }
+
+  TessellationCache cache(TessellationCache::kDefaultMaxBytes,
+                          fml::Duplicate(temp_dir.fd().get()));
+  EXPECT_EQ(cache.GetStats().entries_loaded, 2u);
+
+  for (const auto& [key, expected] : {std::make_pair(key_a, &vertices_a),
+                                      std::make_pair(key_b, &vertices_b)}) {
+    std::optional<TessellationCache::Vertices> found = cache.Find(key);
+    ASSERT_TRUE(found.has_value());
+    ASSERT_EQ(found->point_count, expected->points.size());
+    ASSERT_EQ(found->index_bytes, expected->indices.size());
+    EXPECT_EQ(found->vertex_count, expected->vertex_count);
+    EXPECT_EQ(std::vector<Point>(found->points,
+                                 found->points + found->point_count),
+              expected->points);
+    EXPECT_EQ(std::vector<uint8_t>(found->indices,
+                                   found->indices + found->index_bytes),
+              expected->indices);
+  }
+}
+
+TEST(TessellationCacheTest, SerializedEntriesAreWrittenAfterTheCacheIsGone) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  flutter::DlPath path = MakeCurvedPath(0);
+  TessellationCache::Key key = ComputeKey(path, 1.0f).value();
+  std::function<bool()> write;
+  {
+    TessellationCache cache(TessellationCache::kDefaultMaxBytes,
+                            fml::Duplicate(temp_dir.fd().get()));
+    EXPECT_FALSE(cache.SerializeForPersist());
+    cache.Insert(key, Tessellate(path, key));
+    write = cache.SerializeForPersist();
+    ASSERT_TRUE(write);
+    // Nothing new to write until the next insertion.
+    EXPECT_FALSE(cache.SerializeForPersist());
+  }
+  EXPECT_TRUE(ReadPersistedFile(temp_dir.fd()).empty());
+  ASSERT_TRUE(write());
+
+  TessellationCache cache(TessellationCache::kDefaultMaxBytes,
+                          fml::Duplicate(temp_dir.fd().get()));
+  EXPECT_EQ(cache.GetStats().entries_loaded, 1u);
+  EXPECT_TRUE(cache.Find(key).has_value());
+}
+
+TEST(TessellationCacheTest, IgnoresCorruptFiles) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  flutter::DlPath path = MakeCurvedPath(0);
+  TessellationCache::Key key = ComputeKey(path, 1.0f).value();
+  {
+    TessellationCache cache(TessellationCache::kDefaultMaxBytes,
+                            fml::Duplicate(temp_dir.fd().get()));
+    cache.Insert(key, Tessellate(path, key));
+    ASSERT_TRUE(cache.Persist());
+  }
+
+  // Truncate the file in the middle of the entry.
+  std::unique_ptr<fml::FileMapping> mapping = fml::FileMapping::CreateReadOnly(
+      temp_dir.fd(), "flutter.impeller.tesscache");
+  ASSERT_TRUE(mapping);
+  fml::NonOwnedMapping truncated(mapping->GetMapping(),
+                                 mapping->GetSize() - 4u);
+  ASSERT_TRUE(fml::WriteAtomically(temp_dir.fd(), "flutter.impeller.tesscache",
+                                   truncated));
+
+  TessellationCache cache(TessellationCache::kDefaultMaxBytes,
+                          fml::Duplicate(temp_dir.fd().get()));
+  EXPECT_EQ(cache.GetStats().entries_loaded, 0u);
+  EXPECT_FALSE(cache.Find(key).has_value());
+}
+
+TEST(TessellationCacheTest, IgnoresFilesWithOverflowingSizes) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  flutter::DlPath path = MakeCurvedPath(0);
+  TessellationCache::Key key = ComputeKey(path, 1.0f).value();
+  {
+    TessellationCache cache(TessellationCache::kDefaultMaxBytes,
+                            fml::Duplicate(temp_dir.fd().get()));
+    cache.Insert(key, Tessellate(path, key));
+    ASSERT_TRUE(cache.Persist());
+  }
+
+  std::vector<uint8_t> data = ReadPersistedFile(temp_dir.fd());
+  ASSERT_FALSE(data.empty());
+
+  // Point and vertex counts whose sizes wrap around in 32 bits, at the
+  // offsets of the counts in the header of the first entry.
+  const uint32_t point_count = 0x20000000u;
+  const uint32_t index_bytes = 0xfffffffcu;
+  const uint32_t vertex_count = 0x3fffffffu;
+  std::memcpy(data.data() + 40u, &point_count, sizeof(point_count));
+  std::memcpy(data.data() + 44u, &index_bytes, sizeof(index_bytes));
+  std::memcpy(data.data() + 48u, &vertex_count, sizeof(vertex_count));
+  ASSERT_TRUE(WritePersistedFile(temp_dir.fd(), data));
+
+  TessellationCache cache(TessellationCache::kDefaultMaxBytes,
+                          fml::Duplicate(temp_dir.fd().get()));
+  EXPECT_EQ(cache.GetStats().entries_loaded, 0u);
+  EXPECT_FALSE(cache.Find(key).has_value());
+}
+
+TEST(TessellationCacheTest, ComparesPathsOfCollidingHashes) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  flutter::DlPath path_a = MakeCurvedPath(0);
+  flutter::DlPath path_b = MakeCurvedPath(1);
+  TessellationCache::Key key_a = ComputeKey(path_a, 1.0f).value();
+  // A key of another path whose hash collides with the first one.
+  TessellationCache::Key key_b = key_a;
+  key_b.path_data = ComputeKey(path_b, 1.0f)->path_data;
+
+  {
+    TessellationCache cache(TessellationCache::kDefaultMaxBytes,
+                            fml::Duplicate(temp_dir.fd().get()));
+    cache.Insert(key_a, Tessellate(path_a, key_a));
+    EXPECT_FALSE(cache.Find(key_b).has_value());
+    EXPECT_TRUE(cache.Find(key_a).has_value());
+    ASSERT_TRUE(cache.Persist());
+  }
+
+  TessellationCache cache(TessellationCache::kDefaultMaxBytes,
+                          fml::Duplicate(temp_dir.fd().get()));
+  EXPECT_EQ(cache.GetStats().entries_loaded, 1u);
+  EXPECT_FALSE(cache.Find(key_b).has_value());
+  EXPECT_TRUE(cache.Find(key_a).has_value());
+}
+
+TEST(TessellationCacheTest, IgnoresFilesOfOtherVersionsAndEngines) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  flutter::DlPath path = MakeCurvedPath(0);
+  TessellationCache::Key key = ComputeKey(path, 1.0f).value();
+  {
+    TessellationCache cache(TessellationCache::kDefaultMaxBytes,
+                            fml::Duplicate(temp_dir.fd().get()));
+    cache.Insert(key, Tessellate(path, key));
+    ASSERT_TRUE(cache.Persist());
+  }
+  const std::vector<uint8_t> data = ReadPersistedFile(temp_dir.fd());
+  ASSERT_FALSE(data.empty());
+
+  // The version follows the magic, and the hash of the engine ends the
+  // header of the file.
+  for (size_t offset : {4u, 16u}) {
+    std::vector<uint8_t> other = data;
+    other[offset] ^= 0xffu;
+    ASSERT_TRUE(WritePersistedFile(temp_dir.fd(), other));
+    TessellationCache cache(TessellationCache::kDefaultMaxBytes,
+                            fml::Duplicate(temp_dir.fd().get()));
+    EXPECT_EQ(cache.GetStats().entries_loaded, 0u);
+  }
+}
+
+}  // namespace testing
+}  // namespace impeller
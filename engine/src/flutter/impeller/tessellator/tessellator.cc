@@ -6,8 +6,10 @@
 #include <cstdint>
 #include <cstring>
 
+#include "flutter/fml/hash_combine.h"
 #include "flutter/impeller/core/device_buffer.h"
 #include "flutter/impeller/tessellator/path_tessellator.h"
+#include "flutter/impeller/tessellator/tessellation_cache.h"
 
 namespace {
 static constexpr int kPrecomputedDivisionCount = 1024;
@@ -316,6 +318,47 @@ void DoTessellateConvexInternal(const impeller::PathSource& path,
   impeller::PathTessellator::PathToFilledVertices(path, writer, tolerance);
 }
 
+template <typename IndexT>
+impeller::Tessellator::ConvexVertices DoTessellateConvexToVertices(
+    const impeller::PathSource& path,
+    impeller::Scalar tolerance,
+    bool supports_primitive_restart,
+    bool supports_triangle_fan) {
+  impeller::Tessellator::ConvexVertices result;
+  std::vector<IndexT> indices;
+  if (supports_primitive_restart) {
+    const auto [point_count, contour_count] =
+        impeller::PathTessellator::CountFillStorage(path, tolerance);
+    result.points.resize(point_count);
+    indices.resize(point_count + contour_count);
+
+    auto tessellate_path = [&](auto& writer) {
+      impeller::PathTessellator::PathToFilledVertices(path, writer, tolerance);
+      FML_DCHECK(writer.GetPointCount() <= point_count);
+      FML_DCHECK(writer.GetIndexCount() <= (point_count + contour_count));
+      result.points.resize(writer.GetPointCount());
+      indices.resize(writer.GetIndexCount());
+    };
+
+    if (supports_triangle_fan) {
+      FanPathVertexWriter writer(result.points.data(), indices.data());
+      tessellate_path(writer);
+    } else {
+      StripPathVertexWriter writer(result.points.data(), indices.data());
+      tessellate_path(writer);
+    }
+  } else {
+    DoTessellateConvexInternal(path, result.points, indices, tolerance);
+  }
+
+  result.vertex_count = indices.size();
+  result.indices.resize(sizeof(IndexT) * indices.size());
+  if (!indices.empty()) {
+    memcpy(result.indices.data(), indices.data(), result.indices.size());
+  }
+  return result;
+}
+
 }  // namespace
 
 namespace impeller {
@@ -408,7 +451,8 @@ class ConvexTessellatorImpl : public Tessellator::ConvexTessellator {
 };
 
 Tessellator::Tessellator(bool supports_32bit_primitive_indices)
-    : stroke_points_(kPointArenaSize) {
+    : supports_32bit_primitive_indices_(supports_32bit_primitive_indices),
+      stroke_points_(kPointArenaSize) {
   if (supports_32bit_primitive_indices) {
     convex_tessellator_ = std::make_unique<ConvexTessellatorImpl<uint32_t>>();
   } else {
@@ -431,12 +475,128 @@ VertexBuffer Tessellator::TessellateConvex(const PathSource& path,
                                            HostBuffer& indexes_host_buffer,
                                            Scalar tolerance,
                                            bool supports_primitive_restart,
-                                           bool supports_triangle_fan) {
+                                           bool supports_triangle_fan,
+                                           const void* path_identity) {
+  if (path_identity != nullptr && !pretessellated_convex_.empty()) {
+    auto found = pretessellated_convex_.find(
+        PretessellatedKey{.path_identity = path_identity,
+                          .tolerance = tolerance});
+    if (found != pretessellated_convex_.end()) {
+      pretessellated_convex_hits_++;
+      const ConvexVertices& vertices = found->second;
+      return EmplaceConvexVertices(
+          vertices.points.data(), vertices.points.size(),
+          vertices.indices.data(), vertices.indices.size(),
+          vertices.vertex_count, data_host_buffer, indexes_host_buffer);
+    }
+  }
+  if (tessellation_cache_) {
+    std::optional<TessellationCache::Key> key = TessellationCache::ComputeKey(
+        path, tolerance, supports_primitive_restart, supports_triangle_fan,
+        supports_32bit_primitive_indices_);
+    if (key.has_value()) {
+      std::optional<TessellationCache::Vertices> cached =
+          tessellation_cache_->Find(key.value());
+      if (!cached.has_value()) {
+        ConvexVertices vertices = TessellateConvexToVertices(
+            path, TessellationCache::GetBucketScale(key->scale_bucket),
+            supports_primitive_restart, supports_triangle_fan);
+        if (!tessellation_cache_->CanInsert(key.value(), vertices)) {
+          return EmplaceConvexVertices(
+              vertices.points.data(), vertices.points.size(),
+              vertices.indices.data(), vertices.indices.size(),
+              vertices.vertex_count, data_host_buffer, indexes_host_buffer);
+        }
+        cached = tessellation_cache_->Insert(key.value(), std::move(vertices));
+      }
+      return EmplaceConvexVertices(
+          cached->points, cached->point_count, cached->indices,
+          cached->index_bytes, cached->vertex_count, data_host_buffer,
+          indexes_host_buffer);
+    }
+  }
   return convex_tessellator_->TessellateConvex(
       path, data_host_buffer, indexes_host_buffer, tolerance,
       supports_primitive_restart, supports_triangle_fan);
 }
 
+Tessellator::ConvexVertices Tessellator::TessellateConvexToVertices(
+    const PathSource& path,
+    Scalar tolerance,
+    bool supports_primitive_restart,
+    bool supports_triangle_fan) const {
+  if (supports_32bit_primitive_indices_) {
+    return DoTessellateConvexToVertices<uint32_t>(
+        path, tolerance, supports_primitive_restart, supports_triangle_fan);
+  } else {
+    return DoTessellateConvexToVertices<uint16_t>(
+        path, tolerance, supports_primitive_restart, supports_triangle_fan);
+  }
+}
+
+VertexBuffer Tessellator::EmplaceConvexVertices(
+    const Point* points,
+    size_t point_count,
+    const uint8_t* indices,
+    size_t index_bytes,
+    size_t vertex_count,
+    HostBuffer& data_host_buffer,
+    HostBuffer& indexes_host_buffer) const {
+  IndexType index_type = supports_32bit_primitive_indices_ ? IndexType::k32bit
+                                                           : IndexType::k16bit;
+  if (vertex_count == 0u) {
+    return VertexBuffer{
+        .vertex_buffer = {},
+        .index_buffer = {},
+        .vertex_count = 0u,
+        .index_type = index_type,
+    };
+  }
+  size_t index_alignment = supports_32bit_primitive_indices_
+                               ? alignof(uint32_t)
+                               : alignof(uint16_t);
+  return VertexBuffer{
+      .vertex_buffer = data_host_buffer.Emplace(
+          points, sizeof(Point) * point_count, alignof(Point)),
+      .index_buffer =
+          indexes_host_buffer.Emplace(indices, index_bytes, index_alignment),
+      .vertex_count = vertex_count,
+      .index_type = index_type,
+  };
+}
+
+void Tessellator::SetTessellationCache(
+    std::shared_ptr<TessellationCache> cache) {
+  tessellation_cache_ = std::move(cache);
+}
+
+const std::shared_ptr<TessellationCache>& Tessellator::GetTessellationCache()
+    const {
+  return tessellation_cache_;
+}
+
+void Tessellator::AddPretessellatedConvex(const void* path_identity,
+                                          Scalar tolerance,
+                                          ConvexVertices vertices) {
+  pretessellated_convex_[PretessellatedKey{.path_identity = path_identity,
+                                           .tolerance = tolerance}] =
+      std::move(vertices);
+}
+
+void Tessellator::ClearPretessellatedConvex() {
+  pretessellated_convex_.clear();
+  pretessellated_convex_hits_ = 0u;
+}
+
+size_t Tessellator::GetPretessellatedConvexHitCount() const {
+  return pretessellated_convex_hits_;
+}
+
+std::size_t Tessellator::PretessellatedKey::Hash::operator()(
+    const PretessellatedKey& key) const {
+  return fml::HashCombine(key.path_identity, key.tolerance);
+}
+
 void Tessellator::TessellateConvexInternal(const PathSource& path,
                                            std::vector<Point>& point_buffer,
                                            std::vector<uint16_t>& index_buffer,
@@ -7,6 +7,7 @@
 
 #include <functional>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "impeller/core/formats.h"
@@ -20,6 +21,8 @@
 
 namespace impeller {
 
+class TessellationCache;
+
 /// The size of the point arena buffer stored on the tessellator.
 [[maybe_unused]]
 static constexpr size_t kPointArenaSize = 4096u;
@@ -239,6 +242,17 @@ class Tessellator {
                        std::unique_ptr<Trigs> round_cap_trigs);
   };
 
+  /// The vertices and indices of a convex path fill that were tessellated
+  /// into CPU memory ahead of time by |TessellateConvexToVertices|.
+  struct ConvexVertices {
+    std::vector<Point> points;
+    /// The raw bytes of the indices, stored in the index type of the
+    /// Tessellator that produced them.
+    std::vector<uint8_t> indices;
+    /// The number of indices.
+    size_t vertex_count = 0u;
+  };
+
   explicit Tessellator(bool supports_32bit_primitive_indices = true);
 
   virtual ~Tessellator();
@@ -254,13 +268,65 @@ class Tessellator {
   ///                        Matrix::GetMaxBasisLengthXY of the CTM applied to
   ///                        the path for rendering.
   ///
+  /// @param[in]  path_identity  An optional pointer that uniquely identifies
+  ///                            the path for the current frame. If vertices
+  ///                            were registered for this identity and
+  ///                            tolerance with |AddPretessellatedConvex|,
+  ///                            they are copied into the host buffers
+  ///                            instead of tessellating the path again.
+  ///
   /// @return A vertex buffer containing all data from the provided curve.
   VertexBuffer TessellateConvex(const PathSource& path,
                                 HostBuffer& data_host_buffer,
                                 HostBuffer& indexes_host_buffer,
                                 Scalar tolerance,
                                 bool supports_primitive_restart = false,
-                                bool supports_triangle_fan = false);
+                                bool supports_triangle_fan = false,
+                                const void* path_identity = nullptr);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Given a convex path, produce the same vertices and indices
+  ///             as |TessellateConvex| into CPU memory.
+  ///
+  ///             Unlike the rest of the Tessellator, this method does not
+  ///             touch the state of the object and may be called from
+  ///             multiple threads concurrently.
+  ConvexVertices TessellateConvexToVertices(const PathSource& path,
+                                            Scalar tolerance,
+                                            bool supports_primitive_restart,
+                                            bool supports_triangle_fan) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Registers vertices produced by |TessellateConvexToVertices|
+  ///             for the path identified by |path_identity| at the given
+  ///             tolerance.
+  ///
+  ///             The vertices must have been produced with the same
+  ///             primitive restart and triangle fan settings that the
+  ///             matching |TessellateConvex| call will use.
+  void AddPretessellatedConvex(const void* path_identity,
+                               Scalar tolerance,
+                               ConvexVertices vertices);
+
+  /// @brief      Drops all vertices registered by |AddPretessellatedConvex|.
+  void ClearPretessellatedConvex();
+
+  /// @brief      The number of |TessellateConvex| calls that were satisfied
+  ///             from registered vertices since the last call to
+  ///             |ClearPretessellatedConvex|.
+  size_t GetPretessellatedConvexHitCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the cache consulted by |TessellateConvex| for paths that
+  ///             were not pretessellated, or disables caching if nullptr.
+  ///
+  ///             Paths that are found in the cache, or added to it, are
+  ///             tessellated at the bucketed scale of the cache rather than
+  ///             at the exact tolerance passed to |TessellateConvex|.
+  void SetTessellationCache(std::shared_ptr<TessellationCache> cache);
+
+  /// @brief      Returns the cache set by |SetTessellationCache|, if any.
+  const std::shared_ptr<TessellationCache>& GetTessellationCache() const;
 
   /// Visible for testing.
   ///
@@ -407,6 +473,42 @@ class Tessellator {
 
   /// Used for polyline generation.
   std::unique_ptr<ConvexTessellator> convex_tessellator_;
+  const bool supports_32bit_primitive_indices_;
+
+  struct PretessellatedKey {
+    const void* path_identity;
+    Scalar tolerance;
+
+    struct Hash {
+      std::size_t operator()(const PretessellatedKey& key) const;
+    };
+
+    struct Equal {
+      constexpr bool operator()(const PretessellatedKey& lhs,
+                                const PretessellatedKey& rhs) const {
+        return lhs.path_identity == rhs.path_identity &&
+               lhs.tolerance == rhs.tolerance;
+      }
+    };
+  };
+
+  /// Vertices tessellated ahead of time for the current frame.
+  std::unordered_map<PretessellatedKey,
+                     ConvexVertices,
+                     PretessellatedKey::Hash,
+                     PretessellatedKey::Equal>
+      pretessellated_convex_;
+  size_t pretessellated_convex_hits_ = 0u;
+
+  std::shared_ptr<TessellationCache> tessellation_cache_;
+
+  VertexBuffer EmplaceConvexVertices(const Point* points,
+                                     size_t point_count,
+                                     const uint8_t* indices,
+                                     size_t index_bytes,
+                                     size_t vertex_count,
+                                     HostBuffer& data_host_buffer,
+                                     HostBuffer& indexes_host_buffer) const;
 
   /// Used for stroke path generation.
   std::vector<Point> stroke_points_;
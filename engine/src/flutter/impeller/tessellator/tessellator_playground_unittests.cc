@@ -7,6 +7,7 @@
 
 #include "flutter/display_list/geometry/dl_path_builder.h"
 #include "impeller/playground/playground_test.h"
+#include "impeller/tessellator/tessellation_cache.h"
 #include "impeller/tessellator/tessellator.h"
 
 namespace impeller {
@@ -57,5 +58,120 @@ TEST_P(TessellatorPlaygroundTest, TessellateConvex16or32Bit) {
       CopyBufferView<uint32_t>(vertex_buffer32.index_buffer));
 }
 
+TEST_P(TessellatorPlaygroundTest, PretessellatedConvexMatchesTessellateConvex) {
+  auto data_host_buffer = HostBuffer::Create(
+      GetContext()->GetResourceAllocator(), GetContext()->GetIdleWaiter(),
+      GetContext()->GetCapabilities()->GetMinimumUniformAlignment());
+  auto indexes_host_buffer = HostBuffer::Create(
+      GetContext()->GetResourceAllocator(), GetContext()->GetIdleWaiter(),
+      GetContext()->GetCapabilities()->GetMinimumUniformAlignment());
+
+  flutter::DlPathBuilder builder;
+  builder.AddCircle(Point(50, 50), 40);
+  builder.AddRect(Rect::MakeLTRB(100, 100, 150, 150));
+  flutter::DlPath path = builder.TakePath();
+  // Copies of a DlPath share the same identity.
+  const void* identity = &flutter::DlPath(path).GetSkPath();
+
+  for (bool use_32bit : {false, true}) {
+    for (bool restart : {false, true}) {
+      for (bool fan : {false, true}) {
+        if (fan && !restart) {
+          continue;
+        }
+        Tessellator tessellator(use_32bit);
+        VertexBuffer expected = tessellator.TessellateConvex(
+            path, *data_host_buffer, *indexes_host_buffer, 2.0f, restart, fan);
+
+        tessellator.AddPretessellatedConvex(
+            identity, 2.0f,
+            tessellator.TessellateConvexToVertices(path, 2.0f, restart, fan));
+        // A different tolerance is not satisfied by the registered vertices.
+        tessellator.TessellateConvex(path, *data_host_buffer,
+                                     *indexes_host_buffer, 1.0f, restart, fan,
+                                     identity);
+        EXPECT_EQ(tessellator.GetPretessellatedConvexHitCount(), 0u);
+
+        VertexBuffer actual = tessellator.TessellateConvex(
+            path, *data_host_buffer, *indexes_host_buffer, 2.0f, restart, fan,
+            identity);
+        EXPECT_EQ(tessellator.GetPretessellatedConvexHitCount(), 1u);
+
+        EXPECT_EQ(actual.index_type, expected.index_type);
+        EXPECT_EQ(actual.vertex_count, expected.vertex_count);
+        std::vector<Point> expected_points =
+            CopyBufferView<Point>(expected.vertex_buffer);
+        std::vector<Point> actual_points =
+            CopyBufferView<Point>(actual.vertex_buffer);
+        ASSERT_LE(actual_points.size(), expected_points.size());
+        expected_points.resize(actual_points.size());
+        EXPECT_EQ(actual_points, expected_points);
+        if (use_32bit) {
+          std::vector<uint32_t> expected_indices =
+              CopyBufferView<uint32_t>(expected.index_buffer);
+          expected_indices.resize(expected.vertex_count);
+          EXPECT_EQ(CopyBufferView<uint32_t>(actual.index_buffer),
+                    expected_indices);
+        } else {
+          std::vector<uint16_t> expected_indices =
+              CopyBufferView<uint16_t>(expected.index_buffer);
+          expected_indices.resize(expected.vertex_count);
+          EXPECT_EQ(CopyBufferView<uint16_t>(actual.index_buffer),
+                    expected_indices);
+        }
+
+        tessellator.ClearPretessellatedConvex();
+        EXPECT_EQ(tessellator.GetPretessellatedConvexHitCount(), 0u);
+      }
+    }
+  }
+}
+
+TEST_P(TessellatorPlaygroundTest, TessellateConvexUsesTessellationCache) {
+  auto data_host_buffer = HostBuffer::Create(
+      GetContext()->GetResourceAllocator(), GetContext()->GetIdleWaiter(),
+      GetContext()->GetCapabilities()->GetMinimumUniformAlignment());
+  auto indexes_host_buffer = HostBuffer::Create(
+      GetContext()->GetResourceAllocator(), GetContext()->GetIdleWaiter(),
+      GetContext()->GetCapabilities()->GetMinimumUniformAlignment());
+
+  auto make_path = []() {
+    flutter::DlPathBuilder builder;
+    builder.AddCircle(Point(50, 50), 40);
+    return builder.TakePath();
+  };
+
+  Tessellator tessellator(/*supports_32bit_primitive_indices=*/true);
+  auto cache = std::make_shared<TessellationCache>();
+  tessellator.SetTessellationCache(cache);
+
+  // The second path has the same contents as the first, and a slightly
+  // different scale falls in the same bucket.
+  VertexBuffer first = tessellator.TessellateConvex(
+      make_path(), *data_host_buffer, *indexes_host_buffer, 1.1f);
+  VertexBuffer second = tessellator.TessellateConvex(
+      make_path(), *data_host_buffer, *indexes_host_buffer, 1.15f);
+  EXPECT_EQ(cache->GetStats().misses, 1u);
+  EXPECT_EQ(cache->GetStats().hits, 1u);
+  EXPECT_EQ(cache->GetStats().entry_count, 1u);
+
+  // Both are tessellated at the scale of the bucket.
+  Tessellator::ConvexVertices expected = tessellator.TessellateConvexToVertices(
+      make_path(), TessellationCache::GetBucketScale(1), false, false);
+  for (const VertexBuffer& actual : {first, second}) {
+    EXPECT_EQ(actual.index_type, IndexType::k32bit);
+    EXPECT_EQ(actual.vertex_count, expected.vertex_count);
+    EXPECT_EQ(CopyBufferView<Point>(actual.vertex_buffer), expected.points);
+  }
+
+  // Paths without curves bypass the cache.
+  flutter::DlPathBuilder builder;
+  builder.AddRect(Rect::MakeLTRB(0, 0, 10, 10));
+  tessellator.TessellateConvex(builder.TakePath(), *data_host_buffer,
+                               *indexes_host_buffer, 1.0f);
+  EXPECT_EQ(cache->GetStats().misses, 1u);
+  EXPECT_EQ(cache->GetStats().hits, 1u);
+}
+
 }  // namespace testing
 }  // namespace impeller
@@ -130,6 +130,57 @@ TEST(TessellatorTest, TessellateConvex) {
   }
 }
 
+TEST(TessellatorTest, TessellateConvexToVerticesMatchesInternal) {
+  flutter::DlPathBuilder builder;
+  builder.AddRect(flutter::DlRect::MakeLTRB(0, 0, 10, 10));
+  builder.AddRect(flutter::DlRect::MakeLTRB(20, 20, 30, 30));
+  flutter::DlPath path = builder.TakePath();
+
+  std::vector<Point> points;
+  std::vector<uint16_t> indices;
+  Tessellator::TessellateConvexInternal(path, points, indices, 1.0f);
+
+  Tessellator tessellator(/*supports_32bit_primitive_indices=*/false);
+  Tessellator::ConvexVertices vertices = tessellator.TessellateConvexToVertices(
+      path, 1.0f, /*supports_primitive_restart=*/false,
+      /*supports_triangle_fan=*/false);
+
+  EXPECT_EQ(vertices.points, points);
+  EXPECT_EQ(vertices.vertex_count, indices.size());
+  ASSERT_EQ(vertices.indices.size(), indices.size() * sizeof(uint16_t));
+  EXPECT_EQ(memcmp(vertices.indices.data(), indices.data(),
+                   vertices.indices.size()),
+            0);
+}
+
+TEST(TessellatorTest, TessellateConvexToVerticesWithPrimitiveRestart) {
+  flutter::DlPathBuilder builder;
+  builder.AddRect(flutter::DlRect::MakeLTRB(0, 0, 10, 10));
+  builder.AddRect(flutter::DlRect::MakeLTRB(20, 20, 30, 30));
+  flutter::DlPath path = builder.TakePath();
+
+  Tessellator tessellator(/*supports_32bit_primitive_indices=*/true);
+  Tessellator::ConvexVertices vertices = tessellator.TessellateConvexToVertices(
+      path, 1.0f, /*supports_primitive_restart=*/true,
+      /*supports_triangle_fan=*/true);
+
+  // Each contour is written as a fan of its points followed by a restart
+  // index.
+  ASSERT_EQ(vertices.vertex_count, vertices.points.size() + 2u);
+  ASSERT_EQ(vertices.indices.size(), vertices.vertex_count * sizeof(uint32_t));
+  const uint32_t* indices =
+      reinterpret_cast<const uint32_t*>(vertices.indices.data());
+  size_t restarts = 0u;
+  for (size_t i = 0; i < vertices.vertex_count; i++) {
+    if (indices[i] == static_cast<uint32_t>(-1)) {
+      restarts++;
+    } else {
+      EXPECT_LT(indices[i], vertices.points.size());
+    }
+  }
+  EXPECT_EQ(restarts, 2u);
+}
+
 // Filled Paths without an explicit close should still be closed implicitly
 TEST(TessellatorTest, TessellateConvexUnclosedPath) {
   std::vector<Point> points;
@@ -4,10 +4,12 @@
 
 #include "impeller/typographer/backends/skia/typographer_context_skia.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -24,6 +26,7 @@
 #include "impeller/geometry/rect.h"
 #include "impeller/geometry/size.h"
 #include "impeller/renderer/command_buffer.h"
+#include "impeller/renderer/command_queue.h"
 #include "impeller/renderer/render_pass.h"
 #include "impeller/renderer/render_target.h"
 #include "impeller/typographer/backends/skia/typeface_skia.h"
@@ -47,6 +50,20 @@ namespace impeller {
 
 constexpr auto kPadding = 2;
 
+/// Glyphs that were used within this many generations of the atlas are never
+/// evicted, so that glyphs that are drawn every few frames do not thrash.
+///
+/// This does not protect glyphs that are still sampled by frames in flight, as
+/// the generation may advance several times per frame. The space of evicted
+/// glyphs is instead only reused once the GPU has completed the work that was
+/// submitted before their eviction.
+constexpr size_t kMinimumGlyphEvictionAge = 4;
+
+/// Atlases that cannot grow evict unused glyphs once they are this full, so
+/// that the space of the evicted glyphs has been released by the GPU by the
+/// time it is needed.
+constexpr Scalar kGlyphEvictionOccupancy = 0.75;
+
 namespace {
 SkPaint::Cap ToSkiaCap(Cap cap) {
   switch (cap) {
@@ -97,8 +114,11 @@ static SkImageInfo GetImageInfo(const GlyphAtlas& atlas, Size size) {
   FML_UNREACHABLE();
 }
 
-/// Append as many glyphs to the texture as will fit, and return the first index
-/// of [extra_pairs] that did not fit.
+/// Append as many glyphs, starting at [start_index], to the texture as will
+/// fit, and return the first index of [extra_pairs] that did not fit.
+///
+/// Glyphs are placed below the height adjustment by [rect_packer] if possible,
+/// and otherwise into space freed by evictions above it.
 static size_t AppendToExistingAtlas(
     const std::shared_ptr<GlyphAtlas>& atlas,
     const std::vector<FontGlyphPair>& extra_pairs,
@@ -106,33 +126,127 @@ static size_t AppendToExistingAtlas(
     const std::vector<Rect>& glyph_sizes,
     ISize atlas_size,
     int64_t height_adjustment,
-    const std::shared_ptr<RectanglePacker>& rect_packer) {
+    const std::shared_ptr<RectanglePacker>& rect_packer,
+    const std::shared_ptr<RectanglePacker>& filled_region_packer,
+    size_t start_index) {
   TRACE_EVENT0("impeller", __FUNCTION__);
   if (!rect_packer || atlas_size.IsEmpty()) {
-    return 0;
+    return start_index;
   }
 
-  for (size_t i = 0; i < extra_pairs.size(); i++) {
+  for (size_t i = start_index; i < extra_pairs.size(); i++) {
     ISize glyph_size = ISize::Ceil(glyph_sizes[i].GetSize());
     IPoint16 location_in_atlas;
+    int64_t y_offset = height_adjustment;
     if (!rect_packer->AddRect(glyph_size.width + kPadding,   //
                               glyph_size.height + kPadding,  //
                               &location_in_atlas             //
                               )) {
-      return i;
+      if (!filled_region_packer ||
+          !filled_region_packer->AddRect(glyph_size.width + kPadding,   //
+                                         glyph_size.height + kPadding,  //
+                                         &location_in_atlas             //
+                                         )) {
+        return i;
+      }
+      y_offset = 0;
     }
     // Position the glyph in the center of the 1px padding.
     glyph_positions.push_back(Rect::MakeXYWH(
-        location_in_atlas.x() + 1,                      //
-        location_in_atlas.y() + height_adjustment + 1,  //
-        glyph_size.width,                               //
-        glyph_size.height                               //
+        location_in_atlas.x() + 1,             //
+        location_in_atlas.y() + y_offset + 1,  //
+        glyph_size.width,                      //
+        glyph_size.height                      //
         ));
   }
 
   return extra_pairs.size();
 }
 
+/// Remove the glyphs that have not been used for at least
+/// [kMinimumGlyphEvictionAge] generations from the atlas, and hand their space
+/// to the atlas context to be freed once the GPU work that was submitted
+/// before the eviction has completed. Return the number of glyphs that were
+/// evicted.
+static size_t EvictUnusedGlyphs(const Context& context,
+                                GlyphAtlas& atlas,
+                                GlyphAtlasContext& atlas_context) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  const size_t generation = atlas.GetAtlasGeneration();
+  if (!atlas_context.GetRectPacker() || generation < kMinimumGlyphEvictionAge) {
+    return 0;
+  }
+
+  std::vector<IRect> regions;
+  size_t evicted = atlas.RemoveGlyphs([&](const ScaledFont& scaled_font,
+                                          const SubpixelGlyph& glyph,
+                                          const FrameBounds& bounds) {
+    if (bounds.is_placeholder ||
+        bounds.last_used_generation + kMinimumGlyphEvictionAge > generation) {
+      return false;
+    }
+    // The glyph along with the 1px of padding on each side.
+    regions.push_back(IRect::RoundOut(bounds.atlas_bounds).Expand(1));
+    return true;
+  });
+  if (evicted == 0) {
+    return 0;
+  }
+  atlas_context.RecordEvictedGlyphs(evicted);
+
+  // Frames that sample the evicted glyphs have all been submitted by now, as
+  // glyphs are only evicted before the text of a frame is drawn. An empty
+  // command buffer submitted after them completes once they have. On OpenGLES
+  // this happens as soon as it is submitted, which is safe as texture uploads
+  // are ordered after the draws that were issued before them.
+  auto retired = std::make_shared<std::atomic<bool>>(false);
+  std::shared_ptr<CommandBuffer> fence = context.CreateCommandBuffer();
+  if (fence) {
+    fence->SetLabel("GlyphAtlas Eviction Fence");
+    if (!context.GetCommandQueue()
+             ->Submit({std::move(fence)},
+                      [retired](CommandBuffer::Status) {
+                        retired->store(true, std::memory_order_release);
+                      })
+             .ok()) {
+      VALIDATION_LOG << "Failed to submit glyph atlas eviction fence";
+    }
+  }
+  atlas_context.AddEvictedRegions(std::move(regions), std::move(retired));
+  return evicted;
+}
+
+/// The fraction of the area of the atlas that is in use.
+static Scalar ComputeAtlasOccupancy(const GlyphAtlasContext& atlas_context) {
+  const ISize atlas_size = atlas_context.GetAtlasSize();
+  const int64_t height_adjustment = atlas_context.GetHeightAdjustment();
+  if (atlas_size.IsEmpty()) {
+    return 0;
+  }
+  Scalar used_area = 0;
+  if (const auto& packer = atlas_context.GetRectPacker()) {
+    used_area += packer->PercentFull() * atlas_size.width *
+                 (atlas_size.height - height_adjustment);
+  }
+  if (const auto& packer = atlas_context.GetFilledRegionPacker()) {
+    used_area += packer->PercentFull() * atlas_size.width * height_adjustment;
+  }
+  return used_area / atlas_size.Area();
+}
+
+/// Report the number of glyphs in the atlas, how much of it is in use, and
+/// how many glyphs have been evicted from it to the timeline.
+static void TraceGlyphAtlasCounters(const GlyphAtlasContext& atlas_context) {
+  const std::shared_ptr<GlyphAtlas>& atlas = atlas_context.GetGlyphAtlas();
+  int64_t percent_full =
+      static_cast<int64_t>(100 * ComputeAtlasOccupancy(atlas_context));
+  FML_TRACE_COUNTER("impeller", "GlyphAtlas",
+                    reinterpret_cast<int64_t>(&atlas_context),  // Counter ID
+                    "GlyphCount", atlas->GetGlyphCount(),       //
+                    "PercentFull", percent_full,                //
+                    "EvictedGlyphs", atlas_context.GetEvictedGlyphCount());
+}
+
 static size_t PairsFitInAtlasOfSize(
     const std::vector<FontGlyphPair>& pairs,
     const ISize& atlas_size,
@@ -259,7 +373,8 @@ static void DrawGlyph(SkCanvas* canvas,
   canvas->restore();
 }
 
-/// @brief Batch render to a single surface.
+/// @brief Batch render to a single surface that covers the bounds of the new
+///        glyphs, and upload only that region of the texture.
 ///
 /// This is only safe for use when updating a fresh texture.
 static bool BulkUpdateAtlasBitmap(const GlyphAtlas& atlas,
@@ -273,11 +388,29 @@ static bool BulkUpdateAtlasBitmap(const GlyphAtlas& atlas,
 
   bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
 
+  // The region of the texture covered by the new glyphs and their padding.
+  std::optional<IRect> dirty_rect;
+  for (size_t i = start_index; i < end_index; i++) {
+    auto data = atlas.FindFontGlyphBounds(new_pairs[i]);
+    if (!data.has_value() || data->atlas_bounds.IsEmpty()) {
+      continue;
+    }
+    IRect glyph_rect = IRect::RoundOut(data->atlas_bounds).Expand(1);
+    dirty_rect = IRect::Union(dirty_rect, glyph_rect);
+  }
+  if (dirty_rect.has_value()) {
+    dirty_rect = dirty_rect->Intersection(IRect::MakeSize(texture->GetSize()));
+  }
+  if (!dirty_rect.has_value()) {
+    return blit_pass->ConvertTextureToShaderRead(texture);
+  }
+
   SkBitmap bitmap;
-  bitmap.setInfo(GetImageInfo(atlas, Size(texture->GetSize())));
+  bitmap.setInfo(GetImageInfo(atlas, Size(dirty_rect->GetSize())));
   if (!bitmap.tryAllocPixels()) {
     return false;
   }
+  bitmap.eraseColor(SK_ColorTRANSPARENT);
 
   auto surface = SkSurfaces::WrapPixels(bitmap.pixmap());
   if (!surface) {
@@ -294,31 +427,32 @@ static bool BulkUpdateAtlasBitmap(const GlyphAtlas& atlas,
     if (!data.has_value()) {
       continue;
     }
-    auto [pos, bounds, placeholder] = data.value();
-    FML_DCHECK(!placeholder);
+    const Rect& pos = data->atlas_bounds;
+    FML_DCHECK(!data->is_placeholder);
     Size size = pos.GetSize();
     if (size.IsEmpty()) {
       continue;
     }
 
-    DrawGlyph(canvas, SkPoint::Make(pos.GetLeft(), pos.GetTop()),
-              pair.scaled_font, pair.glyph, bounds, pair.glyph.properties,
-              has_color);
+    DrawGlyph(canvas,
+              SkPoint::Make(pos.GetLeft() - dirty_rect->GetLeft(),
+                            pos.GetTop() - dirty_rect->GetTop()),
+              pair.scaled_font, pair.glyph, data->glyph_bounds,
+              pair.glyph.properties, has_color);
   }
 
   // Writing to a malloc'd buffer and then copying to the staging buffers
   // benchmarks as substantially faster on a number of Android devices.
   BufferView buffer_view = data_host_buffer.Emplace(
       bitmap.getAddr(0, 0),
-      texture->GetSize().Area() *
+      dirty_rect->Area() *
           BytesPerPixelForPixelFormat(
               atlas.GetTexture()->GetTextureDescriptor().format),
       data_host_buffer.GetMinimumUniformAlignment());
 
   return blit_pass->AddCopy(std::move(buffer_view),  //
                             texture,                 //
-                            IRect::MakeXYWH(0, 0, texture->GetSize().width,
-                                            texture->GetSize().height));
+                            dirty_rect.value());
 }
 
 static bool UpdateAtlasBitmap(const GlyphAtlas& atlas,
@@ -338,8 +472,9 @@ static bool UpdateAtlasBitmap(const GlyphAtlas& atlas,
     if (!data.has_value()) {
       continue;
     }
-    auto [pos, bounds, placeholder] = data.value();
-    FML_DCHECK(!placeholder);
+    const Rect& pos = data->atlas_bounds;
+    const Rect& bounds = data->glyph_bounds;
+    FML_DCHECK(!data->is_placeholder);
 
     Size size = pos.GetSize();
     if (size.IsEmpty()) {
@@ -425,6 +560,7 @@ TypographerContextSkia::CollectNewGlyphs(
     const std::vector<RenderableText>& renderable_texts) {
   std::vector<FontGlyphPair> new_glyphs;
   std::vector<Rect> glyph_sizes;
+  const size_t generation = atlas->GetAtlasGeneration();
   for (const auto& frame : renderable_texts) {
     Rational rounded_scale = TextFrame::RoundScaledFontSize(
         frame.origin_transform.GetMaxBasisLengthXY());
@@ -456,10 +592,7 @@ TypographerContextSkia::CollectNewGlyphs(
             frame.origin_transform);
         SubpixelGlyph subpixel_glyph(glyph_position.glyph, subpixel,
                                      frame.properties);
-        const auto& font_glyph_bounds =
-            font_glyph_atlas->FindGlyphBounds(subpixel_glyph);
-
-        if (!font_glyph_bounds.has_value()) {
+        if (!font_glyph_atlas->MarkGlyphUsed(subpixel_glyph, generation)) {
           new_glyphs.push_back(FontGlyphPair{scaled_font, subpixel_glyph});
           auto glyph_bounds = ComputeGlyphSize(
               sk_font, subpixel_glyph, static_cast<Scalar>(scaled_font.scale));
@@ -468,7 +601,8 @@ TypographerContextSkia::CollectNewGlyphs(
           auto frame_bounds = FrameBounds{
               Rect::MakeLTRB(0, 0, 0, 0),  //
               glyph_bounds,                //
-              /*placeholder=*/true         //
+              /*placeholder=*/true,        //
+              generation                   //
           };
 
           font_glyph_atlas->AppendGlyph(subpixel_glyph, frame_bounds);
@@ -506,6 +640,17 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
   if (new_glyphs.size() == 0) {
     return last_atlas;
   }
+  last_atlas->SetAtlasGeneration(last_atlas->GetAtlasGeneration() + 1);
+
+  const int64_t max_texture_height =
+      context.GetResourceAllocator()->GetMaxTextureSizeSupported().height;
+  // OpenGLES cannot reliably perform the blit required to grow the atlas, as
+  // 1) it requires attaching textures as read and write framebuffers which
+  // has substantially smaller size limits that max textures and 2) is missing
+  // a GLES 2.0 implementation and cap check.
+  const bool can_grow_atlas =
+      atlas_context->GetAtlasSize().height < max_texture_height &&
+      context.GetBackendType() != Context::BackendType::kOpenGLES;
 
   // ---------------------------------------------------------------------------
   // Step 2: Determine if the additional missing glyphs can be appended to the
@@ -516,11 +661,35 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
   size_t first_missing_index = 0;
 
   if (last_atlas->GetTexture()) {
-    // Append all glyphs that fit into the current atlas.
+    // Append all glyphs that fit into the current atlas, including the space
+    // of evicted glyphs that the GPU no longer samples.
+    atlas_context->FreeRetiredRegions();
     first_missing_index = AppendToExistingAtlas(
         last_atlas, new_glyphs, glyph_positions, glyph_sizes,
         atlas_context->GetAtlasSize(), atlas_context->GetHeightAdjustment(),
-        atlas_context->GetRectPacker());
+        atlas_context->GetRectPacker(), atlas_context->GetFilledRegionPacker(),
+        /*start_index=*/0);
+
+    // -------------------------------------------------------------------------
+    // Step 2b: If the atlas cannot grow, make room for glyphs by evicting the
+    //          glyphs that have not been used recently rather than
+    //          regenerating the whole atlas. Their space is reused once the
+    //          GPU is done with them, which is usually by a later frame, so
+    //          atlases evict before they are completely full.
+    // -------------------------------------------------------------------------
+    if (!can_grow_atlas &&
+        (first_missing_index < new_glyphs.size() ||
+         ComputeAtlasOccupancy(*atlas_context) >= kGlyphEvictionOccupancy)) {
+      EvictUnusedGlyphs(context, *last_atlas, *atlas_context);
+    }
+    if (first_missing_index < new_glyphs.size() &&
+        atlas_context->FreeRetiredRegions()) {
+      first_missing_index = AppendToExistingAtlas(
+          last_atlas, new_glyphs, glyph_positions, glyph_sizes,
+          atlas_context->GetAtlasSize(), atlas_context->GetHeightAdjustment(),
+          atlas_context->GetRectPacker(),
+          atlas_context->GetFilledRegionPacker(), first_missing_index);
+    }
 
     // ---------------------------------------------------------------------------
     // Step 3a: Record the positions in the glyph atlas of the newly added
@@ -553,23 +722,18 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
 
     // If all glyphs fit, just return the old atlas.
     if (first_missing_index == new_glyphs.size()) {
+      TraceGlyphAtlasCounters(*atlas_context);
       return last_atlas;
     }
   }
 
   int64_t height_adjustment = atlas_context->GetAtlasSize().height;
-  const int64_t max_texture_height =
-      context.GetResourceAllocator()->GetMaxTextureSizeSupported().height;
 
-  // IF the current atlas size is as big as it can get, then "GC" and create an
-  // atlas with only the required glyphs. OpenGLES cannot reliably perform the
-  // blit required here, as 1) it requires attaching textures as read and write
-  // framebuffers which has substantially smaller size limits that max textures
-  // and 2) is missing a GLES 2.0 implementation and cap check.
+  // IF the current atlas cannot grow and evicting unused glyphs did not make
+  // enough room, then "GC" and create an atlas with only the required glyphs.
   bool blit_old_atlas = true;
   std::shared_ptr<GlyphAtlas> new_atlas = last_atlas;
-  if (atlas_context->GetAtlasSize().height >= max_texture_height ||
-      context.GetBackendType() == Context::BackendType::kOpenGLES) {
+  if (!can_grow_atlas) {
     blit_old_atlas = false;
     new_atlas = std::make_shared<GlyphAtlas>(
         type, /*initial_generation=*/last_atlas->GetAtlasGeneration() + 1);
@@ -668,6 +832,7 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
   // Step 8b: Record the texture in the glyph atlas.
   // ---------------------------------------------------------------------------
 
+  TraceGlyphAtlasCounters(*atlas_context);
   return new_atlas;
 }
 
@@ -36,14 +36,83 @@ std::shared_ptr<RectanglePacker> GlyphAtlasContext::GetRectPacker() const {
 void GlyphAtlasContext::UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas,
                                          ISize size,
                                          int64_t height_adjustment) {
+  if (height_adjustment == 0) {
+    filled_region_packer_ = nullptr;
+  } else if (height_adjustment != height_adjustment_ ||
+             !filled_region_packer_) {
+    // Fill the whole region so that only the space of evicted glyphs is ever
+    // handed out again.
+    filled_region_packer_ =
+        RectanglePacker::Factory(size.width, height_adjustment);
+    IPoint16 location;
+    filled_region_packer_->AddRect(size.width, height_adjustment, &location);
+  }
   atlas_ = std::move(atlas);
   atlas_size_ = size;
   height_adjustment_ = height_adjustment;
+  evicted_regions_.clear();
 }
 
 void GlyphAtlasContext::UpdateRectPacker(
     std::shared_ptr<RectanglePacker> rect_packer) {
   rect_packer_ = std::move(rect_packer);
+  evicted_regions_.clear();
+}
+
+std::shared_ptr<RectanglePacker> GlyphAtlasContext::GetFilledRegionPacker()
+    const {
+  return filled_region_packer_;
+}
+
+size_t GlyphAtlasContext::GetEvictedGlyphCount() const {
+  return evicted_glyph_count_;
+}
+
+void GlyphAtlasContext::RecordEvictedGlyphs(size_t count) {
+  evicted_glyph_count_ += count;
+}
+
+void GlyphAtlasContext::AddEvictedRegions(
+    std::vector<IRect> regions,
+    std::shared_ptr<const std::atomic<bool>> retired) {
+  if (regions.empty()) {
+    return;
+  }
+  evicted_regions_.push_back(EvictedRegions{
+      .regions = std::move(regions),
+      .retired = std::move(retired),
+  });
+}
+
+bool GlyphAtlasContext::FreeRetiredRegions() {
+  bool freed = false;
+  for (auto it = evicted_regions_.begin(); it != evicted_regions_.end();) {
+    if (!it->retired->load(std::memory_order_acquire)) {
+      ++it;
+      continue;
+    }
+    for (const IRect& region : it->regions) {
+      if (region.GetTop() >= height_adjustment_) {
+        if (rect_packer_) {
+          rect_packer_->FreeRect(
+              IPoint16{static_cast<int16_t>(region.GetLeft()),
+                       static_cast<int16_t>(region.GetTop() -
+                                            height_adjustment_)},
+              static_cast<int>(region.GetWidth()),
+              static_cast<int>(region.GetHeight()));
+        }
+      } else if (filled_region_packer_) {
+        filled_region_packer_->FreeRect(
+            IPoint16{static_cast<int16_t>(region.GetLeft()),
+                     static_cast<int16_t>(region.GetTop())},
+            static_cast<int>(region.GetWidth()),
+            static_cast<int>(region.GetHeight()));
+      }
+    }
+    it = evicted_regions_.erase(it);
+    freed = true;
+  }
+  return freed;
 }
 
 GlyphAtlas::GlyphAtlas(Type type, size_t initial_generation)
@@ -80,8 +149,35 @@ void GlyphAtlas::AddTypefaceGlyphPositionAndBounds(const FontGlyphPair& pair,
                                                    Rect bounds) {
   FontAtlasMap::iterator it = font_atlas_map_.find(pair.scaled_font);
   FML_DCHECK(it != font_atlas_map_.end());
-  it->second.positions_[pair.glyph] =
-      FrameBounds{position, bounds, /*is_placeholder=*/false};
+  FrameBounds& frame_bounds = it->second.positions_[pair.glyph];
+  frame_bounds.atlas_bounds = position;
+  frame_bounds.glyph_bounds = bounds;
+  frame_bounds.is_placeholder = false;
+}
+
+size_t GlyphAtlas::RemoveGlyphs(
+    const std::function<bool(const ScaledFont& scaled_font,
+                             const SubpixelGlyph& glyph,
+                             const FrameBounds& bounds)>& predicate) {
+  size_t removed = 0u;
+  for (auto font_it = font_atlas_map_.begin();
+       font_it != font_atlas_map_.end();) {
+    FontGlyphAtlas::PositionsMap& positions = font_it->second.positions_;
+    for (auto glyph_it = positions.begin(); glyph_it != positions.end();) {
+      if (predicate(font_it->first, glyph_it->first, glyph_it->second)) {
+        positions.erase(glyph_it++);
+        removed++;
+      } else {
+        ++glyph_it;
+      }
+    }
+    if (positions.empty()) {
+      font_atlas_map_.erase(font_it++);
+    } else {
+      ++font_it;
+    }
+  }
+  return removed;
 }
 
 std::optional<FrameBounds> GlyphAtlas::FindFontGlyphBounds(
@@ -151,4 +247,14 @@ void FontGlyphAtlas::AppendGlyph(const SubpixelGlyph& glyph,
   positions_[glyph] = frame_bounds;
 }
 
+bool FontGlyphAtlas::MarkGlyphUsed(const SubpixelGlyph& glyph,
+                                   size_t generation) {
+  auto found = positions_.find(glyph);
+  if (found == positions_.end()) {
+    return false;
+  }
+  found->second.last_used_generation = generation;
+  return true;
+}
+
 }  // namespace impeller
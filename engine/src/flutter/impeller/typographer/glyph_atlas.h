@@ -5,9 +5,11 @@
 #ifndef FLUTTER_IMPELLER_TYPOGRAPHER_GLYPH_ATLAS_H_
 #define FLUTTER_IMPELLER_TYPOGRAPHER_GLYPH_ATLAS_H_
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "impeller/core/texture.h"
 #include "impeller/geometry/rect.h"
@@ -27,6 +29,10 @@ struct FrameBounds {
   /// Whether [atlas_bounds] are still a placeholder and have
   /// not yet been computed.
   bool is_placeholder = true;
+  /// The generation of the atlas when the glyph was last used to render a
+  /// frame. Glyphs that have not been used for a few generations may be
+  /// evicted to make room for new ones.
+  size_t last_used_generation = 0;
 };
 
 //------------------------------------------------------------------------------
@@ -118,6 +124,19 @@ class GlyphAtlas {
                                const SubpixelGlyph& glyph,
                                const Rect& rect)>& iterator) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Remove glyphs from the atlas. Fonts that no longer have any
+  ///             glyphs are removed as well.
+  ///
+  /// @param[in]  predicate  Returns `true` for the glyphs to remove.
+  ///
+  /// @return     The number of glyphs removed.
+  ///
+  size_t RemoveGlyphs(
+      const std::function<bool(const ScaledFont& scaled_font,
+                               const SubpixelGlyph& glyph,
+                               const FrameBounds& bounds)>& predicate);
+
   //----------------------------------------------------------------------------
   /// @brief      Find the location of a specific font-glyph pair in the atlas.
   ///
@@ -163,7 +182,8 @@ class GlyphAtlas {
   ///
   ///             The generation id is used to match with a TextFrame to
   ///             determine if the frame is guaranteed to already be populated
-  ///             in the atlas.
+  ///             in the atlas. It is advanced whenever glyphs are added to or
+  ///             evicted from the atlas.
   size_t GetAtlasGeneration() const;
 
   //----------------------------------------------------------------------------
@@ -226,11 +246,56 @@ class GlyphAtlasContext {
 
   void UpdateRectPacker(std::shared_ptr<RectanglePacker> rect_packer);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the rect packer for the region of the atlas above
+  ///             the height adjustment, or nullptr if there is none.
+  ///
+  ///             That region was filled before the atlas last grew. The packer
+  ///             starts out full, and only has room for glyphs once glyphs
+  ///             in the region have been evicted and freed back into it.
+  std::shared_ptr<RectanglePacker> GetFilledRegionPacker() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The total number of glyphs that have been evicted from the
+  ///             atlases of this context to make room for new glyphs.
+  size_t GetEvictedGlyphCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Record that glyphs were evicted from the current atlas.
+  void RecordEvictedGlyphs(size_t count);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Record the space, including padding, of glyphs that were
+  ///             evicted from the current atlas.
+  ///
+  ///             The space is not handed out again until [retired] is set,
+  ///             which must only happen once the GPU has completed all work
+  ///             submitted before the eviction, as that work may still sample
+  ///             the evicted glyphs. Regions that have not been freed when the
+  ///             atlas is replaced or grows are dropped.
+  void AddEvictedRegions(std::vector<IRect> regions,
+                         std::shared_ptr<const std::atomic<bool>> retired);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Free the space of evicted glyphs whose work has retired back
+  ///             into the rect packers.
+  ///
+  /// @return     Whether any space was freed.
+  bool FreeRetiredRegions();
+
  private:
+  struct EvictedRegions {
+    std::vector<IRect> regions;
+    std::shared_ptr<const std::atomic<bool>> retired;
+  };
+
   std::shared_ptr<GlyphAtlas> atlas_;
   ISize atlas_size_;
   std::shared_ptr<RectanglePacker> rect_packer_;
-  int64_t height_adjustment_;
+  std::shared_ptr<RectanglePacker> filled_region_packer_;
+  int64_t height_adjustment_ = 0;
+  size_t evicted_glyph_count_ = 0;
+  std::vector<EvictedRegions> evicted_regions_;
 
   GlyphAtlasContext(const GlyphAtlasContext&) = delete;
 
@@ -263,6 +328,17 @@ class FontGlyphAtlas {
   ///             at a later time, as indicated by FrameBounds.placeholder.
   void AppendGlyph(const SubpixelGlyph& glyph, const FrameBounds& frame_bounds);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Record that a glyph in this atlas is used by the frame that is
+  ///             being prepared.
+  ///
+  /// @param[in]  glyph       The glyph
+  /// @param[in]  generation  The current generation of the glyph atlas.
+  ///
+  /// @return     Whether the glyph is in the atlas.
+  ///
+  bool MarkGlyphUsed(const SubpixelGlyph& glyph, size_t generation);
+
  private:
   friend class GlyphAtlas;
 
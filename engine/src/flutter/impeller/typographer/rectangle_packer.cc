@@ -5,6 +5,7 @@
 #include "impeller/typographer/rectangle_packer.h"
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -16,6 +17,9 @@ namespace impeller {
 // Based, in part, on Jukka Jylanki's work at http://clb.demon.fi
 // and ported from Skia's implementation
 // https://github.com/google/skia/blob/b5de4b8ae95c877a9ecfad5eab0765bc22550301/src/gpu/RectanizerSkyline.cpp
+//
+// Rectangles that are freed are kept in a list of free rectangles below the
+// skyline, which are split guillotine style when they are reused.
 class SkylineRectanglePacker final : public RectanglePacker {
  public:
   SkylineRectanglePacker(int w, int h) : RectanglePacker(w, h) { Reset(); }
@@ -26,10 +30,13 @@ class SkylineRectanglePacker final : public RectanglePacker {
     area_so_far_ = 0;
     skyline_.clear();
     skyline_.push_back(SkylineSegment{0, 0, width()});
+    free_rects_.clear();
   }
 
   bool AddRect(int w, int h, IPoint16* loc) final;
 
+  void FreeRect(IPoint16 loc, int w, int h) final;
+
   Scalar PercentFull() const final {
     return area_so_far_ / (static_cast<float>(width()) * height());
   }
@@ -41,10 +48,23 @@ class SkylineRectanglePacker final : public RectanglePacker {
     int width_;
   };
 
+  struct FreeRectangle {
+    int x_;
+    int y_;
+    int width_;
+    int height_;
+  };
+
   std::vector<SkylineSegment> skyline_;
 
+  std::vector<FreeRectangle> free_rects_;
+
   int32_t area_so_far_;
 
+  // Place a width x height rect in the free rectangle that it fits most
+  // tightly, if any, splitting the remainder of that free rectangle in two.
+  bool AddRectToFreeList(int width, int height, IPoint16* loc);
+
   // Can a width x height rectangle fit in the free space represented by
   // the skyline segments >= 'skyline_index'? If so, return true and fill in
   // 'y' with the y-location at which it fits (the x location is pulled from
@@ -65,6 +85,11 @@ bool SkylineRectanglePacker::AddRect(int p_width, int p_height, IPoint16* loc) {
     return false;
   }
 
+  if (AddRectToFreeList(p_width, p_height, loc)) {
+    area_so_far_ += p_width * p_height;
+    return true;
+  }
+
   // find position for new rectangle
   int bestWidth = width() + 1;
   int bestX = 0;
@@ -98,6 +123,93 @@ bool SkylineRectanglePacker::AddRect(int p_width, int p_height, IPoint16* loc) {
   return false;
 }
 
+bool SkylineRectanglePacker::AddRectToFreeList(int p_width,
+                                               int p_height,
+                                               IPoint16* loc) {
+  // Best area fit: minimize the area left over in the free rect.
+  int best_index = -1;
+  int64_t best_area = std::numeric_limits<int64_t>::max();
+  for (auto i = 0u; i < free_rects_.size(); ++i) {
+    const FreeRectangle& rect = free_rects_[i];
+    if (rect.width_ < p_width || rect.height_ < p_height) {
+      continue;
+    }
+    int64_t area = static_cast<int64_t>(rect.width_) * rect.height_;
+    if (area < best_area) {
+      best_index = i;
+      best_area = area;
+    }
+  }
+  if (best_index == -1) {
+    return false;
+  }
+
+  FreeRectangle rect = free_rects_[best_index];
+  free_rects_.erase(free_rects_.begin() + best_index);
+  loc->x_ = rect.x_;
+  loc->y_ = rect.y_;
+
+  // Split the remainder along the shorter leftover axis so that the larger
+  // of the two remaining rects is as big as possible.
+  int width_left = rect.width_ - p_width;
+  int height_left = rect.height_ - p_height;
+  FreeRectangle right;
+  FreeRectangle bottom;
+  if (width_left < height_left) {
+    right = {rect.x_ + p_width, rect.y_, width_left, p_height};
+    bottom = {rect.x_, rect.y_ + p_height, rect.width_, height_left};
+  } else {
+    right = {rect.x_ + p_width, rect.y_, width_left, rect.height_};
+    bottom = {rect.x_, rect.y_ + p_height, p_width, height_left};
+  }
+  if (right.width_ > 0 && right.height_ > 0) {
+    free_rects_.push_back(right);
+  }
+  if (bottom.width_ > 0 && bottom.height_ > 0) {
+    free_rects_.push_back(bottom);
+  }
+  return true;
+}
+
+void SkylineRectanglePacker::FreeRect(IPoint16 loc, int p_width, int p_height) {
+  FML_DCHECK(loc.x() >= 0 && loc.x() + p_width <= width());
+  FML_DCHECK(loc.y() >= 0 && loc.y() + p_height <= height());
+  if (p_width <= 0 || p_height <= 0) {
+    return;
+  }
+  area_so_far_ -= p_width * p_height;
+
+  // Merge the freed rect with free neighbors that share a whole edge with it,
+  // so that the space of adjacent rects of the same size can be reused for
+  // a larger one.
+  FreeRectangle freed = {loc.x(), loc.y(), p_width, p_height};
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (auto i = 0u; i < free_rects_.size(); ++i) {
+      const FreeRectangle& other = free_rects_[i];
+      if (other.y_ == freed.y_ && other.height_ == freed.height_ &&
+          (other.x_ + other.width_ == freed.x_ ||
+           freed.x_ + freed.width_ == other.x_)) {
+        freed.x_ = std::min(freed.x_, other.x_);
+        freed.width_ += other.width_;
+        merged = true;
+      } else if (other.x_ == freed.x_ && other.width_ == freed.width_ &&
+                 (other.y_ + other.height_ == freed.y_ ||
+                  freed.y_ + freed.height_ == other.y_)) {
+        freed.y_ = std::min(freed.y_, other.y_);
+        freed.height_ += other.height_;
+        merged = true;
+      }
+      if (merged) {
+        free_rects_.erase(free_rects_.begin() + i);
+        break;
+      }
+    }
+  }
+  free_rects_.push_back(freed);
+}
+
 bool SkylineRectanglePacker::RectangleFits(size_t skyline_index,
                                            int p_width,
                                            int p_height,
@@ -46,7 +46,18 @@ class RectanglePacker {
   virtual bool AddRect(int width, int height, IPoint16* loc) = 0;
 
   //----------------------------------------------------------------------------
-  /// @brief     Returns how much area has been filled with rectangles.
+  /// @brief     Return the area of a previously added rect to the packer so
+  ///            that later calls to |AddRect| can reuse it.
+  ///
+  /// @param[in]   loc     The position returned by |AddRect| for the rect.
+  /// @param[in]   width   The width the rect was added with.
+  /// @param[in]   height  The height the rect was added with.
+  ///
+  virtual void FreeRect(IPoint16 loc, int width, int height) = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief     Returns how much area has been filled with rectangles,
+  ///            excluding the area of rectangles that have been freed.
   ///
   /// @return    Percentage as a decimal between 0.0 and 1.0
   ///
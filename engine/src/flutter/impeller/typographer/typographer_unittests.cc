@@ -437,6 +437,148 @@ TEST(TypographerTest, RectanglePackerFillsRows) {
   EXPECT_EQ(loc.y(), 16);
 }
 
+TEST(TypographerTest, RectanglePackerReusesFreedRectangles) {
+  auto packer = RectanglePacker::Factory(200, 100);
+
+  IPoint16 first;
+  IPoint16 second;
+  ASSERT_TRUE(packer->AddRect(100, 100, &first));
+  ASSERT_TRUE(packer->AddRect(100, 100, &second));
+  ASSERT_TRUE(flutter::testing::NumberNear(packer->PercentFull(), 1.0));
+  IPoint16 output;
+  ASSERT_FALSE(packer->AddRect(1, 1, &output));
+
+  packer->FreeRect(first, 100, 100);
+  EXPECT_TRUE(flutter::testing::NumberNear(packer->PercentFull(), 0.5));
+
+  // The freed area is split up between the rects that are added to it.
+  ASSERT_TRUE(packer->AddRect(50, 50, &output));
+  EXPECT_EQ(output.x(), first.x());
+  EXPECT_EQ(output.y(), first.y());
+  ASSERT_TRUE(packer->AddRect(50, 100, &output));
+  EXPECT_EQ(output.x(), first.x() + 50);
+  EXPECT_EQ(output.y(), first.y());
+  ASSERT_TRUE(packer->AddRect(50, 50, &output));
+  EXPECT_EQ(output.x(), first.x());
+  EXPECT_EQ(output.y(), first.y() + 50);
+
+  EXPECT_TRUE(flutter::testing::NumberNear(packer->PercentFull(), 1.0));
+  EXPECT_FALSE(packer->AddRect(1, 1, &output));
+}
+
+TEST(TypographerTest, RectanglePackerMergesAdjacentFreedRectangles) {
+  auto packer = RectanglePacker::Factory(200, 100);
+
+  IPoint16 locations[4];
+  for (auto& location : locations) {
+    ASSERT_TRUE(packer->AddRect(50, 100, &location));
+  }
+
+  packer->FreeRect(locations[1], 50, 100);
+  packer->FreeRect(locations[2], 50, 100);
+
+  // Neither freed rect is wide enough on its own.
+  IPoint16 output;
+  ASSERT_TRUE(packer->AddRect(100, 100, &output));
+  EXPECT_EQ(output.x(), 50);
+  EXPECT_EQ(output.y(), 0);
+
+  packer->Reset();
+  EXPECT_EQ(packer->PercentFull(), 0);
+  ASSERT_TRUE(packer->AddRect(200, 100, &output));
+}
+
+TEST(TypographerTest, GlyphAtlasContextFreesEvictedRegionsOnceRetired) {
+  GlyphAtlasContext atlas_context(GlyphAtlas::Type::kAlphaBitmap);
+  atlas_context.UpdateGlyphAtlas(atlas_context.GetGlyphAtlas(), {100, 100},
+                                 /*height_adjustment=*/0);
+  atlas_context.UpdateRectPacker(RectanglePacker::Factory(100, 100));
+  std::shared_ptr<RectanglePacker> packer = atlas_context.GetRectPacker();
+  IPoint16 location;
+  ASSERT_TRUE(packer->AddRect(100, 100, &location));
+
+  auto retired = std::make_shared<std::atomic<bool>>(false);
+  atlas_context.AddEvictedRegions({IRect::MakeXYWH(0, 0, 50, 50)}, retired);
+
+  // The GPU may still sample the evicted glyphs.
+  EXPECT_FALSE(atlas_context.FreeRetiredRegions());
+  EXPECT_FALSE(packer->AddRect(50, 50, &location));
+
+  retired->store(true);
+  EXPECT_TRUE(atlas_context.FreeRetiredRegions());
+  EXPECT_FALSE(atlas_context.FreeRetiredRegions());
+  ASSERT_TRUE(packer->AddRect(50, 50, &location));
+  EXPECT_EQ(location.x(), 0);
+  EXPECT_EQ(location.y(), 0);
+}
+
+TEST(TypographerTest, GlyphAtlasContextDropsEvictedRegionsOfReplacedAtlas) {
+  GlyphAtlasContext atlas_context(GlyphAtlas::Type::kAlphaBitmap);
+  atlas_context.UpdateGlyphAtlas(atlas_context.GetGlyphAtlas(), {100, 100},
+                                 /*height_adjustment=*/0);
+  atlas_context.UpdateRectPacker(RectanglePacker::Factory(100, 100));
+
+  auto retired = std::make_shared<std::atomic<bool>>(true);
+  atlas_context.AddEvictedRegions({IRect::MakeXYWH(0, 0, 50, 50)}, retired);
+  atlas_context.UpdateRectPacker(RectanglePacker::Factory(100, 100));
+
+  EXPECT_FALSE(atlas_context.FreeRetiredRegions());
+  EXPECT_EQ(atlas_context.GetRectPacker()->PercentFull(), 0);
+}
+
+TEST_P(TypographerTest, GlyphAtlasEvictsUnusedGlyphsInsteadOfRegenerating) {
+  if (GetBackend() != PlaygroundBackend::kOpenGLES) {
+    GTEST_SKIP() << "Atlases on other backends grow to the maximum texture "
+                    "size before evicting glyphs.";
+  }
+
+  auto data_host_buffer = HostBuffer::Create(
+      GetContext()->GetResourceAllocator(), GetContext()->GetIdleWaiter(),
+      GetContext()->GetCapabilities()->GetMinimumUniformAlignment());
+  auto context = TypographerContextSkia::Make();
+  auto atlas_context =
+      context->CreateGlyphAtlasContext(GlyphAtlas::Type::kAlphaBitmap);
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont sk_font = flutter::testing::CreateTestFontOfSize(20);
+  auto frame =
+      MakeTextFrameFromTextBlobSkia(SkTextBlob::MakeFromString("A", sk_font));
+
+  // Draw the glyph at a smaller scale every frame, so that each glyph fits
+  // in the space of any of the glyphs drawn before it.
+  std::shared_ptr<GlyphAtlas> atlas;
+  for (int i = 0; i < 30; i++) {
+    std::shared_ptr<Texture> previous_texture =
+        atlas ? atlas->GetTexture() : nullptr;
+    Scalar scale = 40.0f - i;
+    atlas = CreateGlyphAtlas(*GetContext(), context.get(), *data_host_buffer,
+                             GlyphAtlas::Type::kAlphaBitmap,
+                             Matrix::MakeScale({scale, scale, 1.0f}),
+                             atlas_context, frame);
+    ASSERT_TRUE(!!atlas);
+    if (atlas_context->GetEvictedGlyphCount() == 0) {
+      continue;
+    }
+
+    // The atlas made room for the new glyph in place.
+    EXPECT_EQ(atlas->GetTexture(), previous_texture);
+    EXPECT_EQ(atlas->GetGlyphCount() + atlas_context->GetEvictedGlyphCount(),
+              static_cast<size_t>(i + 1));
+    // The glyph of this frame was placed in the atlas.
+    Rational rounded_scale = TextFrame::RoundScaledFontSize(scale);
+    size_t placed_count = 0u;
+    atlas->IterateGlyphs([&](const ScaledFont& scaled_font,
+                             const SubpixelGlyph& glyph, const Rect& rect) {
+      if (scaled_font.scale == rounded_scale && !rect.IsEmpty()) {
+        placed_count++;
+      }
+      return true;
+    });
+    EXPECT_EQ(placed_count, 1u);
+    return;
+  }
+  FAIL() << "No glyphs were evicted.";
+}
+
 TEST_P(TypographerTest, GlyphAtlasTextureWillGrowTilMaxTextureSize) {
   if (GetBackend() == PlaygroundBackend::kOpenGLES) {
     GTEST_SKIP() << "Atlas growth isn't supported for OpenGLES currently.";
@@ -15,6 +15,7 @@
 #include "flutter/lib/ui/dart_runtime_hooks.h"
 #include "flutter/lib/ui/isolate_name_server/isolate_name_server_natives.h"
 #include "flutter/lib/ui/painting/canvas.h"
+#include "flutter/lib/ui/painting/chunked_image_buffer.h"
 #include "flutter/lib/ui/painting/codec.h"
 #include "flutter/lib/ui/painting/color_filter.h"
 #include "flutter/lib/ui/painting/engine_layer.h"
@@ -69,6 +70,7 @@ typedef CanvasPath Path;
 #define FFI_FUNCTION_LIST(V)                                       \
   /* Constructors */                                               \
   V(Canvas::Create)                                                \
+  V(ChunkedImageBuffer::Create)                                    \
   V(ColorFilter::Create)                                           \
   V(FragmentProgram::Create)                                       \
   V(ReusableFragmentShader::Create)                                \
@@ -180,6 +182,11 @@ typedef CanvasPath Path;
   V(Canvas, skew)                                \
   V(Canvas, transform)                           \
   V(Canvas, translate)                           \
+  V(ChunkedImageBuffer, add)                     \
+  V(ChunkedImageBuffer, close)                   \
+  V(ChunkedImageBuffer, dispose)                 \
+  V(ChunkedImageBuffer, instantiateCodec)        \
+  V(ChunkedImageBuffer, length)                  \
   V(Codec, dispose)                              \
   V(Codec, frameCount)                           \
   V(Codec, getNextFrame)                         \
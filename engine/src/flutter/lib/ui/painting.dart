@@ -8975,6 +8975,72 @@ base class ImmutableBuffer extends NativeFieldWrapperClass1 {
   external void _dispose();
 }
 
+/// A buffer for the encoded bytes of an image that arrive in chunks, for
+/// example while the image is downloaded, that can be decoded before all of
+/// its bytes have arrived.
+///
+/// Add the bytes with [add] as they arrive and call [close] once all of them
+/// have been added. The [Codec] returned by [instantiateCodec] decodes the
+/// image while its bytes arrive. Each call to [Codec.getNextFrame] completes
+/// with the newest partially decoded preview of the image that it has not
+/// returned yet, or with the final image once the buffer is closed and fully
+/// decoded. Rows of a preview that are not decoded yet are transparent.
+///
+/// PNG and GIF previews contain the rows decoded so far. Other formats, such
+/// as JPEG and WebP, produce fewer previews, and none if their codec cannot
+/// decode truncated data. Images are decoded at their full size.
+///
+/// Progressive decoding requires Impeller. With other renderers, the codec
+/// completes with an error.
+base class ChunkedImageBuffer extends NativeFieldWrapperClass1 {
+  /// Creates an empty buffer.
+  ChunkedImageBuffer() {
+    _constructor();
+  }
+
+  @Native<Void Function(Handle)>(symbol: 'ChunkedImageBuffer::Create')
+  external void _constructor();
+
+  /// Copies [bytes] to the end of the buffer.
+  ///
+  /// Throws a [StateError] if the buffer has been closed.
+  void add(Uint8List bytes) {
+    final String? error = _add(bytes);
+    if (error != null) {
+      throw StateError(error);
+    }
+  }
+
+  @Native<Handle Function(Pointer<Void>, Handle)>(symbol: 'ChunkedImageBuffer::add')
+  external String? _add(Uint8List bytes);
+
+  /// Marks the buffer as complete. No further bytes may be added.
+  @Native<Void Function(Pointer<Void>)>(symbol: 'ChunkedImageBuffer::close', isLeaf: true)
+  external void close();
+
+  /// The number of bytes added so far.
+  int get length => _length();
+
+  @Native<Uint64 Function(Pointer<Void>)>(symbol: 'ChunkedImageBuffer::length', isLeaf: true)
+  external int _length();
+
+  /// Creates a codec that decodes the image while its bytes are added to this
+  /// buffer.
+  Codec instantiateCodec() {
+    final Codec codec = _NativeCodec._();
+    _instantiateCodec(codec);
+    return codec;
+  }
+
+  @Native<Void Function(Pointer<Void>, Handle)>(symbol: 'ChunkedImageBuffer::instantiateCodec')
+  external void _instantiateCodec(Codec outCodec);
+
+  /// Closes the buffer and releases its resources. A decode in progress
+  /// finishes with the bytes added so far.
+  @Native<Void Function(Pointer<Void>)>(symbol: 'ChunkedImageBuffer::dispose')
+  external void dispose();
+}
+
 /// A descriptor of data that can be turned into an [Image] via a [Codec].
 ///
 /// Use this class to determine the height, width, and byte size of image data
@@ -0,0 +1,54 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/chunked_image_buffer.h"
+
+#include "flutter/lib/ui/painting/progressive_codec.h"
+#include "flutter/lib/ui/ui_dart_state.h"
+#include "third_party/tonic/converter/dart_converter.h"
+#include "third_party/tonic/typed_data/typed_list.h"
+
+namespace flutter {
+
+IMPLEMENT_WRAPPERTYPEINFO(ui, ChunkedImageBuffer);
+
+void ChunkedImageBuffer::Create(Dart_Handle wrapper) {
+  UIDartState::ThrowIfUIOperationsProhibited();
+  auto res = fml::MakeRefCounted<ChunkedImageBuffer>();
+  res->AssociateWithDartWrapper(wrapper);
+}
+
+ChunkedImageBuffer::ChunkedImageBuffer()
+    : data_(std::make_shared<ChunkedImageData>()) {}
+
+ChunkedImageBuffer::~ChunkedImageBuffer() {
+  // A decode still waiting for bytes would otherwise never finish.
+  data_->Close();
+}
+
+Dart_Handle ChunkedImageBuffer::add(Dart_Handle data) {
+  tonic::Uint8List list(data);
+  auto chunk = SkData::MakeWithCopy(list.data(), list.num_elements());
+  list.Release();
+  if (!data_->Append(std::move(chunk))) {
+    return tonic::ToDart("Bytes cannot be added to a closed buffer");
+  }
+  return Dart_Null();
+}
+
+void ChunkedImageBuffer::close() {
+  data_->Close();
+}
+
+void ChunkedImageBuffer::instantiateCodec(Dart_Handle codec_handle) {
+  auto codec = fml::MakeRefCounted<ProgressiveCodec>(data_);
+  codec->AssociateWithDartWrapper(codec_handle);
+}
+
+void ChunkedImageBuffer::dispose() {
+  data_->Close();
+  ClearDartWrapper();
+}
+
+}  // namespace flutter
@@ -0,0 +1,56 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_CHUNKED_IMAGE_BUFFER_H_
+#define FLUTTER_LIB_UI_PAINTING_CHUNKED_IMAGE_BUFFER_H_
+
+#include <memory>
+
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/dart_wrapper.h"
+#include "flutter/lib/ui/painting/chunked_image_data.h"
+
+namespace flutter {
+
+/// The Dart peer of a `ChunkedImageBuffer`, which receives the encoded bytes
+/// of an image in chunks and decodes them progressively.
+class ChunkedImageBuffer : public RefCountedDartWrappable<ChunkedImageBuffer> {
+  DEFINE_WRAPPERTYPEINFO();
+  FML_FRIEND_MAKE_REF_COUNTED(ChunkedImageBuffer);
+
+ public:
+  ~ChunkedImageBuffer() override;
+
+  static void Create(Dart_Handle wrapper);
+
+  /// Copies the bytes of the Dart `Uint8List` `data` into the buffer.
+  ///
+  /// Returns an error message if the buffer is already closed.
+  Dart_Handle add(Dart_Handle data);
+
+  /// Marks the buffer as complete. No further bytes may be added.
+  void close();
+
+  /// The number of bytes added so far.
+  size_t length() const { return data_->GetSize(); }
+
+  /// Creates a `ProgressiveCodec` over the buffer and registers `codec_handle`
+  /// as its Dart peer.
+  void instantiateCodec(Dart_Handle codec_handle);
+
+  /// Closes the buffer, so that any decode in progress finishes with the bytes
+  /// added so far, and clears the Dart native fields.
+  void dispose();
+
+ private:
+  ChunkedImageBuffer();
+
+  std::shared_ptr<ChunkedImageData> data_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ChunkedImageBuffer);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_CHUNKED_IMAGE_BUFFER_H_
@@ -0,0 +1,166 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/chunked_image_data.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+namespace {
+
+class ChunkedImageDataStream final : public SkStreamRewindable {
+ public:
+  explicit ChunkedImageDataStream(std::shared_ptr<const ChunkedImageData> data)
+      : data_(std::move(data)) {}
+
+  // |SkStream|
+  size_t read(void* buffer, size_t size) override {
+    size_t read = 0;
+    if (buffer) {
+      read = data_->Read(position_, buffer, size);
+    } else {
+      // A null buffer skips bytes.
+      size_t available = data_->GetSize();
+      read = position_ < available ? std::min(size, available - position_) : 0;
+    }
+    position_ += read;
+    return read;
+  }
+
+  // |SkStream|
+  size_t peek(void* buffer, size_t size) const override {
+    return data_->Read(position_, buffer, size);
+  }
+
+  // |SkStream|
+  bool isAtEnd() const override {
+    // Check closed before the size, which is final once closed.
+    return data_->IsClosed() && position_ >= data_->GetSize();
+  }
+
+  // |SkStreamRewindable|
+  bool rewind() override {
+    position_ = 0;
+    return true;
+  }
+
+ private:
+  // |SkStream|
+  SkStreamRewindable* onDuplicate() const override {
+    return new ChunkedImageDataStream(data_);
+  }
+
+  std::shared_ptr<const ChunkedImageData> data_;
+  size_t position_ = 0;
+};
+
+}  // namespace
+
+ChunkedImageData::ChunkedImageData() = default;
+
+ChunkedImageData::~ChunkedImageData() = default;
+
+bool ChunkedImageData::Append(sk_sp<SkData> chunk) {
+  DataCallback callback;
+  {
+    std::scoped_lock lock(mutex_);
+    if (closed_) {
+      FML_DLOG(ERROR) << "Attempted to append to closed image data.";
+      return false;
+    }
+    if (!chunk || chunk->isEmpty()) {
+      return true;
+    }
+    offsets_.push_back(size_);
+    size_ += chunk->size();
+    chunks_.push_back(std::move(chunk));
+    callback = data_callback_;
+  }
+  if (callback) {
+    callback();
+  }
+  return true;
+}
+
+void ChunkedImageData::Close() {
+  DataCallback callback;
+  {
+    std::scoped_lock lock(mutex_);
+    if (closed_) {
+      return;
+    }
+    closed_ = true;
+    callback = data_callback_;
+  }
+  if (callback) {
+    callback();
+  }
+}
+
+bool ChunkedImageData::IsClosed() const {
+  std::scoped_lock lock(mutex_);
+  return closed_;
+}
+
+size_t ChunkedImageData::GetSize() const {
+  std::scoped_lock lock(mutex_);
+  return size_;
+}
+
+size_t ChunkedImageData::Read(size_t offset,
+                              void* buffer,
+                              size_t length) const {
+  std::scoped_lock lock(mutex_);
+  if (offset >= size_ || length == 0) {
+    return 0;
+  }
+  // Find the last chunk that starts at or before the offset.
+  auto it = std::upper_bound(offsets_.begin(), offsets_.end(), offset);
+  size_t index = std::distance(offsets_.begin(), it) - 1;
+  auto* destination = static_cast<uint8_t*>(buffer);
+  size_t copied = 0;
+  while (copied < length && index < chunks_.size()) {
+    const sk_sp<SkData>& chunk = chunks_[index];
+    size_t chunk_offset = offset + copied - offsets_[index];
+    size_t count = std::min(length - copied, chunk->size() - chunk_offset);
+    if (destination) {
+      std::memcpy(destination + copied, chunk->bytes() + chunk_offset, count);
+    }
+    copied += count;
+    index++;
+  }
+  return copied;
+}
+
+sk_sp<SkData> ChunkedImageData::GetData() const {
+  std::scoped_lock lock(mutex_);
+  if (chunks_.empty()) {
+    return SkData::MakeEmpty();
+  }
+  if (chunks_.size() == 1) {
+    return chunks_.front();
+  }
+  sk_sp<SkData> data = SkData::MakeUninitialized(size_);
+  auto* destination = static_cast<uint8_t*>(data->writable_data());
+  for (size_t i = 0; i < chunks_.size(); i++) {
+    std::memcpy(destination + offsets_[i], chunks_[i]->data(),
+                chunks_[i]->size());
+  }
+  return data;
+}
+
+void ChunkedImageData::SetDataCallback(DataCallback callback) {
+  std::scoped_lock lock(mutex_);
+  data_callback_ = std::move(callback);
+}
+
+std::unique_ptr<SkStream> ChunkedImageData::MakeStream() {
+  return std::make_unique<ChunkedImageDataStream>(shared_from_this());
+}
+
+}  // namespace flutter
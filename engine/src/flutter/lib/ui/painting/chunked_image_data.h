@@ -0,0 +1,90 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_CHUNKED_IMAGE_DATA_H_
+#define FLUTTER_LIB_UI_PAINTING_CHUNKED_IMAGE_DATA_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkStream.h"
+
+namespace flutter {
+
+/// @brief  The encoded bytes of an image that are received in chunks over
+///         time, for example while the image is downloaded or read from disk.
+///
+///         Chunks may be appended on one thread while decoders read the bytes
+///         received so far on other threads. Appended chunks are never
+///         modified, so reading does not copy them. Once all bytes have been
+///         appended, the data is closed and |GetData| returns the complete
+///         encoded image, suitable for an `ImmutableBuffer`.
+class ChunkedImageData
+    : public std::enable_shared_from_this<ChunkedImageData> {
+ public:
+  /// Invoked on the thread that appended the bytes or closed the data.
+  using DataCallback = std::function<void()>;
+
+  ChunkedImageData();
+
+  ~ChunkedImageData();
+
+  /// @brief  Appends a chunk of bytes.
+  ///
+  /// @return Whether the chunk was appended. Chunks may not be appended once
+  ///         the data is closed.
+  bool Append(sk_sp<SkData> chunk);
+
+  /// @brief  Marks the data as complete. No further chunks may be appended.
+  void Close();
+
+  /// @brief  Whether all chunks have been appended.
+  bool IsClosed() const;
+
+  /// @brief  The number of bytes appended so far.
+  size_t GetSize() const;
+
+  /// @brief  Copies up to |length| bytes starting at |offset| from the bytes
+  ///         appended so far.
+  ///
+  /// @return The number of bytes copied, which is less than |length| if fewer
+  ///         bytes have been appended.
+  size_t Read(size_t offset, void* buffer, size_t length) const;
+
+  /// @brief  All bytes appended so far, as a single buffer. This only copies
+  ///         the bytes if they were appended in more than one chunk.
+  sk_sp<SkData> GetData() const;
+
+  /// @brief  Sets the callback invoked whenever bytes are appended or the
+  ///         data is closed. Replaces any previous callback.
+  void SetDataCallback(DataCallback callback);
+
+  /// @brief  Creates a stream over the bytes appended so far, and those that
+  ///         are appended later.
+  ///
+  ///         A read past the bytes appended so far returns fewer bytes than
+  ///         requested, but the stream is only at its end once the data is
+  ///         closed. This is what `SkCodec` expects for incremental decoding
+  ///         of incomplete input.
+  std::unique_ptr<SkStream> MakeStream();
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<sk_sp<SkData>> chunks_;
+  // The offset of each chunk in the data.
+  std::vector<size_t> offsets_;
+  size_t size_ = 0;
+  bool closed_ = false;
+  DataCallback data_callback_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ChunkedImageData);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_CHUNKED_IMAGE_DATA_H_
@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/chunked_image_data.h"
+
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+sk_sp<SkData> MakeChunk(const std::string& text) {
+  return SkData::MakeWithCopy(text.data(), text.size());
+}
+
+}  // namespace
+
+TEST(ChunkedImageDataTest, ReadsAcrossChunks) {
+  auto data = std::make_shared<ChunkedImageData>();
+  ASSERT_TRUE(data->Append(MakeChunk("abc")));
+  ASSERT_TRUE(data->Append(MakeChunk("de")));
+  ASSERT_TRUE(data->Append(MakeChunk("fghi")));
+  EXPECT_EQ(data->GetSize(), 9u);
+
+  char buffer[16] = {};
+  EXPECT_EQ(data->Read(2, buffer, 5), 5u);
+  EXPECT_EQ(std::string(buffer, 5), "cdefg");
+
+  // Reads are short at the end of the appended bytes.
+  EXPECT_EQ(data->Read(7, buffer, 5), 2u);
+  EXPECT_EQ(std::string(buffer, 2), "hi");
+  EXPECT_EQ(data->Read(9, buffer, 5), 0u);
+}
+
+TEST(ChunkedImageDataTest, GetDataAvoidsCopyForSingleChunk) {
+  auto data = std::make_shared<ChunkedImageData>();
+  sk_sp<SkData> chunk = MakeChunk("abc");
+  ASSERT_TRUE(data->Append(chunk));
+  EXPECT_EQ(data->GetData().get(), chunk.get());
+
+  ASSERT_TRUE(data->Append(MakeChunk("def")));
+  sk_sp<SkData> combined = data->GetData();
+  ASSERT_EQ(combined->size(), 6u);
+  EXPECT_EQ(std::memcmp(combined->data(), "abcdef", 6), 0);
+}
+
+TEST(ChunkedImageDataTest, CannotAppendAfterClose) {
+  auto data = std::make_shared<ChunkedImageData>();
+  ASSERT_TRUE(data->Append(MakeChunk("abc")));
+  EXPECT_FALSE(data->IsClosed());
+  data->Close();
+  EXPECT_TRUE(data->IsClosed());
+  EXPECT_FALSE(data->Append(MakeChunk("def")));
+  EXPECT_EQ(data->GetSize(), 3u);
+}
+
+TEST(ChunkedImageDataTest, InvokesDataCallback) {
+  auto data = std::make_shared<ChunkedImageData>();
+  int calls = 0;
+  data->SetDataCallback([&calls]() { calls++; });
+  data->Append(MakeChunk("abc"));
+  // Empty chunks are ignored.
+  data->Append(SkData::MakeEmpty());
+  data->Close();
+  data->Close();
+  EXPECT_EQ(calls, 2);
+}
+
+TEST(ChunkedImageDataTest, StreamIsOnlyAtEndWhenClosed) {
+  auto data = std::make_shared<ChunkedImageData>();
+  data->Append(MakeChunk("abc"));
+  std::unique_ptr<SkStream> stream = data->MakeStream();
+
+  char buffer[16] = {};
+  EXPECT_EQ(stream->peek(buffer, 2), 2u);
+  EXPECT_EQ(std::string(buffer, 2), "ab");
+  EXPECT_EQ(stream->read(buffer, 8), 3u);
+  EXPECT_EQ(std::string(buffer, 3), "abc");
+  EXPECT_FALSE(stream->isAtEnd());
+
+  data->Append(MakeChunk("de"));
+  EXPECT_EQ(stream->read(buffer, 8), 2u);
+  EXPECT_EQ(std::string(buffer, 2), "de");
+  EXPECT_FALSE(stream->isAtEnd());
+
+  data->Close();
+  EXPECT_TRUE(stream->isAtEnd());
+
+  ASSERT_TRUE(stream->rewind());
+  EXPECT_EQ(stream->skip(4), 4u);
+  EXPECT_EQ(stream->read(buffer, 8), 1u);
+  EXPECT_EQ(buffer[0], 'e');
+}
+
+}  // namespace testing
+}  // namespace flutter
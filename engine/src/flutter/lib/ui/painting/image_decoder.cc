@@ -55,6 +55,15 @@ ImageDecoder::ImageDecoder(
 
 ImageDecoder::~ImageDecoder() = default;
 
+void ImageDecoder::DecodeProgressive(
+    std::shared_ptr<ChunkedImageData> /*data*/,
+    const ProgressiveImageResult& result) {
+  runners_.GetUITaskRunner()->PostTask([result]() {
+    result(nullptr, "Progressive image decoding requires Impeller.",
+           /*is_complete=*/true);
+  });
+}
+
 fml::TaskRunnerAffineWeakPtr<ImageDecoder> ImageDecoder::GetWeakPtr() const {
   return weak_factory_.GetWeakPtr();
 }
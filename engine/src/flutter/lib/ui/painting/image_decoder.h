@@ -5,7 +5,9 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_H_
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_H_
 
+#include <functional>
 #include <memory>
+#include <string>
 
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
@@ -16,6 +18,8 @@
 
 namespace flutter {
 
+class ChunkedImageData;
+
 // An object that coordinates image decompression and texture upload across
 // multiple threads/components in the shell. This object must be created,
 // accessed and collected on the UI thread (typically the engine or its runtime
@@ -58,6 +62,26 @@ class ImageDecoder {
                       const Options& options,
                       const ImageResult& result) = 0;
 
+  // Invoked with an image, or an error message, and whether this is the final
+  // result of a progressive decode.
+  using ProgressiveImageResult =
+      std::function<void(sk_sp<DlImage>, std::string, bool is_complete)>;
+
+  // Decodes an image while its encoded bytes are still being received, and
+  // returns previews of the partially decoded image on the UI thread as more
+  // bytes arrive. PNG and GIF previews contain the rows decoded so far. Other
+  // formats, such as JPEG and WebP, are decoded again from the bytes received
+  // so far whenever those have doubled, and produce a preview only if their
+  // codec can decode truncated data; progressive JPEGs and WebPs usually
+  // cannot. Rows that are not decoded yet are transparent. The last result has
+  // `is_complete` set. Images are decoded at their full size. |data| must
+  // eventually be closed for the decode to finish.
+  //
+  // Only the Impeller decoder supports progressive decoding. Others report an
+  // error.
+  virtual void DecodeProgressive(std::shared_ptr<ChunkedImageData> data,
+                                 const ProgressiveImageResult& result);
+
   fml::TaskRunnerAffineWeakPtr<ImageDecoder> GetWeakPtr() const;
 
  protected:
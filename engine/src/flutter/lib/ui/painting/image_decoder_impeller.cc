@@ -4,8 +4,11 @@
 
 #include "flutter/lib/ui/painting/image_decoder_impeller.h"
 
+#include <cstring>
 #include <format>
 #include <memory>
+#include <mutex>
+#include <optional>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/make_copyable.h"
@@ -15,11 +18,13 @@
 #include "flutter/impeller/display_list/dl_image_impeller.h"
 #include "flutter/impeller/renderer/command_buffer.h"
 #include "flutter/impeller/renderer/context.h"
+#include "flutter/lib/ui/painting/chunked_image_data.h"
 #include "impeller/core/device_buffer.h"
 #include "impeller/core/formats.h"
 #include "impeller/core/texture_descriptor.h"
 #include "impeller/display_list/skia_conversions.h"
 #include "impeller/geometry/size.h"
+#include "third_party/skia/include/codec/SkCodec.h"
 #include "third_party/skia/include/core/SkAlphaType.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkColorSpace.h"
@@ -285,6 +290,301 @@ impeller::PixelFormat ToImpellerPixelFormat(
       return impeller::PixelFormat::kUnknown;
   }
 }
+
+// Drives a progressive decode of a |ChunkedImageData| as its bytes arrive.
+//
+// PNG and GIF are decoded incrementally from a stream over the data, which
+// Skia reads without copying it. Other formats, such as JPEG and WebP, either
+// do not support incremental decoding or copy their whole stream up front,
+// which would spin until the data is closed. They are decoded from scratch
+// from the bytes received so far whenever those have doubled, which bounds
+// the total work to twice that of a single decode.
+//
+// Decode steps run on the concurrent task runner, one at a time, so the codec
+// and bitmap are never accessed concurrently. The decoder is kept alive by the
+// data callback until the decode finishes.
+class ProgressiveDecoder
+    : public std::enable_shared_from_this<ProgressiveDecoder> {
+ public:
+  ProgressiveDecoder(
+      std::shared_ptr<ChunkedImageData> data,
+      std::shared_ptr<impeller::Context> context,
+      std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
+      fml::RefPtr<fml::TaskRunner> io_runner,
+      ImageDecoderImpeller::ProgressiveImageResult result)
+      : data_(std::move(data)),
+        context_(std::move(context)),
+        concurrent_task_runner_(std::move(concurrent_task_runner)),
+        io_runner_(std::move(io_runner)),
+        result_(std::move(result)) {}
+
+  void Start() {
+    data_->SetDataCallback([self = shared_from_this()]() { self->OnData(); });
+    // Decode the bytes appended before the callback was set.
+    OnData();
+  }
+
+ private:
+  const std::shared_ptr<ChunkedImageData> data_;
+  const std::shared_ptr<impeller::Context> context_;
+  const std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
+  const fml::RefPtr<fml::TaskRunner> io_runner_;
+  const ImageDecoderImpeller::ProgressiveImageResult result_;
+
+  std::mutex mutex_;
+  bool step_pending_ = false;
+  bool data_pending_ = false;
+  bool finished_ = false;
+
+  // The number of bytes received before the first decode of a format that
+  // is not decoded incrementally.
+  static constexpr size_t kFirstSnapshotSize = 16u * 1024u;
+
+  // Only accessed by decode steps.
+  std::unique_ptr<SkCodec> codec_;
+  SkBitmap bitmap_;
+  bool incremental_started_ = false;
+  std::optional<bool> incremental_supported_;
+  int rows_decoded_ = 0;
+  size_t next_snapshot_size_ = kFirstSnapshotSize;
+
+  void OnData() {
+    std::scoped_lock lock(mutex_);
+    if (finished_) {
+      return;
+    }
+    if (step_pending_) {
+      // The pending step will schedule another once it is done.
+      data_pending_ = true;
+      return;
+    }
+    step_pending_ = true;
+    PostStep();
+  }
+
+  void PostStep() {
+    concurrent_task_runner_->PostTask(
+        [self = shared_from_this()]() { self->Step(); },
+        fml::ConcurrentTaskPriority::kLow);
+  }
+
+  void Step() {
+    TRACE_EVENT0("impeller", "ProgressiveDecoder::Step");
+    // Sampled before decoding. Bytes that arrive during the decode, including
+    // the close, schedule another step.
+    const bool closed = data_->IsClosed();
+    const bool finished = Decode(closed);
+
+    std::scoped_lock lock(mutex_);
+    if (finished) {
+      finished_ = true;
+      step_pending_ = false;
+      // Break the reference cycle through the data callback.
+      data_->SetDataCallback(nullptr);
+      return;
+    }
+    if (data_pending_) {
+      data_pending_ = false;
+      PostStep();
+    } else {
+      step_pending_ = false;
+    }
+  }
+
+  // Whether the encoded image is in a format that Skia decodes incrementally
+  // from a stream, judging by its first bytes.
+  static bool IsIncrementalFormat(const uint8_t* header, size_t size) {
+    static constexpr uint8_t kPngSignature[] = {0x89, 'P', 'N', 'G'};
+    static constexpr uint8_t kGifSignature[] = {'G', 'I', 'F', '8'};
+    return size >= 4u && (std::memcmp(header, kPngSignature, 4u) == 0 ||
+                          std::memcmp(header, kGifSignature, 4u) == 0);
+  }
+
+  // Decodes the bytes received so far. Returns whether the decode finished.
+  bool Decode(bool closed) {
+    if (!context_) {
+      DeliverError("No Impeller context is available");
+      return true;
+    }
+
+    if (!incremental_supported_.has_value()) {
+      uint8_t header[4];
+      const size_t header_size = data_->Read(0, header, sizeof(header));
+      if (header_size < sizeof(header) && !closed) {
+        return false;
+      }
+      incremental_supported_ = IsIncrementalFormat(header, header_size);
+    }
+    if (!incremental_supported_.value()) {
+      return DecodeSnapshot(closed);
+    }
+
+    if (!codec_) {
+      SkCodec::Result result;
+      codec_ = SkCodec::MakeFromStream(data_->MakeStream(), &result);
+      if (!codec_) {
+        if (result == SkCodec::kIncompleteInput && !closed) {
+          // Wait for the rest of the header.
+          return false;
+        }
+        DeliverError("Could not create a codec for the image data.");
+        return true;
+      }
+      if (!AllocateBitmap(codec_->getInfo())) {
+        return true;
+      }
+    }
+
+    if (!incremental_started_) {
+      SkCodec::Result start = codec_->startIncrementalDecode(
+          bitmap_.info(), bitmap_.getPixels(), bitmap_.rowBytes());
+      switch (start) {
+        case SkCodec::kSuccess:
+          incremental_started_ = true;
+          break;
+        case SkCodec::kUnimplemented:
+          incremental_supported_ = false;
+          codec_.reset();
+          return DecodeSnapshot(closed);
+        case SkCodec::kIncompleteInput:
+          if (!closed) {
+            return false;
+          }
+          [[fallthrough]];
+        default:
+          DeliverError(std::string("Could not start decoding image: ") +
+                       SkCodec::ResultToString(start));
+          return true;
+      }
+    }
+
+    int rows_decoded = 0;
+    SkCodec::Result result = codec_->incrementalDecode(&rows_decoded);
+    switch (result) {
+      case SkCodec::kSuccess:
+        DeliverBitmap(/*is_complete=*/true);
+        return true;
+      case SkCodec::kIncompleteInput:
+      case SkCodec::kErrorInInput:
+        if (closed) {
+          // No more bytes are coming. Like |SkCodec::getPixels|, the rows that
+          // could not be decoded are left as they are.
+          DeliverBitmap(/*is_complete=*/true);
+          return true;
+        }
+        if (rows_decoded > rows_decoded_) {
+          rows_decoded_ = rows_decoded;
+          DeliverBitmap(/*is_complete=*/false);
+        }
+        return false;
+      default:
+        DeliverError(std::string("Could not decode image: ") +
+                     SkCodec::ResultToString(result));
+        return true;
+    }
+  }
+
+  // Decodes the bytes received so far from scratch, if they have doubled
+  // since the last attempt, and delivers the result as a preview. Once the
+  // data is closed, decodes it all and delivers the final image.
+  bool DecodeSnapshot(bool closed) {
+    const size_t size = data_->GetSize();
+    if (!closed && size < next_snapshot_size_) {
+      return false;
+    }
+    next_snapshot_size_ = size * 2u;
+
+    SkCodec::Result result;
+    std::unique_ptr<SkCodec> codec =
+        SkCodec::MakeFromData(data_->GetData(), &result);
+    if (!codec) {
+      if (closed) {
+        DeliverError("Could not create a codec for the image data.");
+        return true;
+      }
+      return false;
+    }
+    if (bitmap_.isNull()) {
+      if (!AllocateBitmap(codec->getInfo())) {
+        return true;
+      }
+    } else if (codec->dimensions() != bitmap_.dimensions()) {
+      DeliverError("The dimensions of the image changed while decoding.");
+      return true;
+    }
+
+    result = codec->getPixels(bitmap_.pixmap());
+    if (result == SkCodec::kSuccess) {
+      DeliverBitmap(/*is_complete=*/true);
+      return true;
+    }
+    if (result != SkCodec::kIncompleteInput &&
+        result != SkCodec::kErrorInInput) {
+      if (closed) {
+        DeliverError(std::string("Could not decode image: ") +
+                     SkCodec::ResultToString(result));
+        return true;
+      }
+      // Such as a truncated progressive JPEG. Try again with more bytes.
+      return false;
+    }
+    // Like |SkCodec::getPixels|, the rows that could not be decoded are
+    // filled in.
+    DeliverBitmap(/*is_complete=*/closed);
+    return closed;
+  }
+
+  // Allocates the bitmap that the image is decoded into. Returns whether it
+  // was allocated, and delivers an error if it was not.
+  bool AllocateBitmap(const SkImageInfo& base_info) {
+    const SkImageInfo info =
+        base_info.makeColorType(kRGBA_8888_SkColorType)
+            .makeAlphaType(ChooseCompatibleAlphaType(base_info.alphaType()))
+            .makeColorSpace(SkColorSpace::MakeSRGB());
+    const impeller::ISize max_size =
+        context_->GetResourceAllocator()->GetMaxTextureSizeSupported();
+    if (info.width() > max_size.width || info.height() > max_size.height) {
+      DeliverError(std::format(
+          "Image dimensions ({}x{}) exceed the maximum texture size ({}x{}).",
+          info.width(), info.height(), max_size.width, max_size.height));
+      return false;
+    }
+    if (!bitmap_.tryAllocPixels(info)) {
+      DeliverError("Could not allocate image pixels.");
+      return false;
+    }
+    bitmap_.eraseColor(SK_ColorTRANSPARENT);
+    return true;
+  }
+
+  void DeliverBitmap(bool is_complete) {
+    auto bitmap = std::make_shared<SkBitmap>();
+    if (is_complete) {
+      // Nothing decodes into |bitmap_| anymore, so its pixels can be shared.
+      *bitmap = bitmap_;
+    } else if (!bitmap->tryAllocPixels(bitmap_.info()) ||
+               !bitmap_.readPixels(bitmap->pixmap())) {
+      // Previews are best effort.
+      return;
+    }
+    auto upload = [self = shared_from_this(), bitmap, is_complete]() {
+      auto [image, decode_error] =
+          ImageDecoderImpeller::UploadTextureToStorage(self->context_, bitmap);
+      self->result_(std::move(image), std::move(decode_error), is_complete);
+    };
+    // The I/O image uploads are not threadsafe on GLES.
+    if (context_->GetBackendType() ==
+        impeller::Context::BackendType::kOpenGLES) {
+      io_runner_->PostTask(upload);
+    } else {
+      upload();
+    }
+  }
+
+  void DeliverError(std::string decode_error) {
+    FML_DLOG(ERROR) << decode_error;
+    result_(nullptr, std::move(decode_error), /*is_complete=*/true);
+  }
 }  // namespace
 
 std::optional<impeller::PixelFormat> ImageDecoderImpeller::ToPixelFormat(
@@ -418,8 +718,12 @@ ImageDecoderImpeller::DecompressTexture(
   std::shared_ptr<ImpellerAllocator> bitmap_allocator =
       premultiplied->allocator;
 
-  if (source_size.width() > max_texture_size.width ||
-      source_size.height() > max_texture_size.height ||
+  // Codecs that support scaled decoding (such as JPEG through DCT scaling and
+  // WebP) have already done most of the resizing. The remaining scale factor
+  // can be applied on the GPU if the decoded image fits in a texture, even if
+  // the source image does not.
+  if (decode_size.width() > max_texture_size.width ||
+      decode_size.height() > max_texture_size.height ||
       !capabilities->SupportsTextureToTextureBlits()) {
     return ResizeOnCpu(bitmap, target_size, allocator);
   }
@@ -735,7 +1039,31 @@ void ImageDecoderImpeller::Decode(fml::RefPtr<ImageDescriptor> descriptor,
         } else {
           upload_texture_and_invoke_result();
         }
-      });
+      },
+      fml::ConcurrentTaskPriority::kLow);
+}
+
+void ImageDecoderImpeller::DecodeProgressive(
+    std::shared_ptr<ChunkedImageData> data,
+    const ProgressiveImageResult& p_result) {
+  FML_DCHECK(data);
+  FML_DCHECK(p_result);
+
+  // Wrap the result callback so that it can be invoked from any thread.
+  ProgressiveImageResult result =
+      [p_result, ui_runner = runners_.GetUITaskRunner()](
+          sk_sp<DlImage> image, std::string decode_error, bool is_complete) {
+        ui_runner->PostTask([p_result, image = std::move(image),
+                             decode_error = std::move(decode_error),
+                             is_complete]() {
+          p_result(image, decode_error, is_complete);
+        });
+      };
+
+  auto decoder = std::make_shared<ProgressiveDecoder>(
+      std::move(data), context_.get(), concurrent_task_runner_,
+      runners_.GetIOTaskRunner(), std::move(result));
+  decoder->Start();
 }
 
 ImpellerAllocator::ImpellerAllocator(
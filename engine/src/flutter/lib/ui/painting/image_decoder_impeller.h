@@ -58,6 +58,10 @@ class ImageDecoderImpeller final : public ImageDecoder {
               const Options& options,
               const ImageResult& result) override;
 
+  // |ImageDecoder|
+  void DecodeProgressive(std::shared_ptr<ChunkedImageData> data,
+                         const ProgressiveImageResult& result) override;
+
   struct ImageInfo {
     impeller::ISize size;
     impeller::PixelFormat format = impeller::PixelFormat::kUnknown;
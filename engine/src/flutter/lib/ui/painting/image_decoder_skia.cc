@@ -328,7 +328,8 @@ void ImageDecoderSkia::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
           // Finally, all done.
           result(std::move(uploaded), std::move(flow));
         }));
-      }));
+      }),
+      fml::ConcurrentTaskPriority::kLow);
 }
 
 }  // namespace flutter
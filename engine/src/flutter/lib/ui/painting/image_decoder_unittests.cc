@@ -11,6 +11,7 @@
 #include "flutter/impeller/display_list/dl_image_impeller.h"
 #include "flutter/impeller/geometry/size.h"
 #include "flutter/impeller/renderer/context.h"
+#include "flutter/lib/ui/painting/chunked_image_data.h"
 #include "flutter/lib/ui/painting/image_decoder.h"
 #include "flutter/lib/ui/painting/image_decoder_impeller.h"
 #include "flutter/lib/ui/painting/image_decoder_no_gl_unittests.h"
@@ -930,6 +931,51 @@ TEST(ImageDecoderTest, VerifySimpleDecoding) {
 #endif  // IMPELLER_SUPPORTS_RENDERING
 }
 
+TEST(ImageDecoderTest, ScaledDecodeThatFitsTextureIsResizedOnGpu) {
+#if !IMPELLER_SUPPORTS_RENDERING
+  GTEST_SKIP() << "Impeller only test.";
+#endif  // IMPELLER_SUPPORTS_RENDERING
+
+  auto data = flutter::testing::OpenFixtureAsSkData("DashInNooglerHat.jpg");
+  ASSERT_TRUE(data);
+  ImageGeneratorRegistry registry;
+  std::shared_ptr<ImageGenerator> generator =
+      registry.CreateCompatibleGenerator(data);
+  ASSERT_TRUE(generator);
+  auto descriptor = fml::MakeRefCounted<ImageDescriptor>(std::move(data),
+                                                         std::move(generator));
+
+  const impeller::ISize max_texture_size(1000, 1000);
+  ASSERT_GT(descriptor->width(), max_texture_size.width);
+  const uint32_t target_width = descriptor->width() / 10;
+  const uint32_t target_height = descriptor->height() / 10;
+  // JPEG decodes at the nearest DCT scale that is at least the target size.
+  const SkISize decode_size = descriptor->get_scaled_dimensions(0.1);
+  ASSERT_LE(decode_size.width(), max_texture_size.width);
+  ASSERT_LE(decode_size.height(), max_texture_size.height);
+  ASSERT_GT(decode_size.width(), static_cast<int>(target_width));
+
+  std::shared_ptr<impeller::Capabilities> capabilities =
+      impeller::CapabilitiesBuilder()
+          .SetSupportsTextureToTextureBlits(true)
+          .Build();
+  std::shared_ptr<impeller::Allocator> allocator =
+      std::make_shared<impeller::TestImpellerAllocator>();
+  auto result = ImageDecoderImpeller::DecompressTexture(
+      descriptor.get(),
+      {.target_width = target_width, .target_height = target_height},
+      max_texture_size, /*supports_wide_gamut=*/false, capabilities, allocator);
+  ASSERT_TRUE(result.ok());
+
+  // The source does not fit in a texture, but the scaled decode does, so the
+  // remaining scale factor is applied on the GPU.
+  EXPECT_EQ(result->image_info.size,
+            impeller::ISize(decode_size.width(), decode_size.height()));
+  ASSERT_TRUE(result->resize_info.has_value());
+  EXPECT_EQ(result->resize_info->width(), static_cast<int>(target_width));
+  EXPECT_EQ(result->resize_info->height(), static_cast<int>(target_height));
+}
+
 TEST(ImageDecoderTest, ImagesWithTransparencyArePremulAlpha) {
   auto data = flutter::testing::OpenFixtureAsSkData("heart_end.png");
   ASSERT_TRUE(data);
@@ -1052,6 +1098,242 @@ TEST_F(ImageDecoderFixtureTest,
   PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
 }
 
+TEST_F(ImageDecoderFixtureTest, MultiFrameCodecDecodesAhead) {
+  auto settings = CreateSettingsForFixture();
+  auto vm_ref = DartVMRef::Create(settings);
+
+  auto gif_mapping =
+      flutter::testing::OpenFixtureAsSkData("four_frame_with_reuse.gif");
+  ASSERT_TRUE(gif_mapping);
+
+  ImageGeneratorRegistry registry;
+  std::shared_ptr<ImageGenerator> gif_generator =
+      registry.CreateCompatibleGenerator(gif_mapping);
+  ASSERT_TRUE(gif_generator);
+  ASSERT_EQ(gif_generator->GetFrameCount(), 4u);
+  const size_t frame_byte_size = gif_generator->GetInfo()
+                                     .makeColorType(kN32_SkColorType)
+                                     .computeMinByteSize();
+
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  fml::AutoResetWaitableEvent frame_latch;
+  AddNativeCallback("ValidateFrameCallback",
+                    CREATE_NATIVE_ENTRY([&frame_latch](Dart_NativeArguments) {
+                      frame_latch.Signal();
+                    }));
+
+  std::unique_ptr<TestIOManager> io_manager;
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+  });
+
+  auto isolate = RunDartCodeInIsolate(vm_ref, settings, runners, "main", {},
+                                      GetDefaultKernelFilePath(),
+                                      io_manager->GetWeakIOManager());
+
+  fml::RefPtr<MultiFrameCodec> codec;
+  auto make_codec = [&](MultiFrameCodec::DecodeAheadOptions options) {
+    PostTaskSync(runners.GetUITaskRunner(), [&]() {
+      EXPECT_TRUE(isolate->RunInIsolateScope([&]() -> bool {
+        codec = fml::MakeRefCounted<MultiFrameCodec>(gif_generator, options);
+        return true;
+      }));
+    });
+  };
+  auto get_next_frame = [&]() {
+    PostTaskSync(runners.GetUITaskRunner(), [&]() {
+      EXPECT_TRUE(isolate->RunInIsolateScope([&]() -> bool {
+        Dart_Handle closure = Dart_GetField(
+            Dart_RootLibrary(), Dart_NewStringFromCString("frameCallback"));
+        if (Dart_IsError(closure) || !Dart_IsClosure(closure)) {
+          return false;
+        }
+        codec->getNextFrame(closure);
+        return true;
+      }));
+    });
+    frame_latch.Wait();
+    // Each decode ahead posts the next one to the IO task runner.
+    for (int i = 0; i < 4; i++) {
+      PostTaskSync(runners.GetIOTaskRunner(), []() {});
+    }
+  };
+
+  // Frames are decoded ahead up to the frame count of the options.
+  make_codec({.frame_count = 2, .byte_budget = 4 * frame_byte_size});
+  get_next_frame();
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    EXPECT_EQ(codec->state_->decodedFrames_.size(), 2u);
+    EXPECT_EQ(codec->state_->nextFrameIndex_, 3);
+    EXPECT_EQ(codec->state_->decodeAheadHits_, 0u);
+    EXPECT_EQ(codec->state_->decodeAheadMisses_, 1u);
+  });
+  get_next_frame();
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    EXPECT_EQ(codec->state_->decodedFrames_.size(), 2u);
+    // Decoding wraps around to the first frame.
+    EXPECT_EQ(codec->state_->nextFrameIndex_, 0);
+    EXPECT_EQ(codec->state_->decodeAheadHits_, 1u);
+    EXPECT_EQ(codec->state_->decodeAheadMisses_, 1u);
+  });
+
+  // The byte budget takes precedence over the frame count.
+  make_codec({.frame_count = 4, .byte_budget = frame_byte_size});
+  get_next_frame();
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    EXPECT_EQ(codec->state_->decodedFrames_.size(), 1u);
+    EXPECT_EQ(codec->state_->decodeAheadMisses_, 1u);
+  });
+
+  PostTaskSync(runners.GetUITaskRunner(), [&]() { codec = nullptr; });
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+}
+
+TEST_F(ImageDecoderFixtureTest, ImpellerDecodesProgressively) {
+#if !IMPELLER_SUPPORTS_RENDERING
+  GTEST_SKIP() << "Impeller only test.";
+#endif  // IMPELLER_SUPPORTS_RENDERING
+
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  std::unique_ptr<TestIOManager> io_manager;
+  std::unique_ptr<ImageDecoderImpeller> image_decoder;
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+  });
+
+  sk_sp<SkData> encoded = OpenFixtureAsSkData("heart_end.png");
+  ASSERT_TRUE(encoded);
+  auto data = std::make_shared<ChunkedImageData>();
+
+  fml::AutoResetWaitableEvent preview_latch;
+  fml::AutoResetWaitableEvent final_latch;
+  sk_sp<DlImage> final_image;
+  size_t previews = 0;
+  size_t previews_before_final = 0;
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    image_decoder = std::make_unique<ImageDecoderImpeller>(
+        runners, loop->GetTaskRunner(), io_manager->GetWeakIOManager(),
+        /*supports_wide_gamut=*/false, std::make_shared<fml::SyncSwitch>());
+    image_decoder->DecodeProgressive(
+        data, [&](const sk_sp<DlImage>& image, const std::string& decode_error,
+                  bool is_complete) {
+          ASSERT_TRUE(runners.GetUITaskRunner()->RunsTasksOnCurrentThread());
+          EXPECT_EQ(decode_error, "");
+          if (is_complete) {
+            previews_before_final = previews;
+            final_image = image;
+            final_latch.Signal();
+            return;
+          }
+          EXPECT_TRUE(image);
+          if (previews++ == 0) {
+            preview_latch.Signal();
+          }
+        });
+  });
+
+  // Append the first half of the image in chunks, as if it was being
+  // downloaded, and wait for the preview of the rows decoded so far.
+  constexpr size_t kChunkSize = 4096;
+  const size_t half_size = encoded->size() / 2;
+  for (size_t offset = 0; offset < half_size; offset += kChunkSize) {
+    size_t size = std::min(kChunkSize, half_size - offset);
+    ASSERT_TRUE(data->Append(SkData::MakeSubset(encoded.get(), offset, size)));
+  }
+  ASSERT_FALSE(preview_latch.WaitWithTimeout(fml::TimeDelta::FromSeconds(10)));
+
+  ASSERT_TRUE(data->Append(SkData::MakeSubset(encoded.get(), half_size,
+                                              encoded->size() - half_size)));
+  data->Close();
+  final_latch.Wait();
+
+  ASSERT_TRUE(final_image);
+  EXPECT_EQ(final_image->GetSize(), DlISize(500, 500));
+  EXPECT_GE(previews_before_final, 1u);
+
+  PostTaskSync(runners.GetUITaskRunner(), [&]() { image_decoder.reset(); });
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+}
+
+TEST_F(ImageDecoderFixtureTest,
+       ImpellerDecodesWebPProgressivelyWithoutBlockingWorkers) {
+#if !IMPELLER_SUPPORTS_RENDERING
+  GTEST_SKIP() << "Impeller only test.";
+#endif  // IMPELLER_SUPPORTS_RENDERING
+
+  // A single worker, so that a decode step waiting for the rest of the bytes
+  // would keep every other task from running.
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  std::unique_ptr<TestIOManager> io_manager;
+  std::unique_ptr<ImageDecoderImpeller> image_decoder;
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+  });
+
+  sk_sp<SkData> encoded = OpenFixtureAsSkData("heart.webp");
+  ASSERT_TRUE(encoded);
+  auto data = std::make_shared<ChunkedImageData>();
+
+  fml::AutoResetWaitableEvent final_latch;
+  sk_sp<DlImage> final_image;
+  std::string final_error;
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    image_decoder = std::make_unique<ImageDecoderImpeller>(
+        runners, loop->GetTaskRunner(), io_manager->GetWeakIOManager(),
+        /*supports_wide_gamut=*/false, std::make_shared<fml::SyncSwitch>());
+    image_decoder->DecodeProgressive(
+        data, [&](const sk_sp<DlImage>& image, const std::string& decode_error,
+                  bool is_complete) {
+          if (is_complete) {
+            final_image = image;
+            final_error = decode_error;
+            final_latch.Signal();
+          }
+        });
+  });
+
+  const size_t half_size = encoded->size() / 2;
+  ASSERT_TRUE(data->Append(SkData::MakeSubset(encoded.get(), 0, half_size)));
+
+  // The worker runs tasks in order, so this only runs once the decode step
+  // for the first half has returned.
+  fml::AutoResetWaitableEvent probe_latch;
+  loop->GetTaskRunner()->PostTask([&]() { probe_latch.Signal(); });
+  ASSERT_FALSE(probe_latch.WaitWithTimeout(fml::TimeDelta::FromSeconds(10)));
+
+  ASSERT_TRUE(data->Append(SkData::MakeSubset(encoded.get(), half_size,
+                                              encoded->size() - half_size)));
+  data->Close();
+  final_latch.Wait();
+
+  ASSERT_TRUE(final_image);
+  EXPECT_EQ(final_error, "");
+  EXPECT_EQ(final_image->GetSize(), DlISize(500, 500));
+
+  PostTaskSync(runners.GetUITaskRunner(), [&]() { image_decoder.reset(); });
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+}
+
 TEST_F(ImageDecoderFixtureTest, NullCheckBuffer) {
   auto context = std::make_shared<impeller::TestImpellerContext>();
   auto allocator = ImpellerAllocator(context->GetResourceAllocator());
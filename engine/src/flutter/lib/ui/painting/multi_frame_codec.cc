@@ -8,6 +8,7 @@
 
 #include "display_list/image/dl_image.h"
 #include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/display_list_image_gpu.h"
 #include "flutter/lib/ui/painting/image.h"
 #if IMPELLER_SUPPORTS_RENDERING
@@ -24,17 +25,26 @@
 namespace flutter {
 
 MultiFrameCodec::MultiFrameCodec(std::shared_ptr<ImageGenerator> generator)
-    : state_(new State(std::move(generator))) {}
+    : MultiFrameCodec(std::move(generator), DecodeAheadOptions()) {}
+
+MultiFrameCodec::MultiFrameCodec(std::shared_ptr<ImageGenerator> generator,
+                                 DecodeAheadOptions decode_ahead_options)
+    : state_(new State(std::move(generator), decode_ahead_options)) {}
 
 MultiFrameCodec::~MultiFrameCodec() = default;
 
-MultiFrameCodec::State::State(std::shared_ptr<ImageGenerator> generator)
+MultiFrameCodec::State::State(std::shared_ptr<ImageGenerator> generator,
+                              DecodeAheadOptions decode_ahead_options)
     : generator_(std::move(generator)),
       frameCount_(generator_->GetFrameCount()),
       repetitionCount_(generator_->GetPlayCount() ==
                                ImageGenerator::kInfinitePlayCount
                            ? -1
                            : generator_->GetPlayCount() - 1),
+      decode_ahead_options_(decode_ahead_options),
+      frameByteSize_(generator_->GetInfo()
+                         .makeColorType(kN32_SkColorType)
+                         .computeMinByteSize()),
       is_impeller_enabled_(UIDartState::Current()->IsImpellerEnabled()) {}
 
 static void InvokeNextFrameCallback(
@@ -222,6 +232,58 @@ MultiFrameCodec::State::GetNextFrameImage(
 #endif  //  !SLIMPELLER
 }
 
+MultiFrameCodec::State::DecodedFrame MultiFrameCodec::State::DecodeNextFrame(
+    const fml::WeakPtr<GrDirectContext>& resourceContext,
+    const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
+    const std::shared_ptr<impeller::Context>& impeller_context,
+    const fml::RefPtr<flutter::SkiaUnrefQueue>& unref_queue) {
+  DecodedFrame frame;
+  std::tie(frame.image, frame.decode_error) = GetNextFrameImage(
+      resourceContext, gpu_disable_sync_switch, impeller_context, unref_queue);
+  if (frame.image) {
+    frame.duration = generator_->GetFrameInfo(nextFrameIndex_).duration;
+  }
+  nextFrameIndex_ = (nextFrameIndex_ + 1) % frameCount_;
+  return frame;
+}
+
+bool MultiFrameCodec::State::ShouldDecodeAhead() const {
+  // A single frame is decoded once and never changes.
+  if (frameCount_ <= 1) {
+    return false;
+  }
+  const size_t frame_count = decodedFrames_.size() + 1;
+  return frame_count <= decode_ahead_options_.frame_count &&
+         frame_count * frameByteSize_ <= decode_ahead_options_.byte_budget;
+}
+
+void MultiFrameCodec::State::ScheduleDecodeAhead(
+    const std::shared_ptr<State>& state,
+    const fml::RefPtr<fml::TaskRunner>& io_task_runner,
+    const fml::WeakPtr<IOManager>& io_manager) {
+  if (state->decodeAheadPending_ || !state->ShouldDecodeAhead()) {
+    return;
+  }
+  state->decodeAheadPending_ = true;
+  io_task_runner->PostTask([weak_state = std::weak_ptr<State>(state),
+                            io_task_runner, io_manager]() {
+    auto state = weak_state.lock();
+    if (!state) {
+      return;
+    }
+    state->decodeAheadPending_ = false;
+    if (!io_manager || !state->ShouldDecodeAhead()) {
+      return;
+    }
+    TRACE_EVENT0("flutter", "MultiFrameCodec::DecodeAhead");
+    state->decodedFrames_.push_back(state->DecodeNextFrame(
+        io_manager->GetResourceContext(),
+        io_manager->GetIsGpuDisabledSyncSwitch(),
+        io_manager->GetImpellerContext(), io_manager->GetSkiaUnrefQueue()));
+    ScheduleDecodeAhead(state, io_task_runner, io_manager);
+  });
+}
+
 void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
     std::unique_ptr<tonic::DartPersistentValue> callback,
     const fml::RefPtr<fml::TaskRunner>& ui_task_runner,
@@ -241,26 +303,37 @@ void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
   }
 #endif  // FML_OS_IOS_SIMULATOR
 
+  DecodedFrame frame;
+  if (!decodedFrames_.empty()) {
+    frame = std::move(decodedFrames_.front());
+    decodedFrames_.pop_front();
+    decodeAheadHits_++;
+  } else {
+    frame = DecodeNextFrame(resourceContext, gpu_disable_sync_switch,
+                            impeller_context, unref_queue);
+    decodeAheadMisses_++;
+  }
+#if !FLUTTER_RELEASE
+  if (decode_ahead_options_.frame_count > 0) {
+    FML_TRACE_COUNTER("flutter", "MultiFrameCodec",
+                      reinterpret_cast<int64_t>(this), "DecodeAheadHits",
+                      decodeAheadHits_, "DecodeAheadMisses",
+                      decodeAheadMisses_);
+  }
+#endif  // !FLUTTER_RELEASE
+
   fml::RefPtr<CanvasImage> image = nullptr;
-  int duration = 0;
-  sk_sp<DlImage> dlImage;
-  std::string decode_error;
-  std::tie(dlImage, decode_error) = GetNextFrameImage(
-      resourceContext, gpu_disable_sync_switch, impeller_context, unref_queue);
-  if (dlImage) {
+  if (frame.image) {
     image = CanvasImage::Create();
-    image->set_image(dlImage);
-    ImageGenerator::FrameInfo frameInfo =
-        generator_->GetFrameInfo(nextFrameIndex_);
-    duration = frameInfo.duration;
+    image->set_image(frame.image);
   }
-  nextFrameIndex_ = (nextFrameIndex_ + 1) % frameCount_;
 
   // The static leak checker gets confused by the use of fml::MakeCopyable.
   // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDeleteLeaks)
   ui_task_runner->PostTask(fml::MakeCopyable(
       [callback = std::move(callback), image = std::move(image),
-       decode_error = std::move(decode_error), duration, trace_id]() mutable {
+       decode_error = std::move(frame.decode_error),
+       duration = frame.duration, trace_id]() mutable {
         InvokeNextFrameCallback(image, duration, decode_error,
                                 std::move(callback), trace_id);
       }));
@@ -296,6 +369,7 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
            tonic::DartState::Current(), callback_handle),
        weak_state = std::weak_ptr<MultiFrameCodec::State>(state_), trace_id,
        ui_task_runner = task_runners.GetUITaskRunner(),
+       io_task_runner = task_runners.GetIOTaskRunner(),
        io_manager = dart_state->GetIOManager()]() mutable {
         auto state = weak_state.lock();
         if (!state) {
@@ -308,6 +382,8 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
             io_manager->GetResourceContext(), io_manager->GetSkiaUnrefQueue(),
             io_manager->GetIsGpuDisabledSyncSwitch(), trace_id,
             io_manager->GetImpellerContext());
+        // Decode the frames Dart asks for next while it shows this one.
+        State::ScheduleDecodeAhead(state, io_task_runner, io_manager);
       }));
 
   return Dart_Null();
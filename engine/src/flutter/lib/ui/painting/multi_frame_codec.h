@@ -6,17 +6,38 @@
 #define FLUTTER_LIB_UI_PAINTING_MULTI_FRAME_CODEC_H_
 
 #include "flutter/fml/macros.h"
+#include "flutter/lib/ui/io_manager.h"
 #include "flutter/lib/ui/painting/codec.h"
 #include "flutter/lib/ui/painting/image_generator.h"
 
+#include <deque>
 #include <utility>
 
 namespace flutter {
 
+namespace testing {
+FML_TEST_CLASS(ImageDecoderFixtureTest, MultiFrameCodecDecodesAhead);
+}  // namespace testing
+
 class MultiFrameCodec : public Codec {
  public:
+  // Controls how many frames are decoded on the IO task runner before Dart
+  // asks for them, so that |getNextFrame| does not wait for the decode and
+  // upload of the frame.
+  struct DecodeAheadOptions {
+    // The maximum number of frames decoded ahead of the frames returned to
+    // Dart. Zero disables decoding ahead.
+    size_t frame_count = 1;
+    // The maximum number of bytes of decoded pixels held by the frames
+    // decoded ahead.
+    size_t byte_budget = 8 * 1024 * 1024;
+  };
+
   explicit MultiFrameCodec(std::shared_ptr<ImageGenerator> generator);
 
+  MultiFrameCodec(std::shared_ptr<ImageGenerator> generator,
+                  DecodeAheadOptions decode_ahead_options);
+
   ~MultiFrameCodec() override;
 
   // |Codec|
@@ -39,17 +60,38 @@ class MultiFrameCodec : public Codec {
   // shares it with the IO task runner's decoding work, and sets the live_
   // member to false when it is destructed.
   struct State {
-    explicit State(std::shared_ptr<ImageGenerator> generator);
+    State(std::shared_ptr<ImageGenerator> generator,
+          DecodeAheadOptions decode_ahead_options);
 
     const std::shared_ptr<ImageGenerator> generator_;
     const int frameCount_;
     const int repetitionCount_;
+    const DecodeAheadOptions decode_ahead_options_;
+    // The size of the pixels of a decoded frame.
+    const size_t frameByteSize_;
     bool is_impeller_enabled_ = false;
 
+    // A frame that was decoded and uploaded, but not yet returned to Dart.
+    struct DecodedFrame {
+      sk_sp<DlImage> image;
+      std::string decode_error;
+      int duration = 0;
+    };
+
     // The non-const members and functions below here are only read or written
     // to on the IO thread. They are not safe to access or write on the UI
     // thread.
+
+    // The index of the next frame to decode. This is ahead of the next frame
+    // returned to Dart by the number of frames in |decodedFrames_|.
     int nextFrameIndex_ = 0;
+    // Frames decoded ahead, in the order they are returned to Dart.
+    std::deque<DecodedFrame> decodedFrames_;
+    // Whether a task that decodes the next frame ahead is posted.
+    bool decodeAheadPending_ = false;
+    // The number of requests for a frame that was or was not already decoded.
+    size_t decodeAheadHits_ = 0;
+    size_t decodeAheadMisses_ = 0;
     // The last decoded frame that's required to decode any subsequent frames.
     std::optional<SkBitmap> lastRequiredFrame_;
     // The index of the last decoded required frame.
@@ -65,6 +107,25 @@ class MultiFrameCodec : public Codec {
         const std::shared_ptr<impeller::Context>& impeller_context,
         const fml::RefPtr<flutter::SkiaUnrefQueue>& unref_queue);
 
+    // Decodes the frame at |nextFrameIndex_| and advances it.
+    DecodedFrame DecodeNextFrame(
+        const fml::WeakPtr<GrDirectContext>& resourceContext,
+        const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
+        const std::shared_ptr<impeller::Context>& impeller_context,
+        const fml::RefPtr<flutter::SkiaUnrefQueue>& unref_queue);
+
+    // Whether one more frame may be decoded ahead within the window and
+    // byte budget of |decode_ahead_options_|.
+    bool ShouldDecodeAhead() const;
+
+    // Posts a task to the IO task runner that decodes the next frame ahead, if
+    // there is room for it. The task posts the next one once it is done, so
+    // that other work on the IO task runner is interleaved with the decodes.
+    static void ScheduleDecodeAhead(
+        const std::shared_ptr<State>& state,
+        const fml::RefPtr<fml::TaskRunner>& io_task_runner,
+        const fml::WeakPtr<IOManager>& io_manager);
+
     void GetNextFrameAndInvokeCallback(
         std::unique_ptr<tonic::DartPersistentValue> callback,
         const fml::RefPtr<fml::TaskRunner>& ui_task_runner,
@@ -78,6 +139,9 @@ class MultiFrameCodec : public Codec {
   // Shared across the UI and IO task runners.
   std::shared_ptr<State> state_;
 
+  FML_FRIEND_TEST(testing::ImageDecoderFixtureTest,
+                  MultiFrameCodecDecodesAhead);
+
   FML_FRIEND_MAKE_REF_COUNTED(MultiFrameCodec);
   FML_FRIEND_REF_COUNTED_THREAD_SAFE(MultiFrameCodec);
 };
@@ -0,0 +1,128 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/progressive_codec.h"
+
+#include "flutter/lib/ui/painting/image_decoder.h"
+#include "flutter/lib/ui/ui_dart_state.h"
+#include "third_party/tonic/logging/dart_invoke.h"
+
+namespace flutter {
+
+ProgressiveCodec::ProgressiveCodec(std::shared_ptr<ChunkedImageData> data)
+    : data_(std::move(data)) {}
+
+ProgressiveCodec::~ProgressiveCodec() = default;
+
+int ProgressiveCodec::frameCount() const {
+  return 1;
+}
+
+int ProgressiveCodec::repetitionCount() const {
+  return 0;
+}
+
+Dart_Handle ProgressiveCodec::getNextFrame(Dart_Handle callback_handle) {
+  if (!Dart_IsClosure(callback_handle)) {
+    return tonic::ToDart("Callback must be a function");
+  }
+
+  // The final image is returned to every caller, a preview only to the first.
+  if (image_ && (complete_ || !image_returned_)) {
+    if (!image_->image()) {
+      return tonic::ToDart("Decoded image has been disposed");
+    }
+    image_returned_ = true;
+    tonic::DartInvoke(callback_handle, {tonic::ToDart(image_), tonic::ToDart(0),
+                                        tonic::ToDart(decode_error_)});
+    return Dart_Null();
+  }
+
+  if (complete_) {
+    return tonic::ToDart(decode_error_.empty() ? "Image failed to decode"
+                                               : decode_error_);
+  }
+
+  // This has to be valid because this method is called from Dart.
+  auto dart_state = UIDartState::Current();
+
+  pending_callbacks_.emplace_back(dart_state, callback_handle);
+
+  if (started_) {
+    // The pending callbacks are invoked with the next decoded image.
+    return Dart_Null();
+  }
+
+  auto decoder = dart_state->GetImageDecoder();
+
+  if (!decoder) {
+    return tonic::ToDart(
+        "Failed to access the internal image decoder "
+        "registry on this isolate. Please file a bug on "
+        "https://github.com/flutter/flutter/issues.");
+  }
+
+  // As with the SingleFrameCodec, keep the codec alive on the UI thread until
+  // the decoder delivers its final result.
+  fml::RefPtr<ProgressiveCodec>* raw_codec_ref =
+      new fml::RefPtr<ProgressiveCodec>(this);
+
+  // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDeleteLeaks)
+  decoder->DecodeProgressive(
+      data_, [raw_codec_ref](sk_sp<DlImage> image, std::string decode_error,
+                             bool is_complete) {
+        (*raw_codec_ref)
+            ->OnImage(std::move(image), std::move(decode_error), is_complete);
+        if (is_complete) {
+          delete raw_codec_ref;
+        }
+      });
+
+  started_ = true;
+
+  return Dart_Null();
+}
+
+void ProgressiveCodec::OnImage(sk_sp<DlImage> image,
+                               std::string decode_error,
+                               bool is_complete) {
+  if (image) {
+    image_ = fml::MakeRefCounted<CanvasImage>();
+    image_->set_image(std::move(image));
+    image_returned_ = false;
+  } else if (is_complete) {
+    // Don't present a preview as the final image of a failed decode.
+    image_ = nullptr;
+  }
+
+  if (is_complete) {
+    complete_ = true;
+    decode_error_ = std::move(decode_error);
+    data_ = nullptr;
+  }
+
+  if (pending_callbacks_.empty() || !(image_ || complete_)) {
+    return;
+  }
+
+  auto state = pending_callbacks_.front().dart_state().lock();
+
+  if (!state) {
+    // This is probably because the isolate has been terminated before the
+    // image could be decoded.
+    return;
+  }
+
+  tonic::DartState::Scope scope(state.get());
+
+  image_returned_ = true;
+  for (const tonic::DartPersistentValue& callback : pending_callbacks_) {
+    tonic::DartInvoke(callback.value(), {tonic::ToDart(image_),
+                                         tonic::ToDart(0),
+                                         tonic::ToDart(decode_error_)});
+  }
+  pending_callbacks_.clear();
+}
+
+}  // namespace flutter
@@ -0,0 +1,62 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_CODEC_H_
+#define FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_CODEC_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/painting/chunked_image_data.h"
+#include "flutter/lib/ui/painting/codec.h"
+#include "flutter/lib/ui/painting/image.h"
+
+namespace flutter {
+
+/// @brief  A codec for a single frame image whose encoded bytes are still
+///         arriving.
+///
+///         The image is decoded while its bytes arrive. Each call to
+///         |getNextFrame| returns the newest partially decoded preview that
+///         has not been returned yet, or waits for the next one. Once the
+///         data is closed and fully decoded, every call returns the final
+///         image.
+class ProgressiveCodec : public Codec {
+ public:
+  explicit ProgressiveCodec(std::shared_ptr<ChunkedImageData> data);
+
+  ~ProgressiveCodec() override;
+
+  // |Codec|
+  int frameCount() const override;
+
+  // |Codec|
+  int repetitionCount() const override;
+
+  // |Codec|
+  Dart_Handle getNextFrame(Dart_Handle callback_handle) override;
+
+ private:
+  void OnImage(sk_sp<DlImage> image,
+               std::string decode_error,
+               bool is_complete);
+
+  std::shared_ptr<ChunkedImageData> data_;
+  bool started_ = false;
+  bool complete_ = false;
+  fml::RefPtr<CanvasImage> image_;
+  // Whether |image_| has been handed to a |getNextFrame| callback.
+  bool image_returned_ = false;
+  std::string decode_error_;
+  std::vector<tonic::DartPersistentValue> pending_callbacks_;
+
+  FML_FRIEND_MAKE_REF_COUNTED(ProgressiveCodec);
+  FML_FRIEND_REF_COUNTED_THREAD_SAFE(ProgressiveCodec);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_CODEC_H_
@@ -142,7 +142,7 @@ void SemanticsUpdateBuilder::updateNode(
       static_cast<SemanticsValidationResult>(validationResult);
   node.locale = std::move(locale);
 
-  nodes_[id] = node;
+  nodes_[id] = std::move(node);
 }
 
 void SemanticsUpdateBuilder::updateCustomAction(int id,
@@ -154,7 +154,7 @@ void SemanticsUpdateBuilder::updateCustomAction(int id,
   action.overrideId = overrideId;
   action.label = std::move(label);
   action.hint = std::move(hint);
-  actions_[id] = action;
+  actions_[id] = std::move(action);
 }
 
 void SemanticsUpdateBuilder::build(Dart_Handle semantics_update_handle) {
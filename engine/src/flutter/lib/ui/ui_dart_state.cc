@@ -127,6 +127,32 @@ void UIDartState::SetPlatformConfiguration(
   }
 }
 
+void UIDartState::SetContext(const UIDartState::Context& context) {
+  FML_DCHECK(IsRootIsolate());
+  FML_DCHECK(!platform_configuration_);
+  FML_DCHECK(context.task_runners.GetUITaskRunner() ==
+             context_.task_runners.GetUITaskRunner());
+  // The task runners are the same and are left as they are.
+  context_.snapshot_delegate = context.snapshot_delegate;
+  context_.io_manager = context.io_manager;
+  context_.unref_queue = context.unref_queue;
+  context_.image_decoder = context.image_decoder;
+  context_.image_generator_registry = context.image_generator_registry;
+  context_.advisory_script_uri = context.advisory_script_uri;
+  context_.advisory_script_entrypoint = context.advisory_script_entrypoint;
+  context_.deterministic_rendering_enabled =
+      context.deterministic_rendering_enabled;
+  context_.concurrent_task_runner = context.concurrent_task_runner;
+  context_.runtime_stage_backend = context.runtime_stage_backend;
+  context_.enable_impeller = context.enable_impeller;
+  context_.enable_flutter_gpu = context.enable_flutter_gpu;
+
+  std::ostringstream debug_name;
+  debug_name << context_.advisory_script_uri << "$"
+             << context_.advisory_script_entrypoint << "-" << main_port_;
+  SetDebugName(debug_name.str());
+}
+
 void UIDartState::SetPlatformMessageHandler(
     std::weak_ptr<PlatformMessageHandler> handler) {
   FML_DCHECK(!IsRootIsolate());
@@ -204,6 +204,11 @@ class UIDartState : public tonic::DartState {
   void SetPlatformConfiguration(
       std::unique_ptr<PlatformConfiguration> platform_configuration);
 
+  // Rebinds a root isolate that was created ahead of time for another engine
+  // on the same task runners to the engine that takes it. Must be called
+  // before the platform configuration is set.
+  void SetContext(const UIDartState::Context& context);
+
   const std::string& GetAdvisoryScriptURI() const;
 
  private:
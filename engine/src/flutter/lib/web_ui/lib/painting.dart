@@ -1044,6 +1044,33 @@ class ImmutableBuffer {
   void dispose() => _list = null;
 }
 
+class ChunkedImageBuffer {
+  ChunkedImageBuffer();
+
+  final BytesBuilder _builder = BytesBuilder();
+  bool _closed = false;
+
+  void add(Uint8List bytes) {
+    if (_closed) {
+      throw StateError('Bytes cannot be added to a closed buffer');
+    }
+    _builder.add(bytes);
+  }
+
+  void close() => _closed = true;
+
+  int get length => _builder.length;
+
+  Codec instantiateCodec() {
+    throw UnsupportedError('ChunkedImageBuffer.instantiateCodec is not supported on the web.');
+  }
+
+  void dispose() {
+    _closed = true;
+    _builder.clear();
+  }
+}
+
 class ImageDescriptor {
   // Not async because there's no expensive work to do here.
   ImageDescriptor.raw(
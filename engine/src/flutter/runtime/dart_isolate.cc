@@ -98,7 +98,8 @@ std::weak_ptr<DartIsolate> DartIsolate::CreateRunningRootIsolate(
     std::unique_ptr<IsolateConfiguration> isolate_configuration,
     const UIDartState::Context& context,
     const DartIsolate* spawning_isolate,
-    std::shared_ptr<NativeAssetsManager> native_assets_manager) {
+    std::shared_ptr<NativeAssetsManager> native_assets_manager,
+    std::shared_ptr<DartIsolate> pooled_isolate) {
   if (!isolate_snapshot) {
     FML_LOG(ERROR) << "Invalid isolate snapshot.";
     return {};
@@ -113,17 +114,25 @@ std::weak_ptr<DartIsolate> DartIsolate::CreateRunningRootIsolate(
       isolate_configuration->IsNullSafetyEnabled(*isolate_snapshot));
   isolate_flags.SetIsDontNeedSafe(isolate_snapshot->IsDontNeedSafe());
 
-  auto isolate = CreateRootIsolate(settings,                           //
-                                   isolate_snapshot,                   //
-                                   std::move(platform_configuration),  //
-                                   isolate_flags,                      //
-                                   isolate_create_callback,            //
-                                   isolate_shutdown_callback,          //
-                                   context,                            //
-                                   spawning_isolate,                   //
-                                   std::move(native_assets_manager)    //
-                                   )
-                     .lock();
+  std::shared_ptr<DartIsolate> isolate;
+  if (pooled_isolate) {
+    TRACE_EVENT0("flutter", "DartIsolate::AdoptPooledRootIsolate");
+    isolate = std::move(pooled_isolate);
+    isolate->SetContext(context);
+    isolate->SetPlatformConfiguration(std::move(platform_configuration));
+  } else {
+    isolate = CreateRootIsolate(settings,                           //
+                                isolate_snapshot,                   //
+                                std::move(platform_configuration),  //
+                                isolate_flags,                      //
+                                isolate_create_callback,            //
+                                isolate_shutdown_callback,          //
+                                context,                            //
+                                spawning_isolate,                   //
+                                std::move(native_assets_manager)    //
+                                )
+                  .lock();
+  }
 
   if (!isolate) {
     FML_LOG(ERROR) << "Could not create root isolate.";
@@ -194,6 +203,23 @@ void DartIsolate::SpawnIsolateShutdownCallback(
   DartIsolate::DartIsolateShutdownCallback(isolate_group_data, isolate_data);
 }
 
+std::weak_ptr<DartIsolate> DartIsolate::CreatePooledRootIsolate(
+    const Settings& settings,
+    const UIDartState::Context& context,
+    const DartIsolate& spawning_isolate) {
+  TRACE_EVENT0("flutter", "DartIsolate::CreatePooledRootIsolate");
+  // The snapshot, flags and callbacks are those of the group, and the
+  // platform configuration is set when the isolate is run.
+  return CreateRootIsolate(/*settings=*/settings,
+                           /*isolate_snapshot=*/nullptr,
+                           /*platform_configuration=*/nullptr,
+                           /*flags=*/Flags{},
+                           /*isolate_create_callback=*/nullptr,
+                           /*isolate_shutdown_callback=*/nullptr,
+                           /*context=*/context,
+                           /*spawning_isolate=*/&spawning_isolate);
+}
+
 std::weak_ptr<DartIsolate> DartIsolate::CreateRootIsolate(
     const Settings& settings,
     fml::RefPtr<const DartSnapshot> isolate_snapshot,
@@ -197,6 +197,10 @@ class DartIsolate : public UIDartState {
   ///                                         accessed by the root dart isolate.
   /// @param[in]  spawning_isolate            The isolate that is spawning the
   ///                                         new isolate.
+  /// @param[in]  pooled_isolate              An isolate created by
+  ///                                         `CreatePooledRootIsolate` in the
+  ///                                         group of the spawning isolate to
+  ///                                         run instead of creating one.
   /// @return     A weak pointer to the root Dart isolate. The caller must
   ///             ensure that the isolate is not referenced for long periods of
   ///             time as it prevents isolate collection when the isolate
@@ -217,7 +221,31 @@ class DartIsolate : public UIDartState {
       std::unique_ptr<IsolateConfiguration> isolate_configuration,
       const UIDartState::Context& context,
       const DartIsolate* spawning_isolate = nullptr,
-      std::shared_ptr<NativeAssetsManager> native_assets_manager = nullptr);
+      std::shared_ptr<NativeAssetsManager> native_assets_manager = nullptr,
+      std::shared_ptr<DartIsolate> pooled_isolate = nullptr);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a root isolate in the group of the spawning isolate
+  ///             ahead of time, so that an engine spawned later can run it
+  ///             with `CreateRunningRootIsolate` instead of paying for its
+  ///             creation. The isolate is left in the
+  ///             `Phase::LibrariesSetup` phase, does not run any Dart code and
+  ///             is rebound to the context of the engine that runs it.
+  ///
+  /// @param[in]  settings          The settings used to create the isolate.
+  /// @param[in]  context           The context of the spawning engine. Only
+  ///                               its task runners are kept once the isolate
+  ///                               is run.
+  /// @param[in]  spawning_isolate  The isolate in whose group the isolate is
+  ///                               created.
+  ///
+  /// @return     A weak pointer to the isolate. The caller must shut the
+  ///             isolate down if it is never run.
+  ///
+  static std::weak_ptr<DartIsolate> CreatePooledRootIsolate(
+      const Settings& settings,
+      const UIDartState::Context& context,
+      const DartIsolate& spawning_isolate);
 
   // |UIDartState|
   ~DartIsolate() override;
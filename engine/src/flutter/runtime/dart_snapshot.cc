@@ -11,6 +11,7 @@
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/snapshot/snapshot.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/runtime/snapshot_mapping_cache.h"
 #include "third_party/dart/runtime/include/dart_api.h"
 
 namespace flutter {
@@ -29,14 +30,12 @@ const char* DartSnapshot::kIsolateInstructionsSymbol =
 
 #if !DART_SNAPSHOT_STATIC_LINK
 
-static std::unique_ptr<const fml::Mapping> GetFileMapping(
+// Engines in the same process that use the same snapshot files share their
+// mappings.
+static std::shared_ptr<const fml::Mapping> GetFileMapping(
     const std::string& path,
     bool executable) {
-  if (executable) {
-    return fml::FileMapping::CreateReadExecute(path);
-  } else {
-    return fml::FileMapping::CreateReadOnly(path);
-  }
+  return SnapshotMappingCache::GetInstance().GetFileMapping(path, executable);
 }
 
 // The first party embedders don't yet use the stable embedder API and depend on
@@ -4,9 +4,11 @@
 
 #include "flutter/runtime/runtime_controller.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "flutter/common/settings.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/compositing/scene.h"
 #include "flutter/lib/ui/ui_dart_state.h"
@@ -59,7 +61,7 @@ std::unique_ptr<RuntimeController> RuntimeController::Spawn(
     fml::TaskRunnerAffineWeakPtr<ImageDecoder> image_decoder,
     fml::TaskRunnerAffineWeakPtr<ImageGeneratorRegistry>
         image_generator_registry,
-    fml::TaskRunnerAffineWeakPtr<SnapshotDelegate> snapshot_delegate) const {
+    fml::TaskRunnerAffineWeakPtr<SnapshotDelegate> snapshot_delegate) {
   UIDartState::Context spawned_context{
       context_.task_runners,
       std::move(snapshot_delegate),
@@ -86,11 +88,20 @@ std::unique_ptr<RuntimeController> RuntimeController::Spawn(
                                           p_persistent_isolate_data,     //
                                           spawned_context);              //
   result->spawning_isolate_ = root_isolate_;
+  result->pooled_isolate_ = TakePooledIsolate();
   return result;
 }
 
 RuntimeController::~RuntimeController() {
   FML_DCHECK(Dart_CurrentIsolate() == nullptr);
+  // Isolates created ahead of time that were never run.
+  spawn_isolate_pool_.push_back(pooled_isolate_);
+  for (const std::weak_ptr<DartIsolate>& weak_isolate : spawn_isolate_pool_) {
+    if (std::shared_ptr<DartIsolate> isolate = weak_isolate.lock()) {
+      isolate->Shutdown();
+    }
+  }
+  spawn_isolate_pool_.clear();
   std::shared_ptr<DartIsolate> root_isolate = root_isolate_.lock();
   if (root_isolate) {
     root_isolate->SetReturnCodeCallback(nullptr);
@@ -330,24 +341,86 @@ bool RuntimeController::NotifyIdle(fml::TimeDelta deadline) {
     return false;
   }
 
-  tonic::DartState::Scope scope(root_isolate);
+  {
+    tonic::DartState::Scope scope(root_isolate);
 
-  Dart_PerformanceMode performance_mode =
-      PlatformConfigurationNativeApi::GetDartPerformanceMode();
-  if (performance_mode == Dart_PerformanceMode::Dart_PerformanceMode_Latency) {
-    return false;
-  }
+    Dart_PerformanceMode performance_mode =
+        PlatformConfigurationNativeApi::GetDartPerformanceMode();
+    if (performance_mode ==
+        Dart_PerformanceMode::Dart_PerformanceMode_Latency) {
+      return false;
+    }
 
-  Dart_NotifyIdle(deadline.ToMicroseconds());
+    Dart_NotifyIdle(deadline.ToMicroseconds());
 
-  // Idle notifications being in isolate scope are part of the contract.
-  if (idle_notification_callback_) {
-    TRACE_EVENT0("flutter", "EmbedderIdleNotification");
-    idle_notification_callback_(deadline.ToMicroseconds());
+    // Idle notifications being in isolate scope are part of the contract.
+    if (idle_notification_callback_) {
+      TRACE_EVENT0("flutter", "EmbedderIdleNotification");
+      idle_notification_callback_(deadline.ToMicroseconds());
+    }
   }
+
+  // Isolates are created outside of the scope of the root isolate.
+  FillSpawnIsolatePool(deadline);
   return true;
 }
 
+size_t RuntimeController::GetPooledIsolateCount() const {
+  return std::count_if(spawn_isolate_pool_.begin(), spawn_isolate_pool_.end(),
+                       [](const std::weak_ptr<DartIsolate>& isolate) {
+                         return !isolate.expired();
+                       });
+}
+
+void RuntimeController::FillSpawnIsolatePool(fml::TimeDelta deadline) {
+  // Engines spawned from an engine that is still alive take from its pool.
+  if (GetPooledIsolateCount() >= spawn_isolate_pool_size_ ||
+      spawning_isolate_.lock()) {
+    return;
+  }
+  // Only create an isolate if the collection left at least the average time
+  // an isolate takes to create before the deadline.
+  if (deadline - fml::TimeDelta::FromMicroseconds(Dart_TimelineGetMicros()) <
+      isolate_creation_time_) {
+    return;
+  }
+  std::shared_ptr<DartIsolate> root_isolate = root_isolate_.lock();
+  if (!root_isolate) {
+    return;
+  }
+
+  fml::TimePoint start = fml::TimePoint::Now();
+  std::weak_ptr<DartIsolate> isolate = DartIsolate::CreatePooledRootIsolate(
+      root_isolate->GetIsolateGroupData().GetSettings(), context_,
+      *root_isolate);
+  fml::TimeDelta creation_time = fml::TimePoint::Now() - start;
+  isolate_creation_count_++;
+  isolate_creation_time_ = isolate_creation_time_ +
+                           (creation_time - isolate_creation_time_) /
+                               static_cast<int64_t>(isolate_creation_count_);
+  if (isolate.expired()) {
+    FML_LOG(ERROR) << "Could not create an isolate for spawned engines. "
+                      "Spawned engines will create their own.";
+    spawn_isolate_pool_size_ = 0u;
+    return;
+  }
+  spawn_isolate_pool_.push_back(std::move(isolate));
+  FML_TRACE_COUNTER("flutter", "SpawnIsolatePool",
+                    reinterpret_cast<int64_t>(this),  //
+                    "PooledIsolates", GetPooledIsolateCount());
+}
+
+std::shared_ptr<DartIsolate> RuntimeController::TakePooledIsolate() {
+  while (!spawn_isolate_pool_.empty()) {
+    std::shared_ptr<DartIsolate> isolate = spawn_isolate_pool_.back().lock();
+    spawn_isolate_pool_.pop_back();
+    if (isolate) {
+      return isolate;
+    }
+  }
+  return nullptr;
+}
+
 bool RuntimeController::DispatchPlatformMessage(
     std::unique_ptr<PlatformMessage> message) {
   if (auto* platform_configuration = GetPlatformConfigurationIfAvailable()) {
@@ -554,6 +627,10 @@ bool RuntimeController::LaunchRootIsolate(
     return false;
   }
 
+  spawn_isolate_pool_size_ = settings.spawn_isolate_pool_size;
+  std::shared_ptr<DartIsolate> pooled_isolate = pooled_isolate_.lock();
+  pooled_isolate_ = {};
+
   auto strong_root_isolate =
       DartIsolate::CreateRunningRootIsolate(
           settings,                                       //
@@ -568,8 +645,9 @@ bool RuntimeController::LaunchRootIsolate(
           dart_entrypoint_args,                           //
           std::move(isolate_configuration),               //
           context_,                                       //
-          spawning_isolate_.lock().get(),
-          std::move(native_assets_manager))  //
+          spawning_isolate_.lock().get(),                 //
+          std::move(native_assets_manager),               //
+          std::move(pooled_isolate))                      //
           .lock();
 
   if (!strong_root_isolate) {
@@ -110,7 +110,10 @@ class RuntimeController : public PlatformConfigurationClient,
   //----------------------------------------------------------------------------
   /// @brief      Create a RuntimeController that shares as many resources as
   ///             possible with the calling RuntimeController such that together
-  ///             they occupy less memory.
+  ///             they occupy less memory. If the calling RuntimeController
+  ///             has created isolates ahead of time at idle time, the new
+  ///             RuntimeController runs one of them instead of creating its
+  ///             root isolate.
   /// @return     A RuntimeController with a running isolate.
   /// @see        RuntimeController::RuntimeController
   ///
@@ -126,7 +129,7 @@ class RuntimeController : public PlatformConfigurationClient,
       fml::TaskRunnerAffineWeakPtr<ImageDecoder> image_decoder,
       fml::TaskRunnerAffineWeakPtr<ImageGeneratorRegistry>
           image_generator_registry,
-      fml::TaskRunnerAffineWeakPtr<SnapshotDelegate> snapshot_delegate) const;
+      fml::TaskRunnerAffineWeakPtr<SnapshotDelegate> snapshot_delegate);
 
   // |PlatformConfigurationClient|
   ~RuntimeController() override;
@@ -680,6 +683,15 @@ class RuntimeController : public PlatformConfigurationClient,
     return root_isolate_;
   }
 
+  //----------------------------------------------------------------------------
+  /// @brief      The number of isolates created at idle time that are waiting
+  ///             for a spawned RuntimeController to run them. Up to
+  ///             `Settings::spawn_isolate_pool_size` isolates are kept, and
+  ///             only by RuntimeControllers that were not spawned from one
+  ///             that is still alive.
+  ///
+  size_t GetPooledIsolateCount() const;
+
   void FlushMicrotaskQueue() {
     if (auto isolate = root_isolate_.lock()) {
       isolate->FlushMicrotasksNow();
@@ -703,6 +715,11 @@ class RuntimeController : public PlatformConfigurationClient,
   RuntimeController(RuntimeDelegate& p_client, const TaskRunners& task_runners);
 
  private:
+  // The time an isolate of the spawn isolate pool is expected to take to
+  // create before one has been created.
+  static constexpr fml::TimeDelta kInitialIsolateCreationTime =
+      fml::TimeDelta::FromMilliseconds(1);
+
   struct Locale {
     Locale(std::string language_code_,
            std::string country_code_,
@@ -724,6 +741,16 @@ class RuntimeController : public PlatformConfigurationClient,
   PlatformData platform_data_;
   std::weak_ptr<DartIsolate> root_isolate_;
   std::weak_ptr<DartIsolate> spawning_isolate_;
+  // The isolate taken from the pool of the spawning RuntimeController, until
+  // it is run by `LaunchRootIsolate`.
+  std::weak_ptr<DartIsolate> pooled_isolate_;
+  size_t spawn_isolate_pool_size_ = 0u;
+  std::vector<std::weak_ptr<DartIsolate>> spawn_isolate_pool_;
+  // The average time it took to create an isolate of the spawn isolate pool.
+  // Isolates are only created at idle time if this much time is left before
+  // the deadline.
+  fml::TimeDelta isolate_creation_time_ = kInitialIsolateCreationTime;
+  size_t isolate_creation_count_ = 0u;
   std::optional<uint32_t> root_isolate_return_code_;
   const fml::closure isolate_create_callback_;
   const fml::closure isolate_shutdown_callback_;
@@ -756,6 +783,12 @@ class RuntimeController : public PlatformConfigurationClient,
   // TODO(dkwingsmt): Fix these problems for all cases.
   std::unordered_set<uint64_t> rendered_views_during_frame_;
 
+  // Creates one isolate for the spawn isolate pool if it is not full and
+  // there is enough time left before the |deadline| of the idle period.
+  void FillSpawnIsolatePool(fml::TimeDelta deadline);
+
+  std::shared_ptr<DartIsolate> TakePooledIsolate();
+
   void MarkAsFrameBorder();
 
   void CheckIfAllViewsRendered();
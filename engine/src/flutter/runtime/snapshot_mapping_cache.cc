@@ -0,0 +1,153 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/runtime/snapshot_mapping_cache.h"
+
+#include <iterator>
+#include <vector>
+
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/trace_event.h"
+
+#if FML_OS_POSIX
+#include <sys/stat.h>
+#endif  // FML_OS_POSIX
+
+#if FML_OS_LINUX || FML_OS_ANDROID
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // FML_OS_LINUX || FML_OS_ANDROID
+
+namespace flutter {
+
+namespace {
+
+// Identifies the file behind the descriptor so that the same file opened
+// through different paths shares a mapping.
+std::string GetFileIdentity(const fml::UniqueFD& fd, const std::string& path) {
+#if FML_OS_POSIX
+  struct stat file_stat = {};
+  if (::fstat(fd.get(), &file_stat) == 0) {
+    return std::to_string(file_stat.st_dev) + ":" +
+           std::to_string(file_stat.st_ino);
+  }
+#endif  // FML_OS_POSIX
+  return path;
+}
+
+// Returns the number of bytes of the mapping that are resident in memory, or
+// zero where residency cannot be queried.
+size_t GetResidentBytes(const fml::Mapping& mapping) {
+#if FML_OS_LINUX || FML_OS_ANDROID
+  if (mapping.GetMapping() == nullptr || mapping.GetSize() == 0u) {
+    return 0u;
+  }
+  const uintptr_t page_size = ::sysconf(_SC_PAGESIZE);
+  const uintptr_t begin =
+      reinterpret_cast<uintptr_t>(mapping.GetMapping()) & ~(page_size - 1u);
+  const uintptr_t end =
+      reinterpret_cast<uintptr_t>(mapping.GetMapping()) + mapping.GetSize();
+  std::vector<unsigned char> residency((end - begin + page_size - 1u) /
+                                       page_size);
+  if (::mincore(reinterpret_cast<void*>(begin), end - begin,
+                residency.data()) != 0) {
+    return 0u;
+  }
+  size_t resident_pages = 0u;
+  for (unsigned char page : residency) {
+    resident_pages += page & 1u;
+  }
+  return resident_pages * page_size;
+#else
+  return 0u;
+#endif  // FML_OS_LINUX || FML_OS_ANDROID
+}
+
+}  // namespace
+
+SnapshotMappingCache& SnapshotMappingCache::GetInstance() {
+  static SnapshotMappingCache* instance = new SnapshotMappingCache();
+  return *instance;
+}
+
+SnapshotMappingCache::SnapshotMappingCache() = default;
+
+SnapshotMappingCache::~SnapshotMappingCache() = default;
+
+std::shared_ptr<const fml::Mapping> SnapshotMappingCache::GetFileMapping(
+    const std::string& path,
+    bool executable) {
+  fml::UniqueFD fd = fml::OpenFile(path.c_str(), false,
+                                   fml::FilePermission::kRead);
+  if (!fd.is_valid()) {
+    return nullptr;
+  }
+
+  std::shared_ptr<const fml::Mapping> mapping;
+  {
+    std::scoped_lock lock(mutex_);
+    Key key(GetFileIdentity(fd, path), executable);
+    auto found = mappings_.find(key);
+    if (found != mappings_.end()) {
+      mapping = found->second.lock();
+    }
+    if (mapping) {
+      deduplicated_bytes_ += mapping->GetSize();
+    } else {
+      mapping = executable ? fml::FileMapping::CreateReadExecute(fd)
+                           : fml::FileMapping::CreateReadOnly(fd);
+      if (!mapping) {
+        return nullptr;
+      }
+      // Drop the entries of files that are no longer mapped.
+      for (auto it = mappings_.begin(); it != mappings_.end();) {
+        it = it->second.expired() ? mappings_.erase(it) : std::next(it);
+      }
+      mappings_[key] = mapping;
+    }
+  }
+
+  TraceStats();
+  return mapping;
+}
+
+SnapshotMappingCache::Stats SnapshotMappingCache::GetStats() const {
+  Stats stats;
+  std::scoped_lock lock(mutex_);
+  stats.deduplicated_bytes = deduplicated_bytes_;
+  for (const auto& [key, weak_mapping] : mappings_) {
+    std::shared_ptr<const fml::Mapping> mapping = weak_mapping.lock();
+    if (!mapping) {
+      continue;
+    }
+    stats.mapping_count++;
+    stats.mapped_bytes += mapping->GetSize();
+    // One of the references is the one that was just taken.
+    if (mapping.use_count() > 2) {
+      stats.shared_resident_bytes += GetResidentBytes(*mapping);
+    } else {
+      stats.private_resident_bytes += GetResidentBytes(*mapping);
+    }
+  }
+  return stats;
+}
+
+void SnapshotMappingCache::TraceStats() const {
+  // The residency of the mappings is queried page by page, so it is only
+  // computed when the counter can be recorded. The timeline event handler is
+  // not installed when the timeline is compiled out or disabled.
+  if (!fml::tracing::TraceHasTimelineEventHandler()) {
+    return;
+  }
+  Stats stats = GetStats();
+  FML_TRACE_COUNTER("flutter", "SnapshotMappingCache",
+                    reinterpret_cast<int64_t>(this),                     //
+                    "MappedBytes", stats.mapped_bytes,                   //
+                    "DeduplicatedBytes", stats.deduplicated_bytes,       //
+                    "SharedResidentBytes", stats.shared_resident_bytes,  //
+                    "PrivateResidentBytes", stats.private_resident_bytes);
+}
+
+}  // namespace flutter
@@ -0,0 +1,93 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNTIME_SNAPSHOT_MAPPING_CACHE_H_
+#define FLUTTER_RUNTIME_SNAPSHOT_MAPPING_CACHE_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      A process-wide cache of the read-only mappings of snapshot
+///             files.
+///
+///             Every shell infers its isolate snapshot from its settings. In
+///             processes that run several engines with the same settings,
+///             this would map the same snapshot files once per engine. The
+///             cache hands out the same mapping for a file for as long as any
+///             engine holds on to it, so that the snapshot is mapped and
+///             faulted in once and each additional engine only costs its
+///             heap.
+///
+///             Files are identified by their device and inode where the
+///             platform has them, and by their path elsewhere. Mappings are
+///             held weakly and unmapped once the last snapshot using them is
+///             collected.
+///
+///             This object is thread safe.
+///
+class SnapshotMappingCache {
+ public:
+  struct Stats {
+    /// The number of distinct files that are currently mapped.
+    size_t mapping_count = 0u;
+    /// The number of bytes that are currently mapped.
+    size_t mapped_bytes = 0u;
+    /// The number of bytes that were not mapped again because a live mapping
+    /// was shared, since the cache was created.
+    size_t deduplicated_bytes = 0u;
+    /// The number of resident bytes of mappings that are used by more than
+    /// one snapshot. Only computed on Linux and Android.
+    size_t shared_resident_bytes = 0u;
+    /// The number of resident bytes of mappings that are used by a single
+    /// snapshot. Only computed on Linux and Android.
+    size_t private_resident_bytes = 0u;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      The cache shared by all of the engines in the process.
+  static SnapshotMappingCache& GetInstance();
+
+  SnapshotMappingCache();
+
+  ~SnapshotMappingCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the mapping of the file at the given path, mapping it
+  ///             if no live mapping of it exists yet.
+  ///
+  /// @param[in]  path        The path of the snapshot file.
+  /// @param[in]  executable  Whether the file is mapped read-execute instead
+  ///                         of read-only.
+  ///
+  /// @return     The mapping, or nullptr if the file could not be mapped.
+  std::shared_ptr<const fml::Mapping> GetFileMapping(const std::string& path,
+                                                     bool executable);
+
+  Stats GetStats() const;
+
+ private:
+  // The identity of the file and whether it is mapped executable.
+  using Key = std::pair<std::string, bool>;
+
+  mutable std::mutex mutex_;
+  std::map<Key, std::weak_ptr<const fml::Mapping>> mappings_;
+  size_t deduplicated_bytes_ = 0u;
+
+  void TraceStats() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SnapshotMappingCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_RUNTIME_SNAPSHOT_MAPPING_CACHE_H_
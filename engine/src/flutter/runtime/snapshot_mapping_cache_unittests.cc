@@ -0,0 +1,77 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/runtime/snapshot_mapping_cache.h"
+
+#include <string>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/paths.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+class SnapshotMappingCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fml::DataMapping contents(std::string(10000u, 's'));
+    ASSERT_TRUE(fml::WriteAtomically(temp_dir_.fd(), "snapshot", contents));
+    snapshot_path_ = fml::paths::JoinPaths({temp_dir_.path(), "snapshot"});
+  }
+
+  fml::ScopedTemporaryDirectory temp_dir_;
+  std::string snapshot_path_;
+};
+
+TEST_F(SnapshotMappingCacheTest, SharesLiveMappings) {
+  SnapshotMappingCache cache;
+  auto first = cache.GetFileMapping(snapshot_path_, false);
+  auto second = cache.GetFileMapping(snapshot_path_, false);
+  ASSERT_TRUE(first);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(first->GetSize(), 10000u);
+
+  SnapshotMappingCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(stats.mapping_count, 1u);
+  EXPECT_EQ(stats.mapped_bytes, 10000u);
+  EXPECT_EQ(stats.deduplicated_bytes, 10000u);
+}
+
+TEST_F(SnapshotMappingCacheTest, MapsExecutableSnapshotsSeparately) {
+  SnapshotMappingCache cache;
+  auto read_only = cache.GetFileMapping(snapshot_path_, false);
+  auto executable = cache.GetFileMapping(snapshot_path_, true);
+  ASSERT_TRUE(read_only);
+  ASSERT_TRUE(executable);
+  EXPECT_NE(read_only, executable);
+
+  SnapshotMappingCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(stats.mapping_count, 2u);
+  EXPECT_EQ(stats.deduplicated_bytes, 0u);
+}
+
+TEST_F(SnapshotMappingCacheTest, UnmapsReleasedSnapshots) {
+  SnapshotMappingCache cache;
+  auto mapping = cache.GetFileMapping(snapshot_path_, false);
+  ASSERT_TRUE(mapping);
+  mapping.reset();
+  EXPECT_EQ(cache.GetStats().mapping_count, 0u);
+
+  mapping = cache.GetFileMapping(snapshot_path_, false);
+  ASSERT_TRUE(mapping);
+  SnapshotMappingCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(stats.mapping_count, 1u);
+  EXPECT_EQ(stats.deduplicated_bytes, 0u);
+}
+
+TEST_F(SnapshotMappingCacheTest, ReturnsNullForMissingFiles) {
+  SnapshotMappingCache cache;
+  auto missing_path = fml::paths::JoinPaths({temp_dir_.path(), "missing"});
+  EXPECT_EQ(cache.GetFileMapping(missing_path, false), nullptr);
+  EXPECT_EQ(cache.GetStats().mapping_count, 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
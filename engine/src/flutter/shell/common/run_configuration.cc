@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
 #include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/unique_fd.h"
@@ -27,10 +28,16 @@ RunConfiguration RunConfiguration::InferFromSettings(
         fml::Duplicate(settings.assets_dir), true));
   }
 
+  fml::UniqueFD assets_directory = fml::OpenDirectory(
+      settings.assets_path.c_str(), false, fml::FilePermission::kRead);
+  // Assets that were packed into a single archive are resolved from it
+  // without opening a file per asset. The bundle is invalid and not added if
+  // there is no archive. It is not kept after the asset manager changes so
+  // that assets updated by a hot reload are not shadowed by the archive.
+  asset_manager->PushBack(std::make_unique<PackedAssetBundle>(
+      assets_directory, PackedAssetBundle::kFileName, false));
   asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
-      fml::OpenDirectory(settings.assets_path.c_str(), false,
-                         fml::FilePermission::kRead),
-      true));
+      std::move(assets_directory), true));
 
   return {IsolateConfiguration::InferFromSettings(settings, asset_manager,
                                                   io_worker, launch_type),
@@ -65,7 +72,7 @@ bool RunConfiguration::IsValid() const {
 }
 
 bool RunConfiguration::AddAssetResolver(
-    std::unique_ptr<AssetResolver> resolver) {
+    std::shared_ptr<AssetResolver> resolver) {
   if (!resolver || !resolver->IsValid()) {
     return false;
   }
@@ -54,6 +54,12 @@ constexpr char kSystemChannel[] = "flutter/system";
 constexpr char kTypeKey[] = "type";
 constexpr char kFontChange[] = "fontsChange";
 
+// Assets first used within this long after the first frame are still recorded
+// into the asset prefetch manifest, since the images requested by the first
+// frame are usually loaded after it.
+constexpr fml::TimeDelta kAssetPrefetchRecordingWindow =
+    fml::TimeDelta::FromSeconds(2);
+
 namespace {
 
 std::unique_ptr<Engine> CreateEngine(
@@ -542,6 +548,10 @@ Shell::Shell(DartVMRef vm,
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
   display_manager_ = std::make_unique<DisplayManager>();
+  if (settings_.enable_asset_prefetch) {
+    asset_prefetcher_ =
+        std::make_shared<AssetPrefetcher>(fml::paths::GetCachesDirectory());
+  }
   resource_cache_limit_calculator->AddResourceCacheLimitItem(
       weak_factory_.GetWeakPtr());
 
@@ -699,6 +709,10 @@ std::unique_ptr<Shell> Shell::Spawn(
     return nullptr;
   }
 
+  size_t spawn_trace_id = fml::tracing::TraceNonce();
+  TRACE_EVENT_ASYNC_BEGIN0("flutter", "Shell::SpawnToFirstFrame",
+                           spawn_trace_id);
+
   // It's safe to store this value since it is set on the platform thread.
   bool is_gpu_disabled = false;
   GetIsGpuDisabledSyncSwitch()->Execute(
@@ -733,6 +747,7 @@ std::unique_ptr<Shell> Shell::Spawn(
             /*gpu_disabled_switch=*/is_gpu_disabled_sync_switch);
       },
       is_gpu_disabled);
+  result->spawn_trace_id_ = spawn_trace_id;
   result->RunEngine(std::move(run_configuration));
   return result;
 }
@@ -783,6 +798,10 @@ void Shell::RunEngine(
   FML_DCHECK(is_set_up_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
+  if (asset_prefetcher_ && run_configuration.GetAssetManager()) {
+    PrefetchAssets(run_configuration.GetAssetManager());
+  }
+
   fml::TaskRunner::RunNowOrPostTask(
       task_runners_.GetUITaskRunner(),
       fml::MakeCopyable(
@@ -1754,6 +1773,17 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
     settings_.frame_rasterized_callback(timing);
   }
 
+  if (asset_prefetcher_ && !asset_prefetch_manifest_scheduled_) {
+    asset_prefetch_manifest_scheduled_ = true;
+    ScheduleAssetPrefetchManifestPersist();
+  }
+
+  if (spawn_trace_id_.has_value()) {
+    TRACE_EVENT_ASYNC_END0("flutter", "Shell::SpawnToFirstFrame",
+                           spawn_trace_id_.value());
+    spawn_trace_id_.reset();
+  }
+
   if (!needs_report_timings_) {
     return;
   }
@@ -1812,6 +1842,39 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
   }
 }
 
+void Shell::PrefetchAssets(
+    const std::shared_ptr<AssetManager>& asset_manager) {
+  asset_manager->SetPrefetcher(asset_prefetcher_);
+  // The resolvers of the asset manager may be updated while the IO thread
+  // prefetches, so the prefetch works on a copy of them.
+  task_runners_.GetIOTaskRunner()->PostTask(
+      [prefetcher = asset_prefetcher_,
+       resolvers = asset_manager->GetResolvers()]() {
+        size_t prefetched = prefetcher->PrefetchAssets(resolvers);
+        FML_DLOG(INFO) << "Prefetched " << prefetched << " assets.";
+      });
+}
+
+void Shell::ScheduleAssetPrefetchManifestPersist() {
+  task_runners_.GetIOTaskRunner()->PostDelayedTask(
+      [prefetcher = asset_prefetcher_]() {
+        prefetcher->StopRecording();
+        prefetcher->Persist();
+        AssetPrefetcher::Stats stats = prefetcher->GetStats();
+        FML_TRACE_COUNTER("flutter", "AssetPrefetcher",
+                          reinterpret_cast<int64_t>(prefetcher.get()),  //
+                          "Hits", stats.hits,                           //
+                          "Misses", stats.misses,                       //
+                          "WastedBytes", stats.wasted_bytes);
+        FML_DLOG(INFO) << "Asset prefetch: " << stats.hits << " of "
+                       << stats.prefetched_assets
+                       << " prefetched assets used, " << stats.misses
+                       << " misses, " << stats.wasted_bytes << " of "
+                       << stats.prefetched_bytes << " prefetched bytes wasted.";
+      },
+      kAssetPrefetchRecordingWindow);
+}
+
 fml::Milliseconds Shell::GetFrameBudget() {
   if (cached_display_refresh_rate_.has_value()) {
     return cached_display_refresh_rate_.value();
@@ -10,6 +10,7 @@
 #include <string_view>
 #include <unordered_map>
 
+#include "flutter/assets/asset_prefetcher.h"
 #include "flutter/assets/directory_asset_bundle.h"
 #include "flutter/common/graphics/texture.h"
 #include "flutter/common/settings.h"
@@ -200,6 +201,12 @@ class Shell final : public PlatformView::Delegate,
   ///             configuration as the current Shell but it needs to be in the
   ///             same snapshot or AOT.
   ///
+  ///             If `Settings::spawn_isolate_pool_size` is set, the root
+  ///             isolate of the new Shell is taken from the isolates this
+  ///             Shell created at idle time. The time from the call to the
+  ///             first frame of the new Shell is traced as
+  ///             "Shell::SpawnToFirstFrame".
+  ///
   /// @see        http://flutter.dev/go/multiple-engines
   std::unique_ptr<Shell> Spawn(
       RunConfiguration run_configuration,
@@ -491,6 +498,16 @@ class Shell final : public PlatformView::Delegate,
   uint64_t next_pointer_flow_id_ = 0;
 
   bool first_frame_rasterized_ = false;
+
+  // Only set if asset prefetch is enabled in the settings. Shared with the
+  // asset managers of the run configurations.
+  std::shared_ptr<AssetPrefetcher> asset_prefetcher_;
+  // Whether persisting the asset prefetch manifest has been scheduled. Only
+  // accessed on the raster thread.
+  bool asset_prefetch_manifest_scheduled_ = false;
+  // Only set for shells created by `Spawn` until their first frame is
+  // rasterized. Accessed on the raster thread once the shell is running.
+  std::optional<size_t> spawn_trace_id_;
   std::atomic<bool> waiting_for_first_frame_ = true;
   std::mutex waiting_for_first_frame_mutex_;
   std::condition_variable waiting_for_first_frame_condition_;
@@ -574,6 +591,14 @@ class Shell final : public PlatformView::Delegate,
 
   void ReportTimings();
 
+  // Starts recording the assets used by |asset_manager| and prefetches the
+  // assets recorded by a previous run on the IO thread.
+  void PrefetchAssets(const std::shared_ptr<AssetManager>& asset_manager);
+
+  // Stops recording assets once the first frame has been rasterized and
+  // persists the manifest of this run.
+  void ScheduleAssetPrefetchManifestPersist();
+
   // |PlatformView::Delegate|
   void OnPlatformViewCreated(std::unique_ptr<Surface> surface) override;
 
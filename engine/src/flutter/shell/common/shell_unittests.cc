@@ -3512,6 +3512,74 @@ TEST_F(ShellTest, ImageGeneratorRegistryNotNullAfterParentShellDestroyed) {
   DestroyShell(std::move(spawn));
 }
 
+TEST_F(ShellTest, SpawnTakesRootIsolateFromPool) {
+  auto settings = CreateSettingsForFixture();
+  settings.spawn_isolate_pool_size = 1;
+  auto shell = CreateShell(settings);
+  ASSERT_TRUE(ValidateShell(shell.get()));
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("emptyMain");
+  RunEngine(shell.get(), std::move(configuration));
+
+  PostSync(shell->GetTaskRunners().GetUITaskRunner(), [&shell] {
+    auto runtime_controller = const_cast<RuntimeController*>(
+        shell->GetEngine()->GetRuntimeController());
+    ASSERT_EQ(runtime_controller->GetPooledIsolateCount(), 0u);
+    auto deadline = fml::TimeDelta::FromMicroseconds(Dart_TimelineGetMicros()) +
+                    fml::TimeDelta::FromMilliseconds(100);
+    EXPECT_TRUE(runtime_controller->NotifyIdle(deadline));
+    EXPECT_EQ(runtime_controller->GetPooledIsolateCount(), 1u);
+    // The pool is full.
+    EXPECT_TRUE(runtime_controller->NotifyIdle(deadline));
+    EXPECT_EQ(runtime_controller->GetPooledIsolateCount(), 1u);
+  });
+
+  std::unique_ptr<Shell> spawn;
+  PostSync(shell->GetTaskRunners().GetPlatformTaskRunner(), [&shell, &settings,
+                                                             &spawn] {
+    auto second_configuration = RunConfiguration::InferFromSettings(settings);
+    ASSERT_TRUE(second_configuration.IsValid());
+    second_configuration.SetEntrypoint("emptyMain");
+    MockPlatformViewDelegate platform_view_delegate;
+    spawn = shell->Spawn(
+        std::move(second_configuration), "/",
+        [&platform_view_delegate](Shell& shell) {
+          auto result = std::make_unique<MockPlatformView>(
+              platform_view_delegate, shell.GetTaskRunners());
+          ON_CALL(*result, CreateRenderingSurface()).WillByDefault([] {
+            return std::make_unique<MockSurface>();
+          });
+          return result;
+        },
+        [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+  });
+  ASSERT_TRUE(ValidateShell(spawn.get()));
+
+  PostSync(spawn->GetTaskRunners().GetUITaskRunner(), [&shell, &spawn] {
+    const RuntimeController* spawner_controller =
+        shell->GetEngine()->GetRuntimeController();
+    const RuntimeController* spawn_controller =
+        spawn->GetEngine()->GetRuntimeController();
+    EXPECT_EQ(spawner_controller->GetPooledIsolateCount(), 0u);
+    EXPECT_EQ(spawner_controller->GetRootIsolateGroup(),
+              spawn_controller->GetRootIsolateGroup());
+
+    // The pooled isolate was rebound to the spawned engine.
+    std::shared_ptr<const DartIsolate> isolate =
+        spawn_controller->GetRootIsolate().lock();
+    ASSERT_TRUE(isolate);
+    EXPECT_EQ(isolate->GetPhase(), DartIsolate::Phase::Running);
+    EXPECT_EQ(isolate->GetImageGeneratorRegistry().get(),
+              spawn->GetEngine()->GetImageGeneratorRegistry().get());
+    EXPECT_EQ(isolate->GetSnapshotDelegate().get(),
+              spawn_controller->GetSnapshotDelegate().get());
+  });
+
+  DestroyShell(std::move(spawn));
+  DestroyShell(std::move(shell));
+}
+
 TEST_F(ShellTest, UpdateAssetResolverByTypeReplaces) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
   Settings settings = CreateSettingsForFixture();
@@ -200,6 +200,12 @@ DEF_SWITCH(PrefetchedDefaultFontManager,
            "prefetched-default-font-manager",
            "Indicates whether the embedding started a prefetch of the "
            "default font manager before creating the engine.")
+DEF_SWITCH(EnableAssetPrefetch,
+           "enable-asset-prefetch",
+           "Record the order in which assets are first used during startup "
+           "into a manifest in the caches directory, and prefetch the assets "
+           "of the manifest recorded by a previous run on the IO thread "
+           "before the first frame.")
 DEF_SWITCH(VerboseLogging,
            "verbose-logging",
            "By default, only errors are logged. This flag enabled logging at "
@@ -244,6 +250,10 @@ DEF_SWITCH(OldGenHeapSize,
 DEF_SWITCH(ResourceCacheMaxBytesThreshold,
            "resource-cache-max-bytes-threshold",
            "The max bytes threshold of resource cache, or 0 for unlimited.")
+DEF_SWITCH(SpawnIsolatePoolSize,
+           "spawn-isolate-pool-size",
+           "The number of isolates to create at idle time for engines spawned "
+           "from this one to take, or 0 to create them on spawn.")
 DEF_SWITCH(EnableImpeller,
            "enable-impeller",
            "Enable the Impeller renderer on supported platforms. Ignored if "
@@ -301,6 +311,23 @@ DEF_SWITCH(ImpellerAntialiasLines,
 DEF_SWITCH(ImpellerUseSDFs,
            "impeller-use-sdfs",
            "Whether to use SDFs for rendering in Impeller.")
+DEF_SWITCH(ImpellerParallelPathTessellation,
+           "impeller-parallel-path-tessellation",
+           "Experimental flag to tessellate the filled paths of a frame on "
+           "the worker threads of the Impeller context before rendering it.")
+DEF_SWITCH(ImpellerTessellationCache,
+           "impeller-tessellation-cache",
+           "Experimental flag to cache the tessellations of curved filled "
+           "paths by their contents and persist them across launches.")
+DEF_SWITCH(ImpellerParallelRenderPassEncoding,
+           "impeller-parallel-render-pass-encoding",
+           "Experimental flag to record the draws of large Vulkan render "
+           "passes into secondary command buffers on worker threads.")
+DEF_SWITCH(ImpellerPipelineVariantWarmUp,
+           "impeller-pipeline-variant-warm-up",
+           "Experimental flag to record the pipeline variants Impeller creates "
+           "on demand and compile them ahead of their first use on the next "
+           "launch.")
 DEF_SWITCHES_END
 
 }  // namespace flutter
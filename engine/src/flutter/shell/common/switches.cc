@@ -468,6 +468,9 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line,
   settings.prefetched_default_font_manager = command_line.HasOption(
       FlagForSwitch(Switch::PrefetchedDefaultFontManager));
 
+  settings.enable_asset_prefetch =
+      command_line.HasOption(FlagForSwitch(Switch::EnableAssetPrefetch));
+
   std::string all_dart_flags;
   if (command_line.GetOptionValue(FlagForSwitch(Switch::DartFlags),
                                   &all_dart_flags)) {
@@ -511,6 +514,13 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line,
         std::stoi(resource_cache_max_bytes_threshold);
   }
 
+  if (command_line.HasOption(FlagForSwitch(Switch::SpawnIsolatePoolSize))) {
+    std::string spawn_isolate_pool_size;
+    command_line.GetOptionValue(FlagForSwitch(Switch::SpawnIsolatePoolSize),
+                                &spawn_isolate_pool_size);
+    settings.spawn_isolate_pool_size = std::stoi(spawn_isolate_pool_size);
+  }
+
   settings.enable_platform_isolates =
       command_line.HasOption(FlagForSwitch(Switch::EnablePlatformIsolates));
 
@@ -558,6 +568,14 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line,
       command_line.HasOption(FlagForSwitch(Switch::ImpellerAntialiasLines));
   settings.impeller_use_sdfs =
       command_line.HasOption(FlagForSwitch(Switch::ImpellerUseSDFs));
+  settings.impeller_parallel_path_tessellation = command_line.HasOption(
+      FlagForSwitch(Switch::ImpellerParallelPathTessellation));
+  settings.impeller_tessellation_cache = command_line.HasOption(
+      FlagForSwitch(Switch::ImpellerTessellationCache));
+  settings.impeller_parallel_render_pass_encoding = command_line.HasOption(
+      FlagForSwitch(Switch::ImpellerParallelRenderPassEncoding));
+  settings.impeller_pipeline_variant_warm_up = command_line.HasOption(
+      FlagForSwitch(Switch::ImpellerPipelineVariantWarmUp));
 
   return settings;
 }
@@ -10,6 +10,7 @@
 #include "flutter/flow/surface.h"
 #include "flutter/fml/macros.h"
 #include "flutter/impeller/display_list/aiks_context.h"
+#include "flutter/impeller/display_list/backdrop_filter_cache.h"
 #include "flutter/impeller/renderer/backend/metal/context_mtl.h"
 #include "flutter/impeller/renderer/backend/metal/swapchain_transients_mtl.h"
 #include "flutter/shell/gpu/gpu_surface_metal_delegate.h"
@@ -48,6 +49,9 @@ class IMPELLER_CA_METAL_LAYER_AVAILABLE GPUSurfaceMetalImpeller
   std::shared_ptr<std::map<void*, DlIRect>> damage_ =
       std::make_shared<std::map<void*, DlIRect>>();
   std::shared_ptr<impeller::SwapchainTransientsMTL> swapchain_transients_;
+  // Filtered backdrops kept across frames, invalidated by the frame damage.
+  std::shared_ptr<impeller::BackdropFilterCache> backdrop_filter_cache_ =
+      std::make_shared<impeller::BackdropFilterCache>();
 
   // |Surface|
   std::unique_ptr<SurfaceFrame> AcquireFrame(
@@ -124,7 +124,8 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceMetalImpeller::AcquireFrameFromCAMetalLa
                          drawable,                                            //
                          weak_last_texture,                                   //
                          weak_layer,                                          //
-                         swapchain_transients = swapchain_transients_         //
+                         swapchain_transients = swapchain_transients_,        //
+                         backdrop_filter_cache = backdrop_filter_cache_       //
   ](SurfaceFrame& surface_frame, DlCanvas* canvas) mutable -> bool {
         id<MTLTexture> strong_last_texture = weak_last_texture;
         CAMetalLayer* strong_layer = weak_layer;
@@ -156,6 +157,10 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceMetalImpeller::AcquireFrameFromCAMetalLa
           (*damage)[texture] = DlIRect();
         }
 
+        // Backdrop filters that only read from undamaged parts of the frame are drawn from the
+        // previous frame. Without frame damage, the cache is cleared.
+        backdrop_filter_cache->Invalidate(surface_frame.submit_info().frame_damage);
+
         std::optional<impeller::IRect> clip_rect;
         if (surface_frame.submit_info().buffer_damage.has_value()) {
           auto buffer_damage = surface_frame.submit_info().buffer_damage;
@@ -186,11 +191,13 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceMetalImpeller::AcquireFrameFromCAMetalLa
         surface->SetFrameBoundary(surface_frame.submit_info().frame_boundary);
 
         const bool reset_host_buffer = surface_frame.submit_info().frame_boundary;
-        auto render_result = impeller::RenderToTarget(aiks_context->GetContentContext(),       //
-                                                      surface->GetRenderTarget(),              //
-                                                      display_list,                            //
-                                                      cull_rect,                               //
-                                                      /*reset_host_buffer=*/reset_host_buffer  //
+        auto render_result = impeller::RenderToTarget(aiks_context->GetContentContext(),        //
+                                                      surface->GetRenderTarget(),               //
+                                                      display_list,                             //
+                                                      cull_rect,                                //
+                                                      /*reset_host_buffer=*/reset_host_buffer,  //
+                                                      /*is_onscreen=*/true,                     //
+                                                      backdrop_filter_cache.get()               //
         );
         if (!render_result) {
           return false;
@@ -249,9 +256,10 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceMetalImpeller::AcquireFrameFromMTLTextur
   SurfaceFrame::EncodeCallback encode_callback =
       fml::MakeCopyable([disable_partial_repaint = disable_partial_repaint_,  //
                          damage = damage_,
-                         aiks_context = aiks_context_,                 //
-                         weak_texture,                                 //
-                         swapchain_transients = swapchain_transients_  //
+                         aiks_context = aiks_context_,                   //
+                         weak_texture,                                   //
+                         swapchain_transients = swapchain_transients_,   //
+                         backdrop_filter_cache = backdrop_filter_cache_  //
   ](SurfaceFrame& surface_frame, DlCanvas* canvas) mutable -> bool {
         id<MTLTexture> strong_texture = weak_texture;
         if (!strong_texture) {
@@ -280,6 +288,10 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceMetalImpeller::AcquireFrameFromMTLTextur
           (*damage)[texture_ptr] = DlIRect();
         }
 
+        // Backdrop filters that only read from undamaged parts of the frame are drawn from the
+        // previous frame. Without frame damage, the cache is cleared.
+        backdrop_filter_cache->Invalidate(surface_frame.submit_info().frame_damage);
+
         std::optional<impeller::IRect> clip_rect;
         if (surface_frame.submit_info().buffer_damage.has_value()) {
           auto buffer_damage = surface_frame.submit_info().buffer_damage;
@@ -305,7 +317,9 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceMetalImpeller::AcquireFrameFromMTLTextur
                                                       surface->GetRenderTarget(),         //
                                                       display_list,                       //
                                                       cull_rect,                          //
-                                                      /*reset_host_buffer=*/true          //
+                                                      /*reset_host_buffer=*/true,         //
+                                                      /*is_onscreen=*/true,               //
+                                                      backdrop_filter_cache.get()         //
         );
         if (!render_result) {
           FML_LOG(ERROR) << "Failed to render Impeller frame";
@@ -61,6 +61,18 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
     return nullptr;
   }
 
+  if (delegate_->PreservesBackingStoreContents()) {
+    framebuffer_info.supports_partial_repaint = true;
+    if (backing_store == last_backing_store_) {
+      // Nothing else has been rendered to the backing store since the last
+      // frame was presented.
+      framebuffer_info.existing_damage = DlIRect();
+    }
+  }
+  // Until this frame is presented, the backing store may hold a partially
+  // rendered frame.
+  last_backing_store_ = nullptr;
+
   // If the surface has been scaled, we need to apply the inverse scaling to the
   // underlying canvas so that coordinates are mapped to the same spot
   // irrespective of surface scaling.
@@ -84,8 +96,12 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
         if (!self || !self->IsValid()) {
           return false;
         }
-        return self->delegate_->PresentBackingStore(
-            surface_frame.SkiaSurface());
+        if (!self->delegate_->PresentBackingStore(
+                surface_frame.SkiaSurface())) {
+          return false;
+        }
+        self->last_backing_store_ = surface_frame.SkiaSurface();
+        return true;
       };
 
   return std::make_unique<SurfaceFrame>(backing_store, framebuffer_info,
@@ -38,6 +38,10 @@ class GPUSurfaceSoftware : public Surface {
   // hack to make avoid allocating resources for the root surface when an
   // external view embedder is present.
   const bool render_to_surface_;
+  // The backing store of the last presented frame. If the delegate preserves
+  // backing store contents and the same one is acquired again, it still holds
+  // that frame and only the damaged region needs to be redrawn.
+  sk_sp<SkSurface> last_backing_store_;
   fml::TaskRunnerAffineWeakPtrFactory<GPUSurfaceSoftware> weak_factory_;
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceSoftware);
 };
@@ -8,4 +8,8 @@ namespace flutter {
 
 GPUSurfaceSoftwareDelegate::~GPUSurfaceSoftwareDelegate() = default;
 
+bool GPUSurfaceSoftwareDelegate::PreservesBackingStoreContents() const {
+  return false;
+}
+
 }  // namespace flutter
@@ -48,6 +48,15 @@ class GPUSurfaceSoftwareDelegate {
   ///             the screen.
   ///
   virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether a backing store returned by |AcquireBackingStore|
+  ///             still has the contents it had when it was last passed to
+  ///             |PresentBackingStore|. If so, and the same backing store is
+  ///             returned for consecutive frames, the GPU surface only redraws
+  ///             the region that changed.
+  ///
+  virtual bool PreservesBackingStoreContents() const;
 };
 
 }  // namespace flutter
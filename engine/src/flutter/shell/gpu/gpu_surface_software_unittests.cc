@@ -0,0 +1,99 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/gpu/gpu_surface_software.h"
+
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+class TestGPUSurfaceSoftwareDelegate : public GPUSurfaceSoftwareDelegate {
+ public:
+  sk_sp<SkSurface> AcquireBackingStore(const DlISize& size) override {
+    if (backing_store_ && backing_store_->width() == size.width &&
+        backing_store_->height() == size.height) {
+      return backing_store_;
+    }
+    backing_store_ = SkSurfaces::Raster(
+        SkImageInfo::MakeN32Premul(size.width, size.height));
+    return backing_store_;
+  }
+
+  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override {
+    return present_result_;
+  }
+
+  bool PreservesBackingStoreContents() const override {
+    return preserves_contents_;
+  }
+
+  void SetPresentResult(bool present_result) {
+    present_result_ = present_result;
+  }
+
+  void SetPreservesBackingStoreContents(bool preserves_contents) {
+    preserves_contents_ = preserves_contents;
+  }
+
+ private:
+  sk_sp<SkSurface> backing_store_;
+  bool present_result_ = true;
+  bool preserves_contents_ = false;
+};
+
+TEST(GPUSurfaceSoftware, RequiresDelegateToPreserveContentsForPartialRepaint) {
+  TestGPUSurfaceSoftwareDelegate delegate;
+  GPUSurfaceSoftware surface(&delegate, /*render_to_surface=*/true);
+
+  auto frame = surface.AcquireFrame(DlISize(100, 100));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_FALSE(frame->framebuffer_info().supports_partial_repaint);
+  ASSERT_TRUE(frame->Submit());
+
+  frame = surface.AcquireFrame(DlISize(100, 100));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_FALSE(frame->framebuffer_info().supports_partial_repaint);
+  EXPECT_FALSE(frame->framebuffer_info().existing_damage.has_value());
+}
+
+TEST(GPUSurfaceSoftware, OnlyReusesContentsOfPresentedBackingStores) {
+  TestGPUSurfaceSoftwareDelegate delegate;
+  delegate.SetPreservesBackingStoreContents(true);
+  GPUSurfaceSoftware surface(&delegate, /*render_to_surface=*/true);
+
+  // A new backing store has no known contents.
+  auto frame = surface.AcquireFrame(DlISize(100, 100));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_TRUE(frame->framebuffer_info().supports_partial_repaint);
+  EXPECT_FALSE(frame->framebuffer_info().existing_damage.has_value());
+  ASSERT_TRUE(frame->Submit());
+
+  // The same backing store holds the presented frame.
+  frame = surface.AcquireFrame(DlISize(100, 100));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_EQ(frame->framebuffer_info().existing_damage, DlIRect());
+
+  // The previous frame was dropped, and may have been partially rendered.
+  frame = surface.AcquireFrame(DlISize(100, 100));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_FALSE(frame->framebuffer_info().existing_damage.has_value());
+  ASSERT_TRUE(frame->Submit());
+
+  delegate.SetPresentResult(false);
+  frame = surface.AcquireFrame(DlISize(100, 100));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_EQ(frame->framebuffer_info().existing_damage, DlIRect());
+  EXPECT_FALSE(frame->Submit());
+
+  // The previous frame failed to present.
+  delegate.SetPresentResult(true);
+  frame = surface.AcquireFrame(DlISize(100, 100));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_FALSE(frame->framebuffer_info().existing_damage.has_value());
+}
+
+}  // namespace testing
+}  // namespace flutter
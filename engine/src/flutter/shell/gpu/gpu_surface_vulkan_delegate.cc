@@ -8,4 +8,8 @@ namespace flutter {
 
 GPUSurfaceVulkanDelegate::~GPUSurfaceVulkanDelegate() = default;
 
+bool GPUSurfaceVulkanDelegate::PreservesImageContents() const {
+  return false;
+}
+
 }  // namespace flutter
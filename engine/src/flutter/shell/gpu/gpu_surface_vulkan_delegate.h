@@ -43,6 +43,15 @@ class GPUSurfaceVulkanDelegate {
   ///         and it's ready to be bound for further reading/writing.
   ///
   virtual bool PresentImage(VkImage image, VkFormat format) = 0;
+
+  /// @brief  Whether an image returned by |AcquireImage| still has the
+  ///         contents it had when it was last passed to |PresentImage|, in
+  ///         the `VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL` layout it was
+  ///         presented in. If so, the engine only redraws the region of the
+  ///         image that changed since then, for images whose usage includes
+  ///         `VK_IMAGE_USAGE_TRANSFER_DST_BIT`.
+  ///
+  virtual bool PreservesImageContents() const;
 };
 
 }  // namespace flutter
@@ -5,6 +5,7 @@
 #include "flutter/shell/gpu/gpu_surface_vulkan_impeller.h"
 
 #include <memory>
+#include <optional>
 
 #include "flow/surface_frame.h"
 #include "flutter/fml/make_copyable.h"
@@ -196,20 +197,40 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceVulkanImpeller::AcquireFrame(
           impeller_context_, desc,
           /*enable_msaa=*/true);
       transients_size_ = frame_size;
+      // The embedder recreates its images when the size changes, and the
+      // handles of the old images may be reused.
+      images_->clear();
     }
 
     auto wrapped_onscreen = std::make_shared<WrappedTextureSourceVK>(
         vk_image, std::move(image_view), desc);
-    auto surface = impeller::SurfaceVK::WrapSwapchainImage(
-        transients_, wrapped_onscreen, [&]() -> bool { return true; });
-    impeller::RenderTarget render_target = surface->GetRenderTarget();
-    auto cull_rect =
-        impeller::Rect::MakeSize(render_target.GetRenderTargetSize());
 
-    SurfaceFrame::EncodeCallback encode_callback = [aiks_context =
-                                                        aiks_context_,  //
-                                                    render_target,
-                                                    cull_rect  //
+    // The damaged region is copied to the image, which requires the image
+    // to be a transfer destination.
+    const bool partial_repaint = delegate_->PreservesImageContents() &&
+                                 (flutter_image.usage &
+                                  VK_IMAGE_USAGE_TRANSFER_DST_BIT) != 0;
+    std::optional<DlIRect> existing_damage;
+    if (partial_repaint) {
+      auto i = images_->find(static_cast<VkImage>(vk_image));
+      if (i != images_->end() &&
+          i->second.layout != impeller::vk::ImageLayout::eUndefined) {
+        existing_damage = i->second.damage;
+        // The image was presented by this surface before, in the layout that
+        // was recorded then. Its contents must not be discarded by a
+        // transition from the undefined layout.
+        wrapped_onscreen->SetLayoutWithoutEncoding(i->second.layout);
+      }
+    }
+
+    SurfaceFrame::EncodeCallback encode_callback =
+        [aiks_context = aiks_context_,            //
+         transients = transients_,                //
+         wrapped_onscreen,                        //
+         images = images_,                        //
+         partial_repaint,                         //
+         image = static_cast<VkImage>(vk_image),  //
+         frame_rect = DlIRect::MakeSize(size)     //
     ](SurfaceFrame& surface_frame, DlCanvas* canvas) mutable -> bool {
       if (!aiks_context) {
         return false;
@@ -221,18 +242,65 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceVulkanImpeller::AcquireFrame(
         return false;
       }
 
-      return impeller::RenderToTarget(aiks_context->GetContentContext(),  //
-                                      render_target,                      //
-                                      display_list,                       //
-                                      cull_rect,                          //
-                                      /*reset_host_buffer=*/true          //
-      );
+      std::optional<impeller::IRect> clip_rect;
+      if (partial_repaint) {
+        const std::optional<DlIRect>& frame_damage =
+            surface_frame.submit_info().frame_damage;
+        for (auto& entry : *images) {
+          // Accumulate damage for the other images. Without frame damage the
+          // whole frame was redrawn.
+          if (entry.first != image) {
+            entry.second.damage =
+                frame_damage.has_value()
+                    ? entry.second.damage.Union(frame_damage.value())
+                    : frame_rect;
+          }
+        }
+        // Reset accumulated damage for the current image. Its contents are
+        // not known until it is presented.
+        (*images)[image] = ImageState{};
+
+        const std::optional<DlIRect>& buffer_damage =
+            surface_frame.submit_info().buffer_damage;
+        if (buffer_damage.has_value()) {
+          clip_rect = impeller::IRect::MakeLTRB(
+              buffer_damage->GetLeft(), buffer_damage->GetTop(),
+              buffer_damage->GetRight(), buffer_damage->GetBottom());
+        }
+      }
+
+      // Nothing changed since the image was last presented.
+      if (clip_rect.has_value() && clip_rect->IsEmpty()) {
+        return true;
+      }
+
+      auto surface = impeller::SurfaceVK::WrapSwapchainImage(
+          transients, wrapped_onscreen, []() -> bool { return true; },
+          clip_rect);
+      if (!surface) {
+        return false;
+      }
+
+      impeller::RenderTarget render_target = surface->GetRenderTarget();
+      auto cull_rect =
+          impeller::Rect::MakeSize(render_target.GetRenderTargetSize());
+      auto render_result =
+          impeller::RenderToTarget(aiks_context->GetContentContext(),  //
+                                   render_target,                      //
+                                   display_list,                       //
+                                   cull_rect,                          //
+                                   /*reset_host_buffer=*/true          //
+          );
+      if (!render_result) {
+        return false;
+      }
+      return surface->PreparePresent();
     };
 
     SurfaceFrame::SubmitCallback submit_callback =
         [image = flutter_image, delegate = delegate_,
-         impeller_context = impeller_context_,
-         wrapped_onscreen](const SurfaceFrame&) -> bool {
+         impeller_context = impeller_context_, wrapped_onscreen,
+         images = images_, partial_repaint](const SurfaceFrame&) -> bool {
       TRACE_EVENT0("flutter", "GPUSurfaceVulkan::PresentImage");
 
       {
@@ -267,11 +335,27 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceVulkanImpeller::AcquireFrame(
         }
       }
 
-      return delegate->PresentImage(reinterpret_cast<VkImage>(image.image),
-                                    static_cast<VkFormat>(image.format));
+      if (!delegate->PresentImage(reinterpret_cast<VkImage>(image.image),
+                                  static_cast<VkFormat>(image.format))) {
+        return false;
+      }
+      if (partial_repaint) {
+        // Record the layout the image really is in, so that the next frame
+        // that renders to it transitions it from that layout.
+        (*images)[reinterpret_cast<VkImage>(image.image)].layout =
+            wrapped_onscreen->GetLayout();
+      }
+      return true;
     };
 
     SurfaceFrame::FramebufferInfo framebuffer_info{.supports_readback = true};
+    if (partial_repaint) {
+      // Provide the accumulated damage of the image to the rasterizer (the
+      // area that lags behind the most recently presented frame). Images that
+      // were never presented are redrawn entirely.
+      framebuffer_info.supports_partial_repaint = true;
+      framebuffer_info.existing_damage = existing_damage;
+    }
 
     return std::make_unique<SurfaceFrame>(nullptr,           // surface
                                           framebuffer_info,  // framebuffer info
@@ -5,6 +5,9 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_VULKAN_IMPELLER_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_VULKAN_IMPELLER_H_
 
+#include <map>
+#include <memory>
+
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/macros.h"
@@ -13,12 +16,17 @@
 #include "flutter/impeller/renderer/context.h"
 #include "flutter/shell/gpu/gpu_surface_vulkan_delegate.h"
 #include "impeller/renderer/backend/vulkan/swapchain/swapchain_transients_vk.h"
+#include "impeller/renderer/backend/vulkan/vk.h"
 
 namespace flutter {
 
 namespace testing {
 FML_TEST_CLASS(GPUSurfaceVulkanImpeller,
                RecreatesTransientsWhenFrameSizeChanges);
+FML_TEST_CLASS(GPUSurfaceVulkanImpeller,
+               TracksDamageWhenImageContentsArePreserved);
+FML_TEST_CLASS(GPUSurfaceVulkanImpeller,
+               RequiresTransferDestinationForPartialRepaint);
 }  // namespace testing
 
 class GPUSurfaceVulkanImpeller final : public Surface {
@@ -35,6 +43,10 @@ class GPUSurfaceVulkanImpeller final : public Surface {
  private:
   FML_FRIEND_TEST(testing::GPUSurfaceVulkanImpeller,
                   RecreatesTransientsWhenFrameSizeChanges);
+  FML_FRIEND_TEST(testing::GPUSurfaceVulkanImpeller,
+                  TracksDamageWhenImageContentsArePreserved);
+  FML_FRIEND_TEST(testing::GPUSurfaceVulkanImpeller,
+                  RequiresTransferDestinationForPartialRepaint);
 
   GPUSurfaceVulkanDelegate* delegate_;
   std::shared_ptr<impeller::Context> impeller_context_;
@@ -42,6 +54,17 @@ class GPUSurfaceVulkanImpeller final : public Surface {
   std::shared_ptr<impeller::SwapchainTransientsVK> transients_;
   /// The size of the textures in [transients_]
   impeller::ISize transients_size_ = {};
+  struct ImageState {
+    // The damage accumulated since the image was last presented.
+    DlIRect damage;
+    // The layout the image was presented in, or undefined if the image was
+    // not presented since it was last rendered to.
+    impeller::vk::ImageLayout layout = impeller::vk::ImageLayout::eUndefined;
+  };
+  // The state of each image of the delegate, keyed by the VkImage handle.
+  // Only tracked if the delegate preserves image contents.
+  std::shared_ptr<std::map<VkImage, ImageState>> images_ =
+      std::make_shared<std::map<VkImage, ImageState>>();
   bool is_valid_ = false;
 
   // |Surface|
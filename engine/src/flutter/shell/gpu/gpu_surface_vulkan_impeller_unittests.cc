@@ -50,16 +50,32 @@ class TestGPUSurfaceVulkanDelegate : public GPUSurfaceVulkanDelegate {
                      ? reinterpret_cast<uint64_t>(test_surface_->GetImage())
                      : 0u,
         .format = VK_FORMAT_R8G8B8A8_UNORM,
+        .usage = image_usage_,
     };
   }
 
   bool PresentImage(VkImage image, VkFormat format) override { return true; }
 
+  bool PreservesImageContents() const override {
+    return preserves_image_contents_;
+  }
+
+  void SetPreservesImageContents(bool preserves_image_contents) {
+    preserves_image_contents_ = preserves_image_contents;
+  }
+
+  void SetImageUsage(uint32_t image_usage) { image_usage_ = image_usage; }
+
  private:
   fml::RefPtr<vulkan::VulkanProcTable> vk_;
   fml::RefPtr<TestVulkanContext> test_context_;
   std::unique_ptr<TestVulkanSurface> test_surface_;
   DlISize surface_size_ = {};
+  bool preserves_image_contents_ = false;
+  // The usage of the images created by |TestVulkanSurface|.
+  uint32_t image_usage_ = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                          VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                          VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 };
 
 TEST(GPUSurfaceVulkanImpeller, DisposesThreadLocalResources) {
@@ -110,5 +126,92 @@ TEST(GPUSurfaceVulkanImpeller, RecreatesTransientsWhenFrameSizeChanges) {
   EXPECT_EQ(surface->transients_size_, impeller::ISize(200, 100));
 }
 
+TEST(GPUSurfaceVulkanImpeller, TracksDamageWhenImageContentsArePreserved) {
+  impeller::ContextVK::Settings context_settings;
+  context_settings.proc_address_callback = vkGetInstanceProcAddr;
+  context_settings.shader_libraries_data = ShaderLibraryMappings();
+  auto context = impeller::ContextVK::Create(std::move(context_settings));
+
+  TestGPUSurfaceVulkanDelegate delegate;
+
+  auto surface = std::make_unique<GPUSurfaceVulkanImpeller>(&delegate, context);
+
+  // Without the guarantee that images keep their contents, every frame is
+  // redrawn entirely.
+  auto frame = surface->AcquireFrame(DlISize(100, 100));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_FALSE(frame->framebuffer_info().supports_partial_repaint);
+  EXPECT_TRUE(surface->images_->empty());
+
+  delegate.SetPreservesImageContents(true);
+
+  // An image that was never presented has no known contents.
+  frame = surface->AcquireFrame(DlISize(100, 100));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_TRUE(frame->framebuffer_info().supports_partial_repaint);
+  EXPECT_FALSE(frame->framebuffer_info().existing_damage.has_value());
+  frame->set_submit_info({
+      .frame_damage = DlIRect::MakeWH(100, 100),
+      .buffer_damage = DlIRect::MakeWH(100, 100),
+  });
+  ASSERT_TRUE(frame->Encode());
+  ASSERT_TRUE(frame->Submit());
+  ASSERT_EQ(surface->images_->size(), 1u);
+  EXPECT_EQ(surface->images_->begin()->second.layout,
+            impeller::vk::ImageLayout::eColorAttachmentOptimal);
+
+  // The delegate returns the same image again, which is up to date.
+  frame = surface->AcquireFrame(DlISize(100, 100));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_TRUE(frame->framebuffer_info().supports_partial_repaint);
+  EXPECT_EQ(frame->framebuffer_info().existing_damage, DlIRect());
+  frame->set_submit_info({
+      .frame_damage = DlIRect::MakeLTRB(10, 10, 20, 20),
+      .buffer_damage = DlIRect::MakeLTRB(10, 10, 20, 20),
+  });
+  ASSERT_TRUE(frame->Encode());
+  ASSERT_TRUE(frame->Submit());
+  EXPECT_EQ(surface->images_->begin()->second.layout,
+            impeller::vk::ImageLayout::eColorAttachmentOptimal);
+
+  // A frame that is encoded but not presented leaves the image with unknown
+  // contents.
+  frame = surface->AcquireFrame(DlISize(100, 100));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_EQ(frame->framebuffer_info().existing_damage, DlIRect());
+  frame->set_submit_info({
+      .frame_damage = DlIRect::MakeLTRB(10, 10, 20, 20),
+      .buffer_damage = DlIRect::MakeLTRB(10, 10, 20, 20),
+  });
+  ASSERT_TRUE(frame->Encode());
+  frame = surface->AcquireFrame(DlISize(100, 100));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_FALSE(frame->framebuffer_info().existing_damage.has_value());
+
+  // New images are created for a new size, so the damage is forgotten.
+  frame = surface->AcquireFrame(DlISize(200, 100));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_FALSE(frame->framebuffer_info().existing_damage.has_value());
+  EXPECT_TRUE(surface->images_->empty());
+}
+
+TEST(GPUSurfaceVulkanImpeller, RequiresTransferDestinationForPartialRepaint) {
+  impeller::ContextVK::Settings context_settings;
+  context_settings.proc_address_callback = vkGetInstanceProcAddr;
+  context_settings.shader_libraries_data = ShaderLibraryMappings();
+  auto context = impeller::ContextVK::Create(std::move(context_settings));
+
+  TestGPUSurfaceVulkanDelegate delegate;
+  delegate.SetPreservesImageContents(true);
+  delegate.SetImageUsage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT);
+
+  auto surface = std::make_unique<GPUSurfaceVulkanImpeller>(&delegate, context);
+
+  auto frame = surface->AcquireFrame(DlISize(100, 100));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_FALSE(frame->framebuffer_info().supports_partial_repaint);
+  EXPECT_TRUE(surface->images_->empty());
+}
+
 }  // namespace testing
 }  // namespace flutter
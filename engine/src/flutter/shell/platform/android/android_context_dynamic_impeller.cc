@@ -129,6 +129,14 @@ GetActualRenderingAPIForImpeller(
               {
                   .antialiased_lines =
                       settings.impeller_flags.antialiased_lines,
+                  .parallel_path_tessellation =
+                      settings.impeller_flags.parallel_path_tessellation,
+                  .tessellation_cache =
+                      settings.impeller_flags.tessellation_cache,
+                  .parallel_render_pass_encoding =
+                      settings.impeller_flags.parallel_render_pass_encoding,
+                  .pipeline_variant_warm_up =
+                      settings.impeller_flags.pipeline_variant_warm_up,
               },
       });
   if (!vulkan_backend->IsValid()) {
@@ -144,6 +144,11 @@ bool AndroidSurfaceSoftware::PresentBackingStore(
   return true;
 }
 
+bool AndroidSurfaceSoftware::PreservesBackingStoreContents() const {
+  // The backing store is only read from when it is copied to the window.
+  return true;
+}
+
 void AndroidSurfaceSoftware::TeardownOnScreenContext() {}
 
 bool AndroidSurfaceSoftware::OnScreenSurfaceResize(const DlISize& size) {
@@ -61,6 +61,14 @@ AndroidContext::ContextSettings CreateContextSettings(
   settings.enable_surface_control = p_settings.enable_surface_control;
   settings.impeller_flags.antialiased_lines =
       p_settings.impeller_antialiased_lines;
+  settings.impeller_flags.parallel_path_tessellation =
+      p_settings.impeller_parallel_path_tessellation;
+  settings.impeller_flags.tessellation_cache =
+      p_settings.impeller_tessellation_cache;
+  settings.impeller_flags.parallel_render_pass_encoding =
+      p_settings.impeller_parallel_render_pass_encoding;
+  settings.impeller_flags.pipeline_variant_warm_up =
+      p_settings.impeller_pipeline_variant_warm_up;
   return settings;
 }
 }  // namespace
@@ -19,6 +19,32 @@ constexpr int kHasScrollingAction =
     FlutterSemanticsAction::kFlutterSemanticsActionScrollUp |
     FlutterSemanticsAction::kFlutterSemanticsActionScrollDown;
 
+// Whether applying |node_data| to |node| would leave its data unchanged. The
+// offset container of a node is set once an update has been applied, see
+// |AccessibilityBridge::OnAtomicUpdateFinished|, so it is not compared.
+static bool IsNodeDataUnchanged(const ui::AXNode& node,
+                                const ui::AXNodeData& node_data) {
+  const ui::AXNodeData& data = node.data();
+  const gfx::Transform* transform = data.relative_bounds.transform.get();
+  const gfx::Transform* new_transform =
+      node_data.relative_bounds.transform.get();
+  if ((transform == nullptr) != (new_transform == nullptr) ||
+      (transform != nullptr && !(*transform == *new_transform))) {
+    return false;
+  }
+  return data.role == node_data.role && data.state == node_data.state &&
+         data.actions == node_data.actions &&
+         data.child_ids == node_data.child_ids &&
+         data.relative_bounds.bounds == node_data.relative_bounds.bounds &&
+         data.string_attributes == node_data.string_attributes &&
+         data.int_attributes == node_data.int_attributes &&
+         data.float_attributes == node_data.float_attributes &&
+         data.bool_attributes == node_data.bool_attributes &&
+         data.intlist_attributes == node_data.intlist_attributes &&
+         data.stringlist_attributes == node_data.stringlist_attributes &&
+         data.html_attributes == node_data.html_attributes;
+}
+
 // AccessibilityBridge
 AccessibilityBridge::AccessibilityBridge()
     : tree_(std::make_unique<ui::AXTree>()) {
@@ -80,16 +106,24 @@ void AccessibilityBridge::CommitUpdates() {
   // lists in the reversed order, this guarantees parent updates always come
   // before child updates. If the root is in the update, it is guaranteed to
   // be the first node of the last list.
+  //
+  // Nodes are moved out of the pending updates rather than copied, since an
+  // update of a large tree holds thousands of them.
   std::vector<std::vector<SemanticsNode>> results;
+  size_t node_count = pending_semantics_node_updates_.size();
   while (!pending_semantics_node_updates_.empty()) {
     auto begin = pending_semantics_node_updates_.begin();
-    SemanticsNode target = begin->second;
-    std::vector<SemanticsNode> sub_tree_list;
-    GetSubTreeList(target, sub_tree_list);
-    results.push_back(sub_tree_list);
+    SemanticsNode target = std::move(begin->second);
     pending_semantics_node_updates_.erase(begin);
+    std::vector<SemanticsNode> sub_tree_list;
+    GetSubTreeList(std::move(target), sub_tree_list);
+    results.push_back(std::move(sub_tree_list));
   }
 
+  // Nodes whose data would not change are left out of the update, so that
+  // resending an unchanged subtree does not make the tree diff and notify
+  // every node of it.
+  update.nodes.reserve(node_count);
   for (size_t i = results.size(); i > 0; i--) {
     for (const SemanticsNode& node : results[i - 1]) {
       ConvertFlutterUpdate(node, update);
@@ -267,15 +301,20 @@ AccessibilityBridge::CreateRemoveReparentedNodesUpdate() {
 }
 
 // Private method.
-void AccessibilityBridge::GetSubTreeList(const SemanticsNode& target,
+void AccessibilityBridge::GetSubTreeList(SemanticsNode target,
                                          std::vector<SemanticsNode>& result) {
-  result.push_back(target);
-  for (int32_t child : target.children_in_traversal_order) {
-    auto iter = pending_semantics_node_updates_.find(child);
+  // |result| may reallocate while the children are visited, so the target is
+  // referred to by index.
+  size_t index = result.size();
+  result.push_back(std::move(target));
+  for (size_t i = 0; i < result[index].children_in_traversal_order.size();
+       i++) {
+    auto iter = pending_semantics_node_updates_.find(
+        result[index].children_in_traversal_order[i]);
     if (iter != pending_semantics_node_updates_.end()) {
-      SemanticsNode node = iter->second;
-      GetSubTreeList(node, result);
+      SemanticsNode node = std::move(iter->second);
       pending_semantics_node_updates_.erase(iter);
+      GetSubTreeList(std::move(node), result);
     }
   }
 }
@@ -303,11 +342,13 @@ void AccessibilityBridge::ConvertFlutterUpdate(const SemanticsNode& node,
       node.transform.skewY, node.transform.scaleY, node.transform.transY, 0,
       node.transform.pers0, node.transform.pers1, node.transform.pers2, 0, 0, 0,
       0, 0);
-  for (auto child : node.children_in_traversal_order) {
-    node_data.child_ids.push_back(child);
-  }
+  node_data.child_ids = node.children_in_traversal_order;
   SetTreeData(node, tree_update);
-  tree_update.nodes.push_back(node_data);
+  ui::AXNode* existing_node = tree_->GetFromId(node.id);
+  if (existing_node && IsNodeDataUnchanged(*existing_node, node_data)) {
+    return;
+  }
+  tree_update.nodes.push_back(std::move(node_data));
 }
 
 void AccessibilityBridge::SetRoleFromFlutterUpdate(ui::AXNodeData& node_data,
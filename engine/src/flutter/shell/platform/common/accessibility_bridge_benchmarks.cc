@@ -0,0 +1,120 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/test_accessibility_bridge.h"
+
+namespace flutter {
+
+namespace {
+
+FlutterSemanticsFlags kEmptyFlags = FlutterSemanticsFlags{};
+
+// A semantics tree of a root with |kGroupCount| groups of |kLeafCount| leaves,
+// about the size of a long scrolling list with accessibility turned on.
+class SemanticsTree {
+ public:
+  static constexpr int32_t kGroupCount = 100;
+  static constexpr int32_t kLeafCount = 99;
+
+  SemanticsTree() {
+    int32_t node_count = 1 + kGroupCount * (1 + kLeafCount);
+    children_.resize(node_count);
+    labels_.resize(node_count);
+    int32_t next_id = 1;
+    for (int32_t group = 0; group < kGroupCount; group++) {
+      int32_t group_id = next_id++;
+      children_[0].push_back(group_id);
+      for (int32_t leaf = 0; leaf < kLeafCount; leaf++) {
+        children_[group_id].push_back(next_id++);
+      }
+    }
+    for (int32_t id = 0; id < node_count; id++) {
+      labels_[id] = "node " + std::to_string(id);
+    }
+  }
+
+  size_t GetNodeCount() const { return labels_.size(); }
+
+  // Toggles a suffix on the label of every |stride|th node.
+  void ChangeLabels(int32_t stride) {
+    for (size_t id = 0; id < labels_.size(); id += stride) {
+      std::string& label = labels_[id];
+      if (label.back() == '\'') {
+        label.pop_back();
+      } else {
+        label.push_back('\'');
+      }
+    }
+  }
+
+  void AddNodeUpdates(AccessibilityBridge& bridge) const {
+    for (size_t id = 0; id < labels_.size(); id++) {
+      bridge.AddFlutterSemanticsNodeUpdate({
+          .id = static_cast<int32_t>(id),
+          .text_selection_base = -1,
+          .text_selection_extent = -1,
+          .label = labels_[id].c_str(),
+          .hint = "",
+          .value = "",
+          .increased_value = "",
+          .decreased_value = "",
+          .rect = {0, 0, 100, 20},
+          .transform = {.scaleX = 1, .scaleY = 1, .pers2 = 1},
+          .child_count = children_[id].size(),
+          .children_in_traversal_order = children_[id].data(),
+          .tooltip = "",
+          .flags2 = &kEmptyFlags,
+      });
+    }
+  }
+
+ private:
+  std::vector<std::vector<int32_t>> children_;
+  std::vector<std::string> labels_;
+};
+
+}  // namespace
+
+static void BM_AccessibilityBridgeCommitNewTree(benchmark::State& state) {
+  SemanticsTree tree;
+  for (auto _ : state) {
+    auto bridge = std::make_shared<TestAccessibilityBridge>();
+    tree.AddNodeUpdates(*bridge);
+    bridge->CommitUpdates();
+  }
+  state.SetItemsProcessed(state.iterations() * tree.GetNodeCount());
+}
+
+// Resends the whole tree with the labels of 1 in |state.range(0)| nodes
+// changed, or none if the range is 0.
+static void BM_AccessibilityBridgeCommitUpdate(benchmark::State& state) {
+  SemanticsTree tree;
+  auto bridge = std::make_shared<TestAccessibilityBridge>();
+  tree.AddNodeUpdates(*bridge);
+  bridge->CommitUpdates();
+  for (auto _ : state) {
+    state.PauseTiming();
+    if (state.range(0) > 0) {
+      tree.ChangeLabels(state.range(0));
+    }
+    bridge->accessibility_events.clear();
+    state.ResumeTiming();
+    tree.AddNodeUpdates(*bridge);
+    bridge->CommitUpdates();
+  }
+  state.SetItemsProcessed(state.iterations() * tree.GetNodeCount());
+}
+
+BENCHMARK(BM_AccessibilityBridgeCommitNewTree)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AccessibilityBridgeCommitUpdate)
+    ->Arg(0)
+    ->Arg(100)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace flutter
@@ -20,8 +20,13 @@ class ByteBufferStreamReader : public ByteStreamReader {
  public:
   // Createa a reader reading from |bytes|, which must have a length of |size|.
   // |bytes| must remain valid for the lifetime of this object.
-  explicit ByteBufferStreamReader(const uint8_t* bytes, size_t size)
-      : bytes_(bytes), size_(size) {}
+  //
+  // If |allow_borrowing| is true, BorrowBytes returns pointers into |bytes|,
+  // which callers may hold on to for as long as |bytes| remains valid.
+  explicit ByteBufferStreamReader(const uint8_t* bytes,
+                                  size_t size,
+                                  bool allow_borrowing = false)
+      : bytes_(bytes), size_(size), allow_borrowing_(allow_borrowing) {}
 
   virtual ~ByteBufferStreamReader() = default;
 
@@ -52,11 +57,24 @@ class ByteBufferStreamReader : public ByteStreamReader {
     }
   }
 
+  // |ByteStreamReader|
+  const uint8_t* BorrowBytes(size_t length) override {
+    // Out of bounds reads are reported by the ReadBytes fallback.
+    if (!allow_borrowing_ || location_ + length > size_) {
+      return nullptr;
+    }
+    const uint8_t* bytes = &bytes_[location_];
+    location_ += length;
+    return bytes;
+  }
+
  private:
   // The buffer to read from.
   const uint8_t* bytes_;
   // The total size of the buffer.
   size_t size_;
+  // Whether BorrowBytes may return pointers into |bytes_|.
+  bool allow_borrowing_;
   // The current read location.
   size_t location_ = 0;
 };
@@ -64,8 +82,9 @@ class ByteBufferStreamReader : public ByteStreamReader {
 // Implementation of ByteStreamWriter based on a byte array.
 class ByteBufferStreamWriter : public ByteStreamWriter {
  public:
-  // Creates a writer that writes into |buffer|.
-  // |buffer| must remain valid for the lifetime of this object.
+  // Creates a writer that appends to |buffer|.
+  // |buffer| must remain valid for the lifetime of this object. Callers that
+  // know the encoded size in advance should reserve it in |buffer| first.
   explicit ByteBufferStreamWriter(std::vector<uint8_t>* buffer)
       : bytes_(buffer) {
     assert(buffer);
@@ -86,9 +105,7 @@ class ByteBufferStreamWriter : public ByteStreamWriter {
   void WriteAlignment(uint8_t alignment) {
     uint8_t mod = bytes_->size() % alignment;
     if (mod) {
-      for (int i = 0; i < alignment - mod; ++i) {
-        WriteByte(0);
-      }
+      bytes_->resize(bytes_->size() + alignment - mod, 0);
     }
   }
 
@@ -97,6 +114,37 @@ class ByteBufferStreamWriter : public ByteStreamWriter {
   std::vector<uint8_t>* bytes_;
 };
 
+// Implementation of ByteStreamWriter that only counts the bytes that would be
+// written, used to size buffers before encoding into them.
+class ByteCountingStreamWriter : public ByteStreamWriter {
+ public:
+  ByteCountingStreamWriter() = default;
+
+  virtual ~ByteCountingStreamWriter() = default;
+
+  // |ByteStreamWriter|
+  void WriteByte(uint8_t /*byte*/) override { size_++; }
+
+  // |ByteStreamWriter|
+  void WriteBytes(const uint8_t* /*bytes*/, size_t length) override {
+    size_ += length;
+  }
+
+  // |ByteStreamWriter|
+  void WriteAlignment(uint8_t alignment) override {
+    uint8_t mod = size_ % alignment;
+    if (mod) {
+      size_ += alignment - mod;
+    }
+  }
+
+  // Returns the number of bytes written so far.
+  size_t size() const { return size_; }
+
+ private:
+  size_t size_ = 0;
+};
+
 }  // namespace flutter
 
 #endif  // FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_BYTE_BUFFER_STREAMS_H_
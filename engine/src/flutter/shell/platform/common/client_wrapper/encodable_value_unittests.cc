@@ -328,6 +328,41 @@ TEST(EncodableValueTest, TypeIndexesCorrect) {
   EXPECT_EQ(((EncodableValue)CustomEncodableValue(customValue)).index(), 12u);
   // FloatList
   EXPECT_EQ(EncodableValue(std::vector<float>()).index(), 13u);
+  // TypedDataView
+  EXPECT_EQ(EncodableValue(EncodableTypedDataView(
+                               static_cast<const uint8_t*>(nullptr), 0))
+                .index(),
+            14u);
 }  // namespace flutter
 
+TEST(EncodableValueTest, TypedDataView) {
+  std::vector<int32_t> elements = {1, 2, 3};
+  EncodableValue value(EncodableTypedDataView(elements.data(), 3));
+
+  const auto& view = std::get<EncodableTypedDataView>(value);
+  EXPECT_EQ(view.element_type(), EncodableTypedDataView::ElementType::kInt32);
+  EXPECT_EQ(view.size(), 3u);
+  EXPECT_EQ(view.size_in_bytes(), 12u);
+  EXPECT_EQ(view.data<int32_t>(), elements.data());
+  EXPECT_EQ(view.ToVector<int32_t>(), elements);
+
+  // Views are compared by contents.
+  std::vector<int32_t> same_elements = {1, 2, 3};
+  std::vector<int32_t> larger_elements = {1, 2, 4};
+  std::vector<float> float_elements = {1.0f, 2.0f, 3.0f};
+  EXPECT_EQ(value, EncodableValue(EncodableTypedDataView(same_elements.data(),
+                                                         3)));
+  EXPECT_LT(value, EncodableValue(EncodableTypedDataView(
+                       larger_elements.data(), 3)));
+  EXPECT_FALSE(value == EncodableValue(EncodableTypedDataView(
+                           float_elements.data(), 3)));
+}
+
+TEST(EncodableValueTest, ConstructionFromTemporaryMovesContents) {
+  std::vector<uint8_t> bytes(1024, 0x42);
+  const uint8_t* data = bytes.data();
+  EncodableValue value(std::move(bytes));
+  EXPECT_EQ(std::get<std::vector<uint8_t>>(value).data(), data);
+}
+
 }  // namespace flutter
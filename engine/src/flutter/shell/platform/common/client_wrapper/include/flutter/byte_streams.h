@@ -26,6 +26,14 @@ class ByteStreamReader {
   // the start of the stream, unless it is already aligned.
   virtual void ReadAlignment(uint8_t alignment) = 0;
 
+  // Returns a pointer to the next |length| bytes of the stream and advances
+  // past them, without copying.
+  //
+  // Returns nullptr without advancing if the stream cannot lend its bytes, in
+  // which case the caller should use ReadBytes instead. The returned bytes are
+  // owned by the stream's underlying buffer.
+  virtual const uint8_t* BorrowBytes(size_t /*length*/) { return nullptr; }
+
   // Reads and returns the next 32-bit integer from the stream.
   int32_t ReadInt32() {
     int32_t value = 0;
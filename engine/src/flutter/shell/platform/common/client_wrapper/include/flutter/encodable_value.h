@@ -5,12 +5,15 @@
 #ifndef FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_ENCODABLE_VALUE_H_
 #define FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_ENCODABLE_VALUE_H_
 
+#include <algorithm>
 #include <any>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <optional>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -89,6 +92,152 @@ class CustomEncodableValue {
   std::any value_;
 };
 
+// A non-owning view of a typed list (Uint8List, Int32List, Int64List,
+// Float32List, or Float64List) whose elements live in a buffer owned by
+// someone else.
+//
+// Writing a view encodes it exactly as the corresponding std::vector would be
+// encoded, which allows sending large typed lists from an existing buffer
+// without first copying them into an EncodableValue. The buffer must remain
+// valid until the message has been encoded.
+//
+// Views are also produced when decoding with
+// StandardMessageCodec::DecodeMessageWithBorrowedTypedData, in which case they
+// point into the message being decoded and must not be used after the message
+// is freed. Use ToVector to keep a copy of the elements.
+//
+// Views compare equal if their element types and elements are equal.
+class EncodableTypedDataView {
+ public:
+  // The type of the elements of the list.
+  enum class ElementType { kUint8, kInt32, kInt64, kFloat32, kFloat64 };
+
+  EncodableTypedDataView(const uint8_t* data, size_t size)
+      : data_(data), size_(size), element_type_(ElementType::kUint8) {}
+  EncodableTypedDataView(const int32_t* data, size_t size)
+      : data_(data), size_(size), element_type_(ElementType::kInt32) {}
+  EncodableTypedDataView(const int64_t* data, size_t size)
+      : data_(data), size_(size), element_type_(ElementType::kInt64) {}
+  EncodableTypedDataView(const float* data, size_t size)
+      : data_(data), size_(size), element_type_(ElementType::kFloat32) {}
+  EncodableTypedDataView(const double* data, size_t size)
+      : data_(data), size_(size), element_type_(ElementType::kFloat64) {}
+
+  ElementType element_type() const { return element_type_; }
+
+  // Returns the number of elements in the list.
+  size_t size() const { return size_; }
+
+  // Returns the number of bytes of the elements.
+  size_t size_in_bytes() const { return size_ * ElementSize(element_type_); }
+
+  // Returns the elements of the list as raw bytes.
+  const uint8_t* bytes() const { return static_cast<const uint8_t*>(data_); }
+
+  // Returns the elements of the list, which must be of type |T|.
+  template <typename T>
+  const T* data() const {
+    assert(element_type_ == ElementTypeOf<T>());
+    return static_cast<const T*>(data_);
+  }
+
+  // Returns a copy of the elements of the list, which must be of type |T|.
+  template <typename T>
+  std::vector<T> ToVector() const {
+    const T* elements = data<T>();
+    return std::vector<T>(elements, elements + size_);
+  }
+
+  // Returns the size of a single element of the given type.
+  static constexpr size_t ElementSize(ElementType element_type) {
+    switch (element_type) {
+      case ElementType::kUint8:
+        return sizeof(uint8_t);
+      case ElementType::kInt32:
+        return sizeof(int32_t);
+      case ElementType::kInt64:
+        return sizeof(int64_t);
+      case ElementType::kFloat32:
+        return sizeof(float);
+      case ElementType::kFloat64:
+        return sizeof(double);
+    }
+    return 0;
+  }
+
+  bool operator==(const EncodableTypedDataView& other) const {
+    if (element_type_ != other.element_type_ || size_ != other.size_) {
+      return false;
+    }
+    switch (element_type_) {
+      case ElementType::kUint8:
+        return ElementsEqual<uint8_t>(other);
+      case ElementType::kInt32:
+        return ElementsEqual<int32_t>(other);
+      case ElementType::kInt64:
+        return ElementsEqual<int64_t>(other);
+      case ElementType::kFloat32:
+        return ElementsEqual<float>(other);
+      case ElementType::kFloat64:
+        return ElementsEqual<double>(other);
+    }
+    return false;
+  }
+
+  bool operator<(const EncodableTypedDataView& other) const {
+    if (element_type_ != other.element_type_) {
+      return element_type_ < other.element_type_;
+    }
+    switch (element_type_) {
+      case ElementType::kUint8:
+        return ElementsLess<uint8_t>(other);
+      case ElementType::kInt32:
+        return ElementsLess<int32_t>(other);
+      case ElementType::kInt64:
+        return ElementsLess<int64_t>(other);
+      case ElementType::kFloat32:
+        return ElementsLess<float>(other);
+      case ElementType::kFloat64:
+        return ElementsLess<double>(other);
+    }
+    return false;
+  }
+
+ private:
+  template <typename T>
+  static constexpr ElementType ElementTypeOf() {
+    if constexpr (std::is_same_v<T, uint8_t>) {
+      return ElementType::kUint8;
+    } else if constexpr (std::is_same_v<T, int32_t>) {
+      return ElementType::kInt32;
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+      return ElementType::kInt64;
+    } else if constexpr (std::is_same_v<T, float>) {
+      return ElementType::kFloat32;
+    } else {
+      static_assert(std::is_same_v<T, double>,
+                    "Unsupported EncodableTypedDataView element type");
+      return ElementType::kFloat64;
+    }
+  }
+
+  template <typename T>
+  bool ElementsEqual(const EncodableTypedDataView& other) const {
+    return std::equal(data<T>(), data<T>() + size_, other.data<T>());
+  }
+
+  template <typename T>
+  bool ElementsLess(const EncodableTypedDataView& other) const {
+    return std::lexicographical_compare(data<T>(), data<T>() + size_,
+                                        other.data<T>(),
+                                        other.data<T>() + other.size_);
+  }
+
+  const void* data_;
+  size_t size_;
+  ElementType element_type_;
+};
+
 class EncodableValue;
 
 // Convenience type aliases.
@@ -114,7 +263,8 @@ using EncodableValueVariant = std::variant<std::monostate,
                                            EncodableList,
                                            EncodableMap,
                                            CustomEncodableValue,
-                                           std::vector<float>>;
+                                           std::vector<float>,
+                                           EncodableTypedDataView>;
 }  // namespace internal
 
 // An object that can contain any value or collection type supported by
@@ -163,6 +313,9 @@ using EncodableValueVariant = std::variant<std::monostate,
 // std::vector<double>  -> Float64List
 // EncodableList        -> List
 // EncodableMap         -> Map
+//
+// EncodableTypedDataView is encoded as the typed list matching its element
+// type, but is only decoded when explicitly requested; see its comment.
 class EncodableValue : public internal::EncodableValueVariant {
  public:
   // Rely on std::variant for most of the constructors/operators.
@@ -197,7 +350,8 @@ class EncodableValue : public internal::EncodableValueVariant {
   // compile, go through a pointer->bool->EncodableValue(bool) chain and
   // silently call the function with a temp-constructed EncodableValue(true).
   template <class T>
-  constexpr explicit EncodableValue(T&& t) noexcept : super(t) {}
+  constexpr explicit EncodableValue(T&& t) noexcept
+      : super(std::forward<T>(t)) {}
 
   // Returns true if the value is null. Convenience wrapper since unlike the
   // other types, std::monostate uses aren't self-documenting.
@@ -62,13 +62,21 @@ class StandardCodecSerializer {
   // position in |stream|, and returns it as the corresponding EncodableValue.
   // |T| must correspond to one of the supported list value types of
   // EncodableValue.
+  //
+  // If |stream| lends its bytes and they are suitably aligned, the list is
+  // returned as an EncodableTypedDataView instead of being copied.
   template <typename T>
   EncodableValue ReadVector(ByteStreamReader* stream) const;
 
   // Writes |vector| to |stream| as a fixed-type list. |T| must correspond to
   // one of the supported list value types of EncodableValue.
   template <typename T>
-  void WriteVector(const std::vector<T> vector, ByteStreamWriter* stream) const;
+  void WriteVector(const std::vector<T>& vector,
+                   ByteStreamWriter* stream) const;
+
+  // Writes |view| to |stream| as the fixed-type list of its element type.
+  void WriteTypedDataView(const EncodableTypedDataView& view,
+                          ByteStreamWriter* stream) const;
 };
 
 }  // namespace flutter
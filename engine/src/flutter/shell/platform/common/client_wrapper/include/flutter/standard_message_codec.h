@@ -35,6 +35,31 @@ class StandardMessageCodec : public MessageCodec<EncodableValue> {
   StandardMessageCodec(StandardMessageCodec const&) = delete;
   StandardMessageCodec& operator=(StandardMessageCodec const&) = delete;
 
+  // Returns the message encoded in |binary_message| like DecodeMessage, except
+  // that typed lists are returned as EncodableTypedDataViews that point into
+  // |binary_message| rather than as copies.
+  //
+  // The returned value must not be used after |binary_message| is freed, so
+  // this is meant for handlers that consume large typed lists before
+  // returning. Lists that are not suitably aligned in |binary_message| are
+  // copied as usual.
+  //
+  // Channels always decode with DecodeMessage. To borrow, register a handler
+  // for raw binary messages on the messenger and decode them with this.
+  std::unique_ptr<EncodableValue> DecodeMessageWithBorrowedTypedData(
+      const uint8_t* binary_message,
+      const size_t message_size) const;
+
+  // Returns |message| encoded like EncodeMessage, except that the message is
+  // measured before it is encoded so that the returned buffer is allocated
+  // once, at its final size.
+  //
+  // This serializes the message twice, so it is only worthwhile for large
+  // messages, such as ones with big typed lists, where growing the buffer
+  // would copy it repeatedly.
+  std::unique_ptr<std::vector<uint8_t>> EncodeMessageIntoExactlySizedBuffer(
+      const EncodableValue& message) const;
+
  protected:
   // |flutter::MessageCodec|
   std::unique_ptr<EncodableValue> DecodeMessageInternal(
@@ -35,6 +35,31 @@ class StandardMethodCodec : public MethodCodec<EncodableValue> {
   StandardMethodCodec(StandardMethodCodec const&) = delete;
   StandardMethodCodec& operator=(StandardMethodCodec const&) = delete;
 
+  // Returns the MethodCall encoded in |message| like DecodeMethodCall, except
+  // that typed lists in the arguments are returned as EncodableTypedDataViews
+  // that point into |message| rather than as copies.
+  //
+  // The returned call must not be used after |message| is freed. See
+  // StandardMessageCodec::DecodeMessageWithBorrowedTypedData. MethodChannel
+  // handlers receive calls decoded with DecodeMethodCall, so borrowing is
+  // only available to code that decodes the binary messages itself.
+  std::unique_ptr<MethodCall<EncodableValue>>
+  DecodeMethodCallWithBorrowedTypedData(const uint8_t* message,
+                                        size_t message_size) const;
+
+  // Returns |method_call| encoded like EncodeMethodCall, into a buffer that
+  // is allocated once at its final size. See
+  // StandardMessageCodec::EncodeMessageIntoExactlySizedBuffer.
+  std::unique_ptr<std::vector<uint8_t>> EncodeMethodCallIntoExactlySizedBuffer(
+      const MethodCall<EncodableValue>& method_call) const;
+
+  // Returns |result| encoded like EncodeSuccessEnvelope, into a buffer that is
+  // allocated once at its final size. See
+  // StandardMessageCodec::EncodeMessageIntoExactlySizedBuffer.
+  std::unique_ptr<std::vector<uint8_t>>
+  EncodeSuccessEnvelopeIntoExactlySizedBuffer(
+      const EncodableValue* result = nullptr) const;
+
  protected:
   // |flutter::MethodCodec|
   std::unique_ptr<MethodCall<EncodableValue>> DecodeMethodCallInternal(
@@ -65,6 +90,18 @@ class StandardMethodCodec : public MethodCodec<EncodableValue> {
   // Instances should be obtained via GetInstance.
   explicit StandardMethodCodec(const StandardCodecSerializer* serializer);
 
+  // Reads a MethodCall from |stream|.
+  std::unique_ptr<MethodCall<EncodableValue>> ReadMethodCall(
+      ByteStreamReader* stream) const;
+
+  // Writes |method_call| to |stream|.
+  void WriteMethodCall(const MethodCall<EncodableValue>& method_call,
+                       ByteStreamWriter* stream) const;
+
+  // Writes a success envelope containing |result| to |stream|.
+  void WriteSuccessEnvelope(const EncodableValue* result,
+                            ByteStreamWriter* stream) const;
+
   const StandardCodecSerializer* serializer_;
 };
 
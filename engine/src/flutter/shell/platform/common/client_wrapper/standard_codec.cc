@@ -8,10 +8,13 @@
 // that any client that needs one of these files needs all three.
 
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "byte_buffer_streams.h"
@@ -73,11 +76,53 @@ EncodedType EncodedTypeForValue(const EncodableValue& value) {
       return EncodedType::kMap;
     case 13:
       return EncodedType::kFloat32List;
+    case 14:
+      switch (std::get<EncodableTypedDataView>(value).element_type()) {
+        case EncodableTypedDataView::ElementType::kUint8:
+          return EncodedType::kUInt8List;
+        case EncodableTypedDataView::ElementType::kInt32:
+          return EncodedType::kInt32List;
+        case EncodableTypedDataView::ElementType::kInt64:
+          return EncodedType::kInt64List;
+        case EncodableTypedDataView::ElementType::kFloat32:
+          return EncodedType::kFloat32List;
+        case EncodableTypedDataView::ElementType::kFloat64:
+          return EncodedType::kFloat64List;
+      }
+      break;
   }
   assert(false);
   return EncodedType::kNull;
 }
 
+// Returns the bytes written by |write|.
+template <typename WriteFunction>
+std::unique_ptr<std::vector<uint8_t>> EncodeIntoBuffer(
+    const WriteFunction& write) {
+  auto encoded = std::make_unique<std::vector<uint8_t>>();
+  ByteBufferStreamWriter stream(encoded.get());
+  write(&stream);
+  return encoded;
+}
+
+// Returns the bytes written by |write|, which is called once to count the bytes
+// and once more to write them into a buffer of exactly that size, so that
+// large messages are never copied by reallocation.
+//
+// Alignment padding is relative to the start of the stream, so the whole
+// message has to be counted at once rather than value by value.
+template <typename WriteFunction>
+std::unique_ptr<std::vector<uint8_t>> EncodeIntoExactlySizedBuffer(
+    const WriteFunction& write) {
+  ByteCountingStreamWriter counter;
+  write(&counter);
+  auto encoded = std::make_unique<std::vector<uint8_t>>();
+  encoded->reserve(counter.size());
+  ByteBufferStreamWriter stream(encoded.get());
+  write(&stream);
+  return encoded;
+}
+
 }  // namespace
 
 StandardCodecSerializer::StandardCodecSerializer() = default;
@@ -162,6 +207,9 @@ void StandardCodecSerializer::WriteValue(const EncodableValue& value,
       WriteVector(std::get<std::vector<float>>(value), stream);
       break;
     }
+    case 14:
+      WriteTypedDataView(std::get<EncodableTypedDataView>(value), stream);
+      break;
   }
 }
 
@@ -188,7 +236,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       std::string string_value;
       string_value.resize(size);
       stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
-      return EncodableValue(string_value);
+      return EncodableValue(std::move(string_value));
     }
     case EncodedType::kUInt8List:
       return ReadVector<uint8_t>(stream);
@@ -205,7 +253,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       for (size_t i = 0; i < length; ++i) {
         list_value.push_back(ReadValue(stream));
       }
-      return EncodableValue(list_value);
+      return EncodableValue(std::move(list_value));
     }
     case EncodedType::kMap: {
       size_t length = ReadSize(stream);
@@ -215,7 +263,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
         EncodableValue value = ReadValue(stream);
         map_value.emplace(std::move(key), std::move(value));
       }
-      return EncodableValue(map_value);
+      return EncodableValue(std::move(map_value));
     }
     case EncodedType::kFloat32List: {
       return ReadVector<float>(stream);
@@ -260,19 +308,30 @@ template <typename T>
 EncodableValue StandardCodecSerializer::ReadVector(
     ByteStreamReader* stream) const {
   size_t count = ReadSize(stream);
-  std::vector<T> vector;
-  vector.resize(count);
   uint8_t type_size = static_cast<uint8_t>(sizeof(T));
   if (type_size > 1) {
     stream->ReadAlignment(type_size);
   }
+  std::vector<T> vector;
+  if (const uint8_t* bytes = stream->BorrowBytes(count * type_size)) {
+    // Alignment in the stream is relative to the start of the message, so the
+    // elements are only aligned in memory if the message itself is.
+    if (reinterpret_cast<uintptr_t>(bytes) % alignof(T) == 0) {
+      return EncodableValue(
+          EncodableTypedDataView(reinterpret_cast<const T*>(bytes), count));
+    }
+    vector.resize(count);
+    std::memcpy(vector.data(), bytes, count * type_size);
+    return EncodableValue(std::move(vector));
+  }
+  vector.resize(count);
   stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
                     count * type_size);
-  return EncodableValue(vector);
+  return EncodableValue(std::move(vector));
 }
 
 template <typename T>
-void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
+void StandardCodecSerializer::WriteVector(const std::vector<T>& vector,
                                           ByteStreamWriter* stream) const {
   size_t count = vector.size();
   WriteSize(count, stream);
@@ -287,6 +346,22 @@ void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
                      count * type_size);
 }
 
+void StandardCodecSerializer::WriteTypedDataView(
+    const EncodableTypedDataView& view,
+    ByteStreamWriter* stream) const {
+  size_t count = view.size();
+  WriteSize(count, stream);
+  if (count == 0) {
+    return;
+  }
+  uint8_t type_size = static_cast<uint8_t>(
+      EncodableTypedDataView::ElementSize(view.element_type()));
+  if (type_size > 1) {
+    stream->WriteAlignment(type_size);
+  }
+  stream->WriteBytes(view.bytes(), view.size_in_bytes());
+}
+
 // ===== standard_message_codec.h =====
 
 // static
@@ -326,13 +401,32 @@ std::unique_ptr<EncodableValue> StandardMessageCodec::DecodeMessageInternal(
   return std::make_unique<EncodableValue>(serializer_->ReadValue(&stream));
 }
 
+std::unique_ptr<EncodableValue>
+StandardMessageCodec::DecodeMessageWithBorrowedTypedData(
+    const uint8_t* binary_message,
+    const size_t message_size) const {
+  if (!binary_message) {
+    return std::make_unique<EncodableValue>();
+  }
+  ByteBufferStreamReader stream(binary_message, message_size,
+                                /*allow_borrowing=*/true);
+  return std::make_unique<EncodableValue>(serializer_->ReadValue(&stream));
+}
+
 std::unique_ptr<std::vector<uint8_t>>
 StandardMessageCodec::EncodeMessageInternal(
     const EncodableValue& message) const {
-  auto encoded = std::make_unique<std::vector<uint8_t>>();
-  ByteBufferStreamWriter stream(encoded.get());
-  serializer_->WriteValue(message, &stream);
-  return encoded;
+  return EncodeIntoBuffer([&](ByteStreamWriter* stream) {
+    serializer_->WriteValue(message, stream);
+  });
+}
+
+std::unique_ptr<std::vector<uint8_t>>
+StandardMessageCodec::EncodeMessageIntoExactlySizedBuffer(
+    const EncodableValue& message) const {
+  return EncodeIntoExactlySizedBuffer([&](ByteStreamWriter* stream) {
+    serializer_->WriteValue(message, stream);
+  });
 }
 
 // ===== standard_method_codec.h =====
@@ -368,7 +462,21 @@ std::unique_ptr<MethodCall<EncodableValue>>
 StandardMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
                                               size_t message_size) const {
   ByteBufferStreamReader stream(message, message_size);
-  EncodableValue method_name_value = serializer_->ReadValue(&stream);
+  return ReadMethodCall(&stream);
+}
+
+std::unique_ptr<MethodCall<EncodableValue>>
+StandardMethodCodec::DecodeMethodCallWithBorrowedTypedData(
+    const uint8_t* message,
+    size_t message_size) const {
+  ByteBufferStreamReader stream(message, message_size,
+                                /*allow_borrowing=*/true);
+  return ReadMethodCall(&stream);
+}
+
+std::unique_ptr<MethodCall<EncodableValue>> StandardMethodCodec::ReadMethodCall(
+    ByteStreamReader* stream) const {
+  EncodableValue method_name_value = serializer_->ReadValue(stream);
   const auto* method_name = std::get_if<std::string>(&method_name_value);
   if (!method_name) {
     std::cerr << "Invalid method call; method name is not a string."
@@ -376,37 +484,62 @@ StandardMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
     return nullptr;
   }
   auto arguments =
-      std::make_unique<EncodableValue>(serializer_->ReadValue(&stream));
+      std::make_unique<EncodableValue>(serializer_->ReadValue(stream));
   return std::make_unique<MethodCall<EncodableValue>>(*method_name,
                                                       std::move(arguments));
 }
 
-std::unique_ptr<std::vector<uint8_t>>
-StandardMethodCodec::EncodeMethodCallInternal(
-    const MethodCall<EncodableValue>& method_call) const {
-  auto encoded = std::make_unique<std::vector<uint8_t>>();
-  ByteBufferStreamWriter stream(encoded.get());
-  serializer_->WriteValue(EncodableValue(method_call.method_name()), &stream);
+void StandardMethodCodec::WriteMethodCall(
+    const MethodCall<EncodableValue>& method_call,
+    ByteStreamWriter* stream) const {
+  serializer_->WriteValue(EncodableValue(method_call.method_name()), stream);
   if (method_call.arguments()) {
-    serializer_->WriteValue(*method_call.arguments(), &stream);
+    serializer_->WriteValue(*method_call.arguments(), stream);
   } else {
-    serializer_->WriteValue(EncodableValue(), &stream);
+    serializer_->WriteValue(EncodableValue(), stream);
   }
-  return encoded;
 }
 
-std::unique_ptr<std::vector<uint8_t>>
-StandardMethodCodec::EncodeSuccessEnvelopeInternal(
-    const EncodableValue* result) const {
-  auto encoded = std::make_unique<std::vector<uint8_t>>();
-  ByteBufferStreamWriter stream(encoded.get());
-  stream.WriteByte(0);
+void StandardMethodCodec::WriteSuccessEnvelope(const EncodableValue* result,
+                                               ByteStreamWriter* stream) const {
+  stream->WriteByte(0);
   if (result) {
-    serializer_->WriteValue(*result, &stream);
+    serializer_->WriteValue(*result, stream);
   } else {
-    serializer_->WriteValue(EncodableValue(), &stream);
+    serializer_->WriteValue(EncodableValue(), stream);
   }
-  return encoded;
+}
+
+std::unique_ptr<std::vector<uint8_t>>
+StandardMethodCodec::EncodeMethodCallInternal(
+    const MethodCall<EncodableValue>& method_call) const {
+  return EncodeIntoBuffer([&](ByteStreamWriter* stream) {
+    WriteMethodCall(method_call, stream);
+  });
+}
+
+std::unique_ptr<std::vector<uint8_t>>
+StandardMethodCodec::EncodeMethodCallIntoExactlySizedBuffer(
+    const MethodCall<EncodableValue>& method_call) const {
+  return EncodeIntoExactlySizedBuffer([&](ByteStreamWriter* stream) {
+    WriteMethodCall(method_call, stream);
+  });
+}
+
+std::unique_ptr<std::vector<uint8_t>>
+StandardMethodCodec::EncodeSuccessEnvelopeInternal(
+    const EncodableValue* result) const {
+  return EncodeIntoBuffer([&](ByteStreamWriter* stream) {
+    WriteSuccessEnvelope(result, stream);
+  });
+}
+
+std::unique_ptr<std::vector<uint8_t>>
+StandardMethodCodec::EncodeSuccessEnvelopeIntoExactlySizedBuffer(
+    const EncodableValue* result) const {
+  return EncodeIntoExactlySizedBuffer([&](ByteStreamWriter* stream) {
+    WriteSuccessEnvelope(result, stream);
+  });
 }
 
 std::unique_ptr<std::vector<uint8_t>>
@@ -414,21 +547,20 @@ StandardMethodCodec::EncodeErrorEnvelopeInternal(
     const std::string& error_code,
     const std::string& error_message,
     const EncodableValue* error_details) const {
-  auto encoded = std::make_unique<std::vector<uint8_t>>();
-  ByteBufferStreamWriter stream(encoded.get());
-  stream.WriteByte(1);
-  serializer_->WriteValue(EncodableValue(error_code), &stream);
-  if (error_message.empty()) {
-    serializer_->WriteValue(EncodableValue(), &stream);
-  } else {
-    serializer_->WriteValue(EncodableValue(error_message), &stream);
-  }
-  if (error_details) {
-    serializer_->WriteValue(*error_details, &stream);
-  } else {
-    serializer_->WriteValue(EncodableValue(), &stream);
-  }
-  return encoded;
+  EncodableValue code(error_code);
+  EncodableValue message = error_message.empty()
+                               ? EncodableValue()
+                               : EncodableValue(error_message);
+  return EncodeIntoBuffer([&](ByteStreamWriter* stream) {
+    stream->WriteByte(1);
+    serializer_->WriteValue(code, stream);
+    serializer_->WriteValue(message, stream);
+    if (error_details) {
+      serializer_->WriteValue(*error_details, stream);
+    } else {
+      serializer_->WriteValue(EncodableValue(), stream);
+    }
+  });
 }
 
 bool StandardMethodCodec::DecodeAndProcessResponseEnvelopeInternal(
@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
+
+namespace flutter {
+namespace benchmarking {
+
+// A message shaped like a frame of sensor data: a few scalar fields and one
+// large typed list whose size is the benchmark argument, in bytes.
+static EncodableValue MakeSensorMessage(size_t payload_bytes) {
+  std::vector<float> samples(payload_bytes / sizeof(float));
+  for (size_t i = 0; i < samples.size(); i++) {
+    samples[i] = static_cast<float>(i);
+  }
+  return EncodableValue(EncodableMap{
+      {EncodableValue("sensor"), EncodableValue("accelerometer")},
+      {EncodableValue("timestamp"), EncodableValue(int64_t{1234567890})},
+      {EncodableValue("samples"), EncodableValue(std::move(samples))},
+  });
+}
+
+static void BM_StandardCodecEncode(benchmark::State& state) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  EncodableValue message = MakeSensorMessage(state.range(0));
+  for (auto _ : state) {
+    std::unique_ptr<std::vector<uint8_t>> encoded =
+        codec.EncodeMessage(message);
+    benchmark::DoNotOptimize(encoded->data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_StandardCodecEncodeExactlySized(benchmark::State& state) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  EncodableValue message = MakeSensorMessage(state.range(0));
+  for (auto _ : state) {
+    std::unique_ptr<std::vector<uint8_t>> encoded =
+        codec.EncodeMessageIntoExactlySizedBuffer(message);
+    benchmark::DoNotOptimize(encoded->data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Encodes a view of the caller's samples, which avoids building an owned
+// EncodableValue for every message.
+static void BM_StandardCodecEncodeTypedDataView(benchmark::State& state) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  std::vector<float> samples(state.range(0) / sizeof(float), 1.0f);
+  for (auto _ : state) {
+    std::unique_ptr<std::vector<uint8_t>> encoded = codec.EncodeMessage(
+        EncodableValue(EncodableTypedDataView(samples.data(), samples.size())));
+    benchmark::DoNotOptimize(encoded->data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_StandardCodecDecode(benchmark::State& state) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  std::unique_ptr<std::vector<uint8_t>> encoded =
+      codec.EncodeMessage(MakeSensorMessage(state.range(0)));
+  for (auto _ : state) {
+    std::unique_ptr<EncodableValue> decoded = codec.DecodeMessage(*encoded);
+    benchmark::DoNotOptimize(decoded.get());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_StandardCodecDecodeBorrowed(benchmark::State& state) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  std::unique_ptr<std::vector<uint8_t>> encoded =
+      codec.EncodeMessage(MakeSensorMessage(state.range(0)));
+  for (auto _ : state) {
+    std::unique_ptr<EncodableValue> decoded =
+        codec.DecodeMessageWithBorrowedTypedData(encoded->data(),
+                                                 encoded->size());
+    benchmark::DoNotOptimize(decoded.get());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_StandardCodecEncode)->RangeMultiplier(16)->Range(64, 4 << 20);
+BENCHMARK(BM_StandardCodecEncodeExactlySized)
+    ->RangeMultiplier(16)
+    ->Range(64, 4 << 20);
+BENCHMARK(BM_StandardCodecEncodeTypedDataView)
+    ->RangeMultiplier(16)
+    ->Range(64, 4 << 20);
+BENCHMARK(BM_StandardCodecDecode)->RangeMultiplier(16)->Range(64, 4 << 20);
+BENCHMARK(BM_StandardCodecDecodeBorrowed)
+    ->RangeMultiplier(16)
+    ->Range(64, 4 << 20);
+
+}  // namespace benchmarking
+}  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
 
+#include <cstring>
 #include <map>
 #include <vector>
 
@@ -262,4 +263,95 @@ TEST(StandardMessageCodec, CanEncodeAndDecodeVariableLengthCustomType) {
                     some_data_comparator);
 }
 
+TEST(StandardMessageCodec, CanEncodeTypedDataViews) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  std::vector<uint8_t> bytes = {0xba, 0x5e, 0xba, 0x11};
+  std::vector<int32_t> ints = {0x12345678, -1, 0};
+  std::vector<int64_t> longs = {0x1234567890abcdef, -1};
+  std::vector<float> floats = {3.1415920257568359375f, 1000.0f};
+  std::vector<double> doubles = {3.14159265358979311599796346854, 1000.0};
+  std::vector<uint8_t> no_bytes;
+
+  EXPECT_EQ(*codec.EncodeMessage(EncodableValue(bytes)),
+            *codec.EncodeMessage(EncodableValue(
+                EncodableTypedDataView(bytes.data(), bytes.size()))));
+  EXPECT_EQ(*codec.EncodeMessage(EncodableValue(ints)),
+            *codec.EncodeMessage(EncodableValue(
+                EncodableTypedDataView(ints.data(), ints.size()))));
+  EXPECT_EQ(*codec.EncodeMessage(EncodableValue(longs)),
+            *codec.EncodeMessage(EncodableValue(
+                EncodableTypedDataView(longs.data(), longs.size()))));
+  EXPECT_EQ(*codec.EncodeMessage(EncodableValue(floats)),
+            *codec.EncodeMessage(EncodableValue(
+                EncodableTypedDataView(floats.data(), floats.size()))));
+  EXPECT_EQ(*codec.EncodeMessage(EncodableValue(doubles)),
+            *codec.EncodeMessage(EncodableValue(
+                EncodableTypedDataView(doubles.data(), doubles.size()))));
+  EXPECT_EQ(*codec.EncodeMessage(EncodableValue(no_bytes)),
+            *codec.EncodeMessage(EncodableValue(
+                EncodableTypedDataView(no_bytes.data(), 0))));
+}
+
+TEST(StandardMessageCodec, EncodedMessagesAreExactlySized) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  EncodableValue value(EncodableList{
+      EncodableValue("a"),
+      EncodableValue(std::vector<double>(1000, 1.0)),
+      EncodableValue(EncodableMap{
+          {EncodableValue(1), EncodableValue(std::vector<float>(3, 1.0f))},
+      }),
+  });
+  auto encoded = codec.EncodeMessageIntoExactlySizedBuffer(value);
+  ASSERT_TRUE(encoded);
+  EXPECT_EQ(encoded->capacity(), encoded->size());
+  EXPECT_EQ(*encoded, *codec.EncodeMessage(value));
+  EXPECT_EQ(*codec.DecodeMessage(*encoded), value);
+}
+
+TEST(StandardMessageCodec, CanDecodeTypedListsWithoutCopying) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  std::vector<double> doubles = {1.0, 2.0, 3.0};
+  std::vector<uint8_t> bytes = {0x01, 0x02};
+  EncodableValue value(EncodableList{
+      EncodableValue(doubles),
+      EncodableValue(bytes),
+      EncodableValue("not a typed list"),
+  });
+  auto encoded = codec.EncodeMessage(value);
+  ASSERT_TRUE(encoded);
+
+  auto decoded = codec.DecodeMessageWithBorrowedTypedData(encoded->data(),
+                                                          encoded->size());
+  const auto& list = std::get<EncodableList>(*decoded);
+  ASSERT_EQ(list.size(), 3u);
+
+  const auto& doubles_view = std::get<EncodableTypedDataView>(list[0]);
+  EXPECT_EQ(doubles_view.ToVector<double>(), doubles);
+  EXPECT_GE(doubles_view.bytes(), encoded->data());
+  EXPECT_LE(doubles_view.bytes() + doubles_view.size_in_bytes(),
+            encoded->data() + encoded->size());
+
+  const auto& bytes_view = std::get<EncodableTypedDataView>(list[1]);
+  EXPECT_EQ(bytes_view.ToVector<uint8_t>(), bytes);
+  EXPECT_EQ(std::get<std::string>(list[2]), "not a typed list");
+
+  // Decoding normally still copies.
+  EXPECT_EQ(*codec.DecodeMessage(*encoded), value);
+}
+
+TEST(StandardMessageCodec, CopiesBorrowedTypedListsThatAreNotAligned) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  std::vector<int64_t> longs = {1, 2, 3};
+  auto encoded = codec.EncodeMessage(EncodableValue(longs));
+  ASSERT_TRUE(encoded);
+
+  // Shift the message by one byte so that the elements are misaligned.
+  std::vector<uint8_t> shifted(encoded->size() + 1);
+  std::memcpy(shifted.data() + 1, encoded->data(), encoded->size());
+
+  auto decoded = codec.DecodeMessageWithBorrowedTypedData(shifted.data() + 1,
+                                                          encoded->size());
+  EXPECT_EQ(*decoded, EncodableValue(longs));
+}
+
 }  // namespace flutter
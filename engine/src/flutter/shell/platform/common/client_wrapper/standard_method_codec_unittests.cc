@@ -180,4 +180,40 @@ TEST(StandardMethodCodec, HandlesCustomTypeArguments) {
   EXPECT_EQ(point, decoded_point);
 };
 
+TEST(StandardMethodCodec, EncodesIntoExactlySizedBuffers) {
+  const StandardMethodCodec& codec = StandardMethodCodec::GetInstance();
+  EncodableValue arguments(std::vector<double>(1000, 1.0));
+  MethodCall<> call("hello", std::make_unique<EncodableValue>(arguments));
+
+  auto encoded_call = codec.EncodeMethodCallIntoExactlySizedBuffer(call);
+  ASSERT_NE(encoded_call.get(), nullptr);
+  EXPECT_EQ(encoded_call->capacity(), encoded_call->size());
+  EXPECT_EQ(*encoded_call, *codec.EncodeMethodCall(call));
+
+  auto encoded_envelope =
+      codec.EncodeSuccessEnvelopeIntoExactlySizedBuffer(&arguments);
+  ASSERT_NE(encoded_envelope.get(), nullptr);
+  EXPECT_EQ(encoded_envelope->capacity(), encoded_envelope->size());
+  EXPECT_EQ(*encoded_envelope, *codec.EncodeSuccessEnvelope(&arguments));
+}
+
+TEST(StandardMethodCodec, CanDecodeTypedListArgumentsWithoutCopying) {
+  const StandardMethodCodec& codec = StandardMethodCodec::GetInstance();
+  std::vector<float> floats = {1.0f, 2.0f, 3.0f};
+  MethodCall<> call("hello", std::make_unique<EncodableValue>(floats));
+  auto encoded = codec.EncodeMethodCall(call);
+  ASSERT_NE(encoded.get(), nullptr);
+  std::unique_ptr<MethodCall<>> decoded =
+      codec.DecodeMethodCallWithBorrowedTypedData(encoded->data(),
+                                                  encoded->size());
+  ASSERT_NE(decoded.get(), nullptr);
+  EXPECT_EQ(decoded->method_name(), "hello");
+
+  const auto& view = std::get<EncodableTypedDataView>(*decoded->arguments());
+  EXPECT_EQ(view.ToVector<float>(), floats);
+  EXPECT_GE(view.bytes(), encoded->data());
+  EXPECT_LE(view.bytes() + view.size_in_bytes(),
+            encoded->data() + encoded->size());
+}
+
 }  // namespace flutter
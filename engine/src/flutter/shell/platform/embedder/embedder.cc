@@ -640,7 +640,12 @@ InferVulkanPlatformViewCreationCallback(
                  static_cast<uint32_t>(frame_size.height)},
     };
 
-    return ptr(user_data, &frame_info);
+    FlutterVulkanImage image = ptr(user_data, &frame_info);
+    // Embedders built against an older version of this struct do not set the
+    // usage of the image.
+    const FlutterVulkanImage* image_ptr = &image;
+    image.usage = SAFE_ACCESS(image_ptr, usage, 0u);
+    return image;
   };
 
   auto vulkan_present_image_callback =
@@ -682,7 +687,8 @@ InferVulkanPlatformViewCreationCallback(
             static_cast<VkDevice>(config->vulkan.device),
             config->vulkan.queue_family_index,
             static_cast<VkQueue>(config->vulkan.queue), vulkan_dispatch_table,
-            view_embedder);
+            view_embedder,
+            SAFE_ACCESS(&config->vulkan, preserves_image_contents, false));
 
     return fml::MakeCopyable(
         [embedder_surface = std::move(embedder_surface),
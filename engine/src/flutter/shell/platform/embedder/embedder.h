@@ -938,6 +938,11 @@ typedef struct {
   FlutterVulkanImageHandle image;
   /// The VkFormat of the image (for example: VK_FORMAT_R8G8B8A8_UNORM).
   uint32_t format;
+  /// The VkImageUsageFlags the image was created with, or 0 if unknown. Only
+  /// read for images returned by `get_next_image_callback`. Partial repaint
+  /// with `FlutterVulkanRendererConfig.preserves_image_contents` requires
+  /// `VK_IMAGE_USAGE_TRANSFER_DST_BIT`.
+  uint32_t usage;
 } FlutterVulkanImage;
 
 /// Callback to fetch a Vulkan function pointer for a given instance. Normally,
@@ -1021,7 +1026,18 @@ typedef struct {
   /// without any additional synchronization.
   /// Not used if a FlutterCompositor is supplied in FlutterProjectArgs.
   FlutterVulkanPresentCallback present_image_callback;
-
+  /// Whether an image returned by `get_next_image_callback` still has the
+  /// contents it had when it was last passed to `present_image_callback`, and
+  /// is still in the layout it was presented in. The engine presents images
+  /// in `VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL`, and an embedder that
+  /// transitions an image to another layout must transition it back before
+  /// returning it again. If set, the Impeller renderer only redraws the region
+  /// of an image that changed since the image was last presented, and leaves
+  /// the rest of the image as it is. The region is copied to the image, so
+  /// this is only done for images whose `FlutterVulkanImage.usage` includes
+  /// `VK_IMAGE_USAGE_TRANSFER_DST_BIT`. Other images are redrawn entirely.
+  /// Not used if a FlutterCompositor is supplied in FlutterProjectArgs.
+  bool preserves_image_contents;
 } FlutterVulkanRendererConfig;
 
 typedef struct {
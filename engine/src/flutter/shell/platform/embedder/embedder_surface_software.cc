@@ -113,4 +113,10 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
   );
 }
 
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::PreservesBackingStoreContents() const {
+  // The embedder is only handed a read-only view of the backing store.
+  return true;
+}
+
 }  // namespace flutter
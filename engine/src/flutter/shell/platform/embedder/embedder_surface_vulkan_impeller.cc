@@ -29,11 +29,13 @@ EmbedderSurfaceVulkanImpeller::EmbedderSurfaceVulkanImpeller(
     uint32_t queue_family_index,
     VkQueue queue,
     const VulkanDispatchTable& vulkan_dispatch_table,
-    std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
+    std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+    bool preserves_image_contents)
     : vk_(fml::MakeRefCounted<vulkan::VulkanProcTable>(
           vulkan_dispatch_table.get_instance_proc_address)),
       vulkan_dispatch_table_(vulkan_dispatch_table),
-      external_view_embedder_(std::move(external_view_embedder)) {
+      external_view_embedder_(std::move(external_view_embedder)),
+      preserves_image_contents_(preserves_image_contents) {
   // Make sure all required members of the dispatch table are checked.
   if (!vulkan_dispatch_table_.get_instance_proc_address ||
       !vulkan_dispatch_table_.get_next_image ||
@@ -106,6 +108,11 @@ bool EmbedderSurfaceVulkanImpeller::PresentImage(VkImage image,
   return vulkan_dispatch_table_.present_image(image, format);
 }
 
+// |GPUSurfaceVulkanDelegate|
+bool EmbedderSurfaceVulkanImpeller::PreservesImageContents() const {
+  return preserves_image_contents_;
+}
+
 // |EmbedderSurface|
 bool EmbedderSurfaceVulkanImpeller::IsValid() const {
   return valid_;
@@ -39,7 +39,8 @@ class EmbedderSurfaceVulkanImpeller final : public EmbedderSurface,
       uint32_t queue_family_index,
       VkQueue queue,
       const VulkanDispatchTable& vulkan_dispatch_table,
-      std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
+      std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+      bool preserves_image_contents = false);
 
   ~EmbedderSurfaceVulkanImpeller() override;
 
@@ -52,6 +53,9 @@ class EmbedderSurfaceVulkanImpeller final : public EmbedderSurface,
   // |GPUSurfaceVulkanDelegate|
   bool PresentImage(VkImage image, VkFormat format) override;
 
+  // |GPUSurfaceVulkanDelegate|
+  bool PreservesImageContents() const override;
+
   // |GPUSurfaceVulkanDelegate|
   std::shared_ptr<impeller::Context> CreateImpellerContext() const override;
 
@@ -61,6 +65,7 @@ class EmbedderSurfaceVulkanImpeller final : public EmbedderSurface,
   VulkanDispatchTable vulkan_dispatch_table_;
   std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
   std::shared_ptr<impeller::ContextVK> context_;
+  const bool preserves_image_contents_;
 
   // |EmbedderSurface|
   bool IsValid() const override;
@@ -636,6 +636,8 @@ def run_engine_benchmarks(
 
   run_engine_executable(build_dir, 'fml_benchmarks', executable_filter, icu_flags)
 
+  run_engine_executable(build_dir, 'assets_benchmarks', executable_filter, icu_flags)
+
   run_engine_executable(build_dir, 'ui_benchmarks', executable_filter, icu_flags)
 
   run_engine_executable(build_dir, 'display_list_builder_benchmarks', executable_filter, icu_flags)